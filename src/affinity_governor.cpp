@@ -0,0 +1,222 @@
+#include "affinity_governor.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace Affinity {
+
+    bool Critical(const std::string& name) {
+        static const char* const kNames[] = {
+            // Windows session, compositor and audio
+            "smss.exe", "csrss.exe", "wininit.exe", "winlogon.exe", "services.exe", "lsass.exe",
+            "dwm.exe", "fontdrvhost.exe", "audiodg.exe",
+            // Linux init and session, audio servers, display servers and compositors
+            "systemd", "systemd-logind", "dbus-daemon", "dbus-broker",
+            "pipewire", "pipewire-pulse", "wireplumber", "pulseaudio", "jackd", "jackdbus",
+            "Xorg", "Xwayland", "gnome-shell", "kwin_wayland", "kwin_x11", "mutter", "sway",
+            "Hyprland", "weston", "gamescope",
+        };
+        for (const char* k : kNames) {
+            size_t i = 0;
+            while (k[i] && i < name.size() &&
+                   std::tolower((unsigned char)k[i]) == std::tolower((unsigned char)name[i]))
+                i++;
+            if (!k[i] && i == name.size()) return true;
+        }
+        return false;
+    }
+
+    Plan MakePlan(const std::vector<Sys::LogicalCpu>& cpus, unsigned reserve) {
+        struct Core { unsigned package, id, perf, first; Sys::CpuMask mask; };
+        std::vector<Core> cores;
+        for (const Sys::LogicalCpu& c : cpus) {
+            if (c.index >= 64) continue;
+            auto it = std::find_if(cores.begin(), cores.end(),
+                                   [&](const Core& k) { return k.package == c.package && k.id == c.core; });
+            if (it == cores.end()) {
+                cores.push_back({ c.package, c.core, c.perfClass, c.index, 0 });
+                it = cores.end() - 1;
+            }
+            it->mask |= Sys::CpuMask(1) << c.index;
+            it->perf  = std::max(it->perf, c.perfClass);
+            it->first = std::min(it->first, c.index);
+        }
+
+        Plan p;
+        for (const Core& k : cores) p.game |= k.mask;
+        p.background = p.game;
+        p.gameCores  = (unsigned)cores.size();
+        if (cores.size() < 2) return p;
+
+        // Fastest first; among equals the high-numbered cores go to the game,
+        // leaving CPU 0 — where most interrupts land — to the background
+        std::sort(cores.begin(), cores.end(), [](const Core& a, const Core& b) {
+            return a.perf != b.perf ? a.perf > b.perf : a.first > b.first;
+        });
+        const unsigned n = (unsigned)cores.size();
+        if (!reserve) reserve = std::max(1u, n / 4);
+        reserve = std::min(reserve, n - 1);
+
+        p.game = p.background = 0;
+        for (unsigned i = 0; i < n; i++) (i < n - reserve ? p.game : p.background) |= cores[i].mask;
+        p.gameCores       = n - reserve;
+        p.backgroundCores = reserve;
+        p.partitioned     = true;
+        return p;
+    }
+
+    bool Governor::Attach(uint32_t rootPid, std::string* error) {
+        Restore();
+        std::vector<Sys::LogicalCpu> cpus;
+        if (!m_be.Topology(cpus)) {
+            if (error) *error = "CPU topology unavailable";
+            return false;
+        }
+        m_plan     = MakePlan(cpus, m_opt.reserveCores);
+        m_stats    = Stats{};
+        m_root     = rootPid;
+        m_self     = Sys::CurrentPid();
+        m_canRaise = false;
+        m_lastCpu.clear();
+        m_lastPoll = Clock::time_point{};
+        if (!Poll()) {
+            if (error) *error = "process " + std::to_string(rootPid) + " not found";
+            return false;
+        }
+        return true;
+    }
+
+    void Governor::Note(bool ok) {
+        if (ok) return;
+        m_stats.failed++;
+        m_stats.lastError = Sys::CallError();
+    }
+
+    void Governor::Touch(const Sys::ProcessInfo& p, bool game) {
+        Saved s;
+        s.name = p.name;
+        s.game = game;
+        Sys::SetCallError(Tweaks::Error::None);
+        // A background process we can't read back (so couldn't restore), or
+        // that refuses the first change, isn't ours: leave it be
+        const bool gotMask = m_plan.partitioned && m_be.GetAffinity(p.pid, s.mask);
+        const bool gotNice = m_be.GetPriority(p.pid, s.nice);
+        if (!game && ((m_plan.partitioned && !gotMask) || !gotNice)) {
+            s.skipped = true;
+            m_touched[p.pid] = std::move(s);
+            return;
+        }
+        if (gotMask) {
+            const Sys::CpuMask want = game ? m_plan.game : m_plan.background;
+            if (s.mask != want) {
+                s.setMask = m_be.SetAffinity(p.pid, want);
+                if (!game && !s.setMask && Sys::CallError() == Tweaks::Error::Denied) {
+                    s.skipped = true;
+                    m_touched[p.pid] = std::move(s);
+                    return;
+                }
+                Note(s.setMask);
+            }
+        }
+        if (gotNice) {
+            if (game && m_opt.gameNice < s.nice) {
+                s.setNice = m_be.SetPriority(p.pid, m_opt.gameNice);
+                Note(s.setNice);
+                if (p.pid == m_root) m_canRaise = s.setNice;
+            } else if (game && p.pid == m_root) {
+                m_canRaise = true;          // launched at that priority already
+            } else if (!game && m_canRaise && m_opt.backgroundNice > s.nice) {
+                s.setNice = m_be.SetPriority(p.pid, m_opt.backgroundNice);
+                Note(s.setNice);
+            }
+        }
+        m_touched[p.pid] = std::move(s);
+    }
+
+    bool Governor::Poll() {
+        XOPT_ZONE("Affinity::Poll");
+        if (!m_root) return false;
+        const Clock::time_point now = Clock::now();
+        if (!m_be.Processes(m_procs)) return true;      // try again next time
+        m_stats.polls++;
+
+        auto find = [this](uint32_t pid) -> const Sys::ProcessInfo* {
+            for (const Sys::ProcessInfo& p : m_procs)
+                if (p.pid == pid) return &p;
+            return nullptr;
+        };
+        if (!find(m_root)) {
+            Restore();
+            m_root = 0;
+            return false;
+        }
+
+        for (uint32_t pid : Sys::ProcessTree(m_procs, m_root))
+            if (!m_touched.count(pid)) Touch(*find(pid), true);
+
+        // Background hogs by CPU share since the last poll, heaviest first
+        const double wallNs = m_lastPoll == Clock::time_point{} ? 0.0
+                            : (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastPoll).count();
+        unsigned moved = 0;
+        for (auto& t : m_touched) moved += !t.second.game && !t.second.skipped;
+        if (wallNs > 0.0 && moved < m_opt.maxMoved) {
+            std::vector<std::pair<double, const Sys::ProcessInfo*>> heavy;
+            for (const Sys::ProcessInfo& p : m_procs) {
+                if (p.system || p.pid == m_self || m_touched.count(p.pid) || Critical(p.name)) continue;
+                auto it = m_lastCpu.find(p.pid);
+                if (it == m_lastCpu.end() || p.cpuNs < it->second) continue;
+                const double pct = 100.0 * (double)(p.cpuNs - it->second) / wallNs;
+                if (pct >= m_opt.heavyPct) heavy.emplace_back(pct, &p);
+            }
+            std::sort(heavy.begin(), heavy.end(), [](auto& a, auto& b) { return a.first > b.first; });
+            for (auto& h : heavy) {
+                if (moved >= m_opt.maxMoved) break;
+                Touch(*h.second, false);
+                moved++;
+            }
+        }
+
+        m_lastCpu.clear();
+        for (const Sys::ProcessInfo& p : m_procs) m_lastCpu[p.pid] = p.cpuNs;
+        m_lastPoll = now;
+        for (auto it = m_touched.begin(); it != m_touched.end();)
+            it = find(it->first) ? std::next(it) : m_touched.erase(it);
+
+        m_stats.gameProcs = m_stats.moved = m_stats.skipped = 0;
+        for (auto& t : m_touched)
+            (t.second.game ? m_stats.gameProcs : t.second.skipped ? m_stats.skipped : m_stats.moved)++;
+        return true;
+    }
+
+    void Governor::Restore() {
+        if (m_touched.empty()) return;
+        m_be.Processes(m_procs);
+        m_stats.restored = 0;
+        for (auto& t : m_touched) {
+            const Saved& s = t.second;
+            // Same pid, same name: still the process we changed
+            const bool alive = std::any_of(m_procs.begin(), m_procs.end(), [&](const Sys::ProcessInfo& p) {
+                return p.pid == t.first && p.name == s.name;
+            });
+            if (!alive || (!s.setMask && !s.setNice)) continue;
+            bool ok = true;
+            if (s.setMask) { const bool r = m_be.SetAffinity(t.first, s.mask); Note(r); ok = ok && r; }
+            if (s.setNice) { const bool r = m_be.SetPriority(t.first, s.nice); Note(r); ok = ok && r; }
+            m_stats.restored += ok;
+        }
+        m_touched.clear();
+        m_stats.gameProcs = m_stats.moved = m_stats.skipped = 0;
+    }
+
+    bool Governor::IsGame(uint32_t pid) const {
+        auto it = m_touched.find(pid);
+        return it != m_touched.end() && it->second.game;
+    }
+
+    bool Governor::IsMoved(uint32_t pid) const {
+        auto it = m_touched.find(pid);
+        return it != m_touched.end() && !it->second.game && !it->second.skipped;
+    }
+
+}  // namespace Affinity
@@ -0,0 +1,116 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  AFFINITY GOVERNOR  —  the game gets the good cores, everything else waits
+// ──────────────────────────────────────────────────────────────────────────────
+//  Attached to a launched game, Poll() (about once a second) walks the
+//  process table through the Backend:
+//    - every process in the game's tree, children included as they appear,
+//      is pinned to the game's cores and raised in priority;
+//    - any other process that used more than `heavyPct` of a core since the
+//      last poll is moved onto the remaining cores and lowered.
+//  The split is by physical core, fastest class first (P before E cores),
+//  so the game never shares an SMT sibling with a background hog.  A
+//  machine with a single physical core gets the priority half only.
+//
+//  Session, audio and compositor processes (Critical()) are never moved:
+//  starving them costs the game more — stutter, crackling audio — than the
+//  cores are worth.  Neither is a process whose affinity and priority can't
+//  be read back, or that refuses the first change, e.g. another user's.
+//
+//  Everything changed is remembered with its original affinity and nice
+//  value and put back by Restore(), which runs on its own once the game's
+//  root process is gone.  Lowering a priority can only be undone with the
+//  right to raise one (CAP_SYS_NICE on Linux), so background processes are
+//  reniced only after raising the game's worked, or the game was started at
+//  that priority already (the GUI launches it HIGH).  Not thread-safe: one
+//  thread owns a Governor.
+#pragma once
+
+#include "backend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Affinity {
+
+    struct Plan {
+        Sys::CpuMask game = 0, background = 0;
+        unsigned     gameCores = 0, backgroundCores = 0;     // physical
+        bool         partitioned = false;                    // false: priorities only
+    };
+
+    // `reserve` physical cores for the background; 0 picks a quarter of them
+    // (at least one).  The slowest cores are the ones reserved.
+    Plan MakePlan(const std::vector<Sys::LogicalCpu>& cpus, unsigned reserve = 0);
+
+    struct Options {
+        double   heavyPct       = 10.0;     // % of one core between polls
+        unsigned reserveCores   = 0;        // see MakePlan
+        int      gameNice       = -5;       // above normal; needs rights to raise
+        int      backgroundNice = 10;       // below normal; never raises anyone
+        unsigned maxMoved       = 32;       // heaviest first
+    };
+
+    // dwm.exe, csrss.exe, audiodg.exe, pipewire, Xorg…; case-insensitive
+    bool Critical(const std::string& name);
+
+    struct Stats {
+        unsigned      gameProcs  = 0;       // currently governed
+        unsigned      moved      = 0;       // background processes currently moved
+        unsigned      skipped    = 0;       // heavy, but not ours to move (see above)
+        unsigned      restored   = 0;       // by the last Restore()
+        unsigned      failed     = 0;       // Set* calls refused, cumulative
+        Tweaks::Error lastError  = Tweaks::Error::None;
+        uint64_t      polls      = 0;
+    };
+
+    class Governor {
+    public:
+        explicit Governor(Sys::Backend& be, Options o = {}) : m_be(be), m_opt(o) {}
+        ~Governor() { Restore(); }
+        Governor(const Governor&)            = delete;
+        Governor& operator=(const Governor&) = delete;
+
+        // Reads the topology and takes the first poll
+        bool Attach(uint32_t rootPid, std::string* error = nullptr);
+        // False once the game's root process is gone (everything restored)
+        bool Poll();
+        void Restore();
+
+        bool         Attached() const { return m_root != 0; }
+        uint32_t     Root() const     { return m_root; }
+        const Plan&  GetPlan() const  { return m_plan; }
+        const Stats& GetStats() const { return m_stats; }
+        bool         IsGame(uint32_t pid) const;
+        bool         IsMoved(uint32_t pid) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Saved {
+            std::string  name;              // pid reuse guard for Restore()
+            Sys::CpuMask mask    = 0;
+            int          nice    = 0;
+            bool         setMask = false, setNice = false;     // what to put back
+            bool         game    = false;
+            bool         skipped = false;   // left alone; remembered so it isn't retried
+        };
+
+        void Touch(const Sys::ProcessInfo& p, bool game);
+        void Note(bool ok);
+
+        Sys::Backend&                   m_be;
+        Options                         m_opt;
+        Plan                            m_plan;
+        Stats                           m_stats;
+        uint32_t                        m_root = 0, m_self = 0;
+        bool                            m_canRaise = false;
+        std::map<uint32_t, Saved>       m_touched;
+        std::map<uint32_t, uint64_t>    m_lastCpu;     // cpuNs at the previous poll
+        Clock::time_point               m_lastPoll{};
+        std::vector<Sys::ProcessInfo>   m_procs;       // reused between polls
+    };
+
+}  // namespace Affinity
@@ -0,0 +1,253 @@
+#include "anim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define XOPT_ANIM_X86 1
+#include <immintrin.h>
+#endif
+
+// No "fma" here on purpose: a fused multiply-add would round differently
+// from the SSE2 / scalar paths and break bit-for-bit determinism
+#if defined(XOPT_ANIM_X86) && !defined(_MSC_VER)
+#define XOPT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define XOPT_TARGET_AVX2
+#endif
+
+namespace Anim {
+
+    float Step(State& s, float target, float dt, float speed) {
+        float diff = target - s.value;
+        s.velocity += diff * speed * dt;
+        s.velocity *= powf(0.001f, dt);  // damping
+        s.value += s.velocity * dt * 60.0f;
+        if (fabsf(diff) < 0.001f && fabsf(s.velocity) < 0.001f) { s.value = target; s.velocity = 0.0f; }
+        return s.value;
+    }
+
+    namespace {
+
+        constexpr float kEps = 0.001f;
+
+        // Per-substep constants, shared by every kernel so all paths round alike
+        struct StepK {
+            float h, h60, damp;
+            StepK() : h((float)Animator::kStepNs * 1e-9f), h60(h * 60.0f), damp(powf(0.001f, h)) {}
+        };
+        const StepK& K() { static const StepK k; return k; }
+
+        // ── Scalar: the reference every SIMD lane must match exactly ─────────
+        void IntegrateScalar(float* x, float* v, const float* t, const float* sp,
+                             size_t n, unsigned steps) {
+            const StepK& c = K();
+            for (size_t i = 0; i < n; i++) {
+                float xi = x[i], vi = v[i];
+                const float ti = t[i], ki = sp[i] * c.h;
+                for (unsigned s = 0; s < steps; s++) {
+                    const float d = ti - xi;
+                    vi = (vi + d * ki) * c.damp;
+                    xi = xi + vi * c.h60;
+                    if (fabsf(d) < kEps && fabsf(vi) < kEps) { xi = ti; vi = 0.0f; }
+                }
+                x[i] = xi; v[i] = vi;
+            }
+        }
+
+#ifdef XOPT_ANIM_X86
+        // Springs stay in registers across all substeps of the frame
+        size_t IntegrateSse2(float* x, float* v, const float* t, const float* sp,
+                             size_t n, unsigned steps) {
+            const StepK& c = K();
+            const __m128 h = _mm_set1_ps(c.h), h60 = _mm_set1_ps(c.h60), damp = _mm_set1_ps(c.damp);
+            const __m128 eps = _mm_set1_ps(kEps), sign = _mm_set1_ps(-0.0f);
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m128 xi = _mm_loadu_ps(x + i), vi = _mm_loadu_ps(v + i);
+                const __m128 ti = _mm_loadu_ps(t + i), ki = _mm_mul_ps(_mm_loadu_ps(sp + i), h);
+                for (unsigned s = 0; s < steps; s++) {
+                    const __m128 d = _mm_sub_ps(ti, xi);
+                    vi = _mm_mul_ps(_mm_add_ps(vi, _mm_mul_ps(d, ki)), damp);
+                    xi = _mm_add_ps(xi, _mm_mul_ps(vi, h60));
+                    const __m128 rest = _mm_and_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, d), eps),
+                                                   _mm_cmplt_ps(_mm_andnot_ps(sign, vi), eps));
+                    xi = _mm_or_ps(_mm_and_ps(rest, ti), _mm_andnot_ps(rest, xi));
+                    vi = _mm_andnot_ps(rest, vi);
+                }
+                _mm_storeu_ps(x + i, xi);
+                _mm_storeu_ps(v + i, vi);
+            }
+            return i;
+        }
+
+        XOPT_TARGET_AVX2
+        size_t IntegrateAvx2(float* x, float* v, const float* t, const float* sp,
+                             size_t n, unsigned steps) {
+            const StepK& c = K();
+            const __m256 h = _mm256_set1_ps(c.h), h60 = _mm256_set1_ps(c.h60), damp = _mm256_set1_ps(c.damp);
+            const __m256 eps = _mm256_set1_ps(kEps), sign = _mm256_set1_ps(-0.0f);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256 xi = _mm256_loadu_ps(x + i), vi = _mm256_loadu_ps(v + i);
+                const __m256 ti = _mm256_loadu_ps(t + i), ki = _mm256_mul_ps(_mm256_loadu_ps(sp + i), h);
+                for (unsigned s = 0; s < steps; s++) {
+                    const __m256 d = _mm256_sub_ps(ti, xi);
+                    vi = _mm256_mul_ps(_mm256_add_ps(vi, _mm256_mul_ps(d, ki)), damp);
+                    xi = _mm256_add_ps(xi, _mm256_mul_ps(vi, h60));
+                    const __m256 rest = _mm256_and_ps(
+                        _mm256_cmp_ps(_mm256_andnot_ps(sign, d), eps, _CMP_LT_OQ),
+                        _mm256_cmp_ps(_mm256_andnot_ps(sign, vi), eps, _CMP_LT_OQ));
+                    xi = _mm256_blendv_ps(xi, ti, rest);
+                    vi = _mm256_andnot_ps(rest, vi);
+                }
+                _mm256_storeu_ps(x + i, xi);
+                _mm256_storeu_ps(v + i, vi);
+            }
+            return i;
+        }
+#endif  // XOPT_ANIM_X86
+
+    }  // namespace
+
+    Animator::Animator(size_t expected) : m_isa(Dsp::Fft::DetectIsa()) {
+        size_t cap = 16;
+        while (cap < expected * 2) cap <<= 1;
+        m_index.assign(cap, Slot{ 0, kEmpty });
+        m_mask  = cap - 1;
+        m_shift = 32;
+        for (size_t c = cap; c > 1; c >>= 1) m_shift--;
+        for (auto* a : { &m_x, &m_v, &m_t, &m_k }) a->reserve(expected);
+        m_id.reserve(expected);
+        m_gen.reserve(expected);
+    }
+
+    size_t Animator::Find(uint32_t id) const {
+        size_t h = Home(id);
+        while (m_index[h].dense != kEmpty && m_index[h].id != id) h = (h + 1) & m_mask;
+        return h;
+    }
+
+    float Animator::Animate(uint32_t id, float target, float speed) {
+        m_stats.calls++;
+        size_t h = Home(id);
+        while (m_index[h].dense != kEmpty && m_index[h].id != id) {
+            h = (h + 1) & m_mask;
+            m_stats.probes++;
+        }
+        if (m_index[h].dense == kEmpty) {
+            if ((m_id.size() + 1) * 2 > m_index.size()) { Grow(); h = Find(id); }
+            m_index[h] = { id, (uint32_t)m_id.size() };
+            m_x.push_back(target); m_v.push_back(0.0f); m_t.push_back(target); m_k.push_back(speed);
+            m_id.push_back(id);    m_gen.push_back(m_frame);
+            return target;
+        }
+        const size_t i = m_index[h].dense;
+        m_gen[i] = m_frame;
+        if (m_t[i] != target || m_k[i] != speed) {
+            m_t[i] = target;
+            m_k[i] = speed;
+            // Resting spring got a new target: pack it into the moving range
+            if (i >= m_active) {
+                const float x = m_x[i];
+                Swap(i, m_active++);
+                return x;
+            }
+        }
+        return m_x[i];
+    }
+
+    void Animator::Integrate(unsigned steps) {
+        float* x = m_x.data();
+        float* v = m_v.data();
+        const float* t = m_t.data();
+        const float* k = m_k.data();
+        size_t done = 0;
+#ifdef XOPT_ANIM_X86
+        if (m_isa == Isa::Avx2)      done = IntegrateAvx2(x, v, t, k, m_active, steps);
+        else if (m_isa == Isa::Sse2) done = IntegrateSse2(x, v, t, k, m_active, steps);
+#endif
+        IntegrateScalar(x + done, v + done, t + done, k + done, m_active - done, steps);
+        m_stats.springSteps += (uint64_t)m_active * steps;
+
+        // Settled springs leave the moving range until their target changes
+        for (size_t i = 0; i < m_active; ) {
+            if (m_v[i] == 0.0f && m_x[i] == m_t[i]) Swap(i, --m_active);
+            else i++;
+        }
+    }
+
+    void Animator::EndFrame(double dt) {
+        const int64_t ns = dt > 0.0 ? (int64_t)std::llround(dt * 1e9) : 0;
+        m_accNs = std::min(m_accNs + ns, kMaxCatchUpNs);
+        const unsigned steps = (unsigned)(m_accNs / kStepNs);
+        m_accNs -= (int64_t)steps * kStepNs;
+        m_stats.substeps += steps;
+        if (steps && m_active) Integrate(steps);
+
+        m_frame++;
+        if (m_frame % kSweepEvery) return;
+        for (size_t i = 0; i < m_id.size(); ) {
+            if (m_frame - m_gen[i] > kMaxIdleFrames) { EraseDense(i); m_stats.evicted++; }
+            else i++;
+        }
+    }
+
+    void Animator::Grow() {
+        const size_t cap = m_index.size() * 2;
+        m_index.assign(cap, Slot{ 0, kEmpty });
+        m_mask = cap - 1;
+        m_shift--;
+        for (uint32_t i = 0; i < (uint32_t)m_id.size(); i++)
+            m_index[Find(m_id[i])] = { m_id[i], i };
+    }
+
+    void Animator::Move(size_t from, size_t to) {
+        m_x[to] = m_x[from]; m_v[to] = m_v[from]; m_t[to] = m_t[from]; m_k[to] = m_k[from];
+        m_id[to] = m_id[from]; m_gen[to] = m_gen[from];
+        m_index[Find(m_id[to])].dense = (uint32_t)to;
+    }
+
+    void Animator::Swap(size_t a, size_t b) {
+        if (a == b) return;
+        std::swap(m_x[a], m_x[b]); std::swap(m_v[a], m_v[b]);
+        std::swap(m_t[a], m_t[b]); std::swap(m_k[a], m_k[b]);
+        std::swap(m_id[a], m_id[b]); std::swap(m_gen[a], m_gen[b]);
+        m_index[Find(m_id[a])].dense = (uint32_t)a;
+        m_index[Find(m_id[b])].dense = (uint32_t)b;
+    }
+
+    // Keep the moving range packed, swap-remove from the dense arrays, then
+    // backward-shift delete the slot so probe runs stay unbroken without
+    // tombstones
+    void Animator::EraseDense(size_t i) {
+        size_t hole = Find(m_id[i]);
+        m_index[hole].dense = kEmpty - 1;               // still occupied while we shuffle
+        if (i < m_active) { Move(m_active - 1, i); i = --m_active; }
+        const size_t last = m_id.size() - 1;
+        if (i != last) Move(last, i);
+        for (auto* a : { &m_x, &m_v, &m_t, &m_k }) a->pop_back();
+        m_id.pop_back();
+        m_gen.pop_back();
+        for (size_t j = (hole + 1) & m_mask; m_index[j].dense != kEmpty; j = (j + 1) & m_mask) {
+            const size_t home = Home(m_index[j].id);
+            // Move j back into the hole unless its home lies cyclically in (hole, j]
+            const bool stays = hole <= j ? (home > hole && home <= j) : (home > hole || home <= j);
+            if (stays) continue;
+            m_index[hole] = m_index[j];
+            hole = j;
+        }
+        m_index[hole].dense = kEmpty;
+    }
+
+    void Animator::Clear() {
+        for (auto* a : { &m_x, &m_v, &m_t, &m_k }) a->clear();
+        m_id.clear();
+        m_gen.clear();
+        m_active = 0;
+        m_accNs  = 0;
+        for (Slot& s : m_index) s.dense = kEmpty;
+    }
+
+}  // namespace Anim
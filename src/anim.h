@@ -0,0 +1,94 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  ANIMATION  —  retained, batched spring integrator for the widgets
+// ──────────────────────────────────────────────────────────────────────────────
+//  UI-agnostic: callers pass their own ids and frame delta, so the same
+//  system runs under ImGui and in headless benchmarks.
+//  Widgets only register a target and read back the current value; EndFrame()
+//  integrates every moving spring in one SoA pass (SSE2 / AVX2, picked at
+//  runtime).  Time advances in fixed 1/240 s substeps counted in integer
+//  nanoseconds, so the result depends only on elapsed time — not on the frame
+//  rate, the ISA or how the time was split into frames.
+//  Springs are stored densely with moving ones packed at the front; an
+//  open-addressing index (linear probing, ≤ 50 % load) maps id → slot.  Every
+//  touch stamps the frame generation, and ids that stop being drawn are swept.
+#pragma once
+
+#include "fft.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Anim {
+
+    struct State { float value = 0.0f; float velocity = 0.0f; };
+
+    // One spring step towards `target`; returns the new value.  Immediate-mode
+    // reference for one-off use — widgets go through Animator.
+    float Step(State& s, float target, float dt, float speed);
+
+    class Animator {
+    public:
+        using Isa = Dsp::Fft::Isa;
+
+        struct Stats {
+            uint64_t calls    = 0;
+            uint64_t substeps = 0;      // fixed steps taken
+            uint64_t springSteps = 0;   // springs × substeps actually integrated
+            uint64_t probes   = 0;      // index slots inspected beyond the first
+            uint64_t evicted  = 0;
+        };
+
+        static constexpr int64_t  kStepNs        = 1000000000 / 240;
+        static constexpr int64_t  kMaxCatchUpNs  = 250000000;  // after a stall, don't fast-forward further
+        static constexpr uint32_t kMaxIdleFrames = 120;        // ~2 s of frames at 60 Hz
+        static constexpr uint32_t kSweepEvery    = 32;
+
+        explicit Animator(size_t expected = 64);
+
+        // Register `target` and get the value as of the last EndFrame().  A new
+        // id starts at its target — a widget that reappears after eviction
+        // doesn't replay its entry animation.
+        float  Animate(uint32_t id, float target, float speed = 14.0f);
+
+        // Once per frame after the widgets: integrate, advance the generation,
+        // periodically sweep stale ids
+        void   EndFrame(double dt);
+
+        size_t Size() const     { return m_id.size(); }
+        size_t Active() const   { return m_active; }   // springs still moving
+        size_t Capacity() const { return m_index.size(); }
+        void   Clear();
+        Stats  GetStats() const { return m_stats; }
+        Isa    ActiveIsa() const { return m_isa; }
+        void   ForceIsa(Isa isa) { m_isa = isa; }        // benchmarks / determinism checks
+
+    private:
+        struct Slot { uint32_t id; uint32_t dense; };     // dense == kEmpty: free
+        static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+        size_t Home(uint32_t id) const { return (size_t)((id * 0x9E3779B1u) >> m_shift); }
+        size_t Find(uint32_t id) const;     // slot holding id, or the free slot ending its probe run
+        void   Grow();
+        void   Move(size_t from, size_t to);   // dense entry + its index slot
+        void   Swap(size_t a, size_t b);
+        void   EraseDense(size_t i);
+        void   Integrate(unsigned steps);
+
+        // SoA, [0, m_active) are moving
+        std::vector<float>    m_x, m_v, m_t, m_k;  // value, velocity, target, speed
+        std::vector<uint32_t> m_id, m_gen;
+        size_t                m_active = 0;
+
+        std::vector<Slot>  m_index;
+        size_t             m_mask  = 0;
+        unsigned           m_shift = 0;
+        uint32_t           m_frame = 1;
+        int64_t            m_accNs = 0;
+        Isa                m_isa;
+        Stats              m_stats;
+    };
+
+    inline float EaseInOut(float t) { return t * t * (3.0f - 2.0f * t); }
+
+}  // namespace Anim
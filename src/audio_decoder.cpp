@@ -0,0 +1,173 @@
+#include "audio_decoder.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Audio {
+
+    static bool Fail(std::string* error, const char* why) {
+        if (error) *error = why;
+        return false;
+    }
+
+    static uint16_t Le16(const uint8_t* p) { return (uint16_t)(p[0] | p[1] << 8); }
+    static uint32_t Le32(const uint8_t* p) {
+        return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    }
+
+    // ── WAV (PCM 8/16/24/32-bit, IEEE float 32/64-bit, WAVE_FORMAT_EXTENSIBLE) ─
+    class WavDecoder final : public Decoder {
+    public:
+        bool Open(const fs::path& p, std::string* error) {
+            if (!m_map.Open(p)) return Fail(error, "cannot open file");
+            const uint8_t* d = m_map.Data();
+            const size_t   n = m_map.Size();
+            if (n < 12 || std::memcmp(d, "RIFF", 4) || std::memcmp(d + 8, "WAVE", 4))
+                return Fail(error, "not a RIFF/WAVE file");
+
+            bool haveFmt = false;
+            for (size_t off = 12; off + 8 <= n; ) {
+                const uint32_t len  = Le32(d + off + 4);
+                const uint8_t* body = d + off + 8;
+                const size_t   avail = std::min<size_t>(len, n - off - 8);
+                if (!std::memcmp(d + off, "fmt ", 4) && avail >= 16) {
+                    m_tag          = Le16(body);
+                    m_fmt.channels = Le16(body + 2);
+                    m_fmt.sampleRate = Le32(body + 4);
+                    m_bits         = Le16(body + 14);
+                    if (m_tag == 0xFFFE && avail >= 26) m_tag = Le16(body + 24);   // SubFormat GUID
+                    haveFmt = true;
+                } else if (!std::memcmp(d + off, "data", 4)) {
+                    m_data  = body;
+                    m_bytes = avail;        // tolerate truncated files
+                    break;
+                }
+                off += 8 + (size_t)len + (len & 1);
+            }
+            if (!haveFmt || !m_data) return Fail(error, "missing fmt or data chunk");
+            if (!m_fmt.channels || !m_fmt.sampleRate) return Fail(error, "bad format");
+            const bool pcm = m_tag == 1 && (m_bits == 8 || m_bits == 16 || m_bits == 24 || m_bits == 32);
+            const bool flt = m_tag == 3 && (m_bits == 32 || m_bits == 64);
+            if (!pcm && !flt) return Fail(error, "unsupported WAV sample format");
+            m_frameBytes = (size_t)m_fmt.channels * (m_bits / 8);
+            m_total      = m_bytes / m_frameBytes;
+            return true;
+        }
+
+        const char* Codec() const override { return "wav"; }
+
+        size_t Read(float* out, size_t frames) override {
+            frames = (size_t)std::min<uint64_t>(frames, m_total - m_pos);
+            const uint8_t* s = m_data + m_pos * m_frameBytes;
+            const size_t   count = frames * m_fmt.channels;
+            switch (m_tag == 3 ? 100 + m_bits : m_bits) {
+                case 8:   for (size_t i = 0; i < count; i++) out[i] = ((int)s[i] - 128) * (1.0f / 128.0f); break;
+                case 16:  for (size_t i = 0; i < count; i++) out[i] = (int16_t)Le16(s + 2 * i) * (1.0f / 32768.0f); break;
+                case 24:
+                    for (size_t i = 0; i < count; i++) {
+                        const uint8_t* b = s + 3 * i;
+                        const int32_t  v = (int32_t)((uint32_t)b[0] << 8 | (uint32_t)b[1] << 16 | (uint32_t)b[2] << 24);
+                        out[i] = (float)(v >> 8) * (1.0f / 8388608.0f);
+                    }
+                    break;
+                case 32:  for (size_t i = 0; i < count; i++) out[i] = (float)((int32_t)Le32(s + 4 * i) * (1.0 / 2147483648.0)); break;
+                case 132: for (size_t i = 0; i < count; i++) { uint32_t u = Le32(s + 4 * i); std::memcpy(&out[i], &u, 4); } break;
+                case 164:
+                    for (size_t i = 0; i < count; i++) {
+                        uint64_t u = (uint64_t)Le32(s + 8 * i) | (uint64_t)Le32(s + 8 * i + 4) << 32;
+                        double   v; std::memcpy(&v, &u, 8);
+                        out[i] = (float)v;
+                    }
+                    break;
+            }
+            m_pos += frames;
+            return frames;
+        }
+
+        bool Seek(uint64_t frame) override {
+            m_pos = std::min(frame, m_total);
+            return true;
+        }
+
+    private:
+        IO::MappedFile m_map;
+        const uint8_t* m_data  = nullptr;
+        size_t         m_bytes = 0, m_frameBytes = 0;
+        uint16_t       m_tag   = 0, m_bits = 0;
+        uint64_t       m_pos   = 0;
+    };
+
+    std::unique_ptr<Decoder> OpenWav(const fs::path& p, std::string* error) {
+        auto d = std::make_unique<WavDecoder>();
+        if (!d->Open(p, error)) return nullptr;
+        return d;
+    }
+
+    // ── Prefetch wrapper ───────────────────────────────────────────────────────
+    class PrefetchDecoder final : public Decoder {
+    public:
+        PrefetchDecoder(std::unique_ptr<Decoder> inner, size_t frames) : m_in(std::move(inner)) {
+            m_fmt   = m_in->Fmt();
+            m_total = m_in->TotalFrames();
+            m_head.resize(frames * m_fmt.channels);
+            m_headFrames = m_in->Read(m_head.data(), frames);
+        }
+
+        const char* Codec() const override { return m_in->Codec(); }
+
+        size_t Read(float* out, size_t frames) override {
+            size_t done = 0;
+            if (m_pos < m_headFrames) {
+                done = std::min(frames, m_headFrames - m_pos);
+                std::memcpy(out, m_head.data() + m_pos * m_fmt.channels, done * m_fmt.channels * sizeof(float));
+                m_pos += done;
+            }
+            if (done < frames) {
+                const size_t got = m_in->Read(out + done * m_fmt.channels, frames - done);
+                done  += got;
+                m_pos += got;
+            }
+            return done;
+        }
+
+        bool Seek(uint64_t frame) override {
+            if (frame <= m_headFrames) {          // still inside the prefetched head
+                if (m_pos > m_headFrames && !m_in->Seek(m_headFrames)) return false;
+                m_pos = (size_t)frame;
+                return true;
+            }
+            if (!m_in->Seek(frame)) return false;
+            m_pos = (size_t)frame;
+            return true;
+        }
+
+    private:
+        std::unique_ptr<Decoder> m_in;
+        std::vector<float>       m_head;
+        size_t                   m_headFrames = 0, m_pos = 0;
+    };
+
+    std::unique_ptr<Decoder> Prefetch(std::unique_ptr<Decoder> dec, size_t frames) {
+        if (!dec) return nullptr;
+        return std::make_unique<PrefetchDecoder>(std::move(dec), frames);
+    }
+
+#ifndef _WIN32
+    std::unique_ptr<Decoder> OpenMediaFoundation(const fs::path&, std::string* error) {
+        Fail(error, "format needs the Windows Media Foundation decoder");
+        return nullptr;
+    }
+#endif
+
+    std::unique_ptr<Decoder> OpenDecoder(const fs::path& p, std::string* error) {
+        IO::MappedFile head;
+        if (!head.Open(p) || head.Size() < 12) { Fail(error, "cannot open file"); return nullptr; }
+        const uint8_t* d = head.Data();
+        if (!std::memcmp(d, "RIFF", 4) && !std::memcmp(d + 8, "WAVE", 4)) return OpenWav(p, error);
+        if (!std::memcmp(d, "fLaC", 4))                                   return OpenFlac(p, error);
+        return OpenMediaFoundation(p, error);      // MP3, AAC, WMA, …
+    }
+
+}  // namespace Audio
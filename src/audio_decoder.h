@@ -0,0 +1,58 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  AUDIO DECODERS  —  WAV / FLAC / MP3 → interleaved float PCM
+// ──────────────────────────────────────────────────────────────────────────────
+//  WAV and FLAC are decoded in-tree straight from a memory-mapped file, so
+//  they work identically everywhere.  MP3 (and anything else) goes through
+//  Media Foundation on Windows; other platforms report it as unsupported.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace Audio {
+
+    namespace fs = std::filesystem;
+
+    struct Format {
+        uint32_t sampleRate = 0;
+        uint16_t channels   = 0;
+        bool operator==(const Format& o) const { return sampleRate == o.sampleRate && channels == o.channels; }
+    };
+
+    class Decoder {
+    public:
+        virtual ~Decoder() = default;
+
+        virtual const char* Codec() const = 0;
+
+        // Up to `frames` interleaved frames into `out`; 0 = end of stream
+        virtual size_t Read(float* out, size_t frames) = 0;
+        virtual bool   Seek(uint64_t frame) = 0;
+
+        const Format& Fmt()         const { return m_fmt; }
+        uint64_t      TotalFrames() const { return m_total; }   // 0 = unknown
+        double        Seconds()     const {
+            return m_fmt.sampleRate ? (double)m_total / m_fmt.sampleRate : 0.0;
+        }
+
+    protected:
+        Format   m_fmt;
+        uint64_t m_total = 0;
+    };
+
+    // Picks a decoder by file signature; nullptr + reason on failure
+    std::unique_ptr<Decoder> OpenDecoder(const fs::path& p, std::string* error = nullptr);
+
+    // Decodes up to `frames` ahead now (on the calling thread) and serves them
+    // first, so the consumer's first Read()s cost a memcpy
+    std::unique_ptr<Decoder> Prefetch(std::unique_ptr<Decoder> dec, size_t frames);
+
+    // Per-format factories (called by OpenDecoder)
+    std::unique_ptr<Decoder> OpenWav(const fs::path& p, std::string* error);
+    std::unique_ptr<Decoder> OpenFlac(const fs::path& p, std::string* error);
+    std::unique_ptr<Decoder> OpenMediaFoundation(const fs::path& p, std::string* error);
+
+}  // namespace Audio
@@ -0,0 +1,425 @@
+#include "audio_engine.h"
+#include "profiler.h"
+#include "spectrum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace Audio {
+
+    using Clock = std::chrono::steady_clock;
+
+    // ── PcmRing ──────────────────────────────────────────────────────────────
+    void PcmRing::Reset(size_t minSamples) {
+        size_t cap = 1024;
+        while (cap < minSamples) cap <<= 1;
+        m_buf.assign(cap, 0.0f);
+        m_mask = cap - 1;
+        m_w.store(0, std::memory_order_relaxed);
+        m_r.store(0, std::memory_order_relaxed);
+    }
+
+    size_t PcmRing::Writable() const {
+        return m_buf.size() - (m_w.load(std::memory_order_relaxed) - m_r.load(std::memory_order_acquire));
+    }
+
+    size_t PcmRing::Readable() const {
+        return m_w.load(std::memory_order_acquire) - m_r.load(std::memory_order_relaxed);
+    }
+
+    size_t PcmRing::Write(const float* src, size_t n) {
+        const size_t w = m_w.load(std::memory_order_relaxed);
+        n = std::min(n, Writable());
+        const size_t at = w & m_mask, first = std::min(n, m_buf.size() - at);
+        std::memcpy(&m_buf[at], src, first * sizeof(float));
+        std::memcpy(&m_buf[0], src + first, (n - first) * sizeof(float));
+        m_w.store(w + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t PcmRing::Read(float* dst, size_t n) {
+        const size_t r = m_r.load(std::memory_order_relaxed);
+        n = std::min(n, Readable());
+        const size_t at = r & m_mask, first = std::min(n, m_buf.size() - at);
+        std::memcpy(dst, &m_buf[at], first * sizeof(float));
+        std::memcpy(dst + first, &m_buf[0], (n - first) * sizeof(float));
+        m_r.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+    // ── Null / WAV sinks: a thread that pulls like a device would ────────────
+    class ClockSink final : public Sink {
+    public:
+        ClockSink(bool paced, fs::path wavPath) : m_paced(paced), m_path(std::move(wavPath)) {}
+        ~ClockSink() override { Close(); }
+
+        const char* Name() const override { return m_path.empty() ? (m_paced ? "null" : "null-fast") : "wav"; }
+        bool Offline() const override { return !m_paced; }
+
+        bool Open(const Format& fmt, Source* src, std::string* error) override {
+            Close();
+            m_fmt = fmt;
+            m_src = src;
+            m_period = std::max<size_t>(64, fmt.sampleRate / 100);   // 10 ms, like a shared-mode device
+            m_buf.assign(m_period * fmt.channels, 0.0f);
+            if (!m_path.empty()) {
+                m_file = std::fopen(m_path.string().c_str(), "wb");
+                if (!m_file) { if (error) *error = "cannot create " + m_path.u8string(); return false; }
+                WriteHeader(0);
+            }
+            m_frames = 0;
+            return true;
+        }
+
+        void Start() override {
+            if (m_thread.joinable() || !m_src) return;
+            m_run = true;
+            m_thread = std::thread([this] { Loop(); });
+        }
+
+        void Stop() override {
+            m_run = false;
+            if (m_thread.joinable()) m_thread.join();
+        }
+
+        void Close() override {
+            Stop();
+            if (m_file) {
+                WriteHeader(m_frames);
+                std::fclose(m_file);
+                m_file = nullptr;
+            }
+            m_src = nullptr;
+        }
+
+    private:
+        void Loop() {
+            Prof::SetThreadName("audio");
+            auto deadline = Clock::now();
+            const auto period = std::chrono::nanoseconds(m_period * 1000000000ull / m_fmt.sampleRate);
+            while (m_run.load(std::memory_order_relaxed)) {
+                if (m_paced) {
+                    deadline += period;
+                    std::this_thread::sleep_until(deadline);
+                } else if (m_src->ReadyFrames() < m_period && !m_src->Drained()) {
+                    std::this_thread::yield();         // offline: wait for the decoder, no underruns
+                    continue;
+                } else if (m_src->Drained()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+                m_src->Render(m_buf.data(), m_period);
+                if (m_file) {
+                    std::fwrite(m_buf.data(), sizeof(float), m_buf.size(), m_file);
+                    m_frames += m_period;
+                }
+            }
+        }
+
+        // 32-bit float WAVE; sizes patched on Close()
+        void WriteHeader(uint64_t frames) {
+            const uint32_t ch = m_fmt.channels, rate = m_fmt.sampleRate;
+            const uint32_t data = (uint32_t)std::min<uint64_t>(frames * ch * 4, 0xFFFFFFFFull - 36);
+            uint8_t h[44];
+            auto le32 = [&](int at, uint32_t v) { for (int i = 0; i < 4; i++) h[at + i] = (uint8_t)(v >> (8 * i)); };
+            auto le16 = [&](int at, uint32_t v) { h[at] = (uint8_t)v; h[at + 1] = (uint8_t)(v >> 8); };
+            std::memcpy(h, "RIFF", 4);      le32(4, 36 + data);
+            std::memcpy(h + 8, "WAVEfmt ", 8); le32(16, 16);
+            le16(20, 3); le16(22, ch); le32(24, rate); le32(28, rate * ch * 4); le16(32, ch * 4); le16(34, 32);
+            std::memcpy(h + 36, "data", 4); le32(40, data);
+            std::fseek(m_file, 0, SEEK_SET);
+            std::fwrite(h, 1, sizeof(h), m_file);
+            std::fseek(m_file, 0, SEEK_END);
+        }
+
+        bool               m_paced;
+        fs::path           m_path;
+        Format             m_fmt;
+        Source*            m_src    = nullptr;
+        size_t             m_period = 480;
+        std::vector<float> m_buf;
+        FILE*              m_file   = nullptr;
+        uint64_t           m_frames = 0;
+        std::thread        m_thread;
+        std::atomic<bool>  m_run{ false };
+    };
+
+#ifndef _WIN32
+    std::unique_ptr<Sink> MakeWasapiSink() { return nullptr; }
+#endif
+
+    std::unique_ptr<Sink> MakeSink(const std::string& spec, std::string* error) {
+        if (spec == "default") {
+            if (auto s = MakeWasapiSink()) return s;
+            return std::make_unique<ClockSink>(true, fs::path());
+        }
+        if (spec == "wasapi") {
+            if (auto s = MakeWasapiSink()) return s;
+            if (error) *error = "wasapi sink is only available on Windows";
+            return nullptr;
+        }
+        if (spec == "null")      return std::make_unique<ClockSink>(true,  fs::path());
+        if (spec == "null-fast") return std::make_unique<ClockSink>(false, fs::path());
+        if (spec.rfind("wav:", 0) == 0 && spec.size() > 4)
+            return std::make_unique<ClockSink>(false, fs::u8path(spec.substr(4)));
+        if (error) *error = "unknown sink '" + spec + "' (default, wasapi, null, null-fast, wav:PATH)";
+        return nullptr;
+    }
+
+    // ── Engine ───────────────────────────────────────────────────────────────
+    Engine::Engine(std::unique_ptr<Sink> sink) : m_sink(std::move(sink)) {}
+
+    Engine::~Engine() { Close(); }
+
+    bool Engine::Open(const fs::path& p, std::string* error) {
+        std::unique_ptr<Decoder> dec = OpenDecoder(p, error);
+        return dec && Open(std::move(dec), error);
+    }
+
+    bool Engine::Open(std::unique_ptr<Decoder> dec, std::string* error) {
+        StopDecoder();
+        if (!dec) return false;
+        const Format fmt = dec->Fmt();
+        if (m_sinkOpen && !(fmt == m_fmt)) { m_sink->Close(); m_sinkOpen = false; }
+        m_fmt = fmt;
+        m_ring.Reset((size_t)m_fmt.sampleRate * m_fmt.channels / 2);     // ~0.5 s
+        Mark m;
+        while (m_seeks.TryPop(m)) {}
+        while (m_wraps.TryPop(m)) {}
+        m_played = 0;
+        m_total  = dec->TotalFrames();
+        m_track  = 0;
+        m_seekReq = m_seekShown = -1;
+        m_eof = false;
+        m_gain = m_volume.load(std::memory_order_relaxed);
+        m_callbacks = m_rendered = m_underruns = m_cbNsTotal = m_cbNsMax = 0;
+        if (m_tap) m_tap->Reset(m_fmt.sampleRate);
+        // Same format as the last track: keep the device stream, skip re-init
+        if (!m_sinkOpen) {
+            if (!m_sink->Open(m_fmt, this, error)) return false;
+            m_sinkOpen = true;
+        }
+
+        m_dec  = std::move(dec);
+        m_open = true;
+        m_run  = true;
+        m_thread = std::thread([this] { DecodeLoop(); });
+        return true;
+    }
+
+    void Engine::StopDecoder() {
+        if (m_playing) { m_sink->Stop(); m_playing = false; }
+        m_run = false;
+        if (m_thread.joinable()) m_thread.join();
+        m_dec.reset();
+        delete m_next.exchange(nullptr);
+        m_open = false;
+    }
+
+    void Engine::Close() {
+        StopDecoder();
+        if (m_sinkOpen) { m_sink->Close(); m_sinkOpen = false; }
+    }
+
+    bool Engine::QueueNext(std::unique_ptr<Decoder>& dec) {
+        if (!m_open || !dec || !(dec->Fmt() == m_fmt)) return false;
+        delete m_next.exchange(dec.release(), std::memory_order_acq_rel);
+        return true;
+    }
+
+    void Engine::Play() {
+        if (!m_open) return;
+        if (Drained()) Seek(0.0);                   // replay a finished track
+        if (m_playing) return;
+        // Let the decoder get ~50 ms ahead so the first callback isn't an underrun
+        const auto until = Clock::now() + std::chrono::milliseconds(100);
+        while (ReadyFrames() < m_fmt.sampleRate / 20 && !m_eof.load(std::memory_order_relaxed) &&
+               Clock::now() < until)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        m_playing = true;
+        m_sink->Start();
+    }
+
+    void Engine::Pause() {
+        if (!m_playing) return;
+        m_sink->Stop();
+        m_playing = false;
+    }
+
+    void Engine::Seek(double seconds) {
+        if (!m_open) return;
+        int64_t f = (int64_t)(std::max(0.0, seconds) * m_fmt.sampleRate);
+        if (const uint64_t total = m_total.load(std::memory_order_relaxed)) f = std::min<int64_t>(f, (int64_t)total);
+        m_seekShown.store(f, std::memory_order_relaxed);
+        m_seekReq.store(f, std::memory_order_release);
+    }
+
+    double Engine::Position() const {
+        if (!m_fmt.sampleRate) return 0.0;
+        const int64_t shown = m_seekShown.load(std::memory_order_relaxed);
+        const uint64_t f = shown >= 0 ? (uint64_t)shown : m_played.load(std::memory_order_relaxed);
+        return (double)f / m_fmt.sampleRate;
+    }
+
+    double Engine::Duration() const {
+        return m_fmt.sampleRate ? (double)m_total.load(std::memory_order_relaxed) / m_fmt.sampleRate : 0.0;
+    }
+
+    float Engine::Progress() const {
+        const double d = Duration();
+        return d > 0.0 ? (float)std::min(1.0, Position() / d) : 0.0f;
+    }
+
+    size_t Engine::ReadyFrames() const {
+        return m_fmt.channels ? m_ring.Readable() / m_fmt.channels : 0;
+    }
+
+    bool Engine::Drained() const {
+        return m_eof.load(std::memory_order_acquire) && m_ring.Readable() == 0 &&
+               m_seekReq.load(std::memory_order_relaxed) < 0;
+    }
+
+    void Engine::DecodeLoop() {
+        constexpr size_t kChunk = 1024;
+        const unsigned   ch     = m_fmt.channels;
+        std::vector<float> buf(kChunk * ch);
+        uint32_t track = 0;
+        Prof::SetThreadName("audio decoder");
+        while (m_run.load(std::memory_order_relaxed)) {
+            const int64_t req = m_seekReq.load(std::memory_order_acquire);
+            if (req >= 0) {
+                if (m_seeks.TryPush({ m_ring.WriteIndex(), (uint64_t)req, 0, 0 })) {
+                    m_dec->Seek((uint64_t)req);
+                    m_eof.store(false, std::memory_order_release);
+                    int64_t expect = req;
+                    m_seekReq.compare_exchange_strong(expect, -1);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));   // callback stalled
+                }
+                continue;
+            }
+            if (m_eof.load(std::memory_order_relaxed)) {
+                // Gapless loop / next track: switch decoders and let the
+                // callback reset the position when it reaches this ring index
+                const uint64_t total = m_dec->TotalFrames();
+                if (m_loop.load(std::memory_order_relaxed) && total) {
+                    if (m_wraps.TryPush({ m_ring.WriteIndex(), 0, total, track })) {
+                        m_dec->Seek(0);
+                        m_eof.store(false, std::memory_order_release);
+                        continue;
+                    }
+                } else if (Decoder* next = m_next.exchange(nullptr, std::memory_order_acq_rel)) {
+                    if (m_wraps.TryPush({ m_ring.WriteIndex(), 0, next->TotalFrames(), track + 1 })) {
+                        m_dec.reset(next);
+                        ++track;
+                        m_eof.store(false, std::memory_order_release);
+                        continue;
+                    }
+                    Decoder* expect = nullptr;
+                    if (!m_next.compare_exchange_strong(expect, next)) delete next;   // replaced meanwhile
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+            if (m_ring.Writable() < buf.size()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+            size_t got;
+            {
+                XOPT_ZONE("Audio::Decode");
+                got = m_dec->Read(buf.data(), kChunk);
+            }
+            if (!got) { m_eof.store(true, std::memory_order_release); continue; }
+            m_ring.Write(buf.data(), got * ch);
+        }
+    }
+
+    void Engine::ApplyWrap(const Mark& w) {
+        m_played.store(w.frame, std::memory_order_relaxed);
+        m_total.store(w.total, std::memory_order_relaxed);
+        m_track.store(w.track, std::memory_order_release);
+    }
+
+    // Output thread: no locks, no allocation
+    void Engine::Render(float* out, size_t frames) {
+        XOPT_ZONE("Audio::Render");
+        const auto     t0 = Clock::now();
+        const unsigned ch = m_fmt.channels;
+        const size_t   want = frames * ch;
+
+        // Seeks: jump to where post-seek audio starts; track switches skipped
+        // over on the way still count
+        Mark m;
+        bool seeked = false;
+        while (m_seeks.TryPop(m)) {
+            m_ring.SkipTo(m.ringIndex);
+            while (const Mark* w = m_wraps.Peek()) {
+                if (w->ringIndex > m.ringIndex) break;
+                ApplyWrap(*w);
+                m_wraps.Drop();
+            }
+            m_played.store(m.frame, std::memory_order_relaxed);
+            seeked = true;
+        }
+        if (seeked) {
+            int64_t expect = (int64_t)m.frame;
+            m_seekShown.compare_exchange_strong(expect, -1);
+        }
+
+        size_t filled = 0;
+        while (filled < want) {
+            size_t limit = want - filled;
+            if (const Mark* w = m_wraps.Peek()) {
+                const size_t r = m_ring.ReadIndex();
+                if (w->ringIndex <= r) {
+                    ApplyWrap(*w);
+                    m_wraps.Drop();
+                    continue;
+                }
+                limit = std::min(limit, w->ringIndex - r);
+            }
+            const size_t got = m_ring.Read(out + filled, limit);
+            filled += got;
+            m_played.fetch_add(got / ch, std::memory_order_relaxed);
+            if (got < limit) break;                 // ring empty
+        }
+        if (filled < want) {
+            std::fill(out + filled, out + want, 0.0f);
+            if (!m_eof.load(std::memory_order_relaxed))
+                m_underruns.fetch_add((want - filled) / ch, std::memory_order_relaxed);
+        }
+
+        if (m_tap && filled) m_tap->Push(out, filled / ch, ch);
+
+        // Volume: linear ramp across the buffer so slider moves don't click
+        const float target = m_volume.load(std::memory_order_relaxed);
+        if (target != m_gain || target != 1.0f) {
+            const float step = (target - m_gain) / (float)frames;
+            float g = m_gain;
+            for (size_t f = 0; f < frames; f++, g += step)
+                for (unsigned c = 0; c < ch; c++) out[f * ch + c] *= g;
+            m_gain = target;
+        }
+
+        const uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        m_callbacks.fetch_add(1, std::memory_order_relaxed);
+        m_rendered.fetch_add(filled / ch, std::memory_order_relaxed);
+        m_cbNsTotal.fetch_add(ns, std::memory_order_relaxed);
+        if (ns > m_cbNsMax.load(std::memory_order_relaxed)) m_cbNsMax.store(ns, std::memory_order_relaxed);
+    }
+
+    Engine::Stats Engine::GetStats() const {
+        Stats s;
+        s.callbacks      = m_callbacks.load(std::memory_order_relaxed);
+        s.framesRendered = m_rendered.load(std::memory_order_relaxed);
+        s.underrunFrames = m_underruns.load(std::memory_order_relaxed);
+        s.callbackNsMax  = m_cbNsMax.load(std::memory_order_relaxed);
+        s.callbackNsAvg  = s.callbacks ? (double)m_cbNsTotal.load(std::memory_order_relaxed) / s.callbacks : 0.0;
+        s.ringSamples    = m_ring.Capacity();
+        return s;
+    }
+
+}  // namespace Audio
@@ -0,0 +1,168 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  AUDIO ENGINE  —  decoder thread → lock-free PCM ring → pull-model sink
+// ──────────────────────────────────────────────────────────────────────────────
+//  The decoder thread keeps ~half a second of interleaved float PCM queued.
+//  The output backend (Sink) pulls from Render() on its own thread; that
+//  callback never locks or allocates.  Volume, loop, seek requests and the
+//  play position are plain atomics, so the UI can poll them every frame for
+//  free.  Seeks and loop wraps travel producer → consumer as markers: the
+//  decoder records the ring index where the new position begins, and the
+//  callback skips to it (seek) or resets the position on reaching it (wrap).
+#pragma once
+
+#include "audio_decoder.h"
+#include "progress.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Dsp { class SpectrumAnalyzer; }
+
+namespace Audio {
+
+    // ── Lock-free SPSC sample ring (indices count samples, never wrap) ───────
+    class PcmRing {
+    public:
+        void   Reset(size_t minSamples);        // not thread-safe: call while idle
+        size_t Capacity() const { return m_buf.size(); }
+
+        // Producer
+        size_t Writable() const;
+        size_t Write(const float* src, size_t n);
+        size_t WriteIndex() const { return m_w.load(std::memory_order_relaxed); }
+
+        // Consumer
+        size_t Readable() const;
+        size_t Read(float* dst, size_t n);
+        size_t ReadIndex() const { return m_r.load(std::memory_order_relaxed); }
+        void   SkipTo(size_t index) { m_r.store(index, std::memory_order_release); }
+
+    private:
+        std::vector<float>              m_buf;
+        size_t                          m_mask = 0;
+        alignas(64) std::atomic<size_t> m_w{ 0 };
+        alignas(64) std::atomic<size_t> m_r{ 0 };
+    };
+
+    // What a sink pulls from; implemented by Engine
+    class Source {
+    public:
+        virtual ~Source() = default;
+        // Always fills `frames` interleaved frames (silence on underrun)
+        virtual void   Render(float* out, size_t frames) = 0;
+        virtual size_t ReadyFrames() const = 0;    // decoded and queued
+        virtual bool   Drained() const = 0;        // end of stream, ring empty
+    };
+
+    // ── Output backend ───────────────────────────────────────────────────────
+    class Sink {
+    public:
+        virtual ~Sink() = default;
+        virtual const char* Name() const = 0;
+        virtual bool Open(const Format& fmt, Source* src, std::string* error) = 0;
+        virtual void Start() = 0;           // begin pulling
+        virtual void Stop()  = 0;           // stop pulling (pause)
+        virtual void Close() = 0;
+        // Offline sinks pull as fast as the decoder allows; the engine then
+        // waits for Drained() instead of treating an empty ring as underrun
+        virtual bool Offline() const { return false; }
+    };
+
+    // "default" (WASAPI on Windows, paced null elsewhere), "null" (paced like
+    // a device), "null-fast" (unthrottled), "wav:PATH" (offline float WAV)
+    std::unique_ptr<Sink> MakeSink(const std::string& spec, std::string* error = nullptr);
+    std::unique_ptr<Sink> MakeWasapiSink();     // nullptr off Windows
+
+    class Engine final : public Source {
+    public:
+        struct Stats {
+            uint64_t callbacks      = 0;
+            uint64_t framesRendered = 0;
+            uint64_t underrunFrames = 0;
+            uint64_t callbackNsMax  = 0;
+            double   callbackNsAvg  = 0.0;
+            size_t   ringSamples    = 0;
+        };
+
+        explicit Engine(std::unique_ptr<Sink> sink);
+        ~Engine() override;
+        Engine(const Engine&)            = delete;
+        Engine& operator=(const Engine&) = delete;
+
+        // Stops the current track; the device stream is kept if the format matches
+        bool Open(const fs::path& p, std::string* error = nullptr);
+        bool Open(std::unique_ptr<Decoder> dec, std::string* error = nullptr);
+        void Close();
+        bool IsOpen() const { return m_open; }
+
+        // Gapless: the decoder thread switches to `dec` when the current track
+        // ends.  Same format only — on false `dec` stays with the caller.
+        bool     QueueNext(std::unique_ptr<Decoder>& dec);
+        std::unique_ptr<Decoder> TakeNext() { return std::unique_ptr<Decoder>(m_next.exchange(nullptr, std::memory_order_acq_rel)); }
+        uint32_t Track() const { return m_track.load(std::memory_order_acquire); }   // audible switches since Open
+
+        void Play();
+        void Pause();
+        bool Playing() const { return m_playing.load(std::memory_order_relaxed); }
+
+        void  SetVolume(float v)  { m_volume.store(v, std::memory_order_relaxed); }   // 0..1
+        float Volume() const      { return m_volume.load(std::memory_order_relaxed); }
+        void  SetLoop(bool on)    { m_loop.store(on, std::memory_order_relaxed); }
+        void  Seek(double seconds);
+
+        double Position() const;            // seconds
+        double Duration() const;            // of the audible track
+        float  Progress() const;            // 0..1
+        bool   Finished() const { return m_open && Drained(); }
+        const Format& Fmt() const { return m_fmt; }
+        const char*   SinkName() const { return m_sink->Name(); }
+        bool          Offline() const { return m_sink->Offline(); }
+
+        // Rendered audio (pre-volume) is pushed here from the output thread
+        void  SetTap(Dsp::SpectrumAnalyzer* tap) { m_tap = tap; }   // while closed
+        Stats GetStats() const;
+
+        // Source
+        void   Render(float* out, size_t frames) override;
+        size_t ReadyFrames() const override;
+        bool   Drained() const override;
+
+    private:
+        // Seek: skip to ringIndex.  Wrap: on reaching ringIndex the position
+        // becomes `frame` of a track `total` frames long, serial `track`.
+        struct Mark { size_t ringIndex; uint64_t frame; uint64_t total; uint32_t track; };
+
+        void DecodeLoop();
+        void StopDecoder();
+        void ApplyWrap(const Mark& w);
+
+        std::unique_ptr<Sink>    m_sink;
+        std::unique_ptr<Decoder> m_dec;             // decoder thread while open
+        std::atomic<Decoder*>    m_next{ nullptr }; // owned; queued gapless successor
+        Format                   m_fmt;
+        bool                     m_open = false, m_sinkOpen = false;
+        Dsp::SpectrumAnalyzer*   m_tap = nullptr;
+        PcmRing                  m_ring;
+        std::thread              m_thread;
+
+        std::atomic<bool>     m_run{ false }, m_playing{ false }, m_loop{ false }, m_eof{ false };
+        std::atomic<float>    m_volume{ 1.0f };
+        std::atomic<int64_t>  m_seekReq{ -1 };      // UI → decoder (frame)
+        std::atomic<int64_t>  m_seekShown{ -1 };    // reported until the callback catches up
+        std::atomic<uint64_t> m_played{ 0 };        // frames handed to the sink
+        std::atomic<uint64_t> m_total{ 0 };         // audible track length, frames
+        std::atomic<uint32_t> m_track{ 0 };
+        Progress::SpscRing<Mark, 16> m_seeks;       // decoder → callback
+        Progress::SpscRing<Mark, 16> m_wraps;       // loop restarts / track switches
+
+        float                 m_gain = 1.0f;        // callback only: ramped towards m_volume
+        std::atomic<uint64_t> m_callbacks{ 0 }, m_rendered{ 0 }, m_underruns{ 0 };
+        std::atomic<uint64_t> m_cbNsTotal{ 0 }, m_cbNsMax{ 0 };
+    };
+
+}  // namespace Audio
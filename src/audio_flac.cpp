@@ -0,0 +1,399 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  FLAC  —  native decoder (STREAMINFO + frames, no seek table needed)
+// ──────────────────────────────────────────────────────────────────────────────
+//  Constant / verbatim / fixed / LPC subframes, Rice and Rice2 residuals with
+//  escape partitions, wasted bits and all three stereo decorrelation modes.
+//  Frames are located by their sync code + header CRC-8, which is also how
+//  Seek() bisects the file.
+#include "audio_decoder.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Audio {
+
+    namespace {
+
+        bool Fail(std::string* error, const char* why) {
+            if (error) *error = why;
+            return false;
+        }
+
+        uint8_t Crc8(const uint8_t* p, size_t n) {
+            uint8_t crc = 0;
+            while (n--) {
+                crc ^= *p++;
+                for (int i = 0; i < 8; i++) crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+            }
+            return crc;
+        }
+
+        unsigned Clz64(uint64_t w) {        // w != 0
+#ifdef _MSC_VER
+            unsigned long i;
+            _BitScanReverse64(&i, w);
+            return 63u - (unsigned)i;
+#else
+            return (unsigned)__builtin_clzll(w);
+#endif
+        }
+
+        // MSB-first bit reader; reads past the end return zeros and set Overrun()
+        class BitReader {
+        public:
+            BitReader(const uint8_t* data, size_t bytes, size_t bytePos)
+                : m_d(data), m_bytes(bytes), m_pos((uint64_t)bytePos * 8) {}
+
+            uint32_t Read(unsigned n) {                     // n <= 32
+                if (!n) return 0;
+                const uint64_t w = Peek();
+                m_pos += n;
+                return (uint32_t)(w >> (64 - n));
+            }
+            int32_t Signed(unsigned n) {
+                if (!n) return 0;
+                const uint32_t v = Read(n);
+                return n >= 32 ? (int32_t)v : (int32_t)(v << (32 - n)) >> (32 - n);
+            }
+            uint32_t Unary() {                              // zeros before the next 1
+                uint32_t zeros = 0;
+                for (;;) {
+                    const uint64_t w     = Peek();
+                    const unsigned valid = 64 - (unsigned)(m_pos & 7);
+                    const unsigned lz    = w ? Clz64(w) : 64;
+                    if (lz < valid) { m_pos += lz + 1; return zeros + lz; }
+                    zeros += valid;
+                    m_pos += valid;
+                    if (Overrun()) return zeros;
+                }
+            }
+            void   AlignByte()    { m_pos = (m_pos + 7) & ~(uint64_t)7; }
+            size_t BytePos() const { return (size_t)(m_pos >> 3); }
+            bool   Overrun() const { return m_pos > (uint64_t)m_bytes * 8; }
+
+        private:
+            // 64 bits from the current position, left-aligned (>= 57 real bits)
+            uint64_t Peek() const {
+                const size_t b = (size_t)(m_pos >> 3);
+                uint64_t w = 0;
+                if (b + 8 <= m_bytes) {
+                    for (int i = 0; i < 8; i++) w = w << 8 | m_d[b + i];
+                } else {
+                    for (int i = 0; i < 8; i++) w = w << 8 | (b + i < m_bytes ? m_d[b + i] : 0);
+                }
+                return w << (m_pos & 7);
+            }
+
+            const uint8_t* m_d;
+            size_t         m_bytes;
+            uint64_t       m_pos;
+        };
+
+        struct FrameHeader {
+            uint32_t blockSize  = 0;
+            uint32_t sampleRate = 0;
+            unsigned channels   = 0;
+            unsigned assignment = 0;        // 0..7 independent, 8 L/S, 9 S/R, 10 M/S
+            unsigned bps        = 0;
+            uint64_t firstSample = 0;
+            size_t   bodyOffset = 0;        // first subframe byte
+        };
+
+    }  // namespace
+
+    class FlacDecoder final : public Decoder {
+    public:
+        bool Open(const fs::path& p, std::string* error) {
+            if (!m_map.Open(p)) return Fail(error, "cannot open file");
+            const uint8_t* d = m_map.Data();
+            const size_t   n = m_map.Size();
+            if (n < 42 || std::memcmp(d, "fLaC", 4)) return Fail(error, "not a FLAC file");
+
+            // Metadata blocks: we only need STREAMINFO (always first)
+            size_t off = 4;
+            bool   last = false, haveInfo = false;
+            while (!last) {
+                if (off + 4 > n) return Fail(error, "truncated metadata");
+                last = (d[off] & 0x80) != 0;
+                const unsigned type = d[off] & 0x7F;
+                const size_t   len  = (size_t)d[off + 1] << 16 | (size_t)d[off + 2] << 8 | d[off + 3];
+                off += 4;
+                if (off + len > n) return Fail(error, "truncated metadata");
+                if (type == 0 && len >= 34) {
+                    BitReader br(d, n, off);
+                    m_minBlock       = br.Read(16);
+                    m_maxBlock       = br.Read(16);
+                    br.Read(24); br.Read(24);           // min / max frame size
+                    m_fmt.sampleRate = br.Read(20);
+                    m_fmt.channels   = (uint16_t)(br.Read(3) + 1);
+                    m_bps            = br.Read(5) + 1;
+                    m_total          = (uint64_t)br.Read(4) << 32 | br.Read(32);
+                    haveInfo = true;
+                }
+                off += len;
+            }
+            if (!haveInfo) return Fail(error, "missing STREAMINFO");
+            if (!m_fmt.sampleRate || m_bps < 4 || m_maxBlock < 16 || m_minBlock > m_maxBlock) return Fail(error, "bad STREAMINFO");
+
+            m_first = m_off = off;
+            m_chan.assign(m_fmt.channels, std::vector<int32_t>(m_maxBlock));
+            m_pcm.resize((size_t)m_maxBlock * m_fmt.channels);
+            return true;
+        }
+
+        const char* Codec() const override { return "flac"; }
+
+        size_t Read(float* out, size_t frames) override {
+            const unsigned ch = m_fmt.channels;
+            size_t done = 0;
+            while (done < frames) {
+                if (m_bufPos == m_bufLen && !DecodeNext()) break;
+                const size_t take = std::min(frames - done, m_bufLen - m_bufPos);
+                std::memcpy(out + done * ch, m_pcm.data() + m_bufPos * ch, take * ch * sizeof(float));
+                m_bufPos += take;
+                done     += take;
+            }
+            return done;
+        }
+
+        bool Seek(uint64_t target) override {
+            if (m_total && target >= m_total) {
+                m_off = m_map.Size();
+                m_bufPos = m_bufLen = 0;
+                return true;
+            }
+            // Bisect on byte offset for the last frame starting at or before target
+            size_t best = m_first, lo = m_first, hi = m_map.Size();
+            while (lo < hi) {
+                const size_t mid = lo + (hi - lo) / 2;
+                FrameHeader  h;
+                const size_t at = FindFrame(mid, h);
+                if (at == SIZE_MAX || h.firstSample > target) hi = mid;
+                else { best = at; lo = at + 1; }
+            }
+            m_off = best;
+            m_bufPos = m_bufLen = 0;
+            while (DecodeNext()) {
+                if (m_frameFirst + m_bufLen > target) {
+                    m_bufPos = (size_t)(target - std::min(target, m_frameFirst));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        bool ParseHeader(size_t off, FrameHeader& h) const {
+            const uint8_t* d = m_map.Data();
+            const size_t   n = m_map.Size();
+            if (off + 6 > n || d[off] != 0xFF || (d[off + 1] & 0xFE) != 0xF8) return false;
+            const bool     variable = d[off + 1] & 1;
+            const unsigned bsCode   = d[off + 2] >> 4, srCode = d[off + 2] & 15;
+            const unsigned chCode   = d[off + 3] >> 4, ssCode = (d[off + 3] >> 1) & 7;
+            if (srCode == 15 || chCode > 10 || ssCode == 3 || (d[off + 3] & 1) || bsCode == 0) return false;
+
+            // UTF-8 style frame / sample number
+            size_t   p = off + 4;
+            uint64_t num = d[p++];
+            unsigned extra = 0;
+            if      (!(num & 0x80))         extra = 0;
+            else if ((num & 0xE0) == 0xC0) { extra = 1; num &= 0x1F; }
+            else if ((num & 0xF0) == 0xE0) { extra = 2; num &= 0x0F; }
+            else if ((num & 0xF8) == 0xF0) { extra = 3; num &= 0x07; }
+            else if ((num & 0xFC) == 0xF8) { extra = 4; num &= 0x03; }
+            else if ((num & 0xFE) == 0xFC) { extra = 5; num &= 0x01; }
+            else if (num == 0xFE)          { extra = 6; num = 0; }
+            else return false;
+            if (p + extra + 4 > n) return false;
+            for (unsigned i = 0; i < extra; i++) {
+                if ((d[p] & 0xC0) != 0x80) return false;
+                num = num << 6 | (d[p++] & 0x3F);
+            }
+
+            if      (bsCode == 1) h.blockSize = 192;
+            else if (bsCode <= 5) h.blockSize = 576u << (bsCode - 2);
+            else if (bsCode == 6) h.blockSize = d[p++] + 1u;
+            else if (bsCode == 7) { h.blockSize = (d[p] << 8 | d[p + 1]) + 1u; p += 2; }
+            else                  h.blockSize = 256u << (bsCode - 8);
+
+            static const uint32_t kRates[12] = { 0, 88200, 176400, 192000, 8000, 16000,
+                                                 22050, 24000, 32000, 44100, 48000, 96000 };
+            if      (srCode < 12)  h.sampleRate = srCode ? kRates[srCode] : m_fmt.sampleRate;
+            else if (srCode == 12) h.sampleRate = d[p++] * 1000u;
+            else if (srCode == 13) { h.sampleRate = d[p] << 8 | d[p + 1]; p += 2; }
+            else                   { h.sampleRate = (d[p] << 8 | d[p + 1]) * 10u; p += 2; }
+
+            if (p >= n || Crc8(d + off, p - off) != d[p]) return false;
+
+            static const unsigned kBits[8] = { 0, 8, 12, 0, 16, 20, 24, 32 };
+            h.bps         = ssCode ? kBits[ssCode] : m_bps;
+            h.assignment  = chCode;
+            h.channels    = chCode < 8 ? chCode + 1 : 2;
+            h.firstSample = variable ? num : num * m_maxBlock;
+            h.bodyOffset  = p + 1;
+            return h.blockSize <= m_maxBlock && h.channels == m_fmt.channels;
+        }
+
+        size_t FindFrame(size_t from, FrameHeader& h) const {
+            const uint8_t* d = m_map.Data();
+            const size_t   n = m_map.Size();
+            for (size_t i = std::max(from, m_first); i + 1 < n; i++)
+                if (d[i] == 0xFF && (d[i + 1] & 0xFE) == 0xF8 && ParseHeader(i, h)) return i;
+            return SIZE_MAX;
+        }
+
+        bool DecodeResidual(BitReader& br, int32_t* out, uint32_t blockSize, unsigned order) const {
+            const unsigned method = br.Read(2);
+            if (method > 1) return false;
+            const unsigned paramBits = method ? 5 : 4, escape = method ? 31 : 15;
+            const unsigned partOrder = br.Read(4);
+            const uint32_t per = blockSize >> partOrder;
+            if ((per << partOrder) != blockSize || per < order) return false;
+
+            int32_t* o = out + order;
+            for (uint32_t part = 0; part < (1u << partOrder); part++) {
+                const uint32_t count = part ? per : per - order;
+                const unsigned k     = br.Read(paramBits);
+                if (k == escape) {
+                    const unsigned bits = br.Read(5);
+                    for (uint32_t i = 0; i < count; i++) *o++ = br.Signed(bits);
+                } else {
+                    for (uint32_t i = 0; i < count; i++) {
+                        const uint32_t q = br.Unary();
+                        const uint32_t u = q << k | br.Read(k);
+                        *o++ = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+                    }
+                }
+                if (br.Overrun()) return false;
+            }
+            return true;
+        }
+
+        bool DecodeSubframe(BitReader& br, int32_t* s, uint32_t blockSize, unsigned bps) const {
+            if (br.Read(1)) return false;
+            const unsigned type = br.Read(6);
+            unsigned wasted = 0;
+            if (br.Read(1)) wasted = br.Unary() + 1;
+            if (wasted >= bps) return false;
+            bps -= wasted;
+
+            if (type == 0) {
+                const int32_t v = br.Signed(bps);
+                std::fill(s, s + blockSize, v);
+            } else if (type == 1) {
+                for (uint32_t i = 0; i < blockSize; i++) s[i] = br.Signed(bps);
+            } else if (type >= 8 && type <= 12) {
+                const unsigned order = type - 8;
+                if (order > blockSize) return false;
+                for (unsigned i = 0; i < order; i++) s[i] = br.Signed(bps);
+                if (!DecodeResidual(br, s, blockSize, order)) return false;
+                switch (order) {
+                    case 1: for (uint32_t i = 1; i < blockSize; i++) s[i] += s[i - 1]; break;
+                    case 2: for (uint32_t i = 2; i < blockSize; i++) s[i] += 2 * s[i - 1] - s[i - 2]; break;
+                    case 3: for (uint32_t i = 3; i < blockSize; i++) s[i] += 3 * s[i - 1] - 3 * s[i - 2] + s[i - 3]; break;
+                    case 4: for (uint32_t i = 4; i < blockSize; i++) s[i] += 4 * s[i - 1] - 6 * s[i - 2] + 4 * s[i - 3] - s[i - 4]; break;
+                }
+            } else if (type >= 32) {
+                const unsigned order = (type & 31) + 1;
+                if (order > blockSize) return false;
+                for (unsigned i = 0; i < order; i++) s[i] = br.Signed(bps);
+                const unsigned prec = br.Read(4) + 1;
+                if (prec == 16) return false;
+                const int shift = br.Signed(5);
+                if (shift < 0) return false;
+                int32_t coef[32];
+                for (unsigned i = 0; i < order; i++) coef[i] = br.Signed(prec);
+                if (!DecodeResidual(br, s, blockSize, order)) return false;
+                for (uint32_t i = order; i < blockSize; i++) {
+                    int64_t sum = 0;
+                    for (unsigned j = 0; j < order; j++) sum += (int64_t)coef[j] * s[i - 1 - j];
+                    s[i] += (int32_t)(sum >> shift);
+                }
+            } else {
+                return false;                               // reserved subframe type
+            }
+            if (wasted)
+                for (uint32_t i = 0; i < blockSize; i++) s[i] = (int32_t)((uint32_t)s[i] << wasted);
+            return !br.Overrun();
+        }
+
+        bool DecodeFrameAt(size_t off) {
+            FrameHeader h;
+            if (!ParseHeader(off, h)) return false;
+            BitReader br(m_map.Data(), m_map.Size(), h.bodyOffset);
+            for (unsigned c = 0; c < h.channels; c++) {
+                const bool side = (h.assignment == 8 && c == 1) || (h.assignment == 9 && c == 0) ||
+                                  (h.assignment == 10 && c == 1);
+                if (!DecodeSubframe(br, m_chan[c].data(), h.blockSize, h.bps + (side ? 1 : 0))) return false;
+            }
+            br.AlignByte();
+            br.Read(16);                                    // CRC-16 (header CRC-8 already checked)
+            if (br.Overrun()) return false;
+
+            const uint32_t bs = h.blockSize;
+            if (h.assignment >= 8) {
+                int32_t* a = m_chan[0].data();
+                int32_t* b = m_chan[1].data();
+                for (uint32_t i = 0; i < bs; i++) {
+                    if (h.assignment == 8) {             // left, side
+                        b[i] = a[i] - b[i];
+                    } else if (h.assignment == 9) {      // side, right
+                        a[i] = a[i] + b[i];
+                    } else {                             // mid, side
+                        const int64_t mid = (int64_t)a[i] * 2 | (b[i] & 1);
+                        a[i] = (int32_t)((mid + b[i]) >> 1);
+                        b[i] = (int32_t)((mid - b[i]) >> 1);
+                    }
+                }
+            }
+
+            const float    scale = 1.0f / (float)(1u << (h.bps - 1));
+            const unsigned ch    = h.channels;
+            for (unsigned c = 0; c < ch; c++) {
+                const int32_t* s = m_chan[c].data();
+                float*         o = m_pcm.data() + c;
+                for (uint32_t i = 0; i < bs; i++) o[(size_t)i * ch] = (float)s[i] * scale;
+            }
+            m_frameFirst = h.firstSample;
+            m_bufPos     = 0;
+            m_bufLen     = bs;
+            m_off        = br.BytePos();
+            return true;
+        }
+
+        // Decode the frame at m_off; on corruption resync to the next valid header
+        bool DecodeNext() {
+            while (m_off < m_map.Size()) {
+                if (DecodeFrameAt(m_off)) return true;
+                FrameHeader h;
+                const size_t next = FindFrame(m_off + 1, h);
+                if (next == SIZE_MAX) break;
+                m_off = next;
+            }
+            m_off = m_map.Size();
+            return false;
+        }
+
+        IO::MappedFile m_map;
+        uint32_t       m_minBlock = 0, m_maxBlock = 0;
+        unsigned       m_bps      = 16;
+        size_t         m_first    = 0, m_off = 0;
+        std::vector<std::vector<int32_t>> m_chan;
+        std::vector<float> m_pcm;                           // current frame, interleaved
+        size_t         m_bufPos = 0, m_bufLen = 0;
+        uint64_t       m_frameFirst = 0;
+    };
+
+    std::unique_ptr<Decoder> OpenFlac(const fs::path& p, std::string* error) {
+        auto d = std::make_unique<FlacDecoder>();
+        if (!d->Open(p, error)) return nullptr;
+        return d;
+    }
+
+}  // namespace Audio
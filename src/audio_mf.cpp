@@ -0,0 +1,144 @@
+// Media Foundation decoder: MP3 / AAC / WMA → float PCM (Windows only)
+#ifdef _WIN32
+
+#include "audio_decoder.h"
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <propvarutil.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Audio {
+
+    template <class T> static void SafeRelease(T*& p) { if (p) { p->Release(); p = nullptr; } }
+
+    class MfDecoder final : public Decoder {
+    public:
+        ~MfDecoder() override {
+            SafeRelease(m_reader);
+            if (m_started) MFShutdown();
+            if (m_com) CoUninitialize();
+        }
+
+        bool Open(const fs::path& p, std::string* error) {
+            auto fail = [error](const char* why) { if (error) *error = why; return false; };
+            m_com = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+            if (FAILED(MFStartup(MF_VERSION, MFSTARTUP_LITE))) return fail("Media Foundation unavailable");
+            m_started = true;
+            if (FAILED(MFCreateSourceReaderFromURL(p.wstring().c_str(), nullptr, &m_reader)))
+                return fail("unsupported or unreadable audio file");
+
+            const DWORD stream = (DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM;
+            m_reader->SetStreamSelection((DWORD)MF_SOURCE_READER_ALL_STREAMS, FALSE);
+            m_reader->SetStreamSelection(stream, TRUE);
+
+            IMFMediaType* want = nullptr;
+            MFCreateMediaType(&want);
+            want->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+            want->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_Float);
+            const HRESULT hr = m_reader->SetCurrentMediaType(stream, nullptr, want);
+            SafeRelease(want);
+            if (FAILED(hr)) return fail("no float PCM conversion for this stream");
+
+            IMFMediaType* got = nullptr;
+            if (FAILED(m_reader->GetCurrentMediaType(stream, &got))) return fail("no audio stream");
+            UINT32 rate = 0, ch = 0;
+            got->GetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, &rate);
+            got->GetUINT32(MF_MT_AUDIO_NUM_CHANNELS, &ch);
+            SafeRelease(got);
+            if (!rate || !ch) return fail("bad audio format");
+            m_fmt.sampleRate = rate;
+            m_fmt.channels   = (uint16_t)ch;
+
+            PROPVARIANT dur;
+            PropVariantInit(&dur);
+            if (SUCCEEDED(m_reader->GetPresentationAttribute((DWORD)MF_SOURCE_READER_MEDIASOURCE,
+                                                             MF_PD_DURATION, &dur)) && dur.vt == VT_UI8)
+                m_total = dur.uhVal.QuadPart * rate / 10000000ull;     // 100 ns units
+            PropVariantClear(&dur);
+            return true;
+        }
+
+        const char* Codec() const override { return "mediafoundation"; }
+
+        size_t Read(float* out, size_t frames) override {
+            const unsigned ch = m_fmt.channels;
+            size_t done = 0;
+            while (done < frames) {
+                if (m_bufPos == m_buf.size() / ch && !Fill()) break;
+                const size_t take = std::min(frames - done, m_buf.size() / ch - m_bufPos);
+                std::memcpy(out + done * ch, m_buf.data() + m_bufPos * ch, take * ch * sizeof(float));
+                m_bufPos += take;
+                done     += take;
+            }
+            return done;
+        }
+
+        bool Seek(uint64_t frame) override {
+            PROPVARIANT pos;
+            InitPropVariantFromInt64((LONGLONG)(frame * 10000000ull / m_fmt.sampleRate), &pos);
+            const HRESULT hr = m_reader->SetCurrentPosition(GUID_NULL, pos);
+            PropVariantClear(&pos);
+            m_buf.clear();
+            m_bufPos = 0;
+            m_eof    = false;
+            return SUCCEEDED(hr);
+        }
+
+    private:
+        bool Fill() {
+            m_buf.clear();
+            m_bufPos = 0;
+            while (!m_eof && m_buf.empty()) {
+                DWORD flags = 0;
+                IMFSample* sample = nullptr;
+                if (FAILED(m_reader->ReadSample((DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM, 0,
+                                                nullptr, &flags, nullptr, &sample))) {
+                    m_eof = true;
+                    break;
+                }
+                if (flags & MF_SOURCE_READERF_ENDOFSTREAM) m_eof = true;
+                if (!sample) continue;
+                IMFMediaBuffer* buf = nullptr;
+                if (SUCCEEDED(sample->ConvertToContiguousBuffer(&buf))) {
+                    BYTE* data = nullptr;
+                    DWORD len  = 0;
+                    if (SUCCEEDED(buf->Lock(&data, nullptr, &len))) {
+                        m_buf.assign((const float*)data, (const float*)(data + len));
+                        buf->Unlock();
+                    }
+                    SafeRelease(buf);
+                }
+                SafeRelease(sample);
+            }
+            return !m_buf.empty();
+        }
+
+        IMFSourceReader*   m_reader  = nullptr;
+        bool               m_com     = false;
+        bool               m_started = false;
+        bool               m_eof     = false;
+        std::vector<float> m_buf;                   // one decoded sample, interleaved
+        size_t             m_bufPos  = 0;           // in frames
+    };
+
+    std::unique_ptr<Decoder> OpenMediaFoundation(const fs::path& p, std::string* error) {
+        auto d = std::make_unique<MfDecoder>();
+        if (!d->Open(p, error)) return nullptr;
+        return d;
+    }
+
+}  // namespace Audio
+
+#endif  // _WIN32
@@ -0,0 +1,168 @@
+// Tag / length readers for the playlist — header bytes only, no decoding
+#include "playlist.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace Audio {
+
+    static uint32_t Le32(const uint8_t* p) {
+        return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    }
+    static uint32_t Be32(const uint8_t* p) {
+        return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    }
+
+    static void AppendUtf8(std::string& s, uint32_t cp) {
+        if (cp < 0x80)         s += (char)cp;
+        else if (cp < 0x800) { s += (char)(0xC0 | cp >> 6);  s += (char)(0x80 | (cp & 0x3F)); }
+        else if (cp < 0x10000) {
+            s += (char)(0xE0 | cp >> 12); s += (char)(0x80 | (cp >> 6 & 0x3F)); s += (char)(0x80 | (cp & 0x3F));
+        } else {
+            s += (char)(0xF0 | cp >> 18); s += (char)(0x80 | (cp >> 12 & 0x3F));
+            s += (char)(0x80 | (cp >> 6 & 0x3F)); s += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    static std::string Trim(std::string s) {
+        while (!s.empty() && (unsigned char)s.back() <= ' ') s.pop_back();
+        return s;
+    }
+
+    // ID3v2 text frame body: encoding byte + text
+    static std::string Id3Text(const uint8_t* p, size_t n) {
+        if (!n) return {};
+        const uint8_t enc = p[0];
+        p++; n--;
+        std::string out;
+        if (enc == 0) {                                 // ISO-8859-1
+            for (size_t i = 0; i < n && p[i]; i++) AppendUtf8(out, p[i]);
+        } else if (enc == 3) {                          // UTF-8
+            out.assign((const char*)p, strnlen((const char*)p, n));
+        } else {                                        // UTF-16 (1: BOM, 2: BE)
+            bool be = enc == 2;
+            size_t i = 0;
+            if (enc == 1 && n >= 2) { be = p[0] == 0xFE; i = 2; }
+            for (; i + 1 < n; i += 2) {
+                uint32_t u = be ? (uint32_t)(p[i] << 8 | p[i + 1]) : (uint32_t)(p[i] | p[i + 1] << 8);
+                if (!u) break;
+                if (u >= 0xD800 && u < 0xDC00 && i + 3 < n) {
+                    const uint32_t lo = be ? (uint32_t)(p[i + 2] << 8 | p[i + 3]) : (uint32_t)(p[i + 2] | p[i + 3] << 8);
+                    u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+                    i += 2;
+                }
+                AppendUtf8(out, u);
+            }
+        }
+        return Trim(out);
+    }
+
+    static void ReadId3(const uint8_t* d, size_t n, TrackInfo& t) {
+        if (n < 10 || std::memcmp(d, "ID3", 3)) return;
+        const unsigned ver = d[3];
+        const size_t   size = (size_t)(d[6] & 0x7F) << 21 | (d[7] & 0x7F) << 14 | (d[8] & 0x7F) << 7 | (d[9] & 0x7F);
+        const size_t   end  = std::min(n, 10 + size);
+        size_t off = 10;
+        if (d[5] & 0x40 && off + 4 <= end)              // extended header
+            off += ver >= 4 ? ((size_t)(d[off] & 0x7F) << 21 | (d[off + 1] & 0x7F) << 14 | (d[off + 2] & 0x7F) << 7 | (d[off + 3] & 0x7F))
+                            : Be32(d + off) + 4;
+        const size_t hdr = ver == 2 ? 6 : 10;
+        while (off + hdr <= end && d[off]) {
+            size_t len;
+            if (ver == 2)      len = (size_t)d[off + 3] << 16 | d[off + 4] << 8 | d[off + 5];
+            else if (ver >= 4) len = (size_t)(d[off + 4] & 0x7F) << 21 | (d[off + 5] & 0x7F) << 14 | (d[off + 6] & 0x7F) << 7 | (d[off + 7] & 0x7F);
+            else               len = Be32(d + off + 4);
+            const uint8_t* body = d + off + hdr;
+            if (off + hdr + len > end) break;
+            const bool title  = ver == 2 ? !std::memcmp(d + off, "TT2", 3) : !std::memcmp(d + off, "TIT2", 4);
+            const bool artist = ver == 2 ? !std::memcmp(d + off, "TP1", 3) : !std::memcmp(d + off, "TPE1", 4);
+            if (title)  t.title  = Id3Text(body, len);
+            if (artist) t.artist = Id3Text(body, len);
+            off += hdr + len;
+        }
+    }
+
+    static void ReadFlacInfo(const uint8_t* d, size_t n, TrackInfo& t) {
+        size_t off = 4;
+        for (bool last = false; !last && off + 4 <= n; ) {
+            last = (d[off] & 0x80) != 0;
+            const unsigned type = d[off] & 0x7F;
+            const size_t   len  = (size_t)d[off + 1] << 16 | (size_t)d[off + 2] << 8 | d[off + 3];
+            const uint8_t* b    = d + off + 4;
+            off += 4 + len;
+            if (off > n) break;
+            if (type == 0 && len >= 18) {
+                t.sampleRate = (uint32_t)b[10] << 12 | (uint32_t)b[11] << 4 | b[12] >> 4;
+                const uint64_t total = (uint64_t)(b[13] & 0x0F) << 32 | Be32(b + 14);
+                if (t.sampleRate) t.seconds = (double)total / t.sampleRate;
+            } else if (type == 4 && len >= 8) {         // VORBIS_COMMENT, little-endian lengths
+                size_t p = 4 + Le32(b);
+                if (p + 4 > len) continue;
+                const uint32_t count = Le32(b + p);
+                p += 4;
+                for (uint32_t i = 0; i < count && p + 4 <= len; i++) {
+                    const uint32_t cl = Le32(b + p);
+                    p += 4;
+                    if (p + cl > len) break;
+                    const std::string kv((const char*)b + p, cl);
+                    p += cl;
+                    const size_t eq = kv.find('=');
+                    if (eq == std::string::npos) continue;
+                    std::string key = kv.substr(0, eq);
+                    for (char& c : key) c = (char)std::toupper((unsigned char)c);
+                    if (key == "TITLE"  && t.title.empty())  t.title  = Trim(kv.substr(eq + 1));
+                    if (key == "ARTIST" && t.artist.empty()) t.artist = Trim(kv.substr(eq + 1));
+                }
+            }
+        }
+    }
+
+    static void ReadWavInfo(const uint8_t* d, size_t n, TrackInfo& t) {
+        uint32_t byteRate = 0;
+        for (size_t off = 12; off + 8 <= n; ) {
+            const uint32_t len  = Le32(d + off + 4);
+            const uint8_t* body = d + off + 8;
+            const size_t   avail = std::min<size_t>(len, n - off - 8);
+            if (!std::memcmp(d + off, "fmt ", 4) && avail >= 16) {
+                t.sampleRate = Le32(body + 4);
+                byteRate     = Le32(body + 8);
+            } else if (!std::memcmp(d + off, "data", 4)) {
+                if (byteRate) t.seconds = (double)avail / byteRate;
+            } else if (!std::memcmp(d + off, "LIST", 4) && avail >= 4 && !std::memcmp(body, "INFO", 4)) {
+                for (size_t p = 4; p + 8 <= avail; ) {
+                    const uint32_t sl = Le32(body + p + 4);
+                    if (p + 8 + sl > avail) break;
+                    std::string v((const char*)body + p + 8, strnlen((const char*)body + p + 8, sl));
+                    if (!std::memcmp(body + p, "INAM", 4)) t.title  = Trim(v);
+                    if (!std::memcmp(body + p, "IART", 4)) t.artist = Trim(v);
+                    p += 8 + sl + (sl & 1);
+                }
+            }
+            off += 8 + (size_t)len + (len & 1);
+        }
+    }
+
+    bool IsAudioFile(const fs::path& p) {
+        std::string ext = p.extension().string();
+        for (char& c : ext) c = (char)std::tolower((unsigned char)c);
+        return ext == ".wav" || ext == ".flac" || ext == ".mp3" || ext == ".m4a" ||
+               ext == ".aac" || ext == ".wma";
+    }
+
+    TrackInfo ReadTrackInfo(const fs::path& p) {
+        TrackInfo t;
+        IO::MappedFile f;
+        if (f.Open(p) && f.Size() >= 12) {
+            const uint8_t* d = f.Data();
+            const size_t   n = f.Size();
+            if (!std::memcmp(d, "RIFF", 4) && !std::memcmp(d + 8, "WAVE", 4)) { t.codec = "wav";  ReadWavInfo(d, n, t); }
+            else if (!std::memcmp(d, "fLaC", 4))                             { t.codec = "flac"; ReadFlacInfo(d, n, t); }
+            else if (!std::memcmp(d, "ID3", 3))                              { t.codec = "mp3";  ReadId3(d, n, t); }
+        }
+        if (t.title.empty()) t.title = p.stem().u8string();
+        return t;
+    }
+
+}  // namespace Audio
@@ -0,0 +1,177 @@
+// WASAPI shared-mode, event-driven output sink (Windows only)
+#ifdef _WIN32
+
+#include "audio_engine.h"
+#include "profiler.h"
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+#include <avrt.h>
+#include <ksmedia.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace Audio {
+
+    template <class T> static void SafeRelease(T*& p) { if (p) { p->Release(); p = nullptr; } }
+
+    // Every COM call happens on the sink's own MTA thread; Start/Stop only flip
+    // an atomic, so the UI thread never touches the audio client directly.
+    class WasapiSink final : public Sink {
+    public:
+        ~WasapiSink() override { Close(); }
+
+        const char* Name() const override { return "wasapi"; }
+
+        bool Open(const Format& fmt, Source* src, std::string* error) override {
+            Close();
+            m_fmt   = fmt;
+            m_src   = src;
+            m_run   = true;
+            m_want  = false;
+            m_state = 0;
+            m_thread = std::thread([this] { Thread(); });
+            std::unique_lock<std::mutex> lk(m_mx);
+            m_cv.wait(lk, [this] { return m_state != 0; });
+            if (m_state < 0) {
+                if (error) *error = m_error;
+                lk.unlock();
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        void Start() override { m_want = true; }
+
+        // Synchronous: once this returns the thread won't call Render() again
+        void Stop() override {
+            m_want = false;
+            while (m_run.load(std::memory_order_relaxed) && m_running.load(std::memory_order_acquire))
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        void Close() override {
+            m_run = false;
+            if (m_thread.joinable()) m_thread.join();
+            m_src = nullptr;
+        }
+
+    private:
+        void Signal(int state, const char* err = "") {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_state = state;
+            m_error = err;
+            m_cv.notify_all();
+        }
+
+        void Thread() {
+            Prof::SetThreadName("audio");
+            const bool com = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+            IMMDeviceEnumerator* en     = nullptr;
+            IMMDevice*           dev    = nullptr;
+            IAudioClient*        client = nullptr;
+            IAudioRenderClient*  render = nullptr;
+            HANDLE               ev     = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            HANDLE               mmcss  = nullptr;
+            DWORD                task   = 0;
+            UINT32               bufFrames = 0;
+            bool                 running = false;
+
+            WAVEFORMATEXTENSIBLE wf{};
+            wf.Format.wFormatTag           = WAVE_FORMAT_EXTENSIBLE;
+            wf.Format.nChannels            = m_fmt.channels;
+            wf.Format.nSamplesPerSec       = m_fmt.sampleRate;
+            wf.Format.wBitsPerSample       = 32;
+            wf.Format.nBlockAlign          = (WORD)(m_fmt.channels * 4);
+            wf.Format.nAvgBytesPerSec      = m_fmt.sampleRate * wf.Format.nBlockAlign;
+            wf.Format.cbSize               = sizeof(wf) - sizeof(WAVEFORMATEX);
+            wf.Samples.wValidBitsPerSample = 32;
+            wf.dwChannelMask               = m_fmt.channels == 1 ? SPEAKER_FRONT_CENTER
+                                                                 : SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT;
+            wf.SubFormat                   = KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
+
+            const REFERENCE_TIME kBuffer = 400000;      // 40 ms, in 100 ns units
+            const DWORD flags = AUDCLNT_STREAMFLAGS_EVENTCALLBACK | AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM |
+                                AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY;
+            if (FAILED(CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+                                        __uuidof(IMMDeviceEnumerator), (void**)&en)) ||
+                FAILED(en->GetDefaultAudioEndpoint(eRender, eConsole, &dev))) {
+                Signal(-1, "no default audio output device");
+            } else if (FAILED(dev->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&client)) ||
+                       FAILED(client->Initialize(AUDCLNT_SHAREMODE_SHARED, flags, kBuffer, 0,
+                                                 &wf.Format, nullptr)) ||
+                       FAILED(client->SetEventHandle(ev)) ||
+                       FAILED(client->GetBufferSize(&bufFrames)) ||
+                       FAILED(client->GetService(__uuidof(IAudioRenderClient), (void**)&render))) {
+                Signal(-1, "audio device rejected the stream format");
+            } else {
+                mmcss = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task);
+                Signal(1);
+                while (m_run.load(std::memory_order_relaxed)) {
+                    const bool want = m_want.load(std::memory_order_relaxed);
+                    if (want != running) {
+                        if (want) {
+                            // Prime the buffer so the first period isn't silence
+                            BYTE* data = nullptr;
+                            UINT32 pad = 0;
+                            client->GetCurrentPadding(&pad);
+                            if (SUCCEEDED(render->GetBuffer(bufFrames - pad, &data))) {
+                                m_src->Render((float*)data, bufFrames - pad);
+                                render->ReleaseBuffer(bufFrames - pad, 0);
+                            }
+                            client->Start();
+                        } else {
+                            client->Stop();
+                        }
+                        running = want;
+                        m_running.store(running, std::memory_order_release);
+                    }
+                    // Timeout keeps Start/Stop responsive while the stream is idle
+                    if (WaitForSingleObject(ev, 20) != WAIT_OBJECT_0 || !running) continue;
+                    UINT32 pad = 0;
+                    if (FAILED(client->GetCurrentPadding(&pad))) break;
+                    const UINT32 avail = bufFrames - pad;
+                    BYTE* data = nullptr;
+                    if (avail && SUCCEEDED(render->GetBuffer(avail, &data))) {
+                        m_src->Render((float*)data, avail);
+                        render->ReleaseBuffer(avail, 0);
+                    }
+                }
+                if (running) client->Stop();
+            }
+            m_running = false;
+
+            if (mmcss) AvRevertMmThreadCharacteristics(mmcss);
+            SafeRelease(render);
+            SafeRelease(client);
+            SafeRelease(dev);
+            SafeRelease(en);
+            if (ev) CloseHandle(ev);
+            if (com) CoUninitialize();
+        }
+
+        Format                  m_fmt;
+        Source*                 m_src = nullptr;
+        std::thread             m_thread;
+        std::atomic<bool>       m_run{ false }, m_want{ false }, m_running{ false };
+        std::mutex              m_mx;               // Open() handshake only
+        std::condition_variable m_cv;
+        int                     m_state = 0;        // 0 starting, 1 ready, -1 failed
+        const char*             m_error = "";
+    };
+
+    std::unique_ptr<Sink> MakeWasapiSink() { return std::make_unique<WasapiSink>(); }
+
+}  // namespace Audio
+
+#endif  // _WIN32
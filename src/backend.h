@@ -0,0 +1,220 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  SYSTEM BACKEND  —  every OS side effect the engine performs
+// ──────────────────────────────────────────────────────────────────────────────
+//  The GUI and the headless runner talk to the OS only through a Backend:
+//  Windows (registry / power / service-control APIs), Linux (sysfs / procfs /
+//  cpufreq / systemd over D-Bus) and an in-memory mock that records calls, so
+//  profiles and the cleaner can be exercised on CI machines without touching
+//  the host.
+//
+//  Every action is applied in-process by default.  The command-line helpers
+//  the app used to shell out to (powercfg, sc, netsh, taskkill, ipconfig;
+//  sysctl, systemctl, resolvectl) are still there as ActionPath::Spawn, for
+//  comparison (xopt-cli --bench-actions) and as an escape hatch.
+#pragma once
+
+#include "tweaks.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Sys {
+
+    namespace fs = std::filesystem;
+
+    enum class ActionPath : uint8_t { InProcess, Spawn };
+
+    // Up to 64 logical CPUs, bit i = LogicalCpu::index i; CPUs past 64 are
+    // left alone
+    using CpuMask = uint64_t;
+
+    struct LogicalCpu {
+        unsigned index     = 0;
+        unsigned core      = 0;     // physical core: SMT siblings share it
+        unsigned package   = 0;
+        unsigned perfClass = 0;     // higher is faster (P vs E cores); all equal when uniform
+    };
+
+    struct ProcessInfo {
+        uint32_t    pid    = 0;
+        uint32_t    ppid   = 0;
+        uint64_t    cpuNs  = 0;     // user + kernel time so far
+        uint64_t    resident = 0;   // bytes: RSS / working set
+        bool        system = false; // kernel thread / protected: never touched
+        std::string name;
+    };
+
+    // Set() for different tweaks may run concurrently (the boost scheduler
+    // does); the same tweak is never set from two threads at once.
+    class Backend {
+    public:
+        virtual ~Backend() = default;
+
+        virtual const char* Name() const = 0;
+
+        // Not while Set() may run.  Tweaks without a helper equivalent take
+        // the in-process path either way.
+        void       SetActionPath(ActionPath p) { m_path = p; }
+        ActionPath GetActionPath() const       { return m_path; }
+        // Whether ActionPath::Spawn runs a helper for this tweak at all
+        virtual bool Spawns(Tweaks::Id id) const { (void)id; return false; }
+
+        // Set(): false when the call failed or the tweak has no equivalent
+        // here; CallError() then says why
+        virtual bool Supported(Tweaks::Id id) const = 0;
+        virtual bool Set(Tweaks::Id id, bool on)    = 0;
+        // Current OS state of a tweak; false when it can't be read back here
+        // (callers fall back to what they last set)
+        virtual bool Get(Tweaks::Id id, bool& on) const { (void)id; (void)on; return false; }
+
+        virtual bool FlushDns() = 0;
+
+        // Process control for the affinity governor.  Affinity and priority
+        // cover every thread of the process.  Priority is on the nice scale,
+        // -20 (highest) … 19 (idle); Windows maps it onto priority classes.
+        // Set*(): false + CallError() when the process is gone or not ours.
+        virtual bool Topology(std::vector<LogicalCpu>& out) const    { (void)out; return false; }
+        virtual bool Processes(std::vector<ProcessInfo>& out) const  { (void)out; return false; }
+        virtual bool GetAffinity(uint32_t pid, CpuMask& mask) const  { (void)pid; (void)mask; return false; }
+        virtual bool SetAffinity(uint32_t pid, CpuMask mask)         { (void)pid; (void)mask; return false; }
+        virtual bool GetPriority(uint32_t pid, int& nice) const      { (void)pid; (void)nice; return false; }
+        virtual bool SetPriority(uint32_t pid, int nice)             { (void)pid; (void)nice; return false; }
+
+        // Memory for the reclaimer.  A memory group is a cgroup v2 path
+        // with memory.reclaim or memory.high; processes outside one are
+        // trimmed one at a time (page-out / working-set trim).  `reclaimed`
+        // is measured: resident (or memory.current) before minus after.
+        virtual bool Memory(uint64_t& total, uint64_t& available) const    { (void)total; (void)available; return false; }
+        virtual bool MemoryGroup(uint32_t pid, std::string& group) const   { (void)pid; (void)group; return false; }
+        virtual bool ReclaimGroup(const std::string& group, uint64_t bytes, uint64_t& reclaimed) {
+            (void)group; (void)bytes; (void)reclaimed; return false;
+        }
+        virtual bool TrimProcess(uint32_t pid, uint64_t& reclaimed)        { (void)pid; (void)reclaimed; return false; }
+
+        // Default cleaner roots (may be empty) and the minimum file age to
+        // delete there — shared temp dirs on Linux hold live session files
+        virtual std::vector<fs::path> CleanRoots() const = 0;
+        virtual uint32_t              CleanMinAge() const { return 0; }
+        // Directory-state journal; lives outside the roots it describes
+        virtual fs::path              JournalPath() const = 0;
+
+    protected:
+        ActionPath m_path = ActionPath::InProcess;
+    };
+
+    // The backend for the OS this binary was built for (process lifetime)
+    Backend& Native();
+
+    // Blocking work inside Set() / FlushDns() on this thread gives up at the
+    // deadline, killing any helper process it started.  The boost scheduler
+    // sets one per task; without one the backends' own caps apply.
+    using Clock = std::chrono::steady_clock;
+    void              SetCallDeadline(Clock::time_point t);   // {}: none
+    Clock::time_point CallDeadline();
+
+    // Why the last failing Set() / FlushDns() on this thread failed, like
+    // errno: backends set it on failure only, callers clear it first
+    void          SetCallError(Tweaks::Error e);
+    Tweaks::Error CallError();
+
+    // Runs a helper (argv[0] from PATH, stdio discarded, nullptr-terminated)
+    // under the call deadline, or 5 s without one.  None on exit status 0;
+    // TimedOut once the helper had to be killed.
+    Tweaks::Error RunHelper(const char* const argv[]);
+
+    // Starts argv (argv[0] from PATH, stdio discarded) without waiting;
+    // 0 on failure.  StopProcess() kills and reaps it.
+    uint32_t StartProcess(const char* const argv[]);
+    bool     StopProcess(uint32_t pid);
+    uint32_t CurrentPid();
+
+    // `root` and everything below it in a Processes() table, root first
+    std::vector<uint32_t> ProcessTree(const std::vector<ProcessInfo>& procs, uint32_t root);
+
+    // ── Mock ──────────────────────────────────────────────────────────────────
+    // Every tweak is supported and remembered; nothing leaves the sandbox.
+    // ActionPath::Spawn runs a no-op helper (`true`) per call, so it still
+    // costs what a process launch costs.
+    // Clean roots live under `sandbox`, which is created on demand, and the
+    // tweak states persist there too, so a later process sees them the way
+    // it would see the real OS — that's what crash-recovery runs rely on.
+    class MockBackend : public Backend {
+    public:
+        struct Call { Tweaks::Id id; bool on; bool ok; };
+
+        explicit MockBackend(fs::path sandbox = fs::temp_directory_path() / "xopt-mock");
+
+        const char* Name() const override { return "mock"; }
+        bool Supported(Tweaks::Id id) const override { return id < Tweaks::Id::Count; }
+        bool Spawns(Tweaks::Id id) const override    { return id < Tweaks::Id::Count; }
+        bool Set(Tweaks::Id id, bool on) override;
+        bool Get(Tweaks::Id id, bool& on) const override;
+        bool FlushDns() override;
+
+        // A made-up machine: two SMT performance cores (CPUs 0–3) and two
+        // efficiency cores (4, 5).  Processes exist only once Spawn()ed.
+        bool Topology(std::vector<LogicalCpu>& out) const override;
+        bool Processes(std::vector<ProcessInfo>& out) const override;
+        bool GetAffinity(uint32_t pid, CpuMask& mask) const override;
+        bool SetAffinity(uint32_t pid, CpuMask mask) override;
+        bool GetPriority(uint32_t pid, int& nice) const override;
+        bool SetPriority(uint32_t pid, int nice) override;
+
+        // 4 GB, 1 GB of it taken outside the fake processes.  A trim keeps
+        // a quarter of a process's resident set; a group reclaim takes what
+        // it asks for from its members, up to that same quarter each.
+        bool Memory(uint64_t& total, uint64_t& available) const override;
+        bool MemoryGroup(uint32_t pid, std::string& group) const override;
+        bool ReclaimGroup(const std::string& group, uint64_t bytes, uint64_t& reclaimed) override;
+        bool TrimProcess(uint32_t pid, uint64_t& reclaimed) override;
+
+        std::vector<fs::path> CleanRoots() const override;
+        fs::path              JournalPath() const override { return m_sandbox / "clean.journal"; }
+
+        // Make Set(id, …) fail from now on with Error::Denied, as missing
+        // rights would
+        void FailOn(Tweaks::Id id, bool fail = true);
+        // Make Set(id, …) block for `ms` like a slow helper process; past the
+        // call deadline it gives up and fails, as a killed helper would
+        void DelayOn(Tweaks::Id id, unsigned ms);
+        // Simulate power loss: the process exits with kCrashExit right after
+        // the n-th Set() from now lands (0 disarms)
+        void CrashAfter(unsigned n) { m_crashAfter = n; }
+        void Reset();   // every tweak off, call log cleared
+
+        // Fake process table: all CPUs, nice 0 when added
+        void Spawn(uint32_t pid, uint32_t ppid, const std::string& name, bool system = false);
+        void Exit(uint32_t pid);
+        void Charge(uint32_t pid, uint64_t cpuNs);      // CPU time used since the last call
+        void SetResident(uint32_t pid, uint64_t bytes, const std::string& group = {});
+
+        static constexpr int kCrashExit = 3;
+
+        bool                     State(Tweaks::Id id) const { return m_state[(size_t)id]; }
+        const std::vector<Call>& Calls() const { return m_calls; }   // not while Set() may run
+        unsigned                 DnsFlushes() const { return m_dnsFlushes; }
+
+    private:
+        void Persist() const;
+
+        fs::path          m_sandbox;
+        mutable std::mutex m_mx;
+        bool              m_state[(size_t)Tweaks::Id::Count] = {};
+        bool              m_fail[(size_t)Tweaks::Id::Count]  = {};
+        unsigned          m_delayMs[(size_t)Tweaks::Id::Count] = {};
+        std::vector<Call> m_calls;
+        unsigned          m_dnsFlushes = 0;
+        unsigned          m_crashAfter = 0;
+
+        struct FakeProcess { ProcessInfo info; CpuMask mask; int nice; std::string group; };
+        std::vector<FakeProcess> m_procs;
+    };
+
+    // "native" | "mock" → process-lifetime backend, nullptr for an unknown name
+    Backend* Find(const std::string& name);
+
+}  // namespace Sys
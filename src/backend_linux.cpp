@@ -0,0 +1,630 @@
+// Linux backend: cpufreq governors, PM QoS, procfs knobs and systemd units
+#ifndef _WIN32
+
+#include "backend.h"
+#include "dbus.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_process_madvise
+#define SYS_process_madvise 440
+#endif
+
+namespace Sys {
+
+    using Tweaks::Id;
+    using Tweaks::Error;
+
+    static const char kCpuDir[]       = "/sys/devices/system/cpu";
+    static const char kDmaLatency[]   = "/dev/cpu_dma_latency";
+    static const char kAutocorking[]  = "/proc/sys/net/ipv4/tcp_autocorking";
+    static const char kSystemdRun[]   = "/run/systemd/system";
+    // SysMain's closest relative: the adaptive readahead daemon
+    static const char kPreloadUnit[]  = "preload.service";
+    static const int  kPageOut        = 21;     // MADV_PAGEOUT, older headers lack it
+
+    static Error FromErrno(int e) {
+        switch (e) {
+            case 0:                               return Error::None;
+            case EACCES: case EPERM: case EROFS:  return Error::Denied;
+            case ENOENT: case ENODEV: case ENXIO: return Error::NotFound;
+            default:                              return Error::Io;
+        }
+    }
+
+    static bool Fail(Error e) { SetCallError(e); return false; }
+
+    static bool ReadText(const fs::path& p, std::string& out) {
+        int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[256];
+        ssize_t n = ::read(fd, buf, sizeof(buf) - 1);
+        ::close(fd);
+        if (n < 0) return false;
+        out.assign(buf, (size_t)n);
+        while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) out.pop_back();
+        return true;
+    }
+
+    // `err`: the failing call's errno, taken before close() can change it
+    static Error WriteText(const fs::path& p, const std::string& text, int* err = nullptr) {
+        if (err) *err = 0;
+        int fd = ::open(p.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (err) *err = errno;
+            return FromErrno(errno);
+        }
+        const ssize_t n   = ::write(fd, text.data(), text.size());
+        const int     why = n < 0 ? errno : 0;
+        const Error   e   = n == (ssize_t)text.size() ? Error::None : n < 0 ? FromErrno(why) : Error::Io;
+        ::close(fd);
+        if (err) *err = why;
+        return e;
+    }
+
+    static bool Writable(const char* p) { return ::access(p, W_OK) == 0; }
+
+    Error RunHelper(const char* const argv[]) {
+        XOPT_ZONE("Sys::RunHelper");
+        posix_spawn_file_actions_t fa;
+        posix_spawn_file_actions_init(&fa);
+        posix_spawn_file_actions_addopen(&fa, 0, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&fa, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&fa, 2, "/dev/null", O_WRONLY, 0);
+        pid_t pid;
+        int rc = posix_spawnp(&pid, argv[0], &fa, nullptr, (char* const*)argv, environ);
+        posix_spawn_file_actions_destroy(&fa);
+        if (rc != 0) return FromErrno(rc);
+        int status = 0;
+        Clock::time_point dl = CallDeadline();
+        if (dl == Clock::time_point{}) dl = Clock::now() + std::chrono::seconds(5);
+        for (;;) {
+            const pid_t r = ::waitpid(pid, &status, WNOHANG);
+            if (r == pid) return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? Error::None : Error::Failed;
+            if (r < 0 && errno != EINTR) return Error::Io;
+            if (Clock::now() >= dl) {
+                ::kill(pid, SIGKILL);
+                while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+                return Error::TimedOut;
+            }
+            ::usleep(1000);
+        }
+    }
+
+    uint32_t StartProcess(const char* const argv[]) {
+        posix_spawn_file_actions_t fa;
+        posix_spawn_file_actions_init(&fa);
+        posix_spawn_file_actions_addopen(&fa, 0, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&fa, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&fa, 2, "/dev/null", O_WRONLY, 0);
+        pid_t pid = 0;
+        const int rc = posix_spawnp(&pid, argv[0], &fa, nullptr, (char* const*)argv, environ);
+        posix_spawn_file_actions_destroy(&fa);
+        return rc == 0 ? (uint32_t)pid : 0;
+    }
+
+    bool StopProcess(uint32_t pid) {
+        if (!pid || ::kill((pid_t)pid, SIGKILL) != 0) return false;
+        int status;
+        while (::waitpid((pid_t)pid, &status, 0) < 0 && errno == EINTR) {}
+        return true;
+    }
+
+    uint32_t CurrentPid() { return (uint32_t)::getpid(); }
+
+    // Threads of a process (/proc/PID/task); affinity and nice are per
+    // thread on Linux, so the governor has to set every one
+    static std::vector<pid_t> Threads(uint32_t pid) {
+        std::vector<pid_t> out;
+        std::error_code ec;
+        for (fs::directory_iterator it("/proc/" + std::to_string(pid) + "/task", ec), end;
+             !ec && it != end; it.increment(ec))
+            out.push_back((pid_t)std::strtol(it->path().filename().c_str(), nullptr, 10));
+        return out;
+    }
+
+    // Per-thread calls: threads exiting meanwhile (ESRCH) don't count, any
+    // other failure is the answer
+    template <class Fn>
+    static bool ForEachThread(uint32_t pid, Fn&& fn) {
+        const std::vector<pid_t> tids = Threads(pid);
+        if (tids.empty()) return Fail(Error::NotFound);
+        unsigned done = 0;
+        for (pid_t tid : tids) {
+            if (fn(tid) == 0) { done++; continue; }
+            if (errno != ESRCH) return Fail(FromErrno(errno));
+        }
+        return done > 0 || Fail(Error::NotFound);
+    }
+
+    // ── Memory reclaim ────────────────────────────────────────────────────────
+
+    // Where the unified (v2) hierarchy is mounted: /sys/fs/cgroup on pure
+    // v2 systems, /sys/fs/cgroup/unified on hybrid ones; empty without one
+    static const fs::path& Cgroup2Root() {
+        static const fs::path root = [] {
+            fs::path out;
+            if (FILE* f = std::fopen("/proc/self/mountinfo", "re")) {
+                char line[1024], mnt[512];
+                while (out.empty() && std::fgets(line, sizeof(line), f))
+                    if (std::strstr(line, " - cgroup2 ") && std::sscanf(line, "%*s %*s %*s %*s %511s", mnt) == 1)
+                        out = mnt;
+                std::fclose(f);
+            }
+            return out;
+        }();
+        return root;
+    }
+
+    static bool ReadBytes(const fs::path& p, uint64_t& v) {
+        std::string s;
+        if (!ReadText(p, s) || s.empty() || !std::isdigit((unsigned char)s[0])) return false;
+        v = std::strtoull(s.c_str(), nullptr, 10);
+        return true;
+    }
+
+    // Resident bytes from /proc/PID/statm (its second field, in pages)
+    static bool Resident(uint32_t pid, uint64_t& bytes) {
+        std::string s;
+        if (!ReadText("/proc/" + std::to_string(pid) + "/statm", s)) return false;
+        unsigned long long size = 0, res = 0;
+        if (std::sscanf(s.c_str(), "%llu %llu", &size, &res) != 2) return false;
+        bytes = res * (uint64_t)::sysconf(_SC_PAGESIZE);
+        return true;
+    }
+
+    static bool UnitInstalled(const char* unit) {
+        if (::access(kSystemdRun, F_OK) != 0) return false;     // not booted with systemd
+        for (const char* dir : { "/etc/systemd/system", "/run/systemd/system", "/usr/lib/systemd/system",
+                                 "/lib/systemd/system" })
+            if (::access((fs::path(dir) / unit).c_str(), F_OK) == 0) return true;
+        return false;
+    }
+
+    static const char kSystemd[]     = "org.freedesktop.systemd1";
+    static const char kSystemdPath[] = "/org/freedesktop/systemd1";
+
+    static Error UnitState(DBus& bus, const char* unit, std::string& state) {
+        return bus.GetProperty(kSystemd, DBus::UnitPath(unit).c_str(), "org.freedesktop.systemd1.Unit",
+                               "ActiveState", state);
+    }
+
+    // Start / stop a unit and wait until systemd reports it there, as
+    // `systemctl` does — the job itself runs asynchronously
+    static Error SetUnit(const char* unit, bool start, bool spawn) {
+        if (spawn) {
+            const char* argv[] = { "systemctl", start ? "start" : "stop", unit, nullptr };
+            return RunHelper(argv);
+        }
+        DBus bus;
+        Error e = bus.Connect();
+        if (e == Error::None)
+            e = bus.Call(kSystemd, kSystemdPath, "org.freedesktop.systemd1.Manager",
+                         start ? "StartUnit" : "StopUnit", "ss", { unit, "replace" });
+        Clock::time_point dl = CallDeadline();
+        if (dl == Clock::time_point{}) dl = Clock::now() + std::chrono::seconds(5);
+        while (e == Error::None) {
+            std::string st;
+            if ((e = UnitState(bus, unit, st)) != Error::None) break;
+            if (start ? st == "active" : st == "inactive" || st == "failed") break;
+            if (start && st == "failed") return Error::Failed;
+            if (Clock::now() >= dl) return Error::TimedOut;
+            ::usleep(2000);
+        }
+        return e;
+    }
+
+    class LinuxBackend final : public Backend {
+    public:
+        ~LinuxBackend() override { if (m_qosFd >= 0) ::close(m_qosFd); }
+
+        const char* Name() const override { return "linux"; }
+
+        bool Supported(Id id) const override {
+            switch (id) {
+                case Id::HighPerfPower: return !Governors().empty();
+                case Id::TimerRes:      return Writable(kDmaLatency);
+                case Id::Network:       return Writable(kAutocorking);
+                case Id::SuperfetchOff: return UnitInstalled(kPreloadUnit);
+                default:                return false;   // Windows-only concepts
+            }
+        }
+
+        bool Spawns(Id id) const override {
+            return id == Id::HighPerfPower || id == Id::Network || id == Id::SuperfetchOff;
+        }
+
+        // Spawn path: the shell / sysctl / systemctl equivalent of each write
+        bool Set(Id id, bool on) override {
+            const bool spawn = m_path == ActionPath::Spawn;
+            Error e = Error::Unsupported;
+            switch (id) {
+                case Id::HighPerfPower: e = SetGovernor(on, spawn); break;
+                // The request is an open fd; no helper could hold it for us
+                case Id::TimerRes:      e = SetDmaLatency(on); break;
+                // Autocorking holds small writes back like Nagle does
+                case Id::Network:
+                    if (spawn) {
+                        const char* argv[] = { "sysctl", "-qw", on ? "net.ipv4.tcp_autocorking=0"
+                                                                   : "net.ipv4.tcp_autocorking=1", nullptr };
+                        e = RunHelper(argv);
+                    } else {
+                        e = WriteText(kAutocorking, on ? "0" : "1");
+                    }
+                    break;
+                case Id::SuperfetchOff: e = SetUnit(kPreloadUnit, !on, spawn); break;
+                default:                break;
+            }
+            return e == Error::None || Fail(e);
+        }
+
+        bool Get(Id id, bool& on) const override {
+            std::string v;
+            switch (id) {
+                case Id::HighPerfPower: {
+                    std::vector<fs::path> govs = Governors();
+                    if (govs.empty()) return false;
+                    on = true;
+                    for (auto& g : govs) {
+                        if (!ReadText(g, v)) return false;
+                        on = on && v == "performance";
+                    }
+                    return true;
+                }
+                // The request lives exactly as long as our fd
+                case Id::TimerRes: on = m_qosFd >= 0; return true;
+                case Id::Network:
+                    if (!ReadText(kAutocorking, v)) return false;
+                    on = v == "0";
+                    return true;
+                case Id::SuperfetchOff: {
+                    DBus bus;
+                    if (bus.Connect() != Error::None || UnitState(bus, kPreloadUnit, v) != Error::None)
+                        return false;
+                    on = v == "inactive" || v == "failed";
+                    return true;
+                }
+                default:           return false;
+            }
+        }
+
+        // Only systemd-resolved keeps a local cache worth flushing
+        bool FlushDns() override {
+            if (::access("/run/systemd/resolve", F_OK) != 0) return true;
+            Error e;
+            if (m_path == ActionPath::Spawn) {
+                const char* argv[] = { "resolvectl", "flush-caches", nullptr };
+                e = RunHelper(argv);
+            } else {
+                DBus bus;
+                e = bus.Connect();
+                if (e == Error::None)
+                    e = bus.Call("org.freedesktop.resolve1", "/org/freedesktop/resolve1",
+                                 "org.freedesktop.resolve1.Manager", "FlushCaches", "", {});
+            }
+            return e == Error::None || Fail(e);
+        }
+
+        // cpuN/topology; perfClass from cpu_capacity (big.LITTLE) or the
+        // maximum clock (hybrid x86), 0 when neither is exposed
+        bool Topology(std::vector<LogicalCpu>& out) const override {
+            out.clear();
+            std::error_code ec;
+            for (fs::directory_iterator it(kCpuDir, ec), end; !ec && it != end; it.increment(ec)) {
+                const std::string n = it->path().filename().string();
+                if (n.size() < 4 || n.compare(0, 3, "cpu") || !std::isdigit((unsigned char)n[3])) continue;
+                const unsigned idx = (unsigned)std::strtoul(n.c_str() + 3, nullptr, 10);
+                std::string v;
+                if (idx >= 64 || (ReadText(it->path() / "online", v) && v == "0")) continue;
+                LogicalCpu c;
+                c.index = idx;
+                c.core  = ReadText(it->path() / "topology" / "thread_siblings_list", v)
+                          ? (unsigned)std::strtoul(v.c_str(), nullptr, 10) : idx;   // first sibling
+                c.package = ReadText(it->path() / "topology" / "physical_package_id", v)
+                          ? (unsigned)std::strtoul(v.c_str(), nullptr, 10) : 0;
+                if (ReadText(it->path() / "cpu_capacity", v) ||
+                    ReadText(it->path() / "cpufreq" / "cpuinfo_max_freq", v))
+                    c.perfClass = (unsigned)std::strtoul(v.c_str(), nullptr, 10);
+                out.push_back(c);
+            }
+            std::sort(out.begin(), out.end(), [](const LogicalCpu& a, const LogicalCpu& b) { return a.index < b.index; });
+            return !out.empty();
+        }
+
+        bool Processes(std::vector<ProcessInfo>& out) const override {
+            out.clear();
+            static const long     tick  = ::sysconf(_SC_CLK_TCK);
+            static const uint64_t kPage = (uint64_t)::sysconf(_SC_PAGESIZE);
+            std::error_code ec;
+            for (fs::directory_iterator it("/proc", ec), end; !ec && it != end; it.increment(ec)) {
+                const std::string n = it->path().filename().string();
+                if (n.empty() || !std::isdigit((unsigned char)n[0])) continue;
+                // "pid (comm) state ppid … flags … utime stime …"; comm may
+                // hold spaces and parentheses, so parse from the last ')'
+                char buf[1024];
+                const int fd = ::open((it->path() / "stat").c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) continue;
+                const ssize_t got = ::read(fd, buf, sizeof(buf) - 1);
+                ::close(fd);
+                if (got <= 0) continue;
+                buf[got] = 0;
+                const char* l = std::strchr(buf, '(');
+                const char* r = std::strrchr(buf, ')');
+                if (!l || !r || r < l) continue;
+                char state;
+                int ppid;
+                unsigned flags;
+                unsigned long long ut, st;
+                long rss = 0;
+                if (std::sscanf(r + 2, "%c %d %*d %*d %*d %*d %u %*u %*u %*u %*u %llu %llu"
+                                       " %*d %*d %*d %*d %*d %*d %*u %*u %ld",
+                                &state, &ppid, &flags, &ut, &st, &rss) < 5)
+                    continue;
+                if (state == 'Z' || state == 'X') continue;            // exited, not yet reaped
+                ProcessInfo p;
+                p.pid    = (uint32_t)std::strtoul(n.c_str(), nullptr, 10);
+                p.ppid   = (uint32_t)ppid;
+                p.cpuNs  = (ut + st) * (1000000000ull / (unsigned long long)(tick > 0 ? tick : 100));
+                p.resident = rss > 0 ? (uint64_t)rss * kPage : 0;
+                p.system = (flags & 0x00200000u) != 0 || p.pid == 1;      // PF_KTHREAD, init
+                p.name.assign(l + 1, r);
+                out.push_back(std::move(p));
+            }
+            return !out.empty();
+        }
+
+        bool GetAffinity(uint32_t pid, CpuMask& mask) const override {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (::sched_getaffinity((pid_t)pid, sizeof(set), &set) != 0) return Fail(FromErrno(errno));
+            mask = 0;
+            for (unsigned i = 0; i < 64; i++)
+                if (CPU_ISSET(i, &set)) mask |= CpuMask(1) << i;
+            return true;
+        }
+
+        bool SetAffinity(uint32_t pid, CpuMask mask) override {
+            if (!mask) return Fail(Error::Failed);
+            return ForEachThread(pid, [mask](pid_t tid) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                if (::sched_getaffinity(tid, sizeof(set), &set) != 0) return -1;
+                for (unsigned i = 0; i < 64; i++) {             // CPUs past 64 stay as they were
+                    if (mask >> i & 1) CPU_SET(i, &set);
+                    else               CPU_CLR(i, &set);
+                }
+                return ::sched_setaffinity(tid, sizeof(set), &set);
+            });
+        }
+
+        bool GetPriority(uint32_t pid, int& nice) const override {
+            errno = 0;
+            const int v = ::getpriority(PRIO_PROCESS, (id_t)pid);
+            if (v == -1 && errno) return Fail(FromErrno(errno));
+            nice = v;
+            return true;
+        }
+
+        // Raising priority (nice < current) needs CAP_SYS_NICE → Denied
+        bool SetPriority(uint32_t pid, int nice) override {
+            return ForEachThread(pid, [nice](pid_t tid) { return ::setpriority(PRIO_PROCESS, (id_t)tid, nice); });
+        }
+
+        bool Memory(uint64_t& total, uint64_t& available) const override {
+            FILE* f = std::fopen("/proc/meminfo", "re");
+            if (!f) return Fail(FromErrno(errno));
+            char line[256];
+            unsigned long long kb;
+            total = available = 0;
+            while (std::fgets(line, sizeof(line), f)) {
+                if (std::sscanf(line, "MemTotal: %llu kB", &kb) == 1)          total     = kb * 1024;
+                else if (std::sscanf(line, "MemAvailable: %llu kB", &kb) == 1) available = kb * 1024;
+            }
+            std::fclose(f);
+            return total > 0;
+        }
+
+        // The process's v2 cgroup ("0::/path" in /proc/PID/cgroup), if the
+        // memory controller is on there.  The root group has no knobs.
+        bool MemoryGroup(uint32_t pid, std::string& group) const override {
+            const fs::path& root = Cgroup2Root();
+            if (root.empty()) return false;
+            FILE* f = std::fopen(("/proc/" + std::to_string(pid) + "/cgroup").c_str(), "re");
+            if (!f) return false;
+            char line[1024];
+            std::string path;
+            while (std::fgets(line, sizeof(line), f))
+                if (!std::strncmp(line, "0::", 3)) {
+                    path = line + 3;
+                    while (!path.empty() && path.back() == '\n') path.pop_back();
+                }
+            std::fclose(f);
+            if (path.size() < 2 || path[0] != '/') return false;
+            const fs::path dir = root / path.substr(1);
+            if (::access((dir / "memory.reclaim").c_str(), W_OK) != 0 &&
+                ::access((dir / "memory.high").c_str(), W_OK) != 0)
+                return false;
+            group = path;
+            return true;
+        }
+
+        // memory.reclaim (5.19+) asks the kernel for exactly `bytes`; EAGAIN
+        // means it got less.  Older kernels: squeeze memory.high down by
+        // `bytes` for a moment, then put it back.
+        bool ReclaimGroup(const std::string& group, uint64_t bytes, uint64_t& reclaimed) override {
+            const fs::path& root = Cgroup2Root();
+            if (root.empty() || group.size() < 2) return Fail(Error::NotFound);
+            const fs::path dir = root / group.substr(1);
+            uint64_t before = 0, after = 0;
+            if (!ReadBytes(dir / "memory.current", before)) return Fail(Error::NotFound);
+            if (::access((dir / "memory.reclaim").c_str(), W_OK) == 0) {
+                int err = 0;
+                const Error e = WriteText(dir / "memory.reclaim", std::to_string(bytes), &err);
+                if (e != Error::None && err != EAGAIN) return Fail(e);
+            } else {
+                std::string high;
+                if (!ReadText(dir / "memory.high", high)) return Fail(Error::NotFound);
+                const uint64_t floor = std::max(before / 4, before > bytes ? before - bytes : 0);
+                const Error e = WriteText(dir / "memory.high", std::to_string(floor));
+                if (e != Error::None) return Fail(e);
+                ::usleep(200 * 1000);                   // reclaim runs as the group next allocates
+                WriteText(dir / "memory.high", high);
+            }
+            ReadBytes(dir / "memory.current", after);
+            reclaimed = before > after ? before - after : 0;
+            return true;
+        }
+
+        // MADV_PAGEOUT on every mapping through process_madvise (5.10+).
+        // Pages shared with another process stay; without swap only
+        // file-backed pages can go.
+        bool TrimProcess(uint32_t pid, uint64_t& reclaimed) override {
+            uint64_t before = 0, after = 0;
+            if (!Resident(pid, before)) return Fail(Error::NotFound);
+            const int pidfd = (int)::syscall(SYS_pidfd_open, (pid_t)pid, 0);
+            if (pidfd < 0) return Fail(FromErrno(errno));
+            FILE* f = std::fopen(("/proc/" + std::to_string(pid) + "/maps").c_str(), "re");
+            if (!f) { const int e = errno; ::close(pidfd); return Fail(FromErrno(e)); }
+            char line[1024];
+            unsigned tried = 0, done = 0;
+            int lastErr = 0;
+            while (std::fgets(line, sizeof(line), f)) {
+                unsigned long lo, hi;
+                if (std::sscanf(line, "%lx-%lx", &lo, &hi) != 2 || std::strstr(line, "[v")) continue;   // vdso, vvar, vsyscall
+                iovec iov{ (void*)lo, hi - lo };
+                tried++;
+                if (::syscall(SYS_process_madvise, pidfd, &iov, 1, kPageOut, 0) >= 0) done++;
+                else lastErr = errno;
+            }
+            std::fclose(f);
+            ::close(pidfd);
+            if (tried && !done) return Fail(FromErrno(lastErr));
+            Resident(pid, after);
+            reclaimed = before > after ? before - after : 0;
+            return true;
+        }
+
+        std::vector<fs::path> CleanRoots() const override {
+            std::error_code ec;
+            fs::path tmp = fs::temp_directory_path(ec);
+            return { ec ? fs::path("/tmp") : tmp };
+        }
+
+        // Shared /tmp holds sockets and scratch files of running sessions
+        uint32_t CleanMinAge() const override { return 24 * 3600; }
+
+        fs::path JournalPath() const override {
+            const char* xdg  = std::getenv("XDG_CACHE_HOME");
+            const char* home = std::getenv("HOME");
+            fs::path base = (xdg && *xdg)   ? fs::path(xdg)
+                          : (home && *home) ? fs::path(home) / ".cache"
+                          : fs::path("/var/tmp");
+            return base / "x-opt" / "clean.journal";
+        }
+
+    private:
+        // cpuN/cpufreq/scaling_governor files we may write
+        static std::vector<fs::path> Governors() {
+            std::vector<fs::path> out;
+            std::error_code ec;
+            for (fs::directory_iterator it(kCpuDir, ec), end; !ec && it != end; it.increment(ec)) {
+                const std::string n = it->path().filename().string();
+                if (n.size() < 4 || n.compare(0, 3, "cpu") || !std::isdigit((unsigned char)n[3])) continue;
+                fs::path g = it->path() / "cpufreq" / "scaling_governor";
+                if (Writable(g.c_str())) out.push_back(g);
+            }
+            return out;
+        }
+
+        // Boost → "performance"; revert → what was there before, or the
+        // distro's usual default when this process never saw the original
+        Error SetGovernor(bool on, bool spawn) {
+            std::vector<fs::path> govs = Governors();
+            if (govs.empty()) return Error::NotFound;
+            Error first = Error::None;
+            for (auto& g : govs) {
+                std::string cur, target = "performance";
+                auto it = m_savedGov.find(g.string());
+                if (on) {
+                    if (ReadText(g, cur) && cur != "performance") m_savedGov.emplace(g.string(), cur);
+                } else {
+                    target = it != m_savedGov.end() ? it->second : DefaultGovernor(g);
+                }
+                Error e;
+                if (spawn) {
+                    const char* argv[] = { "sh", "-c", "printf %s \"$1\" > \"$2\"", "sh",
+                                           target.c_str(), g.c_str(), nullptr };
+                    e = RunHelper(argv);
+                } else {
+                    e = WriteText(g, target);
+                }
+                if (!on && it != m_savedGov.end()) m_savedGov.erase(it);
+                if (first == Error::None) first = e;
+            }
+            return first;
+        }
+
+        static std::string DefaultGovernor(const fs::path& gov) {
+            std::string avail;
+            ReadText(gov.parent_path() / "scaling_available_governors", avail);
+            for (const char* g : { "schedutil", "ondemand", "powersave" })
+                if (avail.find(g) != std::string::npos) return g;
+            return "powersave";
+        }
+
+        // PM QoS: keep CPUs out of deep C-states while the fd stays open —
+        // the closest analogue of timeBeginPeriod(1)
+        Error SetDmaLatency(bool on) {
+            if (!on) {
+                if (m_qosFd >= 0) ::close(m_qosFd);
+                m_qosFd = -1;
+                return Error::None;
+            }
+            if (m_qosFd >= 0) return Error::None;
+            int fd = ::open(kDmaLatency, O_WRONLY | O_CLOEXEC);
+            if (fd < 0) return FromErrno(errno);
+            int32_t us = 0;
+            if (::write(fd, &us, sizeof(us)) != (ssize_t)sizeof(us)) {
+                const Error e = FromErrno(errno);
+                ::close(fd);
+                return e;
+            }
+            m_qosFd = fd;
+            return Error::None;
+        }
+
+        std::map<std::string, std::string> m_savedGov;
+        int                                m_qosFd = -1;
+    };
+
+    Backend& Native() {
+        static LinuxBackend be;
+        return be;
+    }
+
+}  // namespace Sys
+
+#endif  // !_WIN32
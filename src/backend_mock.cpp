@@ -0,0 +1,259 @@
+#include "backend.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace Sys {
+
+    static const char kStateFile[] = "tweaks.state";   // one byte per Tweaks::Id
+
+    MockBackend::MockBackend(fs::path sandbox) : m_sandbox(std::move(sandbox)) {
+        IO::MappedFile f;
+        if (f.Open(m_sandbox / kStateFile) && f.Size() == (size_t)Tweaks::Id::Count)
+            for (size_t i = 0; i < f.Size(); i++) m_state[i] = f.Data()[i] != 0;
+    }
+
+    static thread_local Clock::time_point t_deadline{};
+    static thread_local Tweaks::Error     t_error = Tweaks::Error::None;
+
+    void              SetCallDeadline(Clock::time_point t) { t_deadline = t; }
+    Clock::time_point CallDeadline()                       { return t_deadline; }
+    void              SetCallError(Tweaks::Error e)        { t_error = e; }
+    Tweaks::Error     CallError()                          { return t_error; }
+
+#ifdef _WIN32
+    static const char* const kNoopHelper[] = { "cmd", "/c", "exit", "0", nullptr };
+#else
+    static const char* const kNoopHelper[] = { "true", nullptr };
+#endif
+
+    bool MockBackend::Set(Tweaks::Id id, bool on) {
+        if (id >= Tweaks::Id::Count) { t_error = Tweaks::Error::Unsupported; return false; }
+        if (m_path == ActionPath::Spawn) {
+            const Tweaks::Error e = RunHelper(kNoopHelper);
+            if (e != Tweaks::Error::None) { t_error = e; return false; }
+        }
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            ok = !m_fail[(size_t)id];
+            if (!ok) t_error = Tweaks::Error::Denied;
+            if (const unsigned ms = m_delayMs[(size_t)id]) {
+                Clock::time_point until = Clock::now() + std::chrono::milliseconds(ms);
+                const Clock::time_point dl = t_deadline;
+                if (dl != Clock::time_point{} && dl < until) {
+                    until   = dl;
+                    ok      = false;
+                    t_error = Tweaks::Error::TimedOut;
+                }
+                m_mx.unlock();                          // other tweaks proceed meanwhile
+                std::this_thread::sleep_until(until);
+                m_mx.lock();
+            }
+            if (ok) {
+                m_state[(size_t)id] = on;
+                Persist();
+            }
+            m_calls.push_back({ id, on, ok });
+            if (m_crashAfter && --m_crashAfter == 0) std::_Exit(kCrashExit);
+        }
+        return ok;
+    }
+
+    bool MockBackend::Get(Tweaks::Id id, bool& on) const {
+        if (id >= Tweaks::Id::Count) return false;
+        std::lock_guard<std::mutex> lk(m_mx);
+        on = m_state[(size_t)id];
+        return true;
+    }
+
+    bool MockBackend::FlushDns() {
+        if (m_path == ActionPath::Spawn) {
+            const Tweaks::Error e = RunHelper(kNoopHelper);
+            if (e != Tweaks::Error::None) { t_error = e; return false; }
+        }
+        std::lock_guard<std::mutex> lk(m_mx);
+        ++m_dnsFlushes;
+        return true;
+    }
+
+    void MockBackend::FailOn(Tweaks::Id id, bool fail) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        if (id < Tweaks::Id::Count) m_fail[(size_t)id] = fail;
+    }
+
+    void MockBackend::DelayOn(Tweaks::Id id, unsigned ms) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        if (id < Tweaks::Id::Count) m_delayMs[(size_t)id] = ms;
+    }
+
+    void MockBackend::Reset() {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (bool& s : m_state) s = false;
+        m_calls.clear();
+        Persist();
+    }
+
+    void MockBackend::Persist() const {
+        uint8_t buf[(size_t)Tweaks::Id::Count];
+        for (size_t i = 0; i < sizeof(buf); i++) buf[i] = m_state[i] ? 1 : 0;
+        IO::WriteFileAtomic(m_sandbox / kStateFile, buf, sizeof(buf));
+    }
+
+    static const CpuMask kMockCpus = 0x3F;
+
+    bool MockBackend::Topology(std::vector<LogicalCpu>& out) const {
+        out.clear();
+        for (unsigned i = 0; i < 6; i++)
+            out.push_back({ i, i < 4 ? i / 2 : i - 2, 0, i < 4 ? 1u : 0u });
+        return true;
+    }
+
+    bool MockBackend::Processes(std::vector<ProcessInfo>& out) const {
+        std::lock_guard<std::mutex> lk(m_mx);
+        out.clear();
+        for (const FakeProcess& p : m_procs) out.push_back(p.info);
+        return true;
+    }
+
+    void MockBackend::Spawn(uint32_t pid, uint32_t ppid, const std::string& name, bool system) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        FakeProcess p{ {}, kMockCpus, 0, {} };
+        p.info.pid    = pid;
+        p.info.ppid   = ppid;
+        p.info.name   = name;
+        p.info.system = system;
+        m_procs.push_back(std::move(p));
+    }
+
+    void MockBackend::Exit(uint32_t pid) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (auto it = m_procs.begin(); it != m_procs.end(); ++it)
+            if (it->info.pid == pid) { m_procs.erase(it); return; }
+    }
+
+    void MockBackend::Charge(uint32_t pid, uint64_t cpuNs) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (FakeProcess& p : m_procs)
+            if (p.info.pid == pid) p.info.cpuNs += cpuNs;
+    }
+
+    bool MockBackend::GetAffinity(uint32_t pid, CpuMask& mask) const {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (const FakeProcess& p : m_procs)
+            if (p.info.pid == pid) { mask = p.mask; return true; }
+        return false;
+    }
+
+    bool MockBackend::SetAffinity(uint32_t pid, CpuMask mask) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (FakeProcess& p : m_procs) {
+            if (p.info.pid != pid) continue;
+            if (p.info.system || !(mask & kMockCpus)) { t_error = Tweaks::Error::Denied; return false; }
+            p.mask = mask & kMockCpus;
+            return true;
+        }
+        t_error = Tweaks::Error::NotFound;
+        return false;
+    }
+
+    bool MockBackend::GetPriority(uint32_t pid, int& nice) const {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (const FakeProcess& p : m_procs)
+            if (p.info.pid == pid) { nice = p.nice; return true; }
+        return false;
+    }
+
+    bool MockBackend::SetPriority(uint32_t pid, int nice) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (FakeProcess& p : m_procs) {
+            if (p.info.pid != pid) continue;
+            if (p.info.system) { t_error = Tweaks::Error::Denied; return false; }
+            p.nice = nice < -20 ? -20 : nice > 19 ? 19 : nice;
+            return true;
+        }
+        t_error = Tweaks::Error::NotFound;
+        return false;
+    }
+
+    static const uint64_t kMockMemory = 4ull << 30, kMockBaseline = 1ull << 30;
+
+    void MockBackend::SetResident(uint32_t pid, uint64_t bytes, const std::string& group) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (FakeProcess& p : m_procs)
+            if (p.info.pid == pid) { p.info.resident = bytes; p.group = group; }
+    }
+
+    bool MockBackend::Memory(uint64_t& total, uint64_t& available) const {
+        std::lock_guard<std::mutex> lk(m_mx);
+        uint64_t used = kMockBaseline;
+        for (const FakeProcess& p : m_procs) used += p.info.resident;
+        total     = kMockMemory;
+        available = used < total ? total - used : 0;
+        return true;
+    }
+
+    bool MockBackend::MemoryGroup(uint32_t pid, std::string& group) const {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (const FakeProcess& p : m_procs)
+            if (p.info.pid == pid && !p.group.empty()) { group = p.group; return true; }
+        return false;
+    }
+
+    bool MockBackend::ReclaimGroup(const std::string& group, uint64_t bytes, uint64_t& reclaimed) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        reclaimed = 0;
+        bool any = false;
+        for (FakeProcess& p : m_procs) {
+            if (p.group != group) continue;
+            any = true;
+            const uint64_t take = std::min(bytes - reclaimed, p.info.resident - p.info.resident / 4);
+            p.info.resident -= take;
+            reclaimed       += take;
+        }
+        if (!any) t_error = Tweaks::Error::NotFound;
+        return any;
+    }
+
+    bool MockBackend::TrimProcess(uint32_t pid, uint64_t& reclaimed) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        for (FakeProcess& p : m_procs) {
+            if (p.info.pid != pid) continue;
+            if (p.info.system) { t_error = Tweaks::Error::Denied; return false; }
+            reclaimed        = p.info.resident - p.info.resident / 4;
+            p.info.resident -= reclaimed;
+            return true;
+        }
+        t_error = Tweaks::Error::NotFound;
+        return false;
+    }
+
+    std::vector<uint32_t> ProcessTree(const std::vector<ProcessInfo>& procs, uint32_t root) {
+        std::vector<uint32_t> tree{ root };
+        for (size_t i = 0; i < tree.size(); i++)
+            for (const ProcessInfo& p : procs)
+                if (p.ppid == tree[i] && p.pid != tree[i] && !p.system &&
+                    std::find(tree.begin(), tree.end(), p.pid) == tree.end())
+                    tree.push_back(p.pid);
+        return tree;
+    }
+
+    std::vector<fs::path> MockBackend::CleanRoots() const {
+        std::error_code ec;
+        fs::path root = m_sandbox / "temp";
+        fs::create_directories(root, ec);
+        return { root };
+    }
+
+    Backend* Find(const std::string& name) {
+        if (name == "native") return &Native();
+        if (name == "mock") {
+            static MockBackend mock;
+            return &mock;
+        }
+        return nullptr;
+    }
+
+}  // namespace Sys
@@ -0,0 +1,593 @@
+// Windows backend: registry, power, service-control and process APIs
+#ifdef _WIN32
+
+#include "backend.h"
+#include "profiler.h"
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <shellapi.h>
+#include <mmsystem.h>
+#include <powrprof.h>
+#include <tlhelp32.h>
+#include <psapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Sys {
+
+    using Tweaks::Id;
+    using Tweaks::Error;
+
+    static const GUID kHighPerf = { 0x8c5e7fda, 0xe8bf, 0x4a96, { 0x9a, 0x85, 0xa6, 0xe2, 0x3a, 0x8c, 0x63, 0x5c } };
+    static const GUID kBalanced = { 0x381b4222, 0xf694, 0x41f0, { 0x96, 0x85, 0xff, 0x5b, 0xb2, 0x60, 0xdf, 0x2e } };
+
+    static Error FromWin32(DWORD e) {
+        switch (e) {
+            case ERROR_SUCCESS:                return Error::None;
+            case ERROR_ACCESS_DENIED:
+            case ERROR_PRIVILEGE_NOT_HELD:     return Error::Denied;
+            case ERROR_FILE_NOT_FOUND:
+            case ERROR_PATH_NOT_FOUND:
+            case ERROR_NOT_FOUND:
+            case ERROR_SERVICE_DOES_NOT_EXIST: return Error::NotFound;
+            case ERROR_TIMEOUT:
+            case WAIT_TIMEOUT:                 return Error::TimedOut;
+            default:                           return Error::Failed;
+        }
+    }
+
+    static Error LastWin32()    { return FromWin32(GetLastError()); }
+    static bool  Fail(Error e)  { SetCallError(e); return false; }
+
+    // The helper path.  Runs within the timeout (5 s, or the caller's call
+    // deadline if sooner); a helper still running past it is killed and the
+    // call reports TimedOut.  sc and reg exit with Win32 error codes, which
+    // map like any other; other helpers' non-zero exits are just Failed.
+    static Error RunCmd(const std::wstring& cmd, bool hidden = true) {
+        XOPT_ZONE("Sys::RunCmd");
+        STARTUPINFOW si{};
+        PROCESS_INFORMATION pi{};
+        si.cb = sizeof(si);
+        if (hidden) { si.dwFlags |= STARTF_USESHOWWINDOW; si.wShowWindow = SW_HIDE; }
+        std::wstring mutable_cmd = cmd;
+        if (!CreateProcessW(nullptr, mutable_cmd.data(), nullptr, nullptr, FALSE,
+                            CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi))
+            return LastWin32();
+        DWORD wait = 5000;
+        if (const Clock::time_point dl = CallDeadline(); dl != Clock::time_point{}) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(dl - Clock::now()).count();
+            wait = left <= 0 ? 0 : (DWORD)std::min<long long>(left, wait);
+        }
+        Error e = Error::TimedOut;
+        if (WaitForSingleObject(pi.hProcess, wait) == WAIT_OBJECT_0) {
+            DWORD code = 1;
+            e = GetExitCodeProcess(pi.hProcess, &code) ? FromWin32(code) : LastWin32();
+        } else {
+            TerminateProcess(pi.hProcess, 1);
+        }
+        CloseHandle(pi.hProcess); CloseHandle(pi.hThread);
+        return e;
+    }
+
+    static std::wstring CommandLine(const char* const argv[]) {
+        std::string line;
+        for (const char* const* a = argv; *a; a++) {
+            const std::string arg = *a;
+            const bool quote = arg.empty() || arg.find_first_of(" \t\"") != std::string::npos;
+            if (!line.empty()) line += ' ';
+            if (quote) line += '"';
+            for (char c : arg) line += c == '"' ? std::string("\\\"") : std::string(1, c);
+            if (quote) line += '"';
+        }
+        std::wstring cmd(line.size(), L'\0');
+        cmd.resize((size_t)MultiByteToWideChar(CP_UTF8, 0, line.data(), (int)line.size(),
+                                               cmd.data(), (int)cmd.size()));
+        return cmd;
+    }
+
+    Error RunHelper(const char* const argv[]) { return RunCmd(CommandLine(argv)); }
+
+    uint32_t StartProcess(const char* const argv[]) {
+        STARTUPINFOW si{};
+        PROCESS_INFORMATION pi{};
+        si.cb = sizeof(si);
+        std::wstring cmd = CommandLine(argv);
+        if (!CreateProcessW(nullptr, cmd.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW,
+                            nullptr, nullptr, &si, &pi))
+            return 0;
+        CloseHandle(pi.hThread);
+        CloseHandle(pi.hProcess);
+        return (uint32_t)pi.dwProcessId;
+    }
+
+    bool StopProcess(uint32_t pid) {
+        HANDLE h = OpenProcess(PROCESS_TERMINATE | SYNCHRONIZE, FALSE, pid);
+        if (!h) return false;
+        const bool ok = TerminateProcess(h, 1) != FALSE;
+        if (ok) WaitForSingleObject(h, 5000);
+        CloseHandle(h);
+        return ok;
+    }
+
+    uint32_t CurrentPid() { return (uint32_t)GetCurrentProcessId(); }
+
+    // Priority classes on the nice scale, both ways; REALTIME is never set
+    static int NiceOf(DWORD cls) {
+        switch (cls) {
+            case IDLE_PRIORITY_CLASS:         return 19;
+            case BELOW_NORMAL_PRIORITY_CLASS: return 10;
+            case ABOVE_NORMAL_PRIORITY_CLASS: return -5;
+            case HIGH_PRIORITY_CLASS:         return -10;
+            case REALTIME_PRIORITY_CLASS:     return -20;
+            default:                          return 0;
+        }
+    }
+
+    static DWORD ClassOf(int nice) {
+        return nice >= 15 ? IDLE_PRIORITY_CLASS
+             : nice >= 5  ? BELOW_NORMAL_PRIORITY_CLASS
+             : nice > -3  ? NORMAL_PRIORITY_CLASS
+             : nice > -8  ? ABOVE_NORMAL_PRIORITY_CLASS
+                          : HIGH_PRIORITY_CLASS;
+    }
+
+    static Error SetDword(HKEY root, const wchar_t* key, const wchar_t* value, DWORD v) {
+        HKEY hk;
+        LSTATUS rc = RegOpenKeyExW(root, key, 0, KEY_SET_VALUE, &hk);
+        if (rc != ERROR_SUCCESS) return FromWin32((DWORD)rc);
+        rc = RegSetValueExW(hk, value, 0, REG_DWORD, (BYTE*)&v, sizeof(v));
+        RegCloseKey(hk);
+        return FromWin32((DWORD)rc);
+    }
+
+    // An absent value is already the default
+    static Error DeleteValue(HKEY root, const wchar_t* key, const wchar_t* value) {
+        const LSTATUS rc = RegDeleteKeyValueW(root, key, value);
+        return rc == ERROR_FILE_NOT_FOUND ? Error::None : FromWin32((DWORD)rc);
+    }
+
+    static bool GetDword(HKEY root, const wchar_t* key, const wchar_t* value, DWORD& v) {
+        DWORD size = sizeof(v);
+        return RegGetValueW(root, key, value, RRF_RT_REG_DWORD, nullptr, &v, &size) == ERROR_SUCCESS;
+    }
+
+    static Error SetPowerScheme(bool high, bool spawn) {
+        if (spawn)
+            return high ? RunCmd(L"cmd /c powercfg /setactive 8c5e7fda-e8bf-4a96-9a85-a6e23a8c635c")
+                        : RunCmd(L"cmd /c powercfg /setactive 381b4222-f694-41f0-9685-ff5bb260df2e");
+        return FromWin32(PowerSetActiveScheme(nullptr, high ? &kHighPerf : &kBalanced));
+    }
+
+    // timeBeginPeriod is the live half.  Its requests nest, so the process
+    // holds at most one and begins / ends it only when the state changes —
+    // repeated ons would otherwise pin 1 ms until exit.  The platform tick is
+    // a boot setting in the BCD store, which has no API short of the BCD WMI
+    // provider and only matters after a reboot — only the helper path
+    // (bcdedit) writes it.
+    static std::atomic<bool> s_timerHeld{ false };
+
+    static Error SetTimer(bool on, bool spawn) {
+        if (on && !s_timerHeld.exchange(true) && timeBeginPeriod(1) != TIMERR_NOERROR) {
+            s_timerHeld = false;
+            return Error::Failed;
+        }
+        if (!on && s_timerHeld.exchange(false)) timeEndPeriod(1);
+        if (!spawn) return Error::None;
+        return on ? RunCmd(L"cmd /c bcdedit /set useplatformtick yes")
+                  : RunCmd(L"cmd /c bcdedit /deletevalue useplatformtick");
+    }
+
+    // In-process: the per-interface Nagle / delayed-ACK values.  Windows
+    // ships without either, so off deletes them rather than writing a value
+    // of our own.  Receive-window autotuning has no documented setter short
+    // of the NetTCPSetting WMI provider, so only the helper path (netsh)
+    // changes it; off puts it back to "normal", the default.
+    static Error SetNetwork(bool on, bool spawn) {
+        Error e = Error::None;
+        if (spawn) {
+            e = on ? RunCmd(L"cmd /c netsh int tcp set global autotuninglevel=disabled")
+                   : RunCmd(L"cmd /c netsh int tcp set global autotuninglevel=normal");
+            if (on) RunCmd(L"cmd /c netsh int tcp set global chimney=disabled");   // gone on newer builds
+        }
+        HKEY hk;
+        const LSTATUS rc = RegOpenKeyExW(HKEY_LOCAL_MACHINE,
+            L"SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters\\Interfaces",
+            0, KEY_ENUMERATE_SUB_KEYS, &hk);
+        if (rc != ERROR_SUCCESS) return FromWin32((DWORD)rc);
+        // Iterate subkeys and set / delete TcpAckFrequency and TCPNoDelay
+        WCHAR name[256]; DWORD i = 0, len = 256;
+        while (RegEnumKeyExW(hk, i++, name, &len, 0,0,0,0) == ERROR_SUCCESS) {
+            std::wstring path = std::wstring(L"SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters\\Interfaces\\") + name;
+            for (const wchar_t* value : { L"TcpAckFrequency", L"TCPNoDelay" }) {
+                const Error r = on ? SetDword(HKEY_LOCAL_MACHINE, path.c_str(), value, 1)
+                                   : DeleteValue(HKEY_LOCAL_MACHINE, path.c_str(), value);
+                if (e == Error::None) e = r;
+            }
+            len = 256;
+        }
+        RegCloseKey(hk);
+        return e;
+    }
+
+    static Error SetAnimations(bool enable) {
+        ANIMATIONINFO ai{ sizeof(ANIMATIONINFO), enable ? 1 : 0 };
+        const Error e = SystemParametersInfoW(SPI_SETANIMATION, sizeof(ANIMATIONINFO), &ai, SPIF_UPDATEINIFILE)
+                      ? Error::None : LastWin32();
+        SystemParametersInfoW(SPI_SETLISTBOXSMOOTHSCROLLING, 0, (PVOID)(UINT_PTR)enable, SPIF_SENDCHANGE);
+        SystemParametersInfoW(SPI_SETMENUANIMATION,   0, (PVOID)(UINT_PTR)enable, SPIF_SENDCHANGE);
+        SystemParametersInfoW(SPI_SETSELECTIONFADE,   0, (PVOID)(UINT_PTR)enable, SPIF_SENDCHANGE);
+        SystemParametersInfoW(SPI_SETTOOLTIPANIMATION,0, (PVOID)(UINT_PTR)enable, SPIF_SENDCHANGE);
+        return e;
+    }
+
+    // taskkill /f /im: every process with that image name; NotFound when
+    // there was none, like taskkill's own failure
+    static Error KillProcesses(const wchar_t* image) {
+        HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snap == INVALID_HANDLE_VALUE) return LastWin32();
+        PROCESSENTRY32W pe{};
+        pe.dwSize = sizeof(pe);
+        bool  found = false;
+        Error e     = Error::None;
+        for (BOOL more = Process32FirstW(snap, &pe); more; more = Process32NextW(snap, &pe)) {
+            if (_wcsicmp(pe.szExeFile, image) != 0) continue;
+            found = true;
+            HANDLE h = OpenProcess(PROCESS_TERMINATE, FALSE, pe.th32ProcessID);
+            const Error r = h && TerminateProcess(h, 1) ? Error::None : LastWin32();
+            if (h) CloseHandle(h);
+            if (e == Error::None) e = r;
+        }
+        CloseHandle(snap);
+        return found ? e : Error::NotFound;
+    }
+
+    // sc stop + config start=disabled, or config start=auto + sc start
+    static Error SetSysMain(bool off) {
+        SC_HANDLE scm = OpenSCManagerW(nullptr, nullptr, SC_MANAGER_CONNECT);
+        if (!scm) return LastWin32();
+        SC_HANDLE svc = OpenServiceW(scm, L"SysMain", SERVICE_STOP | SERVICE_START | SERVICE_CHANGE_CONFIG);
+        Error e = svc ? Error::None : LastWin32();
+        auto startType = [&](DWORD type) {
+            return ChangeServiceConfigW(svc, SERVICE_NO_CHANGE, type, SERVICE_NO_CHANGE, nullptr, nullptr,
+                                        nullptr, nullptr, nullptr, nullptr, nullptr)
+                 ? Error::None : LastWin32();
+        };
+        if (svc && off) {
+            SERVICE_STATUS st{};
+            if (!ControlService(svc, SERVICE_CONTROL_STOP, &st)) {
+                const DWORD err = GetLastError();
+                if (err != ERROR_SERVICE_NOT_ACTIVE) e = FromWin32(err);
+            }
+            if (e == Error::None) e = startType(SERVICE_DISABLED);
+        } else if (svc) {
+            e = startType(SERVICE_AUTO_START);
+            if (e == Error::None && !StartServiceW(svc, 0, nullptr)) {
+                const DWORD err = GetLastError();
+                if (err != ERROR_SERVICE_ALREADY_RUNNING) e = FromWin32(err);
+            }
+        }
+        if (svc) CloseServiceHandle(svc);
+        CloseServiceHandle(scm);
+        return e;
+    }
+
+    class WindowsBackend final : public Backend {
+    public:
+        const char* Name() const override { return "windows"; }
+        bool Supported(Id id) const override { return id < Id::Count; }
+        bool Spawns(Id id) const override {
+            return id == Id::HighPerfPower || id == Id::TimerRes || id == Id::Network ||
+                   id == Id::KillExplorer || id == Id::SuperfetchOff;
+        }
+        bool Set(Id id, bool on) override;
+        bool Get(Id id, bool& on) const override;
+        bool FlushDns() override;
+        bool Topology(std::vector<LogicalCpu>& out) const override;
+        bool Processes(std::vector<ProcessInfo>& out) const override;
+        bool GetAffinity(uint32_t pid, CpuMask& mask) const override;
+        bool SetAffinity(uint32_t pid, CpuMask mask) override;
+        bool GetPriority(uint32_t pid, int& nice) const override;
+        bool SetPriority(uint32_t pid, int nice) override;
+        bool Memory(uint64_t& total, uint64_t& available) const override;
+        bool TrimProcess(uint32_t pid, uint64_t& reclaimed) override;
+        std::vector<fs::path> CleanRoots() const override;
+        fs::path JournalPath() const override;
+    };
+
+    bool WindowsBackend::Set(Id id, bool on) {
+        const bool spawn = m_path == ActionPath::Spawn;
+        Error e = Error::Unsupported;
+        switch (id) {
+            case Id::HighPerfPower:
+                e = SetPowerScheme(on, spawn);
+                break;
+            case Id::TimerRes:
+                e = SetTimer(on, spawn);
+                break;
+            case Id::CpuPriority:
+                e = SetDword(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\PriorityControl",
+                             L"Win32PrioritySeparation", on ? 2 : 1);
+                break;
+            case Id::Network:
+                e = SetNetwork(on, spawn);
+                break;
+            case Id::KillExplorer:
+                if (on)
+                    e = spawn ? RunCmd(L"cmd /c taskkill /f /im explorer.exe") : KillProcesses(L"explorer.exe");
+                else if (FindWindowW(L"Shell_TrayWnd", nullptr))
+                    e = Error::None;            // shell already up: a second explorer.exe opens a window
+                else
+                    e = (INT_PTR)ShellExecuteW(nullptr, L"open", L"explorer.exe", nullptr, nullptr, SW_SHOW) > 32
+                      ? Error::None : LastWin32();
+                break;
+            case Id::SuperfetchOff:
+                if (spawn)
+                    e = on ? RunCmd(L"cmd /c sc stop SysMain & sc config SysMain start=disabled")
+                           : RunCmd(L"cmd /c sc config SysMain start=auto & sc start SysMain");
+                else
+                    e = SetSysMain(on);
+                break;
+            case Id::AnimationsOff:
+                e = SetAnimations(!on);
+                break;
+            case Id::GameMode:
+                e = SetDword(HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft\\GameBar",
+                             L"AutoGameModeEnabled", on ? 1 : 0);
+                break;
+            case Id::GameBarOff:
+                e = SetDword(HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\GameDVR",
+                             L"AppCaptureEnabled", on ? 0 : 1);
+                break;
+            case Id::Count:
+                break;
+        }
+        return e == Error::None || Fail(e);
+    }
+
+    bool WindowsBackend::FlushDns() {
+        // What ipconfig /flushdns calls: exported by dnsapi.dll, not declared
+        // in its header
+        using FlushFn = BOOL (WINAPI*)();
+        static const FlushFn flush = [] {
+            HMODULE dll = LoadLibraryW(L"dnsapi.dll");
+            return dll ? reinterpret_cast<FlushFn>(reinterpret_cast<void*>(
+                             GetProcAddress(dll, "DnsFlushResolverCache")))
+                       : nullptr;
+        }();
+        Error e;
+        if (m_path == ActionPath::Spawn || !flush) e = RunCmd(L"cmd /c ipconfig /flushdns");
+        else                                       e = flush() ? Error::None : LastWin32();
+        return e == Error::None || Fail(e);
+    }
+
+    // The timer request is this process's own, so it reads back as off after
+    // a restart, whatever the store last committed.  The per-interface TCP
+    // values have no single source of truth to read back — those stay unknown
+    bool WindowsBackend::Get(Id id, bool& on) const {
+        DWORD v = 0;
+        switch (id) {
+            case Id::HighPerfPower: {
+                GUID* active = nullptr;
+                if (PowerGetActiveScheme(nullptr, &active) != ERROR_SUCCESS) return false;
+                on = IsEqualGUID(*active, kHighPerf) != 0;
+                LocalFree(active);
+                return true;
+            }
+            case Id::TimerRes:
+                on = s_timerHeld;
+                return true;
+            case Id::CpuPriority:
+                if (!GetDword(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\PriorityControl",
+                              L"Win32PrioritySeparation", v)) return false;
+                on = v == 2;
+                return true;
+            case Id::KillExplorer:
+                on = FindWindowW(L"Shell_TrayWnd", nullptr) == nullptr;
+                return true;
+            case Id::SuperfetchOff: {
+                SC_HANDLE scm = OpenSCManagerW(nullptr, nullptr, SC_MANAGER_CONNECT);
+                if (!scm) return false;
+                SC_HANDLE svc = OpenServiceW(scm, L"SysMain", SERVICE_QUERY_CONFIG);
+                BYTE  buf[8192];
+                DWORD need = 0;
+                bool  ok = svc && QueryServiceConfigW(svc, (QUERY_SERVICE_CONFIGW*)buf, sizeof(buf), &need);
+                if (ok) on = ((QUERY_SERVICE_CONFIGW*)buf)->dwStartType == SERVICE_DISABLED;
+                if (svc) CloseServiceHandle(svc);
+                CloseServiceHandle(scm);
+                return ok;
+            }
+            case Id::AnimationsOff: {
+                ANIMATIONINFO ai{ sizeof(ANIMATIONINFO), 0 };
+                if (!SystemParametersInfoW(SPI_GETANIMATION, sizeof(ai), &ai, 0)) return false;
+                on = ai.iMinAnimate == 0;
+                return true;
+            }
+            case Id::GameMode:
+                if (!GetDword(HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft\\GameBar", L"AutoGameModeEnabled", v))
+                    return false;
+                on = v != 0;
+                return true;
+            case Id::GameBarOff:
+                if (!GetDword(HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\GameDVR",
+                              L"AppCaptureEnabled", v)) return false;
+                on = v == 0;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Processor group 0 only (≤ 64 logical CPUs).  EfficiencyClass is higher
+    // on the performance cores of hybrid parts, 0 everywhere otherwise.
+    bool WindowsBackend::Topology(std::vector<LogicalCpu>& out) const {
+        out.clear();
+        DWORD len = 0;
+        GetLogicalProcessorInformationEx(RelationAll, nullptr, &len);
+        std::vector<BYTE> buf(len);
+        if (!len || !GetLogicalProcessorInformationEx(RelationAll,
+                (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buf.data(), &len))
+            return Fail(LastWin32());
+        std::vector<std::pair<KAFFINITY, unsigned>> packages;
+        unsigned core = 0;
+        for (DWORD off = 0; off < len;) {
+            const auto* info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(buf.data() + off);
+            off += info->Size;
+            if (info->Relationship == RelationProcessorPackage) {
+                for (WORD g = 0; g < info->Processor.GroupCount; g++)
+                    if (info->Processor.GroupMask[g].Group == 0)
+                        packages.emplace_back(info->Processor.GroupMask[g].Mask, (unsigned)packages.size());
+            } else if (info->Relationship == RelationProcessorCore) {
+                const GROUP_AFFINITY& ga = info->Processor.GroupMask[0];
+                if (ga.Group == 0) {
+                    for (unsigned i = 0; i < 64; i++)
+                        if (ga.Mask >> i & 1) out.push_back({ i, core, 0, info->Processor.EfficiencyClass });
+                }
+                core++;
+            }
+        }
+        for (LogicalCpu& c : out)
+            for (auto& pk : packages)
+                if (pk.first >> c.index & 1) c.package = pk.second;
+        std::sort(out.begin(), out.end(), [](const LogicalCpu& a, const LogicalCpu& b) { return a.index < b.index; });
+        return !out.empty();
+    }
+
+    // Processes we can't query, or can query but not change (protected,
+    // other sessions as a normal user), are reported as system and left alone
+    bool WindowsBackend::Processes(std::vector<ProcessInfo>& out) const {
+        out.clear();
+        HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snap == INVALID_HANDLE_VALUE) return Fail(LastWin32());
+        PROCESSENTRY32W pe{};
+        pe.dwSize = sizeof(pe);
+        for (BOOL more = Process32FirstW(snap, &pe); more; more = Process32NextW(snap, &pe)) {
+            ProcessInfo p;
+            p.pid  = pe.th32ProcessID;
+            p.ppid = pe.th32ParentProcessID;
+            char name[MAX_PATH * 3];
+            const int n = WideCharToMultiByte(CP_UTF8, 0, pe.szExeFile, -1, name, sizeof(name), nullptr, nullptr);
+            p.name.assign(name, n > 0 ? (size_t)n - 1 : 0);
+            HANDLE h = p.pid > 4 ? OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_SET_INFORMATION,
+                                               FALSE, p.pid) : nullptr;
+            if (!h && p.pid > 4) {
+                h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, p.pid);
+                p.system = true;
+            }
+            FILETIME c, e, k, u;
+            if (h && GetProcessTimes(h, &c, &e, &k, &u)) {
+                auto ns = [](const FILETIME& f) { return (((uint64_t)f.dwHighDateTime << 32) | f.dwLowDateTime) * 100; };
+                p.cpuNs = ns(k) + ns(u);
+                PROCESS_MEMORY_COUNTERS mc{};
+                if (GetProcessMemoryInfo(h, &mc, sizeof(mc))) p.resident = mc.WorkingSetSize;
+            } else {
+                p.system = true;
+            }
+            if (h) CloseHandle(h);
+            out.push_back(std::move(p));
+        }
+        CloseHandle(snap);
+        return !out.empty();
+    }
+
+    bool WindowsBackend::GetAffinity(uint32_t pid, CpuMask& mask) const {
+        HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!h) return Fail(LastWin32());
+        DWORD_PTR proc = 0, sys = 0;
+        const bool ok = GetProcessAffinityMask(h, &proc, &sys) != FALSE;
+        const Error e = ok ? Error::None : LastWin32();
+        CloseHandle(h);
+        if (!ok) return Fail(e);
+        mask = (CpuMask)proc;
+        return true;
+    }
+
+    // Process-wide: covers every thread, including ones started later
+    bool WindowsBackend::SetAffinity(uint32_t pid, CpuMask mask) {
+        HANDLE h = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!h) return Fail(LastWin32());
+        DWORD_PTR proc = 0, sys = 0;
+        bool ok = GetProcessAffinityMask(h, &proc, &sys) && (mask & sys) &&
+                  SetProcessAffinityMask(h, (DWORD_PTR)(mask & sys));
+        const Error e = ok ? Error::None : LastWin32();
+        CloseHandle(h);
+        return ok || Fail(e == Error::None ? Error::Failed : e);
+    }
+
+    bool WindowsBackend::GetPriority(uint32_t pid, int& nice) const {
+        HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!h) return Fail(LastWin32());
+        const DWORD cls = GetPriorityClass(h);
+        const Error e = cls ? Error::None : LastWin32();
+        CloseHandle(h);
+        if (!cls) return Fail(e);
+        nice = NiceOf(cls);
+        return true;
+    }
+
+    bool WindowsBackend::SetPriority(uint32_t pid, int nice) {
+        HANDLE h = OpenProcess(PROCESS_SET_INFORMATION, FALSE, pid);
+        if (!h) return Fail(LastWin32());
+        const bool  ok = SetPriorityClass(h, ClassOf(nice)) != FALSE;
+        const Error e  = ok ? Error::None : LastWin32();
+        CloseHandle(h);
+        return ok || Fail(e);
+    }
+
+    bool WindowsBackend::Memory(uint64_t& total, uint64_t& available) const {
+        MEMORYSTATUSEX ms{};
+        ms.dwLength = sizeof(ms);
+        if (!GlobalMemoryStatusEx(&ms)) return Fail(LastWin32());
+        total     = ms.ullTotalPhys;
+        available = ms.ullAvailPhys;
+        return true;
+    }
+
+    // EmptyWorkingSet: pages move to the standby / modified lists, so they
+    // count as available at once and fault back in cheaply if touched
+    bool WindowsBackend::TrimProcess(uint32_t pid, uint64_t& reclaimed) {
+        HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_SET_QUOTA, FALSE, pid);
+        if (!h) return Fail(LastWin32());
+        PROCESS_MEMORY_COUNTERS before{}, after{};
+        bool ok = GetProcessMemoryInfo(h, &before, sizeof(before)) && EmptyWorkingSet(h);
+        const Error e = ok ? Error::None : LastWin32();
+        if (ok) GetProcessMemoryInfo(h, &after, sizeof(after));
+        CloseHandle(h);
+        if (!ok) return Fail(e);
+        reclaimed = before.WorkingSetSize > after.WorkingSetSize ? before.WorkingSetSize - after.WorkingSetSize : 0;
+        return true;
+    }
+
+    std::vector<fs::path> WindowsBackend::CleanRoots() const {
+        std::vector<fs::path> roots;
+        wchar_t tmp[MAX_PATH];
+        roots.push_back(GetTempPathW(MAX_PATH, tmp) ? fs::path(tmp) : fs::path());
+        roots.push_back(L"C:\\Windows\\Temp");
+        roots.push_back(L"C:\\Windows\\Prefetch");
+        return roots;
+    }
+
+    fs::path WindowsBackend::JournalPath() const {
+        wchar_t buf[MAX_PATH];
+        DWORD n = GetEnvironmentVariableW(L"LOCALAPPDATA", buf, MAX_PATH);
+        fs::path base = (n && n < MAX_PATH) ? fs::path(buf) : fs::current_path();
+        return base / L"X-OPT" / L"clean.journal";
+    }
+
+    Backend& Native() {
+        static WindowsBackend be;
+        return be;
+    }
+
+}  // namespace Sys
+
+#endif  // _WIN32
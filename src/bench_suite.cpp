@@ -0,0 +1,269 @@
+#include "bench_suite.h"
+#include "backend.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace Bench {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Anchors: "fast" is a tuned desktop, "slow" an untuned laptop on
+    // battery (15.6 ms timer tick, deep C-states, spinning disk)
+    static const MetricInfo kInfo[] = {
+        { Metric::TimerJitter,  "timer_jitter_us", "Timer jitter",    "us",     true,    50.0, 16000.0, 0.25f },
+        { Metric::WakeLatency,  "wake_latency_us", "Thread wake",     "us",     true,    10.0,  2000.0, 0.25f },
+        { Metric::MemBandwidth, "mem_gbps",        "Memory bandwidth", "GB/s",  false,   25.0,     1.0, 0.15f },
+        { Metric::SingleCore,   "cpu_mops",        "Single core",     "Mops/s", false,  500.0,    50.0, 0.20f },
+        { Metric::SmallFileIo,  "file_us",         "Small-file I/O",  "us",     true,    20.0,  3000.0, 0.15f },
+    };
+    static_assert(sizeof(kInfo) / sizeof(kInfo[0]) == (size_t)Metric::Count, "kInfo out of sync with Metric");
+
+    static const char kMagic[4] = { 'X', 'O', 'B', '1' };
+    static_assert(sizeof(HistoryHeader) == 8,  "history header layout");
+    static_assert(sizeof(HistoryRecord) == 88, "history record layout");
+
+    const MetricInfo& Describe(Metric m) { return kInfo[(size_t)m]; }
+
+    static double Us(Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); }
+
+    static double Percentile(std::vector<double>& v, double p) {
+        if (v.empty()) return 0.0;
+        const size_t k = std::min(v.size() - 1, (size_t)(p * (double)v.size()));
+        std::nth_element(v.begin(), v.begin() + (ptrdiff_t)k, v.end());
+        return v[k];
+    }
+
+    // ── Benchmarks ────────────────────────────────────────────────────────────
+
+    // Requested 1 ms; what comes back over that is the timer's fault
+    static double TimerJitter() {
+        constexpr int kSamples = 200;
+        std::vector<double> over;
+        over.reserve(kSamples);
+        for (int i = 0; i < kSamples; i++) {
+            const auto t0 = Clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            over.push_back(std::max(0.0, Us(Clock::now() - t0) - 1000.0));
+        }
+        return Percentile(over, 0.99);
+    }
+
+    // Notify → blocked waiter running again.  The waiter sleeps between
+    // rounds so it really is descheduled when the notify lands.
+    static double WakeLatency() {
+        constexpr int kRounds = 1000;
+        std::mutex              mx;
+        std::condition_variable go, back;
+        Clock::time_point       sent;
+        int                     round = 0, seen = 0;
+        std::vector<double>     lat;
+        lat.reserve(kRounds);
+
+        std::thread waiter([&] {
+            std::unique_lock<std::mutex> lk(mx);
+            for (int r = 1; r <= kRounds; r++) {
+                go.wait(lk, [&] { return round >= r; });
+                lat.push_back(Us(Clock::now() - sent));
+                seen = r;
+                back.notify_one();
+            }
+        });
+        for (int r = 1; r <= kRounds; r++) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            {
+                std::lock_guard<std::mutex> lk(mx);
+                round = r;
+                sent  = Clock::now();
+            }
+            go.notify_one();
+            std::unique_lock<std::mutex> lk(mx);
+            back.wait(lk, [&] { return seen >= r; });
+        }
+        waiter.join();
+        return Percentile(lat, 0.99);
+    }
+
+    // Best of a few passes over buffers well past the last-level cache
+    static double MemBandwidth() {
+        constexpr size_t kBytes = 64u << 20;
+        std::vector<uint8_t> a(kBytes, 1), b(kBytes, 2);
+        double best = 0.0;
+        for (int pass = 0; pass < 6; pass++) {
+            const auto t0 = Clock::now();
+            std::memcpy(pass & 1 ? a.data() : b.data(), pass & 1 ? b.data() : a.data(), kBytes);
+            const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (s > 0.0) best = std::max(best, (double)kBytes / s / 1e9);
+        }
+        volatile uint8_t sink = a[kBytes / 2] ^ b[kBytes / 3];
+        (void)sink;
+        return best;
+    }
+
+    // A dependent xorshift / multiply chain: no memory, no vectorising,
+    // just how fast one core runs right now
+    static double SingleCore() {
+        constexpr uint64_t kIters = 40'000'000;
+        uint64_t x = 0x9E3779B97F4A7C15ull;
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < kIters; i++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            x *= 0xD6E8FEB86659FD93ull;
+        }
+        const double us = Us(Clock::now() - t0);
+        volatile uint64_t sink = x;
+        (void)sink;
+        return us > 0.0 ? (double)kIters / us : 0.0;
+    }
+
+    // Create + write, read back, delete — what a game's shader / config
+    // caches and the cleaner do.  No fsync: that measures the drive's flush,
+    // not the I/O path the tweaks touch.
+    static double SmallFileIo(const fs::path& dir) {
+        constexpr int kFiles = 256;
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        char block[4096];
+        for (size_t i = 0; i < sizeof(block); i++) block[i] = (char)(i * 31);
+        std::vector<fs::path> names;
+        for (int i = 0; i < kFiles; i++) names.push_back(dir / ("b" + std::to_string(i) + ".tmp"));
+
+        const auto t0 = Clock::now();
+        int done = 0;
+        for (auto& p : names) {         // streams take the path as is, non-ANSI names included
+            std::ofstream f(p, std::ios::binary);
+            done += (bool)f.write(block, sizeof(block));
+        }
+        for (auto& p : names) {
+            std::ifstream f(p, std::ios::binary);
+            done += (bool)f.read(block, sizeof(block));
+        }
+        for (auto& p : names) done += fs::remove(p, ec);
+        const double us = Us(Clock::now() - t0);
+        fs::remove(dir, ec);
+        return done == 3 * kFiles ? us / kFiles : kInfo[(size_t)Metric::SmallFileIo].slow;
+    }
+
+    Result Run(const fs::path& scratch, const std::string& label,
+               const std::function<void(Metric, double)>& onMetric) {
+        Result r;
+        r.label = label;
+        r.time  = (int64_t)std::chrono::duration_cast<std::chrono::seconds>(
+                      std::chrono::system_clock::now().time_since_epoch()).count();
+        auto put = [&](Metric m, double v) {
+            r.value[(size_t)m] = v;
+            if (onMetric) onMetric(m, v);
+        };
+        put(Metric::TimerJitter,  TimerJitter());
+        put(Metric::WakeLatency,  WakeLatency());
+        put(Metric::MemBandwidth, MemBandwidth());
+        put(Metric::SingleCore,   SingleCore());
+        put(Metric::SmallFileIo,  SmallFileIo(scratch));
+        r.score = Score(r);
+        return r;
+    }
+
+    // ── Scoring ───────────────────────────────────────────────────────────────
+
+    float SubScore(Metric m, double v) {
+        const MetricInfo& i = Describe(m);
+        if (v <= 0.0) return 0.0f;
+        const double s = i.lowerIsBetter ? std::log(i.slow / v) / std::log(i.slow / i.fast)
+                                         : std::log(v / i.slow) / std::log(i.fast / i.slow);
+        return (float)std::clamp(s * 100.0, 0.0, 100.0);
+    }
+
+    float Score(const Result& r) {
+        float s = 0.0f, w = 0.0f;
+        for (const MetricInfo& i : kInfo) {
+            s += i.weight * SubScore(i.id, r.value[(size_t)i.id]);
+            w += i.weight;
+        }
+        return w > 0.0f ? s / w : 0.0f;
+    }
+
+    double Improvement(Metric m, double before, double after) {
+        if (before <= 0.0 || after <= 0.0) return 0.0;
+        return (Describe(m).lowerIsBetter ? before / after : after / before) * 100.0 - 100.0;
+    }
+
+    std::vector<Metric> Regressions(const Result& prev, const Result& cur, double tolerance) {
+        std::vector<Metric> out;
+        for (const MetricInfo& i : kInfo) {
+            const double a = prev.value[(size_t)i.id], b = cur.value[(size_t)i.id];
+            if (a > 0.0 && b > 0.0 && Improvement(i.id, a, b) < -tolerance * 100.0) out.push_back(i.id);
+        }
+        return out;
+    }
+
+    // ── History ───────────────────────────────────────────────────────────────
+
+    bool History::Load() {
+        m_runs.clear();
+        IO::MappedFile f;
+        if (!f.Open(m_file) || f.Size() < sizeof(HistoryHeader)) return false;
+        HistoryHeader h;
+        std::memcpy(&h, f.Data(), sizeof(h));
+        if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion
+            || h.metrics != (uint8_t)Metric::Count
+            || f.Size() != sizeof(h) + (size_t)h.count * sizeof(HistoryRecord))
+            return false;
+        const uint8_t* p = f.Data() + sizeof(h);
+        for (unsigned i = 0; i < h.count; i++, p += sizeof(HistoryRecord)) {
+            HistoryRecord rec;
+            std::memcpy(&rec, p, sizeof(rec));
+            Result r;
+            r.time  = rec.time;
+            r.score = rec.score;
+            std::memcpy(r.value, rec.value, sizeof(r.value));
+            r.label.assign(rec.label, strnlen(rec.label, sizeof(rec.label)));
+            m_runs.push_back(std::move(r));
+        }
+        return true;
+    }
+
+    bool History::Append(const Result& r) {
+        m_runs.push_back(r);
+        if (m_runs.size() > kMaxRuns) m_runs.erase(m_runs.begin(), m_runs.end() - kMaxRuns);
+
+        HistoryHeader h{};
+        std::memcpy(h.magic, kMagic, 4);
+        h.version = kVersion;
+        h.metrics = (uint8_t)Metric::Count;
+        h.count   = (uint16_t)m_runs.size();
+        std::vector<uint8_t> buf(sizeof(h) + m_runs.size() * sizeof(HistoryRecord));
+        std::memcpy(buf.data(), &h, sizeof(h));
+        uint8_t* p = buf.data() + sizeof(h);
+        for (const Result& run : m_runs) {
+            HistoryRecord rec{};
+            rec.time  = run.time;
+            rec.score = run.score;
+            std::memcpy(rec.value, run.value, sizeof(rec.value));
+            std::memcpy(rec.label, run.label.data(), std::min(run.label.size(), sizeof(rec.label) - 1));
+            std::memcpy(p, &rec, sizeof(rec));
+            p += sizeof(rec);
+        }
+        std::error_code ec;
+        fs::create_directories(m_file.parent_path(), ec);
+        return IO::WriteFileAtomic(m_file, buf.data(), buf.size());
+    }
+
+    const Result* History::Last(const std::string& label) const {
+        for (auto it = m_runs.rbegin(); it != m_runs.rend(); ++it)
+            if (label.empty() || it->label == label) return &*it;
+        return nullptr;
+    }
+
+    fs::path DefaultHistoryPath(const Sys::Backend& be) {
+        return be.JournalPath().parent_path() / "bench.hist";
+    }
+
+}  // namespace Bench
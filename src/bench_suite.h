@@ -0,0 +1,113 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  BENCH SUITE  —  the optimisation score, measured on this machine
+// ──────────────────────────────────────────────────────────────────────────────
+//  Five short micro-benchmarks, picked because the boost tweaks move them:
+//  sleep overshoot (timer resolution), cross-thread wake latency (scheduler,
+//  C-states), memory bandwidth, single-core throughput (power plan /
+//  governor) and small-file I/O (background services).  Each maps onto
+//  0–100 between a "slow" and a "fast" anchor on a log scale; the score is
+//  their weighted mean.  A run takes about a second.
+//
+//  Runs are appended to a small history file, labelled ("manual",
+//  "before:gaming", "after:gaming"…), so a run can be compared with the last
+//  one under the same label and regressions show up across sessions.
+//
+//  On disk (native endianness):
+//      HistoryHeader | HistoryRecord[count]      oldest first, ≤ kMaxRuns
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Sys { class Backend; }
+
+namespace Bench {
+
+    namespace fs = std::filesystem;
+
+    enum class Metric : uint8_t {
+        TimerJitter,        // µs, p99 overshoot of a 1 ms sleep
+        WakeLatency,        // µs, p99 condition-variable wake of a blocked thread
+        MemBandwidth,       // GB/s, large memcpy
+        SingleCore,         // Mops/s, dependent integer mixing loop
+        SmallFileIo,        // µs per 4 KiB file created, read back and deleted
+        Count
+    };
+
+    struct MetricInfo {
+        Metric      id;
+        const char* key;
+        const char* label;
+        const char* unit;
+        bool        lowerIsBetter;
+        double      fast;           // scores 100
+        double      slow;           // scores 0
+        float       weight;
+    };
+
+    const MetricInfo& Describe(Metric m);
+
+    struct Result {
+        int64_t     time  = 0;      // unix seconds
+        float       score = 0.0f;   // 0–100
+        double      value[(size_t)Metric::Count] = {};
+        std::string label;
+    };
+
+    // 0–100 for one metric / the weighted mean over all of them
+    float SubScore(Metric m, double value);
+    float Score(const Result& r);
+    // How much better `after` is than `before`, in percent (negative: worse).
+    // Throughput ratio for higher-is-better metrics, time ratio otherwise.
+    double Improvement(Metric m, double before, double after);
+    // Metrics more than `tolerance` (a fraction) worse in `cur` than in `prev`
+    std::vector<Metric> Regressions(const Result& prev, const Result& cur, double tolerance = 0.15);
+
+    // Runs every benchmark on the calling thread; `scratch` is created for
+    // the file test and removed afterwards.  `onMetric` sees each value as
+    // it lands (for progress in the UI).
+    Result Run(const fs::path& scratch, const std::string& label,
+               const std::function<void(Metric, double)>& onMetric = {});
+
+    struct HistoryHeader {          // 8 bytes
+        char     magic[4];          // "XOB1"
+        uint8_t  version;
+        uint8_t  metrics;           // (size_t)Metric::Count when written
+        uint16_t count;
+    };
+
+    struct HistoryRecord {          // 88 bytes
+        int64_t time;
+        float   score;
+        uint32_t reserved;
+        double  value[(size_t)Metric::Count];
+        char    label[32];          // NUL-padded
+    };
+
+    class History {
+    public:
+        static constexpr uint8_t kVersion = 1;
+        static constexpr size_t  kMaxRuns = 256;
+
+        explicit History(fs::path file) : m_file(std::move(file)) {}
+
+        bool Load();                            // false: missing / corrupt → empty
+        bool Append(const Result& r);           // drops the oldest past kMaxRuns, saves
+
+        const std::vector<Result>& Runs() const { return m_runs; }
+        // Newest run with `label`; "" matches any
+        const Result*              Last(const std::string& label = "") const;
+        const fs::path&            File() const { return m_file; }
+
+    private:
+        fs::path            m_file;
+        std::vector<Result> m_runs;
+    };
+
+    // Next to the backend's other state (the clean journal)
+    fs::path DefaultHistoryPath(const Sys::Backend& be);
+
+}  // namespace Bench
@@ -0,0 +1,234 @@
+#include "boost_scheduler.h"
+#include "backend.h"
+#include "profiler.h"
+
+#include <algorithm>
+
+namespace Tweaks {
+
+    using Clock = std::chrono::steady_clock;
+
+    static double MsSince(Clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    }
+
+    // ── Scheduler ─────────────────────────────────────────────────────────────
+
+    Scheduler::Plan Scheduler::BuildPlan(const std::vector<std::pair<Id, bool>>& steps) {
+        Plan plan;
+        plan.reserve(steps.size());
+        for (size_t j = 0; j < steps.size(); j++) {
+            Task t{ steps[j].first, steps[j].second, Describe(steps[j].first).timeoutMs, {} };
+            // Latest conflicting predecessor only — it already waits for the earlier ones
+            uint16_t last[(size_t)Id::Count];
+            std::fill(last, last + (size_t)Id::Count, (uint16_t)0xFFFF);
+            for (size_t i = 0; i < j; i++) {
+                const Id other = steps[i].first;
+                if (other == t.id || Ordered(other, t.id)) last[(size_t)other] = (uint16_t)i;
+            }
+            for (uint16_t i : last)
+                if (i != 0xFFFF) t.after.push_back(i);
+            plan.push_back(std::move(t));
+        }
+        return plan;
+    }
+
+    Scheduler::Scheduler(Sys::Backend& be, unsigned workers) : m_be(be) {
+        // Steps mostly wait on helper processes, not the CPU: size for the
+        // widest plan rather than the core count
+        if (!workers) workers = (unsigned)Id::Count;
+        for (unsigned i = 0; i < workers; i++) m_threads.emplace_back([this] { Worker(); });
+    }
+
+    Scheduler::~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_quit = true;
+        }
+        m_cv.notify_all();
+        for (auto& t : m_threads) t.join();
+    }
+
+    void Scheduler::SetWakeHook(void (*fn)(void*), void* ctx) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        m_hook    = fn;
+        m_hookCtx = ctx;
+    }
+
+    bool Scheduler::Busy() const {
+        std::lock_guard<std::mutex> lk(m_mx);
+        return m_busy;
+    }
+
+    bool Scheduler::Start(Plan plan, bool stopOnFailure, uint64_t ticket) {
+        std::unique_lock<std::mutex> lk(m_mx);
+        if (m_busy) return false;
+        m_plan = std::move(plan);
+        const size_t n = m_plan.size();
+        m_dependents.assign(n, {});
+        m_waiting.assign(n, 0);
+        m_ready.clear();
+        m_job = Job{};
+        m_job.ticket = ticket;
+        m_job.results.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            const Task& t = m_plan[i];
+            m_job.results.push_back({ t.id, t.on, Status::Cancelled, 0.0 });
+            m_waiting[i] = (uint16_t)t.after.size();
+            for (uint16_t a : t.after) m_dependents[a].push_back((uint16_t)i);
+            if (t.after.empty()) m_ready.push_back((uint16_t)i);
+        }
+        m_stopOnFailure = stopOnFailure;
+        m_halt     = false;
+        m_busy     = true;
+        m_finished = n == 0;
+        m_running  = 0;
+        m_t0       = Clock::now();
+        lk.unlock();
+        if (n) m_cv.notify_all();
+        else   m_doneCv.notify_all();
+        return true;
+    }
+
+    bool Scheduler::Poll(std::vector<StepResult>& steps, Job& done) {
+        std::lock_guard<std::mutex> lk(m_mx);
+        steps.insert(steps.end(), m_events.begin(), m_events.end());
+        m_events.clear();
+        if (!m_finished) return false;
+        done       = std::move(m_job);
+        m_job      = Job{};
+        m_finished = false;
+        m_busy     = false;
+        return true;
+    }
+
+    void Scheduler::Wait() {
+        std::unique_lock<std::mutex> lk(m_mx);
+        m_doneCv.wait(lk, [this] { return !m_busy || m_finished || !m_events.empty(); });
+    }
+
+    void Scheduler::Worker() {
+        Prof::SetThreadName("boost worker");
+        std::unique_lock<std::mutex> lk(m_mx);
+        for (;;) {
+            m_cv.wait(lk, [this] { return m_quit || !m_ready.empty(); });
+            if (m_quit) return;
+            const uint16_t i = m_ready.front();
+            m_ready.pop_front();
+            const Task t = m_plan[i];
+            m_job.peak = std::max(m_job.peak, ++m_running);
+            lk.unlock();
+
+            const StepResult r = RunStep(m_be, t.id, t.on, t.timeoutMs);
+
+            lk.lock();
+            m_running--;
+            m_job.results[i] = r;
+            m_events.push_back(r);
+            if (r.status == Status::Failed || r.status == Status::TimedOut) {
+                m_job.failed = true;
+                if (m_stopOnFailure) { m_halt = true; m_ready.clear(); }
+            }
+            if (!m_halt)
+                for (uint16_t d : m_dependents[i])
+                    if (--m_waiting[d] == 0) { m_ready.push_back(d); m_cv.notify_one(); }
+            // The plan is a DAG over earlier indices, so an empty ready queue
+            // with nothing in flight means every reachable step has run
+            if (m_running == 0 && m_ready.empty()) {
+                m_job.ms   = MsSince(m_t0);
+                m_finished = true;
+            }
+            void (*hook)(void*) = m_hook;
+            void* ctx = m_hookCtx;
+            lk.unlock();
+            m_doneCv.notify_all();
+            if (hook) hook(ctx);
+            lk.lock();
+        }
+    }
+
+    // ── Switcher ──────────────────────────────────────────────────────────────
+
+    Switcher::Switcher(ProfileStore& store, Sys::Backend& be, unsigned workers)
+        : m_store(store), m_be(be), m_sched(be, workers) {}
+
+    uint64_t Switcher::Apply(Profile p) {
+        const uint64_t t = m_next++;
+        m_queue.push_back({ t, std::move(p), Clock::now() });
+        return t;
+    }
+
+    uint64_t Switcher::Switch(const std::string& name) {
+        const Profile* p = m_store.Find(name);
+        return p ? Apply(*p) : 0;
+    }
+
+    void Switcher::StartNext(std::vector<Outcome>& done) {
+        while (m_phase == Phase::Idle && !m_queue.empty()) {
+            m_cur = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_tx   = ProfileStore::TxResult{};
+            m_peak = 0;
+            if (!m_store.Begin(m_be, m_cur.p, m_tx)) { Finish(done); continue; }
+            m_sched.Start(Scheduler::BuildPlan(m_cur.p.steps), true, m_cur.ticket);
+            m_phase = Phase::Forward;
+        }
+    }
+
+    void Switcher::Finish(std::vector<Outcome>& done) {
+        Outcome o;
+        o.ticket = m_cur.ticket;
+        o.name   = m_cur.p.name;
+        o.tx     = std::move(m_tx);
+        o.ms     = MsSince(m_cur.queued);
+        o.peak   = m_peak;
+        done.push_back(std::move(o));
+        m_tx    = ProfileStore::TxResult{};
+        m_phase = Phase::Idle;
+    }
+
+    void Switcher::Update(std::vector<Outcome>& done, std::vector<StepResult>* progress) {
+        StartNext(done);
+        if (m_phase == Phase::Idle) return;
+
+        std::vector<StepResult> steps;
+        Scheduler::Job job;
+        const bool finished = m_sched.Poll(steps, job);
+        if (progress && m_phase == Phase::Forward) progress->insert(progress->end(), steps.begin(), steps.end());
+        if (!finished) return;
+
+        if (m_phase == Phase::Forward) {
+            m_peak     = job.peak;
+            m_tx.steps = std::move(job.results);
+            if (m_store.Commit(m_cur.p, m_tx)) { Finish(done); StartNext(done); return; }
+            const auto undo = m_store.RollbackSteps(m_be, ProfileStore::Touched(m_tx));
+            if (!undo.empty()) {
+                // Reversed list order reverses every Ordered() edge as well
+                m_sched.Start(Scheduler::BuildPlan(undo), false, m_cur.ticket);
+                m_phase = Phase::Rollback;
+                return;
+            }
+        } else {
+            m_tx.undo = std::move(job.results);
+        }
+        m_store.EndRollback(m_tx);
+        Finish(done);
+        StartNext(done);
+    }
+
+    Switcher::Outcome Switcher::Run(Profile p, const std::function<void(const StepResult&)>& onStep) {
+        const uint64_t ticket = Apply(std::move(p));
+        std::vector<Outcome>    done;
+        std::vector<StepResult> progress;
+        for (;;) {
+            Update(done, &progress);
+            if (onStep) for (const StepResult& r : progress) onStep(r);
+            progress.clear();
+            for (Outcome& o : done)
+                if (o.ticket == ticket) return std::move(o);
+            done.clear();
+            m_sched.Wait();
+        }
+    }
+
+}  // namespace Tweaks
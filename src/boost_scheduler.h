@@ -0,0 +1,150 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  BOOST SCHEDULER  —  profile steps on a worker pool, off the UI thread
+// ──────────────────────────────────────────────────────────────────────────────
+//  A plan is a dependency graph over tweak steps: a step waits only for
+//  earlier steps on the same tweak and for Tweaks::Ordered() partners, so a
+//  profile takes about as long as its slowest helper process rather than
+//  the sum of all of them.  Every step runs under its tweak's timeout
+//  (Sys::SetCallDeadline — helpers are killed past it).  One plan runs at a
+//  time; results land in a queue the UI drains with Poll(), and a wake hook
+//  tells a sleeping render loop there's something to show.
+//
+//  Switcher wraps that in ProfileStore transactions: Begin() on the UI
+//  thread, the steps on the pool, then Commit() — or a rollback plan on the
+//  pool followed by EndRollback().  The store is only touched from the
+//  thread that calls Update().
+#pragma once
+
+#include "profile_store.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Sys { class Backend; }
+
+namespace Tweaks {
+
+    class Scheduler {
+    public:
+        struct Task {
+            Id                    id;
+            bool                  on;
+            uint32_t              timeoutMs;
+            std::vector<uint16_t> after;        // plan indices that must finish first
+        };
+        using Plan = std::vector<Task>;
+
+        struct Job {
+            uint64_t                ticket = 0;
+            std::vector<StepResult> results;    // index-aligned with the plan
+            bool                    failed = false;
+            double                  ms     = 0.0;   // wall time
+            unsigned                peak   = 0;     // most steps in flight at once
+        };
+
+        static Plan BuildPlan(const std::vector<std::pair<Id, bool>>& steps);
+
+        // workers 0: one per tweak
+        explicit Scheduler(Sys::Backend& be, unsigned workers = 0);
+        ~Scheduler();
+        Scheduler(const Scheduler&)            = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        // false while a job runs or its result hasn't been collected.  With
+        // stopOnFailure nothing new starts after a failed / timed-out step;
+        // steps that never ran report Cancelled.
+        bool Start(Plan plan, bool stopOnFailure, uint64_t ticket);
+        // Step results since the last call; true (and `done` filled) once the
+        // job has finished — the scheduler is free again after that
+        bool Poll(std::vector<StepResult>& steps, Job& done);
+        // Block until Poll() has something (or nothing is running)
+        void Wait();
+        bool Busy() const;
+
+        unsigned Workers() const { return (unsigned)m_threads.size(); }
+        void     SetWakeHook(void (*fn)(void*), void* ctx);
+
+    private:
+        void Worker();
+
+        Sys::Backend&                         m_be;
+        mutable std::mutex                    m_mx;
+        std::condition_variable               m_cv;        // workers: ready steps / quit
+        std::condition_variable               m_doneCv;    // Wait(): events / finished
+        std::vector<std::thread>              m_threads;
+
+        Plan                                  m_plan;
+        std::vector<std::vector<uint16_t>>    m_dependents;
+        std::vector<uint16_t>                 m_waiting;   // unfinished prerequisites per step
+        std::deque<uint16_t>                  m_ready;
+        std::vector<StepResult>               m_events;
+        Job                                   m_job;
+        std::chrono::steady_clock::time_point m_t0;
+        unsigned                              m_running  = 0;
+        bool                                  m_stopOnFailure = false;
+        bool                                  m_halt     = false;
+        bool                                  m_busy     = false;
+        bool                                  m_finished = false;
+        bool                                  m_quit     = false;
+        void                                (*m_hook)(void*) = nullptr;
+        void*                                 m_hookCtx  = nullptr;
+    };
+
+    class Switcher {
+    public:
+        struct Outcome {
+            uint64_t               ticket = 0;
+            std::string            name;        // profile name; "" for one-off toggles
+            ProfileStore::TxResult tx;
+            double                 ms     = 0.0;    // queued → committed / rolled back
+            unsigned               peak   = 0;
+        };
+
+        Switcher(ProfileStore& store, Sys::Backend& be, unsigned workers = 0);
+
+        // Queued; transactions run one at a time, in order.  Switch() returns
+        // 0 for an unknown profile.
+        uint64_t Apply(Profile p);
+        uint64_t Switch(const std::string& name);
+
+        // Owner thread, e.g. once per frame: starts the next transaction,
+        // commits or rolls back a finished one.  `progress` receives forward
+        // step results as they complete.
+        void Update(std::vector<Outcome>& done, std::vector<StepResult>* progress = nullptr);
+        bool Busy() const { return m_phase != Phase::Idle || !m_queue.empty(); }
+
+        // Blocking: queue, drive Update() until this transaction is done.
+        // For callers with nothing else queued — other outcomes are dropped.
+        Outcome Run(Profile p, const std::function<void(const StepResult&)>& onStep = {});
+
+        Scheduler&    Pool()  { return m_sched; }
+        ProfileStore& Store() { return m_store; }
+        void SetWakeHook(void (*fn)(void*), void* ctx) { m_sched.SetWakeHook(fn, ctx); }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+        enum class Phase { Idle, Forward, Rollback };
+        struct Pending { uint64_t ticket; Profile p; Clock::time_point queued; };
+
+        void StartNext(std::vector<Outcome>& done);
+        void Finish(std::vector<Outcome>& done);
+
+        ProfileStore&          m_store;
+        Sys::Backend&          m_be;
+        Scheduler              m_sched;
+        std::deque<Pending>    m_queue;
+        Pending                m_cur{};
+        ProfileStore::TxResult m_tx;
+        Phase                  m_phase = Phase::Idle;
+        unsigned               m_peak  = 0;
+        uint64_t               m_next  = 1;
+    };
+
+}  // namespace Tweaks
@@ -0,0 +1,646 @@
+#include "clean_index.h"
+#include "profiler.h"
+#include "work_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Cleaner {
+
+    using Clock = std::chrono::steady_clock;
+
+    // ── NameArena ─────────────────────────────────────────────────────────────
+    uint32_t NameArena::Add(const Char* s, size_t len) {
+        len = std::min(len, kMaxLen);
+        if (m_used + len + 1 > kBlockChars) {
+            m_blocks.emplace_back(new Char[kBlockChars]);
+            m_used = 0;
+        }
+        Char*    dst = m_blocks.back().get() + m_used;
+        uint32_t h   = ((uint32_t)(m_blocks.size() - 1) << 16) | m_used;
+        std::memcpy(dst, s, len * sizeof(Char));
+        dst[len] = 0;
+        m_used += (uint32_t)len + 1;
+        return h;
+    }
+
+    // ── Helpers ───────────────────────────────────────────────────────────────
+    // Leaf component of a native path without building a temporary fs::path
+    static const NameArena::Char* Leaf(const fs::path::string_type& s, size_t& len) {
+#ifdef _WIN32
+        size_t p = s.find_last_of(L"\\/");
+#else
+        size_t p = s.find_last_of('/');
+#endif
+        size_t b = (p == fs::path::string_type::npos) ? 0 : p + 1;
+        len = s.size() - b;
+        return s.data() + b;
+    }
+
+    // file_time_type → Unix seconds (C++17 has no clock_cast)
+    struct TimeBase {
+        fs::file_time_type                    fnow = fs::file_time_type::clock::now();
+        std::chrono::system_clock::time_point snow = std::chrono::system_clock::now();
+
+        uint32_t ToUnix(fs::file_time_type ft) const {
+            auto d = std::chrono::duration_cast<std::chrono::system_clock::duration>(ft - fnow);
+            auto t = std::chrono::system_clock::to_time_t(snow + d);
+            return t < 0 ? 0u : (uint32_t)t;
+        }
+        uint32_t Now() const { return (uint32_t)std::chrono::system_clock::to_time_t(snow); }
+    };
+
+    static bool StatEntry(const fs::directory_entry& e, const TimeBase& tb,
+                          uint64_t& size, uint32_t& mtime) {
+#ifdef _WIN32
+        // MSVC caches size + mtime from FindNextFileW — no extra syscall
+        std::error_code ec;
+        size  = e.file_size(ec);
+        if (ec) size = 0;
+        auto ft = e.last_write_time(ec);
+        mtime = ec ? 0u : tb.ToUnix(ft);
+        return true;
+#else
+        (void)tb;
+        struct stat st{};
+        if (::lstat(e.path().c_str(), &st) != 0) return false;
+        size  = (uint64_t)st.st_size;
+        mtime = st.st_mtime < 0 ? 0u : (uint32_t)st.st_mtime;
+        return true;
+#endif
+    }
+
+#ifdef _WIN32
+    // In use by another process (sharing violation) or no DELETE access
+    static bool ProbeLocked(const fs::path& p) {
+        HANDLE h = CreateFileW(p.c_str(), DELETE,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               nullptr, OPEN_EXISTING, FILE_FLAG_OPEN_REPARSE_POINT, nullptr);
+        if (h == INVALID_HANDLE_VALUE) return true;
+        CloseHandle(h);
+        return false;
+    }
+
+    // Delete-on-close for an open handle; read-only files too, like fs::remove
+    static bool MarkDeleted(HANDLE h) {
+#ifdef FILE_DISPOSITION_FLAG_DELETE
+        FILE_DISPOSITION_INFO_EX ex{ FILE_DISPOSITION_FLAG_DELETE | FILE_DISPOSITION_FLAG_POSIX_SEMANTICS |
+                                     FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE };
+        if (SetFileInformationByHandle(h, FileDispositionInfoEx, &ex, sizeof(ex))) return true;
+#endif
+        FILE_DISPOSITION_INFO di{ TRUE };     // before Windows 10 1809
+        return SetFileInformationByHandle(h, FileDispositionInfo, &di, sizeof(di)) != FALSE;
+    }
+#else
+    // POSIX unlink only needs write+search permission on the parent directory
+    static bool DirWritable(const fs::path& dir) {
+        return ::access(dir.c_str(), W_OK | X_OK) == 0;
+    }
+#endif
+
+    template <class Fn>
+    static void ParallelFor(unsigned threads, size_t count, Fn&& fn) {
+        std::atomic<size_t> next{ 0 };
+        auto body = [&](unsigned self) {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; )
+                fn(self, i);
+        };
+        threads = (unsigned)std::max<size_t>(1, std::min<size_t>(threads, count));
+        std::vector<std::thread> workers;
+        for (unsigned w = 1; w < threads; w++)
+            workers.emplace_back([&body](unsigned self) {
+                Prof::SetThreadName("clean worker");
+                body(self);
+            }, w);
+        body(0);
+        for (auto& th : workers) th.join();
+    }
+
+    // ── Pinned directory chains ───────────────────────────────────────────────
+    // Commit() never deletes through a path string built at scan time: a
+    // directory swapped for a symlink or junction in between would be
+    // followed.  Each worker holds its directory open one component at a
+    // time from the root (the caller's, trusted), refusing anything that is
+    // no longer a plain directory, and deletes relative to that.  POSIX:
+    // openat(O_NOFOLLOW) + unlinkat.  Windows: every level is held without
+    // FILE_SHARE_DELETE, so nothing in the chain can be renamed or replaced
+    // while it is open, and reparse points are refused.
+#ifdef _WIN32
+    using DirHandle = HANDLE;
+    static const DirHandle kNoDir = INVALID_HANDLE_VALUE;
+    static void CloseDir(DirHandle h) { CloseHandle(h); }
+#else
+    using DirHandle = int;
+    static constexpr DirHandle kNoDir = -1;
+    static void CloseDir(DirHandle h) { ::close(h); }
+#endif
+
+    struct DirTable {
+        const std::vector<DirEntry>& dirs;
+        const NameArena&             names;
+        const std::vector<fs::path>& paths;
+    };
+
+    class DirChain {
+    public:
+        DirChain() = default;
+        DirChain(const DirChain&)            = delete;
+        DirChain& operator=(const DirChain&) = delete;
+        ~DirChain() { Truncate(0); }
+
+        // `dir` held open, reusing the levels shared with the last call;
+        // kNoDir if any level is gone or no longer a plain directory
+        DirHandle Open(const DirTable& t, uint32_t dir) {
+            if (!m_ids.empty() && m_ids.back() == dir) return m_open.back();
+            m_want.clear();
+            for (uint32_t d = dir; d != DirEntry::kNoParent; d = t.dirs[d].parent) m_want.push_back(d);
+            std::reverse(m_want.begin(), m_want.end());
+            size_t keep = 0;
+            while (keep < m_ids.size() && keep < m_want.size() && m_ids[keep] == m_want[keep]) keep++;
+            Truncate(keep);
+            for (size_t k = keep; k < m_want.size(); k++) {
+                const DirHandle h = OpenLevel(t, m_want[k], k ? m_open[k - 1] : kNoDir);
+                if (h == kNoDir) return kNoDir;
+                m_ids.push_back(m_want[k]);
+                m_open.push_back(h);
+            }
+            return m_open.back();
+        }
+
+    private:
+        static DirHandle OpenLevel(const DirTable& t, uint32_t id, DirHandle parent) {
+            const bool root = parent == kNoDir;
+#ifdef _WIN32
+            HANDLE h = CreateFileW(t.paths[id].c_str(), FILE_LIST_DIRECTORY | FILE_READ_ATTRIBUTES,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                   FILE_FLAG_BACKUP_SEMANTICS | (root ? 0 : FILE_FLAG_OPEN_REPARSE_POINT), nullptr);
+            if (h == INVALID_HANDLE_VALUE) return kNoDir;
+            BY_HANDLE_FILE_INFORMATION bi{};
+            if (!GetFileInformationByHandle(h, &bi) || !(bi.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ||
+                (!root && (bi.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))) {
+                CloseHandle(h);
+                return kNoDir;
+            }
+            return h;
+#else
+            if (root) return ::open(t.paths[id].c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            return ::openat(parent, t.names.Get(t.dirs[id].name), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+#endif
+        }
+
+        void Truncate(size_t keep) {
+            while (m_open.size() > keep) { CloseDir(m_open.back()); m_open.pop_back(); m_ids.pop_back(); }
+        }
+
+        std::vector<uint32_t>  m_ids, m_want;
+        std::vector<DirHandle> m_open;
+    };
+
+    // Delete `name` inside the held directory `dir` if it is still what the
+    // scan saw: not a directory, and `size` bytes long
+    static bool RemoveFileAt(DirHandle dir, const fs::path& dirPath, const NameArena::Char* name, uint64_t size) {
+#ifdef _WIN32
+        (void)dir;      // the chain pins dirPath; the handle is only held
+        HANDLE h = CreateFileW((dirPath / name).c_str(), DELETE | FILE_READ_ATTRIBUTES,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_OPEN_REPARSE_POINT, nullptr);
+        if (h == INVALID_HANDLE_VALUE) return false;
+        BY_HANDLE_FILE_INFORMATION bi{};
+        bool ok = GetFileInformationByHandle(h, &bi) && !(bi.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                  (((uint64_t)bi.nFileSizeHigh << 32) | bi.nFileSizeLow) == size;
+        if (ok) ok = MarkDeleted(h);
+        CloseHandle(h);
+        return ok;
+#else
+        (void)dirPath;
+        struct stat st{};
+        if (::fstatat(dir, name, &st, AT_SYMLINK_NOFOLLOW) != 0) return false;
+        if (S_ISDIR(st.st_mode) || (uint64_t)st.st_size != size) return false;
+        return ::unlinkat(dir, name, 0) == 0;
+#endif
+    }
+
+    // rmdir of `name` inside the held directory `parent`, if it is still a
+    // plain directory (never a link to one) and empty
+    static bool RemoveDirAt(DirHandle parent, const fs::path& path, const NameArena::Char* name) {
+#ifdef _WIN32
+        (void)parent; (void)name;
+        HANDLE h = CreateFileW(path.c_str(), DELETE | FILE_READ_ATTRIBUTES,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT, nullptr);
+        if (h == INVALID_HANDLE_VALUE) return false;
+        BY_HANDLE_FILE_INFORMATION bi{};
+        bool ok = GetFileInformationByHandle(h, &bi) && (bi.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                  !(bi.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT);
+        if (ok) ok = MarkDeleted(h);    // fails on a directory that isn't empty
+        CloseHandle(h);
+        return ok;
+#else
+        (void)path;
+        struct stat st{};
+        if (::fstatat(parent, name, &st, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISDIR(st.st_mode)) return false;
+        return ::unlinkat(parent, name, AT_REMOVEDIR) == 0;
+#endif
+    }
+
+    // ── Index ─────────────────────────────────────────────────────────────────
+    uint64_t Index::FileCount() const {
+        uint64_t n = 0;
+        for (auto& sh : m_shards) n += sh.files.size();
+        return n;
+    }
+
+    uint64_t Index::ReclaimableBytes() const {
+        uint64_t b = 0;
+        for (auto& r : m_roots) b += r.bytes;
+        return b;
+    }
+
+    size_t Index::MemoryBytes() const {
+        size_t b = m_dirNames.Bytes() + m_dirs.capacity() * sizeof(DirEntry);
+        for (auto& sh : m_shards)
+            b += sh.names.Bytes() + sh.files.capacity() * sizeof(FileEntry);
+        return b;
+    }
+
+    fs::path Index::DirPath(uint32_t dir) const {
+        std::vector<uint32_t> chain;
+        for (uint32_t d = dir; d != DirEntry::kNoParent; d = m_dirs[d].parent) chain.push_back(d);
+        fs::path p;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) p /= m_dirNames.Get(m_dirs[*it].name);
+        return p;
+    }
+
+    // Parents are always registered before their children, so one forward pass
+    std::vector<fs::path> Index::DirPaths() const {
+        std::vector<fs::path> out(m_dirs.size());
+        for (size_t i = 0; i < m_dirs.size(); i++) {
+            const DirEntry& d = m_dirs[i];
+            out[i] = d.parent == DirEntry::kNoParent
+                   ? fs::path(m_dirNames.Get(d.name))
+                   : out[d.parent] / m_dirNames.Get(d.name);
+        }
+        return out;
+    }
+
+    void Index::Clear() {
+        m_shards.clear();
+        m_dirNames.Clear();
+        m_dirs.clear();
+        m_roots.clear();
+        m_scanSeconds = 0.0;
+    }
+
+    // ── Scan ──────────────────────────────────────────────────────────────────
+    struct ScanTask {
+        uint32_t dir   = 0;
+        uint16_t root  = 0;
+        uint16_t depth = 0;
+        uint32_t jid   = Journal::kNone;   // matching journal record, if any
+        fs::path path;
+    };
+
+    Index Scan(const std::vector<fs::path>& roots, const Options& opt, const Journal* journal) {
+        XOPT_ZONE("Clean::Scan");
+        auto     t0 = Clock::now();
+        TimeBase tb;
+        Index    idx;
+        idx.m_roots.resize(roots.size());
+
+        std::map<uint64_t, std::unique_ptr<DeviceGate>> gates;
+        std::vector<DeviceGate*>                       rootGate(roots.size(), nullptr);
+        std::vector<ScanTask>                          seeds;
+
+        for (size_t i = 0; i < roots.size(); i++) {
+            idx.m_roots[i].path = roots[i];
+            std::error_code ec;
+            if (!fs::is_directory(roots[i], ec)) continue;
+            auto& g = gates[DeviceKey(roots[i])];
+            if (!g) { g = std::make_unique<DeviceGate>(); g->cap = std::max(1u, opt.perDeviceCap); }
+            rootGate[i] = g.get();
+
+            DirEntry d;
+            d.name    = idx.m_dirNames.Add(roots[i].c_str(), roots[i].native().size());
+            d.nameLen = (uint16_t)std::min(roots[i].native().size(), NameArena::kMaxLen);
+            d.root    = (uint16_t)i;
+            uint32_t jid = journal ? journal->FindRoot(roots[i]) : Journal::kNone;
+            seeds.push_back({ (uint32_t)idx.m_dirs.size(), (uint16_t)i, 0, jid, roots[i] });
+            idx.m_dirs.push_back(d);
+        }
+        if (seeds.empty()) return idx;
+
+        unsigned n = std::min(255u, PoolSize(opt.threads, gates.size(), opt.perDeviceCap,
+                                             opt.progress != nullptr));
+        idx.m_shards.resize(n);
+
+        const uint16_t run = opt.progress ? opt.progress->BeginRun() : 0;
+        std::vector<Progress::Reporter> rep;
+        for (unsigned w = 0; w < n; w++)
+            rep.emplace_back(opt.progress, w, Progress::Phase::Scan, run, roots.size());
+        if (opt.progress) opt.progress->PushControl(0, { Progress::Event::Begin, Progress::Phase::Scan, 0, run });
+
+        const uint32_t cutoff = opt.minAgeSeconds ? tb.Now() - opt.minAgeSeconds : 0xFFFFFFFFu;
+        // A directory modified within minAgeSeconds is kept even when empty;
+        // its mtime is read now, as Commit()'s own deletions will touch it
+        auto young = [&](int64_t mt) {
+            return opt.minAgeSeconds && tb.ToUnix(fs::file_time_type(fs::file_time_type::duration(mt))) > cutoff;
+        };
+        std::mutex     dirMtx;
+        WorkPool<ScanTask> pool(n);
+        for (size_t i = 0; i < seeds.size(); i++) pool.Push((unsigned)(i % n), std::move(seeds[i]));
+
+        // Register subdirectories in one critical section, then fan out
+        auto fanOut = [&](unsigned self, const ScanTask& t, uint8_t flags, uint32_t deferred,
+                          std::vector<ScanTask>& kids) {
+            {
+                std::lock_guard<std::mutex> lk(dirMtx);
+                idx.m_dirs[t.dir].flags   |= flags;
+                idx.m_dirs[t.dir].deferred = deferred;
+                for (auto& k : kids) {
+                    size_t len;
+                    const NameArena::Char* leaf = Leaf(k.path.native(), len);
+                    DirEntry d;
+                    d.parent  = t.dir;
+                    d.name    = idx.m_dirNames.Add(leaf, len);
+                    d.nameLen = (uint16_t)std::min(len, NameArena::kMaxLen);
+                    d.depth   = k.depth;
+                    d.root    = k.root;
+                    k.dir     = (uint32_t)idx.m_dirs.size();
+                    idx.m_dirs.push_back(d);
+                }
+            }
+            for (auto& k : kids) pool.Push(self, std::move(k));
+        };
+
+        pool.RunAll([&](unsigned self, ScanTask& t) {
+            XOPT_ZONE("Clean::ScanDir");
+            Index::Shard&         sh    = idx.m_shards[self];
+            DeviceGate*           gate  = rootGate[t.root];
+            const uint16_t        depth = (uint16_t)(t.depth + 1);
+            std::vector<ScanTask> kids;
+
+            // Journalled and unchanged: same entries as last run, so only the
+            // recorded subdirectories need a look — no listing, no stats
+            if (t.jid != Journal::kNone) {
+                int64_t mt = 0;
+                gate->Acquire();
+                bool exists = Journal::DirMtime(t.path, mt);
+                gate->Release();
+                if (!exists) { fanOut(self, t, kEntryGone, 0, kids); return; }
+                rep[self].Add(t.root, 0, 1, 0, 0);
+                // Files deferred as too young don't touch the mtime as they
+                // age, so once they're old enough the dir is listed again
+                const JournalDir& jd   = journal->Dir(t.jid);
+                const bool        aged = jd.deferred && jd.deferred <= cutoff;
+                if (!aged && journal->Unchanged(t.jid, mt)) {
+                    for (uint32_t k = jd.firstChild; k < jd.firstChild + jd.childCount; k++) {
+                        const JournalDir& c = journal->Dir(k);
+                        fs::path::string_type leaf(journal->Name(k), c.nameLen);
+                        kids.push_back({ 0, t.root, depth, k, t.path / leaf });
+                    }
+                    fanOut(self, t, jd.entries || young(mt) ? (kEntryClean | kEntryLocked) : kEntryClean,
+                           jd.deferred, kids);
+                    return;
+                }
+            }
+
+            gate->Acquire();
+            const size_t filesBefore = sh.files.size();
+            bool held = false;   // something stays behind → never rmdir this dir
+            uint32_t deferred = 0;
+            if (opt.minAgeSeconds) {
+                int64_t mt = 0;
+                held = Journal::DirMtime(t.path, mt) && young(mt);
+            }
+#ifndef _WIN32
+            const bool dirLocked = opt.probeLocks && !DirWritable(t.path);
+#endif
+            std::error_code ec;
+            fs::directory_iterator it(t.path, ec), end;
+            if (ec) held = true;
+            for (; !ec && it != end; it.increment(ec)) {
+                fs::file_type ft = it->symlink_status(ec).type();
+                size_t len;
+                const NameArena::Char* leaf = Leaf(it->path().native(), len);
+                if (ft == fs::file_type::directory) {
+                    uint32_t jid = t.jid != Journal::kNone ? journal->FindChild(t.jid, leaf, len)
+                                                           : Journal::kNone;
+                    kids.push_back({ 0, t.root, depth, jid, it->path() });
+                    continue;
+                }
+                if (IsSpecial(ft)) { held = true; continue; }
+
+                FileEntry f;
+                if (!StatEntry(*it, tb, f.size, f.mtime)) { held = true; continue; }
+                if (f.mtime > cutoff) { held = true; deferred = std::max(deferred, f.mtime); continue; }
+#ifdef _WIN32
+                if (opt.probeLocks && ProbeLocked(it->path())) f.flags |= kEntryLocked;
+#else
+                if (dirLocked) f.flags |= kEntryLocked;
+#endif
+                if (f.flags & kEntryLocked) held = true;
+
+                f.name    = sh.names.Add(leaf, len);
+                f.nameLen = (uint16_t)std::min(len, NameArena::kMaxLen);
+                f.dir     = t.dir;
+                f.shard   = (uint8_t)self;
+                sh.files.push_back(f);
+            }
+            if (ec) held = true;
+            gate->Release();
+
+            uint64_t found = 0;
+            for (size_t i = filesBefore; i < sh.files.size(); i++) found += sh.files[i].size;
+            rep[self].Add(t.root, (uint32_t)(sh.files.size() - filesBefore), 1, 0, found);
+            fanOut(self, t, held ? kEntryLocked : 0, deferred, kids);
+        });
+
+        // Per-root totals for the UI
+        for (auto& sh : idx.m_shards) {
+            for (auto& f : sh.files) {
+                RootStats& r = idx.m_roots[idx.m_dirs[f.dir].root];
+                if (f.flags & kEntryLocked) { r.lockedFiles++; r.lockedBytes += f.size; }
+                else                        { r.files++;       r.bytes       += f.size; }
+            }
+        }
+        for (auto& d : idx.m_dirs) {
+            if (d.flags & kEntryClean) idx.m_roots[d.root].cleanDirs++;
+            if (d.parent != DirEntry::kNoParent && !(d.flags & kEntryGone)) idx.m_roots[d.root].dirs++;
+        }
+
+        idx.m_scanSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (opt.progress) {
+            Progress::Event e;
+            e.kind  = Progress::Event::End;
+            e.phase = Progress::Phase::Scan;
+            e.run   = run;
+            uint64_t files = 0;
+            for (auto& r : idx.m_roots) { files += r.files + r.lockedFiles; e.bytes += r.bytes + r.lockedBytes; }
+            e.files = (uint32_t)std::min<uint64_t>(files, UINT32_MAX);
+            e.dirs  = (uint32_t)std::min<size_t>(idx.m_dirs.size(), UINT32_MAX);
+            opt.progress->PushControl(0, e);
+        }
+        return idx;
+    }
+
+    // ── Commit ────────────────────────────────────────────────────────────────
+    std::vector<Result> Commit(Index& idx, const Options& opt, Journal* journal) {
+        XOPT_ZONE("Clean::Commit");
+        auto t0 = Clock::now();
+        const size_t nRoots = idx.m_roots.size();
+        std::vector<Result> out(nRoots);
+        if (idx.Empty()) return out;
+
+        std::map<uint64_t, std::unique_ptr<DeviceGate>> gates;
+        std::vector<DeviceGate*>                       rootGate(nRoots, nullptr);
+        for (size_t r = 0; r < nRoots; r++) {
+            auto& g = gates[DeviceKey(idx.m_roots[r].path)];
+            if (!g) { g = std::make_unique<DeviceGate>(); g->cap = std::max(1u, opt.perDeviceCap); }
+            rootGate[r] = g.get();
+        }
+        const unsigned n = PoolSize(opt.threads, gates.size(), opt.perDeviceCap, opt.progress != nullptr);
+        const std::vector<fs::path> dirPaths = idx.DirPaths();
+        const int lowest = opt.removeRoot ? 0 : 1;
+
+        const uint16_t run = opt.progress ? opt.progress->BeginRun() : 0;
+        std::vector<Progress::Reporter> rep;
+        for (unsigned w = 0; w < n; w++)
+            rep.emplace_back(opt.progress, w, Progress::Phase::Commit, run, nRoots);
+        if (opt.progress) {
+            Progress::Event e{ Progress::Event::Begin, Progress::Phase::Commit, 0, run };
+            e.total = idx.FileCount();
+            for (auto& d : idx.m_dirs)
+                if (d.depth >= lowest && !(d.flags & kEntryGone)) e.total++;
+            opt.progress->PushControl(0, e);
+        }
+
+        struct Acc { uint64_t files = 0, dirs = 0, errors = 0, bytes = 0; };
+        std::vector<std::vector<Acc>> acc(n, std::vector<Acc>(nRoots));
+        std::vector<std::vector<uint32_t>> failedDirs(n);
+
+        // Files: fixed-size chunks over every shard, pulled by an atomic cursor
+        struct Chunk { uint32_t shard; size_t begin, end; };
+        std::vector<Chunk> chunks;
+        const size_t batch = std::max<size_t>(1, opt.batchSize);
+        for (uint32_t s = 0; s < idx.m_shards.size(); s++)
+            for (size_t b = 0; b < idx.m_shards[s].files.size(); b += batch)
+                chunks.push_back({ s, b, std::min(b + batch, idx.m_shards[s].files.size()) });
+
+        const DirTable table{ idx.m_dirs, idx.m_dirNames, dirPaths };
+        std::vector<DirChain> chains(n);
+        ParallelFor(n, chunks.size(), [&](unsigned self, size_t ci) {
+            XOPT_ZONE("Clean::Unlink");
+            const Chunk&         c  = chunks[ci];
+            const Index::Shard&  sh = idx.m_shards[c.shard];
+            DeviceGate*          held = nullptr;
+            for (size_t i = c.begin; i < c.end; i++) {
+                const FileEntry& f = sh.files[i];
+                const uint16_t   r = idx.m_dirs[f.dir].root;
+                Acc&             a = acc[self][r];
+                if (f.flags & kEntryLocked) { a.errors++; rep[self].Add(r, 0, 0, 1, 0); continue; }
+                if (held != rootGate[r]) {
+                    if (held) held->Release();
+                    held = rootGate[r];
+                    held->Acquire();
+                }
+                const DirHandle dir = chains[self].Open(table, f.dir);
+                if (dir != kNoDir && RemoveFileAt(dir, dirPaths[f.dir], sh.names.Get(f.name), f.size)) {
+                    a.files++; a.bytes += f.size;
+                    rep[self].Add(r, 1, 0, 0, f.size);
+                } else {
+                    a.errors++;
+                    failedDirs[self].push_back(f.dir);
+                    rep[self].Add(r, 0, 0, 1, 0);
+                }
+            }
+            if (held) held->Release();
+        });
+        chains.clear();                         // nothing held open while dirs go
+        // Directories: anything still holding a file pins all its ancestors
+        for (auto& v : failedDirs)
+            for (uint32_t d : v) idx.m_dirs[d].flags |= kEntryLocked;
+        uint16_t maxDepth = 0;
+        for (auto& d : idx.m_dirs) maxDepth = std::max(maxDepth, d.depth);
+        std::vector<std::vector<uint32_t>> levels(maxDepth + 1u);
+        for (uint32_t i = 0; i < idx.m_dirs.size(); i++) levels[idx.m_dirs[i].depth].push_back(i);
+        for (int depth = maxDepth; depth > 0; depth--)
+            for (uint32_t i : levels[depth])
+                if (idx.m_dirs[i].flags & kEntryLocked)
+                    idx.m_dirs[idx.m_dirs[i].parent].flags |= kEntryLocked;
+
+        std::vector<uint8_t> removed(idx.m_dirs.size(), 0);   // one writer per slot
+        for (int depth = maxDepth; depth >= lowest; depth--) {
+            XOPT_ZONE("Clean::RemoveDirs");
+            const auto& lv = levels[depth];
+            std::vector<DirChain> parents(n);   // a level's parents, closed before they go
+            ParallelFor(n, lv.size(), [&](unsigned self, size_t k) {
+                const DirEntry& d = idx.m_dirs[lv[k]];
+                if (d.flags & kEntryGone) return;
+                if (d.flags & kEntryLocked) { rep[self].Add(d.root, 0, 0, 1, 0); return; }
+                DeviceGate* g = rootGate[d.root];
+                g->Acquire();
+                bool ok;
+                if (d.parent == DirEntry::kNoParent) {
+                    std::error_code ec;
+                    ok = fs::remove(dirPaths[lv[k]], ec) && !ec;
+                } else {
+                    const DirHandle p = parents[self].Open(table, d.parent);
+                    ok = p != kNoDir && RemoveDirAt(p, dirPaths[lv[k]], idx.m_dirNames.Get(d.name));
+                }
+                g->Release();
+                if (ok) { acc[self][d.root].dirs++; removed[lv[k]] = 1; rep[self].Add(d.root, 0, 1, 0, 0); }
+                else    { acc[self][d.root].errors++;               rep[self].Add(d.root, 0, 0, 1, 0); }
+            });
+        }
+
+        // Whatever survived is what the next incremental Scan() will stat
+        if (journal) {
+            std::vector<fs::path> keep;
+            std::vector<uint32_t> parent, deferred, slot(idx.m_dirs.size(), Journal::kNone);
+            for (uint32_t i = 0; i < idx.m_dirs.size(); i++) {
+                const DirEntry& d = idx.m_dirs[i];
+                if (removed[i] || (d.flags & kEntryGone)) continue;
+                uint32_t p = Journal::kNone;
+                if (d.parent != DirEntry::kNoParent) {
+                    p = slot[d.parent];
+                    if (p == Journal::kNone) continue;   // parent vanished underneath us
+                }
+                slot[i] = (uint32_t)keep.size();
+                keep.push_back(dirPaths[i]);
+                parent.push_back(p);
+                deferred.push_back(d.deferred);
+            }
+            journal->Capture(keep, parent, deferred);
+        }
+
+        const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        for (size_t r = 0; r < nRoots; r++) {
+            for (unsigned w = 0; w < n; w++) {
+                out[r].filesRemoved += acc[w][r].files;
+                out[r].dirsRemoved  += acc[w][r].dirs;
+                out[r].errors       += acc[w][r].errors;
+                out[r].bytesFreed   += acc[w][r].bytes;
+            }
+            out[r].seconds = secs;
+        }
+        if (opt.progress) opt.progress->PushControl(0, EndEvent(Progress::Phase::Commit, run, out));
+        idx.Clear();
+        return out;
+    }
+
+}  // namespace Cleaner
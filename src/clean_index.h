@@ -0,0 +1,131 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  CLEAN INDEX  —  dry-run scan of cleaner roots, committed without a rewalk
+// ──────────────────────────────────────────────────────────────────────────────
+//  Scan() walks the roots once on the work-stealing pool and records every
+//  candidate (size, mtime, locked flag) in a flat table.  Names live in a
+//  chunked arena and each entry stores only its leaf name plus a parent
+//  directory id, so ~1M entries cost roughly 24 B + name length apiece.
+//  Commit() deletes straight from the table: files in parallel batches, then
+//  directories bottom-up by depth.  It deletes relative to directories it
+//  holds open, re-checking each entry's type and size first, so a directory
+//  swapped for a link after the scan is refused rather than followed.
+//  Directories modified within minAgeSeconds are kept, like young files.
+#pragma once
+
+#include "cleaner.h"
+#include "clean_journal.h"
+
+#include <memory>
+
+namespace Cleaner {
+
+    // ── Chunked string arena ──────────────────────────────────────────────────
+    // Strings never move once written; handle = (block << 16) | offset.
+    class NameArena {
+    public:
+        using Char = fs::path::value_type;
+        static constexpr uint32_t kBlockChars = 1u << 16;
+        static constexpr size_t   kMaxLen     = 4096;
+
+        uint32_t    Add(const Char* s, size_t len);
+        const Char* Get(uint32_t h) const {
+            return m_blocks[h >> 16].get() + (h & 0xFFFFu);
+        }
+        size_t      Bytes() const { return m_blocks.size() * kBlockChars * sizeof(Char); }
+        void        Clear()       { m_blocks.clear(); m_used = kBlockChars; }
+
+    private:
+        std::vector<std::unique_ptr<Char[]>> m_blocks;
+        uint32_t                             m_used = kBlockChars;
+    };
+
+    enum EntryFlags : uint8_t {
+        kEntryLocked = 1 << 0,   // in use / no delete access — Commit() skips it
+        kEntryClean  = 1 << 1,   // dir unchanged since the journal — not listed
+        kEntryGone   = 1 << 2,   // journalled dir no longer exists
+    };
+
+    struct FileEntry {           // 24 bytes
+        uint64_t size    = 0;
+        uint32_t mtime   = 0;    // seconds since Unix epoch
+        uint32_t dir     = 0;    // index into the directory table
+        uint32_t name    = 0;    // handle into the owning shard's arena
+        uint16_t nameLen = 0;
+        uint8_t  flags   = 0;
+        uint8_t  shard   = 0;
+    };
+
+    struct DirEntry {
+        static constexpr uint32_t kNoParent = 0xFFFFFFFFu;
+        uint32_t parent  = kNoParent;
+        uint32_t name    = 0;    // roots store their full path here
+        uint16_t nameLen = 0;
+        uint16_t depth   = 0;
+        uint16_t root    = 0;
+        uint8_t  flags   = 0;
+        uint32_t deferred = 0;   // newest file skipped for minAgeSeconds (Unix s), for the journal
+    };
+
+    struct RootStats {
+        fs::path path;
+        uint64_t files       = 0;
+        uint64_t dirs        = 0;
+        uint64_t bytes       = 0;   // reclaimable (unlocked) bytes
+        uint64_t lockedFiles = 0;
+        uint64_t lockedBytes = 0;
+        uint64_t cleanDirs   = 0;   // skipped via the journal
+    };
+
+    class Index {
+    public:
+        const std::vector<RootStats>& Roots() const { return m_roots; }
+
+        bool     Empty()            const { return m_dirs.empty(); }
+        uint64_t FileCount()        const;
+        uint64_t DirCount()         const { return m_dirs.size(); }
+        uint64_t ReclaimableBytes() const;
+        size_t   MemoryBytes()      const;
+        double   ScanSeconds()      const { return m_scanSeconds; }
+
+        fs::path DirPath(uint32_t dir) const;
+        void     Clear();
+
+        // fn(const FileEntry&, const fs::path& dirPath, const NameArena::Char* name)
+        template <class Fn>
+        void ForEachFile(Fn&& fn) const {
+            std::vector<fs::path> dirPaths = DirPaths();
+            for (auto& sh : m_shards)
+                for (auto& f : sh.files)
+                    fn(f, dirPaths[f.dir], sh.names.Get(f.name));
+        }
+
+    private:
+        friend Index Scan(const std::vector<fs::path>&, const Options&, const Journal*);
+        friend std::vector<Result> Commit(Index&, const Options&, Journal*);
+
+        struct Shard {
+            NameArena              names;
+            std::vector<FileEntry> files;
+        };
+
+        std::vector<fs::path> DirPaths() const;
+
+        std::vector<Shard>     m_shards;
+        NameArena              m_dirNames;
+        std::vector<DirEntry>  m_dirs;
+        std::vector<RootStats> m_roots;
+        double                 m_scanSeconds = 0.0;
+    };
+
+    // Dry run: index every candidate under `roots` without touching anything.
+    // With a journal, directories unchanged since the last commit are skipped.
+    Index Scan(const std::vector<fs::path>& roots, const Options& opt = {},
+               const Journal* journal = nullptr);
+
+    // Delete everything recorded in `idx` (locked entries are skipped and
+    // counted as errors).  Results are per root, in Scan() order.  Clears idx.
+    // With a journal, the surviving directories are captured into it.
+    std::vector<Result> Commit(Index& idx, const Options& opt = {},
+                               Journal* journal = nullptr);
+
+}  // namespace Cleaner
@@ -0,0 +1,172 @@
+#include "clean_journal.h"
+#include "mapped_file.h"
+
+#include <cstring>
+
+namespace Cleaner {
+
+    static const char kMagic[4] = { 'X', 'O', 'J', '1' };
+
+    // A leaf name read back from disk may only name an entry in its parent:
+    // Scan() appends it to a path that Commit() deletes under
+    static bool ValidLeaf(const Journal::Char* s, uint32_t len) {
+        if (len == 0 || (s[0] == '.' && (len == 1 || (len == 2 && s[1] == '.')))) return false;
+        for (uint32_t i = 0; i < len; i++) {
+            if (s[i] == 0 || s[i] == '/') return false;
+#ifdef _WIN32
+            if (s[i] == '\\' || s[i] == ':') return false;   // separators, drive / stream names
+#endif
+        }
+        return true;
+    }
+
+    bool Journal::DirMtime(const fs::path& dir, int64_t& mtime) {
+        std::error_code ec;
+        auto ft = fs::last_write_time(dir, ec);
+        if (ec) return false;
+        mtime = (int64_t)ft.time_since_epoch().count();
+        return true;
+    }
+
+    void Journal::Adopt(const JournalDir* dirs, uint32_t count, uint32_t roots,
+                        const Char* names, uint64_t namesLen, int64_t written) {
+        m_dirs     = dirs;
+        m_count    = count;
+        m_roots    = roots;
+        m_names    = names;
+        m_namesLen = namesLen;
+        m_written  = written;
+    }
+
+    void Journal::Clear() {
+        m_map.Close();
+        m_ownDirs.clear();
+        m_ownNames.clear();
+        Adopt(nullptr, 0, 0, nullptr, 0, 0);
+    }
+
+    bool Journal::Load(const fs::path& file) {
+        Clear();
+        if (!m_map.Open(file)) return false;
+
+        const uint8_t* p = m_map.Data();
+        const size_t   n = m_map.Size();
+        JournalHeader  h;
+        if (n < sizeof(h)) { Clear(); return false; }
+        std::memcpy(&h, p, sizeof(h));
+        if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion ||
+            h.charSize != sizeof(Char) || h.rootCount > h.dirCount) { Clear(); return false; }
+
+        const uint64_t need = sizeof(h) + (uint64_t)h.dirCount * sizeof(JournalDir)
+                            + h.namesChars * sizeof(Char);
+        if (need != n) { Clear(); return false; }
+
+        // Records are read in place from the mapping — no copy, no parse
+        auto* dirs  = reinterpret_cast<const JournalDir*>(p + sizeof(h));
+        auto* names = reinterpret_cast<const Char*>(p + sizeof(h) + h.dirCount * sizeof(JournalDir));
+        // Corrupt or tampered records are refused outright, and the caller
+        // falls back to a full scan: names stay leaves, every parent comes
+        // before its children and children point back at it, so the tree
+        // has no cycles and no shared subtrees
+        for (uint32_t i = 0; i < h.dirCount; i++) {
+            const JournalDir& d = dirs[i];
+            bool ok = (uint64_t)d.nameOff + d.nameLen <= h.namesChars && d.nameLen > 0;
+            if (ok && i < h.rootCount) ok = d.parent == kNone;
+            else if (ok)               ok = d.parent < i && ValidLeaf(names + d.nameOff, d.nameLen);
+            if (ok && d.childCount)
+                ok = d.firstChild > i && (uint64_t)d.firstChild + d.childCount <= h.dirCount;
+            for (uint32_t c = d.firstChild; ok && c < d.firstChild + d.childCount; c++) ok = dirs[c].parent == i;
+            if (!ok) { Clear(); return false; }
+        }
+        Adopt(dirs, h.dirCount, h.rootCount, names, h.namesChars, h.written);
+        return true;
+    }
+
+    bool Journal::Save(const fs::path& file) const {
+        JournalHeader h{};
+        std::memcpy(h.magic, kMagic, 4);
+        h.version    = kVersion;
+        h.charSize   = (uint16_t)sizeof(Char);
+        h.dirCount   = m_count;
+        h.rootCount  = m_roots;
+        h.written    = m_written;
+        h.namesChars = m_namesLen;
+
+        std::vector<uint8_t> buf(sizeof(h) + m_count * sizeof(JournalDir) + m_namesLen * sizeof(Char));
+        std::memcpy(buf.data(), &h, sizeof(h));
+        if (m_count)    std::memcpy(buf.data() + sizeof(h), m_dirs, m_count * sizeof(JournalDir));
+        if (m_namesLen) std::memcpy(buf.data() + sizeof(h) + m_count * sizeof(JournalDir),
+                                    m_names, m_namesLen * sizeof(Char));
+        return IO::WriteFileAtomic(file, buf.data(), buf.size());
+    }
+
+    void Journal::Capture(const std::vector<fs::path>& dirs, const std::vector<uint32_t>& parent,
+                          const std::vector<uint32_t>& deferred) {
+        Clear();
+        const int64_t written = (int64_t)fs::file_time_type::clock::now().time_since_epoch().count();
+
+        // BFS order: roots first, then each directory's children contiguously
+        std::vector<std::vector<uint32_t>> kids(dirs.size());
+        std::vector<uint32_t>              order;
+        for (uint32_t i = 0; i < dirs.size(); i++) {
+            if (parent[i] == kNone) order.push_back(i);
+            else                    kids[parent[i]].push_back(i);
+        }
+        const uint32_t roots = (uint32_t)order.size();
+        std::vector<uint32_t> slot(dirs.size(), kNone);
+        for (size_t q = 0; q < order.size(); q++) {
+            slot[order[q]] = (uint32_t)q;
+            for (uint32_t k : kids[order[q]]) order.push_back(k);
+        }
+
+        m_ownDirs.resize(order.size());
+        for (uint32_t q = 0; q < order.size(); q++) {
+            const uint32_t src = order[q];
+            JournalDir&    d   = m_ownDirs[q];
+            d = JournalDir{};
+            d.parent     = parent[src] == kNone ? kNone : slot[parent[src]];
+            d.childCount = (uint32_t)kids[src].size();
+            d.firstChild = d.childCount ? slot[kids[src].front()] : 0;
+            d.deferred   = deferred[src];
+            if (!DirMtime(dirs[src], d.mtime)) d.mtime = 0;   // 0 never matches → dirty
+
+            std::error_code ec;
+            for (fs::directory_iterator it(dirs[src], ec), end; !ec && it != end; it.increment(ec))
+                d.entries++;
+
+            const auto& nat  = dirs[src].native();
+            size_t      off  = 0;
+            if (d.parent != kNone) {
+                size_t sep = nat.find_last_of(fs::path::preferred_separator);
+                off = (sep == fs::path::string_type::npos) ? 0 : sep + 1;
+            }
+            d.nameOff = (uint32_t)m_ownNames.size();
+            d.nameLen = (uint32_t)(nat.size() - off);
+            m_ownNames.insert(m_ownNames.end(), nat.begin() + off, nat.end());
+        }
+        Adopt(m_ownDirs.data(), (uint32_t)m_ownDirs.size(), roots,
+              m_ownNames.data(), m_ownNames.size(), written);
+    }
+
+    uint32_t Journal::FindRoot(const fs::path& root) const {
+        const auto& nat = root.native();
+        for (uint32_t i = 0; i < m_roots; i++) {
+            const JournalDir& d = m_dirs[i];
+            if (d.nameLen == nat.size() &&
+                std::memcmp(m_names + d.nameOff, nat.data(), d.nameLen * sizeof(Char)) == 0)
+                return i;
+        }
+        return kNone;
+    }
+
+    uint32_t Journal::FindChild(uint32_t dir, const Char* name, size_t len) const {
+        const JournalDir& p = m_dirs[dir];
+        for (uint32_t i = p.firstChild; i < p.firstChild + p.childCount; i++) {
+            const JournalDir& d = m_dirs[i];
+            if (d.nameLen == len && std::memcmp(m_names + d.nameOff, name, len * sizeof(Char)) == 0)
+                return i;
+        }
+        return kNone;
+    }
+
+}  // namespace Cleaner
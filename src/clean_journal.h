@@ -0,0 +1,103 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  CLEAN JOURNAL  —  directory state persisted between cleaner runs
+// ──────────────────────────────────────────────────────────────────────────────
+//  After a commit, every directory that survived (roots + folders pinned by
+//  locked files) is recorded with its mtime and entry count.  The next Scan()
+//  stats those directories instead of listing them: a directory whose mtime
+//  is unchanged has the same entries as last time, so only its journalled
+//  subdirectories are visited.  New subdirectories can only appear in dirty
+//  (re-listed) parents, so nothing is missed.
+//
+//  Files that were locked last run are not retried while their folder stays
+//  unchanged — run a Scan() without a journal for a full pass.  Files that
+//  were skipped as younger than minAgeSeconds are: ageing doesn't touch the
+//  folder's mtime, so the newest one's mtime is recorded and the folder is
+//  listed again once that has aged out.
+//
+//  Load() refuses a journal whose names aren't plain leaf names or whose
+//  tree links aren't strictly forward; the next Scan() is then a full one.
+//
+//  On disk (native endianness, native path chars — not portable across OSes):
+//      JournalHeader | JournalDir[dirCount] | Char names[namesChars]
+//  Records are in BFS order so each directory's children are contiguous.
+#pragma once
+
+#include "cleaner.h"
+#include "mapped_file.h"
+
+namespace Cleaner {
+
+    struct JournalHeader {
+        char     magic[4];          // "XOJ1"
+        uint16_t version;
+        uint16_t charSize;          // sizeof(fs::path::value_type)
+        uint32_t dirCount;
+        uint32_t rootCount;         // the first rootCount records are roots
+        int64_t  written;           // capture time, fs::file_time_type ticks
+        uint64_t namesChars;
+    };
+
+    struct JournalDir {             // 40 bytes
+        int64_t  mtime;             // fs::file_time_type ticks
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t childCount;
+        uint32_t entries;
+        uint32_t nameOff;           // roots: full path, others: leaf name
+        uint32_t nameLen;
+        uint32_t deferred;          // newest file skipped as too young, Unix s; 0: none
+        uint32_t reserved;
+    };
+
+    class Journal {
+    public:
+        using Char = fs::path::value_type;
+        static constexpr uint32_t kNone        = 0xFFFFFFFFu;
+        static constexpr uint16_t kVersion     = 2;
+        // mtimes this close to the capture time are not trusted (coarse FAT
+        // timestamps, or a write racing the capture) — treat them as dirty
+        static constexpr fs::file_time_type::duration kRacyWindow =
+            std::chrono::duration_cast<fs::file_time_type::duration>(std::chrono::seconds(2));
+
+        bool Load(const fs::path& file);          // false: missing / stale / corrupt
+        bool Save(const fs::path& file) const;
+        void Clear();
+
+        // Record the current state of `dirs` (parents precede children;
+        // parent[i] == kNone marks a root) and each one's deferred mtime.
+        // Stats and lists each directory.
+        void Capture(const std::vector<fs::path>& dirs, const std::vector<uint32_t>& parent,
+                     const std::vector<uint32_t>& deferred);
+
+        bool              Empty()    const { return m_count == 0; }
+        uint32_t          DirCount() const { return m_count; }
+        const JournalDir& Dir(uint32_t i) const { return m_dirs[i]; }
+        const Char*       Name(uint32_t i) const { return m_names + m_dirs[i].nameOff; }  // not NUL-terminated
+
+        uint32_t FindRoot(const fs::path& root) const;
+        uint32_t FindChild(uint32_t dir, const Char* name, size_t len) const;
+
+        // Same mtime as recorded, and old enough to be trusted
+        bool Unchanged(uint32_t dir, int64_t mtime) const {
+            return mtime == m_dirs[dir].mtime && mtime < m_written - (int64_t)kRacyWindow.count();
+        }
+
+        static bool DirMtime(const fs::path& dir, int64_t& mtime);
+
+    private:
+        void Adopt(const JournalDir* dirs, uint32_t count, uint32_t roots,
+                   const Char* names, uint64_t namesLen, int64_t written);
+
+        IO::MappedFile          m_map;
+        std::vector<JournalDir> m_ownDirs;        // Capture() storage
+        std::vector<Char>       m_ownNames;
+
+        const JournalDir*       m_dirs      = nullptr;
+        const Char*             m_names     = nullptr;
+        uint32_t                m_count     = 0;
+        uint32_t                m_roots     = 0;
+        uint64_t                m_namesLen  = 0;
+        int64_t                 m_written   = 0;
+    };
+
+}  // namespace Cleaner
@@ -0,0 +1,54 @@
+#include "cleaner.h"
+
+#include "profiler.h"
+#include "work_pool.h"
+
+#include <algorithm>
+#include <map>
+
+#ifdef _WIN32
+#include <cwctype>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace Cleaner {
+
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t DeviceKey(const fs::path& p) {
+#ifdef _WIN32
+        // Volume is identified by its drive letter / UNC share
+        std::wstring rn = p.root_name().native();
+        std::transform(rn.begin(), rn.end(), rn.begin(), ::towlower);
+        return std::hash<std::wstring>{}(rn);
+#else
+        struct stat st{};
+        if (::stat(p.c_str(), &st) != 0) return 0;
+        return (uint64_t)st.st_dev;
+#endif
+    }
+
+    unsigned PoolSize(unsigned requested, size_t devices, unsigned perDeviceCap, bool reporting) {
+        // More workers than device slots would only queue on the gates
+        unsigned hw  = requested ? requested : std::thread::hardware_concurrency();
+        unsigned cap = (unsigned)std::max<size_t>(1, devices) * std::max(1u, perDeviceCap);
+        unsigned n   = std::max(1u, std::min(std::max(1u, hw), cap));
+        // Each reporting worker needs its own SPSC ring
+        return reporting ? std::min(n, Progress::Channel::kProducers) : n;
+    }
+
+    Progress::Event EndEvent(Progress::Phase phase, uint16_t run, const std::vector<Result>& res) {
+        Progress::Event e;
+        e.kind  = Progress::Event::End;
+        e.phase = phase;
+        e.run   = run;
+        uint64_t files = 0, dirs = 0, errors = 0;
+        for (auto& r : res) { files += r.filesRemoved; dirs += r.dirsRemoved; errors += r.errors; e.bytes += r.bytesFreed; }
+        e.files  = (uint32_t)std::min<uint64_t>(files,  UINT32_MAX);
+        e.dirs   = (uint32_t)std::min<uint64_t>(dirs,   UINT32_MAX);
+        e.errors = (uint32_t)std::min<uint64_t>(errors, UINT32_MAX);
+        return e;
+    }
+
+}  // namespace Cleaner
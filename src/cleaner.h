@@ -0,0 +1,45 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  CLEANER ENGINE  —  options and results shared by the clean phases
+// ──────────────────────────────────────────────────────────────────────────────
+//  A clean is Scan() then Commit() (clean_index.h), both spread across a
+//  work-stealing pool (work_pool.h).  Commit deletes relative to open
+//  directory handles and never follows a link, so only it may remove
+//  anything.  Portable C++17 — runs against any root.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "progress.h"
+
+namespace Cleaner {
+
+    namespace fs = std::filesystem;
+
+    struct Options {
+        unsigned threads      = 0;     // 0 = std::thread::hardware_concurrency()
+        unsigned perDeviceCap = 4;     // max workers doing I/O on one device
+        size_t   batchSize    = 256;   // files unlinked per task
+        bool     removeRoot   = false; // false: empty the root, keep the folder
+        Progress::Channel* progress = nullptr;  // live events for a UI (optional)
+
+        // Scan() only
+        bool     probeLocks    = true; // flag files we could not delete right now
+        uint32_t minAgeSeconds = 0;    // skip files modified more recently than this
+    };
+
+    struct Result {
+        uint64_t filesRemoved = 0;
+        uint64_t dirsRemoved  = 0;
+        uint64_t errors       = 0;     // entries that could not be removed (locked, ACL)
+        uint64_t bytesFreed   = 0;     // Commit() only
+        double   seconds      = 0.0;
+
+        uint64_t Items() const { return filesRemoved + dirsRemoved; }
+    };
+
+}  // namespace Cleaner
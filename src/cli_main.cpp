@@ -0,0 +1,24 @@
+// xopt-cli — console entry point for the headless runner (see headless.h)
+#include "headless.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counted here, in their own translation unit, so the replacement
+// operators are never inlined next to the code they measure
+static std::atomic<uint64_t> g_allocs{ 0 };
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept              { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+uint64_t Headless::Allocations() { return g_allocs.load(std::memory_order_relaxed); }
+
+int main(int argc, char** argv) {
+    return Headless::Run(argc, argv);
+}
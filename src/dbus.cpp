@@ -0,0 +1,376 @@
+#ifndef _WIN32
+
+#include "dbus.h"
+#include "backend.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Sys {
+
+    using Tweaks::Error;
+
+    static const char kDefaultSocket[] = "/run/dbus/system_bus_socket";
+    static const int  kDefaultWaitMs   = 5000;
+    static const size_t kMaxMessage    = 1u << 20;     // replies we care about are tiny
+
+    enum : uint8_t { kMethodCall = 1, kMethodReturn = 2, kErrorReply = 3 };
+    enum : uint8_t {
+        kFieldPath = 1, kFieldInterface = 2, kFieldMember = 3, kFieldErrorName = 4,
+        kFieldReplySerial = 5, kFieldDestination = 6, kFieldSignature = 8,
+    };
+
+    namespace {
+
+        // Little-endian marshalling; alignment is relative to the message
+        // start, which is where the buffer starts
+        struct Writer {
+            std::vector<uint8_t> b;
+
+            void Align(size_t n) { while (b.size() % n) b.push_back(0); }
+            void U8(uint8_t v)   { b.push_back(v); }
+            void U32(uint32_t v) {
+                Align(4);
+                for (int i = 0; i < 4; i++) b.push_back((uint8_t)(v >> (8 * i)));
+            }
+            void Patch32(size_t at, uint32_t v) {
+                for (int i = 0; i < 4; i++) b[at + i] = (uint8_t)(v >> (8 * i));
+            }
+            void Str(const std::string& s) {
+                U32((uint32_t)s.size());
+                b.insert(b.end(), s.begin(), s.end());
+                b.push_back(0);
+            }
+            void Sig(const std::string& s) {
+                U8((uint8_t)s.size());
+                b.insert(b.end(), s.begin(), s.end());
+                b.push_back(0);
+            }
+            // Header field: STRUCT(BYTE code, VARIANT value)
+            void Field(uint8_t code, char type, const std::string& v) {
+                Align(8);
+                U8(code);
+                Sig(std::string(1, type));
+                if (type == 'g') Sig(v);
+                else             Str(v);
+            }
+        };
+
+        struct Reader {
+            const uint8_t* p;
+            size_t         n;
+            bool           swap;
+            size_t         pos = 0;
+            bool           ok  = true;
+
+            void Align(size_t a) {
+                pos = (pos + a - 1) / a * a;
+                if (pos > n) ok = false;
+            }
+            uint8_t U8() {
+                if (pos >= n) { ok = false; return 0; }
+                return p[pos++];
+            }
+            uint32_t U32() {
+                Align(4);
+                if (!ok || pos + 4 > n) { ok = false; return 0; }
+                uint32_t v = 0;
+                for (int i = 0; i < 4; i++) v |= (uint32_t)p[pos + (swap ? 3 - i : i)] << (8 * i);
+                pos += 4;
+                return v;
+            }
+            std::string Str() {
+                const uint32_t len = U32();
+                if (!ok || len > n - pos || n - pos - len < 1) { ok = false; return {}; }
+                std::string s((const char*)p + pos, len);
+                pos += len + 1;
+                return s;
+            }
+            std::string Sig() {
+                const uint8_t len = U8();
+                if (!ok || (size_t)len + 1 > n - pos) { ok = false; return {}; }
+                std::string s((const char*)p + pos, len);
+                pos += len + 1;
+                return s;
+            }
+            // One basic value; strings land in *s, integers in *u
+            void Value(char t, std::string* s, uint32_t* u) {
+                switch (t) {
+                    case 'y': { const uint32_t v = U8(); if (u) *u = v; break; }
+                    case 'b': case 'u': case 'i': case 'h': { const uint32_t v = U32(); if (u) *u = v; break; }
+                    case 's': case 'o': { std::string v = Str(); if (s) *s = std::move(v); break; }
+                    case 'g': { std::string v = Sig(); if (s) *s = std::move(v); break; }
+                    default:  ok = false;   // nothing else appears in a header
+                }
+            }
+        };
+
+        Error MapErrorName(const std::string& name) {
+            auto has = [&name](const char* what) { return name.find(what) != std::string::npos; };
+            if (has("AccessDenied") || has("NotAuthorized") || has("InteractiveAuthorizationRequired")
+                || has("AuthFailed"))
+                return Error::Denied;
+            if (has("NoSuchUnit") || has("ServiceUnknown") || has("UnknownObject") || has("UnknownMethod")
+                || has("NameHasNoOwner") || has("LoadFailed"))
+                return Error::NotFound;
+            if (has("NoReply") || has("Timeout") || has("TimedOut")) return Error::TimedOut;
+            return Error::Failed;
+        }
+
+        // "unix:path=/run/dbus/system_bus_socket,guid=…;tcp:…" → first unix entry
+        bool ParseAddress(const char* addr, std::string& path, bool& abstract) {
+            std::string a = addr;
+            for (size_t at = 0; at < a.size(); ) {
+                size_t end = a.find(';', at);
+                if (end == std::string::npos) end = a.size();
+                const std::string entry = a.substr(at, end - at);
+                at = end + 1;
+                if (entry.compare(0, 5, "unix:")) continue;
+                for (size_t k = 5; k < entry.size(); ) {
+                    size_t ke = entry.find(',', k);
+                    if (ke == std::string::npos) ke = entry.size();
+                    const std::string kv = entry.substr(k, ke - k);
+                    k = ke + 1;
+                    const size_t eq = kv.find('=');
+                    if (eq == std::string::npos) continue;
+                    const std::string key = kv.substr(0, eq);
+                    if (key != "path" && key != "abstract") continue;
+                    path.clear();
+                    for (size_t i = eq + 1; i < kv.size(); i++) {
+                        if (kv[i] == '%' && i + 2 < kv.size()) {
+                            path += (char)std::strtol(kv.substr(i + 1, 2).c_str(), nullptr, 16);
+                            i += 2;
+                        } else {
+                            path += kv[i];
+                        }
+                    }
+                    abstract = key == "abstract";
+                    return !path.empty();
+                }
+            }
+            return false;
+        }
+
+    }  // namespace
+
+    DBus::~DBus() {
+        if (m_fd >= 0) ::close(m_fd);
+    }
+
+    void DBus::StartClock() {
+        const Clock::time_point dl = CallDeadline();
+        m_deadline = dl != Clock::time_point{} ? dl : Clock::now() + std::chrono::milliseconds(kDefaultWaitMs);
+        m_timedOut = false;
+    }
+
+    bool DBus::Wait(short events) {
+        for (;;) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - Clock::now()).count();
+            if (left <= 0) { m_timedOut = true; return false; }
+            pollfd pfd{ m_fd, events, 0 };
+            const int r = ::poll(&pfd, 1, (int)left);
+            if (r > 0) return true;
+            if (r < 0 && errno != EINTR) return false;
+        }
+    }
+
+    bool DBus::SendAll(const void* p, size_t n) {
+        const char* c = (const char*)p;
+        while (n) {
+            if (!Wait(POLLOUT)) return false;
+            const ssize_t k = ::send(m_fd, c, n, MSG_NOSIGNAL);
+            if (k < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                return false;
+            }
+            c += k;
+            n -= (size_t)k;
+        }
+        return true;
+    }
+
+    bool DBus::RecvAll(void* p, size_t n) {
+        char* c = (char*)p;
+        while (n) {
+            if (!Wait(POLLIN)) return false;
+            const ssize_t k = ::recv(m_fd, c, n, 0);
+            if (k == 0) return false;
+            if (k < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                return false;
+            }
+            c += k;
+            n -= (size_t)k;
+        }
+        return true;
+    }
+
+    Error DBus::Connect() {
+        StartClock();
+        std::string path = kDefaultSocket;
+        bool abstract = false;
+        if (const char* a = std::getenv("DBUS_SYSTEM_BUS_ADDRESS"))
+            if (!ParseAddress(a, path, abstract)) return Error::NotFound;
+
+        sockaddr_un sa{};
+        sa.sun_family = AF_UNIX;
+        if (path.size() + 1 >= sizeof(sa.sun_path)) return Error::NotFound;
+        socklen_t len;
+        if (abstract) {
+            std::memcpy(sa.sun_path + 1, path.data(), path.size());
+            len = (socklen_t)(offsetof(sockaddr_un, sun_path) + 1 + path.size());
+        } else {
+            std::memcpy(sa.sun_path, path.data(), path.size());
+            len = (socklen_t)sizeof(sa);
+        }
+        // Local connects complete (or fail) at once; only the traffic after
+        // it needs the deadline
+        m_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_fd < 0) return Error::Io;
+        if (::connect(m_fd, (const sockaddr*)&sa, len) < 0) {
+            return errno == EACCES || errno == EPERM       ? Error::Denied
+                 : errno == ENOENT || errno == ECONNREFUSED ? Error::NotFound
+                                                             : Error::Io;
+        }
+        ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+
+        // SASL EXTERNAL: the bus checks our peer credentials against the uid
+        char uid[16];
+        std::snprintf(uid, sizeof(uid), "%u", (unsigned)::getuid());
+        std::string auth(1, '\0');
+        auth += "AUTH EXTERNAL ";
+        for (const char* c = uid; *c; c++) {
+            char hex[3];
+            std::snprintf(hex, sizeof(hex), "%02x", (unsigned char)*c);
+            auth += hex;
+        }
+        auth += "\r\n";
+        if (!SendAll(auth.data(), auth.size())) return m_timedOut ? Error::TimedOut : Error::Io;
+        std::string line;
+        while (line.size() < 512 && (line.size() < 2 || line.compare(line.size() - 2, 2, "\r\n"))) {
+            char c;
+            if (!RecvAll(&c, 1)) return m_timedOut ? Error::TimedOut : Error::Io;
+            line += c;
+        }
+        if (line.compare(0, 3, "OK ")) return Error::Denied;
+        static const char kBegin[] = "BEGIN\r\n";
+        if (!SendAll(kBegin, sizeof(kBegin) - 1)) return m_timedOut ? Error::TimedOut : Error::Io;
+
+        return Call("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "Hello", "", {});
+    }
+
+    Error DBus::Call(const char* dest, const char* path, const char* iface, const char* member,
+                     const char* sig, const std::vector<std::string>& args,
+                     std::string* reply, std::string* errorName) {
+        if (m_fd < 0) return Error::Io;
+        const size_t argc = std::strlen(sig);
+        if (argc != args.size()) return Error::Failed;
+        StartClock();
+
+        Writer w;
+        w.U8('l'); w.U8(kMethodCall); w.U8(0); w.U8(1);
+        w.U32(0);                           // body length, patched below
+        const uint32_t serial = ++m_serial;
+        w.U32(serial);
+        w.U32(0);                           // header-field array length, patched below
+        const size_t fieldsAt = w.b.size();
+        w.Field(kFieldPath, 'o', path);
+        w.Field(kFieldDestination, 's', dest);
+        if (iface) w.Field(kFieldInterface, 's', iface);
+        w.Field(kFieldMember, 's', member);
+        if (argc) w.Field(kFieldSignature, 'g', sig);
+        w.Patch32(12, (uint32_t)(w.b.size() - fieldsAt));
+        w.Align(8);
+        const size_t bodyAt = w.b.size();
+        for (size_t i = 0; i < argc; i++) {
+            if (sig[i] == 'b') w.U32(args[i] == "true" ? 1 : 0);
+            else               w.Str(args[i]);
+        }
+        w.Patch32(4, (uint32_t)(w.b.size() - bodyAt));
+        if (!SendAll(w.b.data(), w.b.size())) return m_timedOut ? Error::TimedOut : Error::Io;
+
+        // Signals (NameAcquired after Hello, unit changes…) are skipped
+        for (;;) {
+            uint8_t fixed[16];
+            if (!RecvAll(fixed, sizeof(fixed))) return m_timedOut ? Error::TimedOut : Error::Io;
+            if (fixed[0] != 'l' && fixed[0] != 'B') return Error::Io;
+            Reader h{ fixed, sizeof(fixed), fixed[0] == 'B' };
+            h.pos = 4;
+            const uint32_t bodyLen = h.U32();
+            h.U32();
+            const uint32_t fieldsLen = h.U32();
+            if (bodyLen > kMaxMessage || fieldsLen > kMaxMessage) return Error::Io;
+            const size_t hdrEnd = (16 + (size_t)fieldsLen + 7) & ~(size_t)7;
+            std::vector<uint8_t> msg(hdrEnd + bodyLen);
+            std::memcpy(msg.data(), fixed, sizeof(fixed));
+            if (!RecvAll(msg.data() + 16, msg.size() - 16)) return m_timedOut ? Error::TimedOut : Error::Io;
+
+            Reader r{ msg.data(), msg.size(), fixed[0] == 'B' };
+            r.pos = 16;
+            uint32_t    replySerial = 0;
+            std::string errName, bodySig;
+            while (r.ok && r.pos < 16 + (size_t)fieldsLen) {
+                r.Align(8);
+                const uint8_t     code = r.U8();
+                const std::string vsig = r.Sig();
+                if (vsig.size() != 1) { r.ok = false; break; }
+                std::string s;
+                uint32_t    u = 0;
+                r.Value(vsig[0], &s, &u);
+                if (code == kFieldReplySerial) replySerial = u;
+                if (code == kFieldErrorName)   errName = s;
+                if (code == kFieldSignature)   bodySig = s;
+            }
+            if (!r.ok) return Error::Io;
+            const uint8_t type = fixed[1];
+            if ((type != kMethodReturn && type != kErrorReply) || replySerial != serial) continue;
+
+            if (type == kErrorReply) {
+                if (errorName) *errorName = errName;
+                return MapErrorName(errName);
+            }
+            if (reply && !bodySig.empty()) {
+                r.pos = hdrEnd;
+                char t = bodySig[0];
+                if (t == 'v') {
+                    const std::string inner = r.Sig();
+                    t = inner.size() == 1 ? inner[0] : 0;
+                }
+                if (t == 's' || t == 'o' || t == 'g') r.Value(t, reply, nullptr);
+                if (!r.ok) return Error::Io;
+            }
+            return Error::None;
+        }
+    }
+
+    Error DBus::GetProperty(const char* dest, const char* path, const char* iface,
+                            const char* name, std::string& value) {
+        return Call(dest, path, "org.freedesktop.DBus.Properties", "Get", "ss", { iface, name }, &value);
+    }
+
+    std::string DBus::UnitPath(const std::string& unit) {
+        std::string p = "/org/freedesktop/systemd1/unit/";
+        for (size_t i = 0; i < unit.size(); i++) {
+            const unsigned char c = (unsigned char)unit[i];
+            const bool digit = c >= '0' && c <= '9';
+            const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            if (alpha || (digit && i > 0)) { p += (char)c; continue; }
+            char hex[4];
+            std::snprintf(hex, sizeof(hex), "_%02x", c);
+            p += hex;
+        }
+        return p;
+    }
+
+}  // namespace Sys
+
+#endif  // !_WIN32
@@ -0,0 +1,64 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  DBUS  —  just enough of the system bus for systemd and resolved
+// ──────────────────────────────────────────────────────────────────────────────
+//  A blocking client over the bus socket: EXTERNAL auth, Hello, then method
+//  calls whose arguments are strings (s / o) or booleans and whose reply is
+//  read as one string (s, o, or a variant holding either).  That covers
+//  StartUnit / StopUnit, the ActiveState property and FlushCaches without
+//  linking libdbus or sd-bus.  Every wait gives up at the caller's
+//  Sys::CallDeadline(), or 5 s after the call started without one.
+#pragma once
+#ifndef _WIN32
+
+#include "tweaks.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Sys {
+
+    class DBus {
+    public:
+        DBus() = default;
+        ~DBus();
+        DBus(const DBus&)            = delete;
+        DBus& operator=(const DBus&) = delete;
+
+        // $DBUS_SYSTEM_BUS_ADDRESS (unix:path= / unix:abstract=), else the
+        // well-known socket
+        Tweaks::Error Connect();
+
+        // `sig` is one char per argument: 's', 'o', or 'b' ("true" / "false").
+        // `reply` gets the first string-ish value of the answer; on a D-Bus
+        // error `errorName` gets its name and the result maps it (AccessDenied
+        // → Denied, NoSuchUnit → NotFound, …).
+        Tweaks::Error Call(const char* dest, const char* path, const char* iface, const char* member,
+                           const char* sig, const std::vector<std::string>& args,
+                           std::string* reply = nullptr, std::string* errorName = nullptr);
+
+        // org.freedesktop.DBus.Properties.Get for a string-valued property
+        Tweaks::Error GetProperty(const char* dest, const char* path, const char* iface,
+                                  const char* name, std::string& value);
+
+        // systemd's object path for a unit: "sshd.service" → "…/unit/sshd_2eservice"
+        static std::string UnitPath(const std::string& unit);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        void StartClock();
+        bool SendAll(const void* p, size_t n);
+        bool RecvAll(void* p, size_t n);
+        bool Wait(short events);
+
+        int               m_fd       = -1;
+        uint32_t          m_serial   = 0;
+        Clock::time_point m_deadline{};
+        bool              m_timedOut = false;
+    };
+
+}  // namespace Sys
+
+#endif  // !_WIN32
@@ -0,0 +1,218 @@
+#include "event_bus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace Events {
+
+    const char* LevelName(Level l) {
+        switch (l) {
+            case Level::Info:    return "info";
+            case Level::Success: return "success";
+            case Level::Warning: return "warning";
+            case Level::Error:   return "error";
+        }
+        return "?";
+    }
+
+    const char* SourceName(Source s) {
+        static const char* const kNames[] = { "app", "boost", "clean", "launch", "audio", "bench",
+                                              "latency", "governor", "reclaim", "stats" };
+        static_assert(sizeof(kNames) / sizeof(kNames[0]) == (size_t)Source::Count, "one name per source");
+        return (size_t)s < (size_t)Source::Count ? kNames[(size_t)s] : "?";
+    }
+
+    Bus::Bus(Options o) : m_opt(o) {
+        // Reserve once so reusing a slot never reallocates
+        for (Entry& e : m_hist) {
+            e.text.reserve(kMaxText);
+            e.label.reserve(kMaxText + 32);
+        }
+    }
+
+    // ── Producer side ─────────────────────────────────────────────────────────
+    bool Bus::Post(Source s, Level l, const char* text, size_t len, uint32_t color) {
+        Message m;
+        if (len >= kMaxText) {
+            len = kMaxText - 1;
+            while (len && ((unsigned char)text[len] & 0xC0) == 0x80) --len;    // don't split a character
+        }
+        std::memcpy(m.text, text, len);
+        m.text[len] = 0;
+        m.len    = (uint16_t)len;
+        m.source = s;
+        m.level  = l;
+        m.color  = color;
+        m.ns     = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count();
+        uint64_t h = 1469598103934665603ull ^ (uint64_t)s;                     // FNV-1a
+        for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)text[i]) * 1099511628211ull;
+        m.key = h;
+
+        // Still queued: count it in the owner's slot.  Else claim a free one
+        // of the few probed; with none free the message just goes unmerged.
+        // Warning / Error probe their own half, which an Info flood can't fill.
+        const bool     urgent = l == Level::Warning || l == Level::Error;
+        const size_t   half   = kSlots / 2;
+        const uint64_t tag    = h >> 32 << 32;
+        Slot*          claim  = nullptr;
+        for (size_t i = 0; i < kProbe; i++) {
+            Slot& sl = m_slots[(urgent ? half : 0) + ((h + i) & (half - 1))];
+            uint64_t w = sl.word.load(std::memory_order_acquire);
+            while ((uint32_t)w != 0 && (w >> 32 << 32) == tag) {
+                sl.lastNs.store(m.ns, std::memory_order_relaxed);
+                if (sl.word.compare_exchange_weak(w, w + 1, std::memory_order_acq_rel)) return true;
+            }
+            if (!w && !claim) claim = &sl;
+        }
+        if (claim) {
+            uint64_t w = 0;
+            if (claim->word.compare_exchange_strong(w, tag | 1, std::memory_order_acq_rel)) {
+                claim->lastNs.store(m.ns, std::memory_order_relaxed);
+                m.slot = (uint32_t)(claim - m_slots) + 1;
+            }
+        }
+        if (m_queue.TryPush(m, urgent ? 0 : kReserve)) return true;
+        // Repeats that joined the slot meanwhile are lost with it
+        const uint64_t n = m.slot ? (uint32_t)claim->word.exchange(0, std::memory_order_acq_rel) : 1;
+        m_lost.fetch_add(n, std::memory_order_relaxed);
+        if (urgent) m_lostUrgent.fetch_add(n, std::memory_order_relaxed);
+        return false;
+    }
+
+    // ── Consumer side ─────────────────────────────────────────────────────────
+    bool Bus::Update(float dt) {
+        while (m_queue.TryPop(m_msg)) {
+            unsigned count  = 1;
+            int64_t  lastNs = m_msg.ns;
+            if (m_msg.slot) {                   // release the slot; later repeats queue afresh
+                Slot& sl = m_slots[m_msg.slot - 1];
+                count  = (unsigned)(uint32_t)sl.word.exchange(0, std::memory_order_acq_rel);
+                lastNs = std::max(lastNs, sl.lastNs.load(std::memory_order_relaxed));
+            }
+            m_stats.queued++;
+            Apply(m_msg, std::max(count, 1u), lastNs);
+        }
+
+        m_clock += dt;
+        for (size_t i = m_shown; i-- > 0;) {
+            m_toast[i].left -= dt;
+            if (m_toast[i].left <= 0.0f || !Get(m_toast[i].seq)) Remove(i);
+        }
+        const size_t visible = std::min<size_t>(m_opt.maxVisible, kToasts);
+        while (m_shown < m_toasts && m_shown < visible && m_clock - m_lastShow >= m_opt.minGapSec) {
+            if (!Get(m_toast[m_shown].seq)) { Remove(m_shown); continue; }    // rotated out while waiting
+            m_toast[m_shown++].left = m_opt.toastSec;
+            m_lastShow = m_clock;
+            m_stats.shown++;
+        }
+        return m_toasts > 0;
+    }
+
+    void Bus::Apply(const Message& m, unsigned count, int64_t lastNs) {
+        m_stats.received += count;
+
+        // The same text again: one entry, a count, and its toast re-armed
+        const int64_t window = (int64_t)(m_opt.coalesceSec * 1e9);
+        const uint64_t oldest = m_seq > kHistory ? m_seq - kHistory : 0;
+        for (uint64_t s = m_seq; s > oldest && s + 16 > m_seq; s--) {
+            Entry& e = m_hist[s % kHistory];
+            if (e.key != m.key || m.ns - e.lastNs > window || e.text.compare(0, std::string::npos, m.text, m.len))
+                continue;
+            e.count += count;
+            e.lastNs = std::max(e.lastNs, lastNs);
+            Relabel(e);
+            for (size_t i = 0; i < m_shown; i++)
+                if (m_toast[i].seq == s) m_toast[i].left = m_opt.toastSec;
+            m_stats.coalesced += count;
+            return;
+        }
+
+        Entry& e = m_hist[++m_seq % kHistory];
+        e.seq     = m_seq;
+        e.source  = m.source;
+        e.level   = m.level;
+        e.color   = m.color;
+        e.key     = m.key;
+        e.firstNs = m.ns;
+        e.lastNs  = lastNs;
+        e.count   = count;
+        e.folded  = 0;
+        m_stats.coalesced += count - 1;
+        e.text.assign(m.text, m.len);
+        Enqueue(e);
+        Relabel(e);
+    }
+
+    void Bus::Enqueue(Entry& e) {
+        // A burst from one source: the newest replaces its waiting toast
+        for (size_t i = m_shown; i < m_toasts; i++) {
+            const Entry* prev = Get(m_toast[i].seq);
+            if (!prev || prev->source != e.source) continue;
+            e.folded = prev->folded + prev->count;
+            m_toast[i].seq = e.seq;
+            m_stats.folded++;
+            return;
+        }
+        if (m_toasts == kToasts) {
+            if (m_shown == kToasts) return;                // can't happen while maxVisible < kToasts
+            Remove(m_shown);                               // oldest waiting one
+            m_stats.dropped++;
+        }
+        m_toast[m_toasts++] = Toast{ e.seq, 0.0f };
+    }
+
+    void Bus::Remove(size_t i) {
+        if (i < m_shown) m_shown--;
+        std::copy(m_toast + i + 1, m_toast + m_toasts, m_toast + i);
+        m_toasts--;
+    }
+
+    void Bus::Relabel(Entry& e) {
+        e.label = e.text;
+        char extra[48];
+        int  n = 0;
+        if (e.count > 1)  n += std::snprintf(extra + n, sizeof(extra) - n, " (x%u)", e.count);
+        if (e.folded > 0) n += std::snprintf(extra + n, sizeof(extra) - n, "  +%u more", e.folded);
+        e.label.append(extra, (size_t)n);
+        e.width = -1.0f;
+    }
+
+    // ── History ───────────────────────────────────────────────────────────────
+    const Entry* Bus::Get(uint64_t seq) const {
+        const Entry& e = m_hist[seq % kHistory];
+        return seq && e.seq == seq ? &e : nullptr;
+    }
+
+    size_t Bus::Search(const char* query, std::vector<const Entry*>& out, size_t max) const {
+        out.clear();
+        const size_t qn = query ? std::strlen(query) : 0;
+        auto lower = [](char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; };
+        auto contains = [&](const char* s, size_t n) {
+            if (qn > n) return false;
+            for (size_t i = 0; i + qn <= n; i++) {
+                size_t k = 0;
+                while (k < qn && lower(s[i + k]) == lower(query[k])) k++;
+                if (k == qn) return true;
+            }
+            return false;
+        };
+        const uint64_t oldest = m_seq > kHistory ? m_seq - kHistory : 0;
+        for (uint64_t s = m_seq; s > oldest && out.size() < max; s--) {
+            const Entry& e = m_hist[s % kHistory];
+            const char*  src = SourceName(e.source);
+            if (!qn || contains(e.text.data(), e.text.size()) || contains(src, std::strlen(src)))
+                out.push_back(&e);
+        }
+        return out.size();
+    }
+
+    const Stats& Bus::GetStats() const {
+        m_stats.lost       = m_lost.load(std::memory_order_relaxed);
+        m_stats.lostUrgent = m_lostUrgent.load(std::memory_order_relaxed);
+        return m_stats;
+    }
+
+}  // namespace Events
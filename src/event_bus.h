@@ -0,0 +1,218 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  EVENT BUS  —  typed notifications from any thread, toasts and history on one
+// ──────────────────────────────────────────────────────────────────────────────
+//  Producers (the UI, the cleaner, the measure / governor / reclaimer
+//  workers) Post() into a bounded lock-free MPSC queue: a fixed-size copy,
+//  no lock, no allocation, never a wait — a full queue drops the message and
+//  counts it.  A repeat of a message still waiting in the queue doesn't take
+//  a cell: each queued message owns a slot in a small table keyed by its
+//  hash, and a repeat bumps that slot's count with one CAS instead.  Info and
+//  Success may only fill the queue up to kReserve cells short of full, so a
+//  flood of them can't crowd out Warnings and Errors: those have the last
+//  cells to themselves.  The UI thread
+//  alone calls Update() once per frame, which drains the queue and:
+//
+//   • coalesces — the same text from the same source within `coalesceSec`
+//     bumps the existing entry's count (by however many repeats its slot
+//     collected) instead of adding one, and re-arms its toast if it is
+//     still up;
+//   • folds — a new message from a source whose previous toast is still
+//     waiting to be shown replaces it ("+N more"), so a burst from one
+//     worker becomes one toast;
+//   • rate-limits — at most `maxVisible` toasts on screen, a new one at
+//     most every `minGapSec`, and a short bounded waiting line behind them;
+//   • records every message in a fixed ring of history entries that can be
+//     searched.
+//
+//  Each entry carries its toast label and a width slot for the UI: the label
+//  is rebuilt only when the count changes, so the text is measured once per
+//  message rather than once per frame.  Entries reuse their strings, so a
+//  warmed-up bus allocates nothing.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Events {
+
+    enum class Level : uint8_t { Info, Success, Warning, Error };
+    enum class Source : uint8_t { App, Boost, Clean, Launch, Audio, Bench, Latency, Governor, Reclaim, Stats, Count };
+    const char* LevelName(Level l);      // "info", "success", …
+    const char* SourceName(Source s);    // "app", "boost", …
+
+    static constexpr size_t kMaxText = 160;    // bytes, longer text is cut at a UTF-8 boundary
+
+    struct Message {
+        Source   source = Source::App;
+        Level    level  = Level::Info;
+        uint16_t len    = 0;
+        uint32_t color  = 0;        // packed RGBA for the UI; 0 = pick by level
+        uint32_t slot   = 0;        // 1 + the repeat-counting slot it owns; 0 = none
+        uint64_t key    = 0;        // hash of source + text, the coalescing key
+        int64_t  ns     = 0;        // steady clock, stamped by the producer
+        char     text[kMaxText];
+    };
+
+    // ── Bounded lock-free MPSC queue ──────────────────────────────────────────
+    // Each cell's sequence number says whose turn it is: producers claim a
+    // slot with one CAS on the head, fill it, then publish it through the
+    // sequence; the consumer reads cells in order.  A push with a `reserve`
+    // fails while fewer than that many cells would be left free after it.
+    template <class T, size_t N>
+    class MpscRing {
+        static_assert((N & (N - 1)) == 0, "MpscRing size must be a power of two");
+    public:
+        MpscRing() {
+            for (size_t i = 0; i < N; i++) m_cell[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        bool TryPush(const T& v, size_t reserve = 0) {     // any thread
+            size_t pos = m_head.load(std::memory_order_relaxed);
+            for (;;) {
+                if (reserve && pos - m_tail.load(std::memory_order_acquire) + reserve >= N) return false;
+                Cell& c = m_cell[pos & (N - 1)];
+                const intptr_t d = (intptr_t)c.seq.load(std::memory_order_acquire) - (intptr_t)pos;
+                if (d == 0) {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        c.value = v;
+                        c.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (d < 0) {
+                    return false;                  // full
+                } else {
+                    pos = m_head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool TryPop(T& out) {                      // the one consumer
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            Cell& c = m_cell[tail & (N - 1)];
+            if (c.seq.load(std::memory_order_acquire) != tail + 1) return false;
+            out = c.value;
+            c.seq.store(tail + N, std::memory_order_release);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct alignas(64) Cell {
+            std::atomic<size_t> seq{ 0 };
+            T                   value;
+        };
+        alignas(64) std::atomic<size_t> m_head{ 0 };
+        alignas(64) std::atomic<size_t> m_tail{ 0 };   // written by the consumer only
+        Cell                            m_cell[N];
+    };
+
+    // One history entry: a message plus everything coalesced into it
+    struct Entry {
+        uint64_t    seq    = 0;         // 1, 2, …; 0 = slot unused
+        Source      source = Source::App;
+        Level       level  = Level::Info;
+        uint32_t    color  = 0;
+        uint64_t    key    = 0;
+        int64_t     firstNs = 0, lastNs = 0;
+        unsigned    count  = 1;         // identical posts merged in
+        unsigned    folded = 0;         // earlier waiting toasts from the source it replaced
+        std::string text;
+        std::string label;              // text + " (x3)" / "  +2 more"
+        float       width  = -1.0f;     // label layout, the UI's to fill; < 0 = not measured
+    };
+
+    struct Options {
+        double   coalesceSec = 2.0;
+        float    toastSec    = 3.0f;
+        unsigned maxVisible  = 4;
+        double   minGapSec   = 0.25;
+    };
+
+    struct Stats {
+        uint64_t received   = 0;        // posts drained, repeats merged at Post() included
+        uint64_t queued     = 0;        // … of which took a queue cell
+        uint64_t lost       = 0;        // queue full at Post()
+        uint64_t lostUrgent = 0;        // … of which Warning / Error (reserve used up)
+        uint64_t coalesced  = 0;        // merged into an existing entry
+        uint64_t folded     = 0;        // waiting toasts replaced by a newer one
+        uint64_t dropped    = 0;        // waiting toasts pushed out of the line
+        uint64_t shown      = 0;        // toasts put on screen
+    };
+
+    class Bus {
+    public:
+        static constexpr size_t kQueue   = 256;
+        static constexpr size_t kReserve = 64;         // cells only Warning / Error may take
+        static constexpr size_t kSlots   = 1024;       // repeat counters: half Info / Success, half urgent
+        static constexpr size_t kProbe   = 4;
+        static constexpr size_t kHistory = 256;
+        static constexpr size_t kToasts  = 8;          // on screen + waiting
+
+        explicit Bus(Options o = {});
+        Bus(const Bus&)            = delete;
+        Bus& operator=(const Bus&) = delete;
+
+        // Producer side (any thread) ──────────────────────────────────────────
+        // False only when the message was dropped
+        bool Post(Source s, Level l, const char* text, size_t len, uint32_t color = 0);
+        bool Post(Source s, Level l, const std::string& text, uint32_t color = 0) {
+            return Post(s, l, text.data(), text.size(), color);
+        }
+
+        // Consumer side (one thread) ──────────────────────────────────────────
+        // Drains, coalesces, ages the toasts by `dt` seconds and lets the next
+        // waiting one in.  True while any toast is up or waiting.
+        bool Update(float dt);
+
+        // On-screen toasts, newest first, with their seconds left
+        template <class Fn>
+        void ForEachShown(Fn&& fn) {
+            for (size_t i = m_shown; i-- > 0;) fn(m_hist[m_toast[i].seq % kHistory], m_toast[i].left);
+        }
+
+        // History entries whose text or source contains `query` (ASCII
+        // case-insensitive; empty matches all), newest first
+        size_t Search(const char* query, std::vector<const Entry*>& out, size_t max = SIZE_MAX) const;
+        const Entry* Get(uint64_t seq) const;          // null once it has rotated out
+        uint64_t     Last() const { return m_seq; }
+
+        const Stats&   GetStats() const;
+        const Options& GetOptions() const          { return m_opt; }
+        void           SetOptions(const Options& o) { m_opt = o; }
+
+    private:
+        struct Toast {
+            uint64_t seq  = 0;
+            float    left = 0.0f;                      // seconds; only once shown
+        };
+
+        // A queued message's claim on a slot: the key's top 32 bits and the
+        // posts it stands for (0 = free).  One word, so a repeat either joins
+        // before Update() takes the count or finds the slot free again.
+        struct alignas(16) Slot {
+            std::atomic<uint64_t> word{ 0 };
+            std::atomic<int64_t>  lastNs{ 0 };
+        };
+
+        void Apply(const Message& m, unsigned count, int64_t lastNs);
+        void Enqueue(Entry& e);
+        void Remove(size_t i);
+        static void Relabel(Entry& e);
+
+        Options                    m_opt;
+        MpscRing<Message, kQueue>  m_queue;
+        Slot                       m_slots[kSlots];
+        std::atomic<uint64_t>      m_lost{ 0 }, m_lostUrgent{ 0 };
+        Message                    m_msg;              // Update()'s pop target
+        Entry                      m_hist[kHistory];
+        uint64_t                   m_seq = 0;
+        Toast                      m_toast[kToasts];
+        size_t                     m_toasts = 0, m_shown = 0;   // the shown ones come first
+        double                     m_clock = 0.0, m_lastShow = -1e9;
+        mutable Stats              m_stats;
+    };
+
+}  // namespace Events
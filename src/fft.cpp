@@ -0,0 +1,250 @@
+#include "fft.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define XOPT_FFT_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles any intrinsic without flags; GCC/Clang need per-function targets
+#if defined(XOPT_FFT_X86) && !defined(_MSC_VER)
+#define XOPT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define XOPT_TARGET_AVX2
+#endif
+
+namespace Dsp {
+
+    namespace {
+
+        struct Tw { const float *r1, *i1, *r2, *i2, *r3, *i3; };
+
+        // ── Scalar butterflies ────────────────────────────────────────────────
+        void Radix4Scalar(size_t n, size_t s, const Tw& w,
+                          const float* xr, const float* xi, float* yr, float* yi) {
+            const size_t m = n / 4;
+            for (size_t p = 0; p < m; p++) {
+                const float w1r = w.r1[p], w1i = w.i1[p];
+                const float w2r = w.r2[p], w2i = w.i2[p];
+                const float w3r = w.r3[p], w3i = w.i3[p];
+                for (size_t q = 0; q < s; q++) {
+                    const size_t a = q + s * p, b = a + s * m, c = b + s * m, d = c + s * m;
+                    const float apcr = xr[a] + xr[c], apci = xi[a] + xi[c];
+                    const float amcr = xr[a] - xr[c], amci = xi[a] - xi[c];
+                    const float bpdr = xr[b] + xr[d], bpdi = xi[b] + xi[d];
+                    const float jbr  = xi[d] - xi[b], jbi  = xr[b] - xr[d];   // i·(b − d)
+                    const size_t o = q + s * 4 * p;
+                    yr[o] = apcr + bpdr;
+                    yi[o] = apci + bpdi;
+                    float tr = amcr - jbr, ti = amci - jbi;
+                    yr[o + s] = tr * w1r - ti * w1i;   yi[o + s] = tr * w1i + ti * w1r;
+                    tr = apcr - bpdr; ti = apci - bpdi;
+                    yr[o + 2 * s] = tr * w2r - ti * w2i; yi[o + 2 * s] = tr * w2i + ti * w2r;
+                    tr = amcr + jbr; ti = amci + jbi;
+                    yr[o + 3 * s] = tr * w3r - ti * w3i; yi[o + 3 * s] = tr * w3i + ti * w3r;
+                }
+            }
+        }
+
+        // Last stage when log2(n) is odd: n == 2, twiddle is 1
+        void Radix2(size_t s, const float* xr, const float* xi, float* yr, float* yi) {
+            for (size_t q = 0; q < s; q++) {
+                const float ar = xr[q], ai = xi[q], br = xr[q + s], bi = xi[q + s];
+                yr[q] = ar + br;     yi[q] = ai + bi;
+                yr[q + s] = ar - br; yi[q + s] = ai - bi;
+            }
+        }
+
+#ifdef XOPT_FFT_X86
+        // ── SSE2 ──────────────────────────────────────────────────────────────
+        struct V4 { __m128 r, i; };
+
+        inline V4 Mul4(__m128 ar, __m128 ai, __m128 wr, __m128 wi) {
+            return { _mm_sub_ps(_mm_mul_ps(ar, wr), _mm_mul_ps(ai, wi)),
+                     _mm_add_ps(_mm_mul_ps(ar, wi), _mm_mul_ps(ai, wr)) };
+        }
+
+        // Four butterflies sharing one set of twiddles (broadcast or per-lane)
+        inline void Bfly4(__m128 ar, __m128 ai, __m128 br, __m128 bi,
+                          __m128 cr, __m128 ci, __m128 dr, __m128 di,
+                          __m128 w1r, __m128 w1i, __m128 w2r, __m128 w2i,
+                          __m128 w3r, __m128 w3i, V4 out[4]) {
+            const __m128 apcr = _mm_add_ps(ar, cr), apci = _mm_add_ps(ai, ci);
+            const __m128 amcr = _mm_sub_ps(ar, cr), amci = _mm_sub_ps(ai, ci);
+            const __m128 bpdr = _mm_add_ps(br, dr), bpdi = _mm_add_ps(bi, di);
+            const __m128 jbr  = _mm_sub_ps(di, bi), jbi  = _mm_sub_ps(br, dr);
+            out[0] = { _mm_add_ps(apcr, bpdr), _mm_add_ps(apci, bpdi) };
+            out[1] = Mul4(_mm_sub_ps(amcr, jbr), _mm_sub_ps(amci, jbi), w1r, w1i);
+            out[2] = Mul4(_mm_sub_ps(apcr, bpdr), _mm_sub_ps(apci, bpdi), w2r, w2i);
+            out[3] = Mul4(_mm_add_ps(amcr, jbr), _mm_add_ps(amci, jbi), w3r, w3i);
+        }
+
+        void Radix4Sse2(size_t n, size_t s, const Tw& w,
+                        const float* xr, const float* xi, float* yr, float* yi) {
+            const size_t m = n / 4;
+            V4 o[4];
+            if (s == 1) {
+                // First stage: vectorise across p, transpose 4×4 into y[4p + k]
+                for (size_t p = 0; p < m; p += 4) {
+                    Bfly4(_mm_loadu_ps(xr + p),         _mm_loadu_ps(xi + p),
+                          _mm_loadu_ps(xr + p + m),     _mm_loadu_ps(xi + p + m),
+                          _mm_loadu_ps(xr + p + 2 * m), _mm_loadu_ps(xi + p + 2 * m),
+                          _mm_loadu_ps(xr + p + 3 * m), _mm_loadu_ps(xi + p + 3 * m),
+                          _mm_loadu_ps(w.r1 + p), _mm_loadu_ps(w.i1 + p),
+                          _mm_loadu_ps(w.r2 + p), _mm_loadu_ps(w.i2 + p),
+                          _mm_loadu_ps(w.r3 + p), _mm_loadu_ps(w.i3 + p), o);
+                    _MM_TRANSPOSE4_PS(o[0].r, o[1].r, o[2].r, o[3].r);
+                    _MM_TRANSPOSE4_PS(o[0].i, o[1].i, o[2].i, o[3].i);
+                    for (int k = 0; k < 4; k++) {
+                        _mm_storeu_ps(yr + 4 * p + 4 * k, o[k].r);
+                        _mm_storeu_ps(yi + 4 * p + 4 * k, o[k].i);
+                    }
+                }
+                return;
+            }
+            // s >= 4: vectorise across q, twiddles broadcast
+            for (size_t p = 0; p < m; p++) {
+                const __m128 w1r = _mm_set1_ps(w.r1[p]), w1i = _mm_set1_ps(w.i1[p]);
+                const __m128 w2r = _mm_set1_ps(w.r2[p]), w2i = _mm_set1_ps(w.i2[p]);
+                const __m128 w3r = _mm_set1_ps(w.r3[p]), w3i = _mm_set1_ps(w.i3[p]);
+                const size_t a = s * p, b = a + s * m, c = b + s * m, d = c + s * m;
+                const size_t y0 = s * 4 * p;
+                for (size_t q = 0; q < s; q += 4) {
+                    Bfly4(_mm_loadu_ps(xr + a + q), _mm_loadu_ps(xi + a + q),
+                          _mm_loadu_ps(xr + b + q), _mm_loadu_ps(xi + b + q),
+                          _mm_loadu_ps(xr + c + q), _mm_loadu_ps(xi + c + q),
+                          _mm_loadu_ps(xr + d + q), _mm_loadu_ps(xi + d + q),
+                          w1r, w1i, w2r, w2i, w3r, w3i, o);
+                    for (int k = 0; k < 4; k++) {
+                        _mm_storeu_ps(yr + y0 + k * s + q, o[k].r);
+                        _mm_storeu_ps(yi + y0 + k * s + q, o[k].i);
+                    }
+                }
+            }
+        }
+
+        // ── AVX2 + FMA (s >= 8; smaller strides fall back to SSE2) ────────────
+        XOPT_TARGET_AVX2
+        void Radix4Avx2(size_t n, size_t s, const Tw& w,
+                        const float* xr, const float* xi, float* yr, float* yi) {
+            const size_t m = n / 4;
+            for (size_t p = 0; p < m; p++) {
+                const __m256 w1r = _mm256_set1_ps(w.r1[p]), w1i = _mm256_set1_ps(w.i1[p]);
+                const __m256 w2r = _mm256_set1_ps(w.r2[p]), w2i = _mm256_set1_ps(w.i2[p]);
+                const __m256 w3r = _mm256_set1_ps(w.r3[p]), w3i = _mm256_set1_ps(w.i3[p]);
+                const size_t a = s * p, b = a + s * m, c = b + s * m, d = c + s * m;
+                const size_t y0 = s * 4 * p;
+                for (size_t q = 0; q < s; q += 8) {
+                    const __m256 ar = _mm256_loadu_ps(xr + a + q), ai = _mm256_loadu_ps(xi + a + q);
+                    const __m256 br = _mm256_loadu_ps(xr + b + q), bi = _mm256_loadu_ps(xi + b + q);
+                    const __m256 cr = _mm256_loadu_ps(xr + c + q), ci = _mm256_loadu_ps(xi + c + q);
+                    const __m256 dr = _mm256_loadu_ps(xr + d + q), di = _mm256_loadu_ps(xi + d + q);
+                    const __m256 apcr = _mm256_add_ps(ar, cr), apci = _mm256_add_ps(ai, ci);
+                    const __m256 amcr = _mm256_sub_ps(ar, cr), amci = _mm256_sub_ps(ai, ci);
+                    const __m256 bpdr = _mm256_add_ps(br, dr), bpdi = _mm256_add_ps(bi, di);
+                    const __m256 jbr  = _mm256_sub_ps(di, bi), jbi  = _mm256_sub_ps(br, dr);
+                    _mm256_storeu_ps(yr + y0 + q, _mm256_add_ps(apcr, bpdr));
+                    _mm256_storeu_ps(yi + y0 + q, _mm256_add_ps(apci, bpdi));
+                    __m256 tr = _mm256_sub_ps(amcr, jbr), ti = _mm256_sub_ps(amci, jbi);
+                    _mm256_storeu_ps(yr + y0 + s + q, _mm256_fmsub_ps(tr, w1r, _mm256_mul_ps(ti, w1i)));
+                    _mm256_storeu_ps(yi + y0 + s + q, _mm256_fmadd_ps(tr, w1i, _mm256_mul_ps(ti, w1r)));
+                    tr = _mm256_sub_ps(apcr, bpdr); ti = _mm256_sub_ps(apci, bpdi);
+                    _mm256_storeu_ps(yr + y0 + 2 * s + q, _mm256_fmsub_ps(tr, w2r, _mm256_mul_ps(ti, w2i)));
+                    _mm256_storeu_ps(yi + y0 + 2 * s + q, _mm256_fmadd_ps(tr, w2i, _mm256_mul_ps(ti, w2r)));
+                    tr = _mm256_add_ps(amcr, jbr); ti = _mm256_add_ps(amci, jbi);
+                    _mm256_storeu_ps(yr + y0 + 3 * s + q, _mm256_fmsub_ps(tr, w3r, _mm256_mul_ps(ti, w3i)));
+                    _mm256_storeu_ps(yi + y0 + 3 * s + q, _mm256_fmadd_ps(tr, w3i, _mm256_mul_ps(ti, w3r)));
+                }
+            }
+        }
+#endif  // XOPT_FFT_X86
+
+    }  // namespace
+
+    Fft::Isa Fft::DetectIsa() {
+#ifdef XOPT_FFT_X86
+#ifdef _MSC_VER
+        int r[4];
+        __cpuid(r, 0);
+        if (r[0] >= 7) {
+            __cpuid(r, 1);
+            const bool osxsave = (r[2] & (1 << 27)) != 0, fma = (r[2] & (1 << 12)) != 0;
+            __cpuidex(r, 7, 0);
+            const bool avx2 = (r[1] & (1 << 5)) != 0;
+            if (osxsave && fma && avx2 && (_xgetbv(0) & 6) == 6) return Isa::Avx2;
+        }
+        return Isa::Sse2;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::Avx2;
+        return Isa::Sse2;
+#endif
+#else
+        return Isa::Scalar;
+#endif
+    }
+
+    const char* Fft::IsaName(Isa isa) {
+        switch (isa) {
+            case Isa::Avx2:   return "avx2";
+            case Isa::Sse2:   return "sse2";
+            case Isa::Scalar: break;
+        }
+        return "scalar";
+    }
+
+    Fft::Fft(size_t n) : m_n(n), m_isa(DetectIsa()), m_yr(n), m_yi(n) {
+        const double kTwoPi = 6.283185307179586;
+        size_t len = n, s = 1;
+        while (len > 1) {
+            Stage st{ len, s, m_twr[0].size(), len == 2 };
+            if (!st.radix2) {
+                const size_t m = len / 4;
+                for (size_t p = 0; p < m; p++) {
+                    for (int k = 0; k < 3; k++) {
+                        const double a = kTwoPi * (double)((k + 1) * p) / (double)len;
+                        m_twr[k].push_back((float)std::cos(a));
+                        m_twi[k].push_back((float)-std::sin(a));
+                    }
+                }
+            }
+            m_stages.push_back(st);
+            s   *= st.radix2 ? 2 : 4;
+            len /= st.radix2 ? 2 : 4;
+        }
+    }
+
+    void Fft::Forward(float* re, float* im) {
+        float *xr = re, *xi = im, *yr = m_yr.data(), *yi = m_yi.data();
+        for (const Stage& st : m_stages) {
+            if (st.radix2) {
+                Radix2(st.s, xr, xi, yr, yi);
+            } else {
+                const Tw w{ m_twr[0].data() + st.tw, m_twi[0].data() + st.tw,
+                            m_twr[1].data() + st.tw, m_twi[1].data() + st.tw,
+                            m_twr[2].data() + st.tw, m_twi[2].data() + st.tw };
+#ifdef XOPT_FFT_X86
+                if (m_isa == Isa::Avx2 && st.s >= 8)
+                    Radix4Avx2(st.n, st.s, w, xr, xi, yr, yi);
+                else if (m_isa != Isa::Scalar && (st.s >= 4 || (st.s == 1 && st.n >= 16)))
+                    Radix4Sse2(st.n, st.s, w, xr, xi, yr, yi);
+                else
+#endif
+                    Radix4Scalar(st.n, st.s, w, xr, xi, yr, yi);
+            }
+            std::swap(xr, yr);
+            std::swap(xi, yi);
+        }
+        if (xr != re) {
+            std::memcpy(re, xr, m_n * sizeof(float));
+            std::memcpy(im, xi, m_n * sizeof(float));
+        }
+    }
+
+}  // namespace Dsp
@@ -0,0 +1,47 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  FFT  —  Stockham radix-4 (+ final radix-2) complex FFT, SSE2 / AVX2
+// ──────────────────────────────────────────────────────────────────────────────
+//  Split re/im arrays so every butterfly column is a contiguous vector load.
+//  The Stockham ping-pong ordering needs no bit-reversal pass and leaves the
+//  output in natural order.  The ISA is picked once at runtime; twiddles are
+//  precomputed per stage, so Forward() never allocates.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Dsp {
+
+    class Fft {
+    public:
+        enum class Isa { Scalar, Sse2, Avx2 };
+
+        // n: power of two, >= 16
+        explicit Fft(size_t n);
+
+        size_t Size() const { return m_n; }
+
+        // In-place forward transform (e^{-i...}); re/im hold n floats each
+        void Forward(float* re, float* im);
+
+        static Isa         DetectIsa();
+        static const char* IsaName(Isa isa);
+        Isa                ActiveIsa() const { return m_isa; }
+        void               ForceIsa(Isa isa) { m_isa = isa; }   // benchmarks / tests
+
+    private:
+        struct Stage {
+            size_t n, s;                    // sub-transform length, stride
+            size_t tw;                      // offset into the twiddle tables
+            bool   radix2;
+        };
+
+        size_t             m_n;
+        Isa                m_isa;
+        std::vector<Stage> m_stages;
+        // w1, w2, w3 per stage, split re/im (unaligned loads throughout)
+        std::vector<float> m_twr[3], m_twi[3];
+        std::vector<float> m_yr, m_yi;      // ping-pong scratch
+    };
+
+}  // namespace Dsp
@@ -0,0 +1,126 @@
+#include "font_cache.h"
+#include "backend.h"
+
+#include <cstring>
+#include <vector>
+
+namespace FontCache {
+
+    static const char kMagic[4] = { 'X', 'O', 'F', '1' };
+
+    static_assert(sizeof(CacheHeader) == 48, "CacheHeader is an on-disk layout");
+    static_assert(sizeof(Font) == 20 && sizeof(Glyph) == 44 && sizeof(LineUv) == 16,
+                  "font cache tables are on-disk layouts");
+
+    uint64_t Key(const fs::path& font, const void* settings, size_t settingsSize) {
+        std::error_code ec;
+        const uint64_t size = fs::file_size(font, ec);
+        if (ec) return 0;
+        const int64_t mtime = (int64_t)fs::last_write_time(font, ec).time_since_epoch().count();
+        if (ec) return 0;
+
+        uint64_t h = 1469598103934665603ull;                                // FNV-1a
+        auto mix = [&h](const void* p, size_t n) {
+            for (size_t i = 0; i < n; i++) h = (h ^ ((const uint8_t*)p)[i]) * 1099511628211ull;
+        };
+        const std::string path = font.u8string();
+        mix(path.data(), path.size());
+        mix(&size, sizeof(size));
+        mix(&mtime, sizeof(mtime));
+        mix(&kVersion, sizeof(kVersion));
+        if (settings) mix(settings, settingsSize);
+        return h ? h : 1;
+    }
+
+    bool Save(const fs::path& p, const Atlas& a, std::string* error) {
+        auto fail = [&](const char* why) {
+            if (error) *error = why;
+            return false;
+        };
+        if (!a.pixels || !a.width || !a.height) return fail("atlas has no pixels");
+        if (a.fontCount > 0xFFFF) return fail("too many fonts");
+        for (uint32_t i = 0; i < a.fontCount; i++)
+            if ((uint64_t)a.fonts[i].firstGlyph + a.fonts[i].glyphCount > a.glyphCount)
+                return fail("font glyph range outside the glyph table");
+
+        CacheHeader h{};
+        std::memcpy(h.magic, kMagic, 4);
+        h.version    = kVersion;
+        h.fontCount  = (uint16_t)a.fontCount;
+        h.key        = a.key;
+        h.width      = a.width;
+        h.height     = a.height;
+        h.glyphCount = a.glyphCount;
+        h.lineCount  = a.lineCount;
+        h.whiteU     = a.whiteU;
+        h.whiteV     = a.whiteV;
+        h.sourceLen  = (uint32_t)a.source.size();
+
+        const size_t pixels = (size_t)a.width * a.height;
+        std::vector<uint8_t> buf;
+        buf.reserve(sizeof(h) + a.fontCount * sizeof(Font) + a.glyphCount * sizeof(Glyph)
+                    + a.lineCount * sizeof(LineUv) + pixels + a.source.size());
+        auto put = [&buf](const void* d, size_t n) {
+            if (n) buf.insert(buf.end(), (const uint8_t*)d, (const uint8_t*)d + n);
+        };
+        put(&h, sizeof(h));
+        put(a.fonts, a.fontCount * sizeof(Font));
+        put(a.glyphs, a.glyphCount * sizeof(Glyph));
+        put(a.lines, a.lineCount * sizeof(LineUv));
+        put(a.pixels, pixels);
+        put(a.source.data(), a.source.size());
+
+        std::error_code ec;
+        fs::create_directories(p.parent_path(), ec);
+        if (IO::WriteFileAtomic(p, buf.data(), buf.size())) return true;
+        if (error) *error = "cannot write " + p.u8string();
+        return false;
+    }
+
+    bool Cache::Open(const fs::path& p, std::string* error) {
+        Close();
+        auto fail = [&](const char* why) {
+            Close();
+            if (error) *error = why;
+            return false;
+        };
+        if (!m_file.Open(p)) return fail("no font cache yet");
+        CacheHeader h;
+        if (m_file.Size() < sizeof(h)) return fail("font cache truncated");
+        std::memcpy(&h, m_file.Data(), sizeof(h));
+        if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion)
+            return fail("font cache has an unknown format");
+
+        const uint64_t need = sizeof(h) + (uint64_t)h.fontCount * sizeof(Font)
+                            + (uint64_t)h.glyphCount * sizeof(Glyph) + (uint64_t)h.lineCount * sizeof(LineUv)
+                            + (uint64_t)h.width * h.height + h.sourceLen;
+        if (!h.width || !h.height || need != m_file.Size()) return fail("font cache is corrupt");
+
+        const uint8_t* d = m_file.Data() + sizeof(h);
+        Atlas& a = m_atlas;
+        a.key    = h.key;
+        a.width  = h.width;
+        a.height = h.height;
+        a.whiteU = h.whiteU;
+        a.whiteV = h.whiteV;
+        a.fonts  = (const Font*)d;     a.fontCount  = h.fontCount;   d += h.fontCount * sizeof(Font);
+        a.glyphs = (const Glyph*)d;    a.glyphCount = h.glyphCount;  d += (size_t)h.glyphCount * sizeof(Glyph);
+        a.lines  = (const LineUv*)d;   a.lineCount  = h.lineCount;   d += (size_t)h.lineCount * sizeof(LineUv);
+        a.pixels = d;                                                d += (size_t)h.width * h.height;
+        a.source.assign((const char*)d, h.sourceLen);
+        for (uint32_t i = 0; i < a.fontCount; i++)
+            if ((uint64_t)a.fonts[i].firstGlyph + a.fonts[i].glyphCount > a.glyphCount)
+                return fail("font cache is corrupt");
+        return true;
+    }
+
+    void Cache::Close() {
+        m_file.Close();
+        m_atlas = Atlas{};
+    }
+
+    fs::path DefaultPath(const Sys::Backend& be) {
+        return be.JournalPath().parent_path() / "fonts.xof";
+    }
+
+}  // namespace FontCache
@@ -0,0 +1,104 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  FONT CACHE  —  the baked font atlas, mapped back in instead of rasterized
+// ──────────────────────────────────────────────────────────────────────────────
+//  The GUI bakes its font atlas once: glyph tables, a few atlas UVs and the
+//  8-bit coverage pixels.  Save() writes that atlas to one file; Cache::Open()
+//  maps it back and hands out pointers into the mapping, with nothing parsed
+//  or copied.  Every table is 4-byte aligned in the file, so the pointers can
+//  be used in place.
+//
+//  The key identifies what the atlas was baked from: the font file's path,
+//  size and modification time, plus the caller's settings bytes (pixel size,
+//  oversampling, the ImGui version).  If the key no longer matches, the
+//  caller rebakes and saves.  The file also records which font it was baked
+//  from, so a warm start stats that one file and probes no others.
+//
+//  On disk (native endianness):
+//      CacheHeader | Font[fontCount] | Glyph[glyphCount] | LineUv[lineCount]
+//                  | u8 pixels[width * height] | source path (UTF-8, no NUL)
+#pragma once
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace Sys { class Backend; }
+
+namespace FontCache {
+
+    namespace fs = std::filesystem;
+
+    struct Font {                   // 20 bytes
+        float    size    = 0.0f;    // px
+        float    ascent  = 0.0f, descent = 0.0f;
+        uint32_t firstGlyph = 0;    // into the glyph table
+        uint32_t glyphCount = 0;
+    };
+
+    struct Glyph {                  // 44 bytes, ImFontGlyph's fields
+        uint32_t codepoint = 0;
+        uint32_t flags     = 0;     // kVisible | kColored
+        float    advanceX  = 0.0f;
+        float    x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        float    u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+
+        static constexpr uint32_t kVisible = 1, kColored = 2;
+    };
+
+    struct LineUv { float u0, v0, u1, v1; };   // baked anti-aliased line widths
+
+    // One atlas, either the caller's own tables (for Save) or pointers into
+    // a mapping (from Cache)
+    struct Atlas {
+        uint64_t       key        = 0;
+        uint32_t       width      = 0, height = 0;
+        float          whiteU     = 0.0f, whiteV = 0.0f;
+        const Font*    fonts      = nullptr;  uint32_t fontCount  = 0;
+        const Glyph*   glyphs     = nullptr;  uint32_t glyphCount = 0;
+        const LineUv*  lines      = nullptr;  uint32_t lineCount  = 0;
+        const uint8_t* pixels     = nullptr;  // width * height coverage
+        std::string    source;                // font file it was baked from
+    };
+
+    struct CacheHeader {            // 48 bytes
+        char     magic[4];          // "XOF1"
+        uint16_t version;
+        uint16_t fontCount;
+        uint64_t key;
+        uint32_t width, height;
+        uint32_t glyphCount, lineCount;
+        float    whiteU, whiteV;
+        uint32_t sourceLen;
+        uint32_t reserved;
+    };
+
+    static constexpr uint16_t kVersion = 1;
+
+    // Hash of the font file's identity (path, size, mtime) and `settings`;
+    // 0 if the file can't be stat'ed
+    uint64_t Key(const fs::path& font, const void* settings, size_t settingsSize);
+
+    bool Save(const fs::path& p, const Atlas& a, std::string* error = nullptr);
+
+    class Cache {
+    public:
+        // False (and no atlas) if missing, truncated or another version
+        bool Open(const fs::path& p, std::string* error = nullptr);
+        void Close();
+
+        bool         IsOpen() const { return m_file.IsOpen(); }
+        const Atlas& Get() const    { return m_atlas; }   // valid while open
+        size_t       Bytes() const  { return m_file.Size(); }
+
+    private:
+        IO::MappedFile m_file;
+        Atlas          m_atlas;
+    };
+
+    // Next to the backend's other state (the clean journal)
+    fs::path DefaultPath(const Sys::Backend& be);
+
+}  // namespace FontCache
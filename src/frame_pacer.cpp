@@ -0,0 +1,45 @@
+#include "frame_pacer.h"
+
+#include <cmath>
+
+namespace Anim {
+
+    void FramePacer::WakeIn(double seconds) {
+        const double at = m_now + (seconds > 0.0 ? seconds : 0.0);
+        if (m_deadline < 0.0 || at < m_deadline) m_deadline = at;
+    }
+
+    void FramePacer::Wake() {
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        if (!m_woken.exchange(true, std::memory_order_acq_rel) && m_hook) m_hook(m_hookCtx);
+    }
+
+    bool FramePacer::ShouldRender(double now) {
+        if (m_woken.exchange(false, std::memory_order_acq_rel)) RequestFrames(1);
+        return m_pending > 0 || (m_deadline >= 0.0 && now >= m_deadline);
+    }
+
+    double FramePacer::WaitSeconds(double now) {
+        if (ShouldRender(now)) return 0.0;
+        return m_deadline >= 0.0 ? m_deadline - now : kForever;
+    }
+
+    void FramePacer::BeginFrame(double now) {
+        m_now = now;
+        if (m_pending) m_pending--;
+        if (m_deadline >= 0.0 && now >= m_deadline) m_deadline = kForever;
+        m_keepAlive = false;
+    }
+
+    void FramePacer::EndFrame(double now) {
+        if (m_keepAlive) RequestFrames(1);
+        // Every refresh interval since the last frame that we didn't fill
+        if (m_lastFrame >= 0.0) {
+            const double missed = std::floor((now - m_lastFrame) / m_period + 0.5) - 1.0;
+            if (missed > 0.0) m_stats.skipped += (uint64_t)missed;
+        }
+        m_lastFrame = now;
+        m_stats.rendered++;
+    }
+
+}  // namespace Anim
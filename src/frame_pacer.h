@@ -0,0 +1,68 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  FRAME PACER  —  render only while something on screen changes
+// ──────────────────────────────────────────────────────────────────────────────
+//  Frame-building code reports why the *next* frame is needed: a spring that
+//  hasn't settled calls KeepAlive(), input asks for a few frames so hover and
+//  layout settle, a blinking caret or a polled progress counter asks for a
+//  frame at a later time with WakeIn().  With none of those pending the loop
+//  blocks on the OS message queue.  Other threads call Wake(), which goes
+//  through a hook (PostMessage on Windows) so a blocked loop notices.
+//  UI-agnostic: time is passed in as seconds, so it runs headless too.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Anim {
+
+    class FramePacer {
+    public:
+        struct Stats {
+            uint64_t rendered = 0;
+            uint64_t skipped  = 0;      // display refreshes that passed without a frame
+            uint64_t wakeups  = 0;      // cross-thread Wake() calls
+        };
+
+        static constexpr unsigned kInputFrames = 3;
+        static constexpr double   kForever     = -1.0;
+
+        explicit FramePacer(double refreshHz = 60.0) : m_period(1.0 / refreshHz) {}
+
+        void SetRefresh(double hz) { if (hz > 0.0) m_period = 1.0 / hz; }
+        void SetWakeHook(void (*fn)(void*), void* ctx) { m_hook = fn; m_hookCtx = ctx; }
+
+        // While building a frame (UI thread)
+        void KeepAlive()                 { m_keepAlive = true; }
+        void RequestFrames(unsigned n)   { if (n > m_pending) m_pending = n; }
+        void WakeIn(double seconds);
+
+        // Any thread
+        void Wake();
+
+        // Loop (UI thread)
+        bool   ShouldRender(double now);
+        double WaitSeconds(double now);     // 0: render now, kForever: block until a message
+        void   BeginFrame(double now);
+        void   EndFrame(double now);
+
+        Stats GetStats() const {
+            Stats s = m_stats;
+            s.wakeups = m_wakeups.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        double   m_period;
+        double   m_now       = 0.0;         // of the frame being built
+        double   m_deadline  = kForever;    // earliest WakeIn() target
+        double   m_lastFrame = -1.0;
+        unsigned m_pending   = 1;           // first frame always renders
+        bool     m_keepAlive = false;
+        std::atomic<bool> m_woken{ false };
+        std::atomic<uint64_t> m_wakeups{ 0 };
+        void   (*m_hook)(void*) = nullptr;
+        void*    m_hookCtx   = nullptr;
+        Stats    m_stats;
+    };
+
+}  // namespace Anim
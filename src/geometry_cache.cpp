@@ -0,0 +1,100 @@
+#include "geometry_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Geo {
+
+    static constexpr double kTau = 6.283185307179586;
+
+    // One extra entry so interpolation never wraps
+    struct Table {
+        float cos[kLut + 1], sin[kLut + 1];
+        Table() {
+            for (unsigned i = 0; i <= kLut; i++) {
+                cos[i] = (float)std::cos(kTau * i / kLut);
+                sin[i] = (float)std::sin(kTau * i / kLut);
+            }
+        }
+    };
+    static const Table g_table;
+
+    void CosSin(float angle, float& c, float& s) {
+        const float    x = angle * (float)(kLut / kTau);
+        const float    f = std::floor(x);
+        const unsigned i = (unsigned)(int32_t)f & (kLut - 1);
+        const float    t = x - f;
+        c = g_table.cos[i] + (g_table.cos[i + 1] - g_table.cos[i]) * t;
+        s = g_table.sin[i] + (g_table.sin[i + 1] - g_table.sin[i]) * t;
+    }
+
+    void Arc(float cx, float cy, float r, float a0, float a1, unsigned segments, Point* out) {
+        const float step = segments ? (a1 - a0) / (float)segments : 0.0f;
+        for (unsigned i = 0; i <= segments; i++) {
+            float c, s;
+            CosSin(a0 + step * (float)i, c, s);
+            out[i] = { cx + c * r, cy + s * r };
+        }
+    }
+
+    const Mesh* Cache::Find(uint64_t key) {
+        if (!m_enabled) return nullptr;
+        auto it = m_map.find(key);
+        if (it == m_map.end()) { m_cur.misses++; return nullptr; }
+        Mesh& m = it->second;
+        m.used = m_frame;
+        m_cur.hits++;
+        m_cur.vtxReplayed += m.vtx.size();
+        m_cur.idxReplayed += m.idx.size();
+        return &m;
+    }
+
+    bool Cache::Admit(uint64_t key) {
+        if (!m_enabled) return false;
+        const bool again = std::find(m_missedPrev.begin(), m_missedPrev.end(), key) != m_missedPrev.end();
+        if (!again && m_missed.size() < kMaxEntries) m_missed.push_back(key);
+        return again;
+    }
+
+    void Cache::Store(uint64_t key, Mesh&& m) {
+        if (!m_enabled) return;
+        if (m_map.size() >= kMaxEntries && !m_map.count(key)) EvictOldest();
+        m.used = m_frame;
+        m_map[key] = std::move(m);
+        m_cur.stored++;
+    }
+
+    void Cache::EvictOldest() {
+        auto oldest = m_map.end();
+        for (auto it = m_map.begin(); it != m_map.end(); ++it)
+            if (oldest == m_map.end() || it->second.used < oldest->second.used) oldest = it;
+        if (oldest == m_map.end()) return;
+        m_map.erase(oldest);
+        m_cur.evicted++;
+    }
+
+    void Cache::EndFrame() {
+        for (auto it = m_map.begin(); it != m_map.end();) {
+            if (m_frame - it->second.used > kMaxAge) { it = m_map.erase(it); m_cur.evicted++; }
+            else ++it;
+        }
+        m_missedPrev.swap(m_missed);
+        m_missed.clear();
+        m_last = m_cur;
+        m_cur  = FrameStats{};
+        m_frame++;
+    }
+
+    void Cache::Clear() {
+        m_map.clear();
+        m_missed.clear();
+        m_missedPrev.clear();
+    }
+
+    size_t Cache::Bytes() const {
+        size_t n = 0;
+        for (auto& kv : m_map) n += kv.second.vtx.capacity() * sizeof(Vertex) + kv.second.idx.capacity() * sizeof(uint32_t);
+        return n;
+    }
+
+}  // namespace Geo
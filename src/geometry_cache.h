@@ -0,0 +1,135 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  GEOMETRY CACHE  —  custom widgets tessellated once, replayed while unchanged
+// ──────────────────────────────────────────────────────────────────────────────
+//  The toggles, sliders, score ring and sidebar draw the same rounded rects,
+//  circles and glows frame after frame.  Their tessellated vertices are kept
+//  here, keyed by the widget's state (size, colours, quantized animation
+//  progress) relative to its origin.  The UI replays a hit straight into the
+//  draw list at the widget's current position, so scrolling doesn't change
+//  the key.
+//
+//  Admission: a key is stored the second frame in a row that it misses.
+//  Widgets that animate change key every frame; this way they never churn
+//  the table, and a widget that has settled is cached from its next frame.
+//  Entries unused for kMaxAge frames are evicted, and so is the least
+//  recently used one when the table is full.
+//
+//  Retained() is the whole replay / record path.  The widgets run it over
+//  their ImDrawList; the headless bench runs the same code over plain
+//  vectors.
+//
+//  Arcs use a sine/cosine table with linear interpolation instead of calling
+//  cosf/sinf per point.  The error is under 5e-6 of the radius.
+//
+//  Not thread-safe: the UI thread owns the cache.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Geo {
+
+    // ── Trig table ────────────────────────────────────────────────────────────
+    static constexpr unsigned kLut = 1024;      // entries per turn, a power of two
+
+    void CosSin(float angle, float& c, float& s);   // radians, any range
+
+    struct Point { float x, y; };
+    // segments + 1 points from a0 to a1 (radians) on the circle (cx, cy, r)
+    void Arc(float cx, float cy, float r, float a0, float a1, unsigned segments, Point* out);
+
+    // ── Retained meshes ───────────────────────────────────────────────────────
+    struct Vertex {                 // ImDrawVert's default layout
+        float    x, y;              // relative to the widget's origin
+        float    u, v;
+        uint32_t col;
+    };
+
+    struct Mesh {
+        std::vector<Vertex>   vtx;
+        std::vector<uint32_t> idx;  // into vtx
+        uint32_t              used = 0;     // frame last drawn
+    };
+
+    // FNV-1a over a widget's state; combine fields with Mix()
+    struct Key {
+        uint64_t h = 1469598103934665603ull;
+        Key& Mix(const void* p, size_t n) {
+            for (size_t i = 0; i < n; i++) h = (h ^ ((const uint8_t*)p)[i]) * 1099511628211ull;
+            return *this;
+        }
+        template <class T> Key& Mix(const T& v) { return Mix(&v, sizeof(v)); }
+        Key& Mix(float v, float quantum) { return Mix((int32_t)(v / quantum + (v < 0 ? -0.5f : 0.5f))); }
+    };
+
+    struct FrameStats {
+        uint32_t hits = 0, misses = 0, stored = 0, evicted = 0;
+        uint64_t vtxReplayed = 0, idxReplayed = 0;          // from the cache
+        uint64_t vtxTessellated = 0, idxTessellated = 0;    // drawn live
+    };
+
+    class Cache {
+    public:
+        static constexpr size_t   kMaxEntries = 256;
+        static constexpr uint32_t kMaxAge     = 600;        // frames
+
+        // The mesh for `key` if cached (marks it used), else null
+        const Mesh* Find(uint64_t key);
+        // After a miss: true if `key` also missed last frame, so the caller
+        // should record what it draws and Store() it
+        bool        Admit(uint64_t key);
+        void        Store(uint64_t key, Mesh&& m);
+        // Live geometry drawn after a miss, for the report
+        void        CountTessellated(size_t vtx, size_t idx) {
+            m_cur.vtxTessellated += vtx;
+            m_cur.idxTessellated += idx;
+        }
+
+        // Closes the frame: ages and evicts, makes its stats Last()
+        void EndFrame();
+        void Clear();
+
+        void              SetEnabled(bool on) { if (!on) Clear(); m_enabled = on; }
+        bool              Enabled() const     { return m_enabled; }
+        const FrameStats& Last() const        { return m_last; }
+        size_t            Entries() const     { return m_map.size(); }
+        size_t            Bytes() const;
+
+    private:
+        void EvictOldest();
+
+        std::unordered_map<uint64_t, Mesh> m_map;
+        std::vector<uint64_t>              m_missed, m_missedPrev;
+        uint32_t                           m_frame = 1;
+        bool                               m_enabled = true;
+        FrameStats                         m_cur, m_last;
+    };
+
+    // Replays the cached mesh for `key` at (ox, oy).  On a miss, runs `draw`,
+    // which must place everything relative to the origin, and records its
+    // output once the key has missed two frames running.  `L` is the draw
+    // list:
+    //     M    Mark() const                          where the next draw starts
+    //     void Drawn(const M&, size_t& vtx, size_t& idx) const
+    //     bool Take(const M&, float ox, float oy, Mesh& out) const
+    //                                                false: not one replayable block
+    //     void Replay(const Mesh&, float ox, float oy)
+    template <class L, class Fn>
+    void Retained(Cache& cache, L& list, uint64_t key, float ox, float oy, Fn&& draw) {
+        if (const Mesh* m = cache.Find(key)) {
+            if (!m->idx.empty()) list.Replay(*m, ox, oy);
+            return;
+        }
+        const bool record = cache.Admit(key);
+        const auto mark   = list.Mark();
+        draw();
+        size_t vtx = 0, idx = 0;
+        list.Drawn(mark, vtx, idx);
+        cache.CountTessellated(vtx, idx);
+        Mesh m;
+        if (record && list.Take(mark, ox, oy, m)) cache.Store(key, std::move(m));
+    }
+
+}  // namespace Geo
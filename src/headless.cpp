@@ -0,0 +1,472 @@
+#include "headless.h"
+#include "headless_steps.h"
+
+#include "backend.h"
+#include "boost_scheduler.h"
+#include "clean_index.h"
+#include "json_writer.h"
+#include "profiler.h"
+#include "profile_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef XOPT_VERSION
+#define XOPT_VERSION "dev"
+#endif
+
+namespace Headless {
+
+    // The --bench-NAME [N] modes, in the order they run; Args::bench follows it
+    static const BenchMode* const kBenches[] = {
+        &kBenchAnim, &kBenchActions, &kBenchNotify, &kBenchFontCache, &kBenchGeometry, &kBenchUiRegress,
+    };
+    static constexpr size_t kBenchCount = std::size(kBenches);
+
+    static void Usage(FILE* f) {
+        std::fputs(
+            "usage: xopt-cli [--clean] [--dry-run] [--profile NAME] [options]\n"
+            "\n"
+            "  --clean            wipe the temp roots (incremental via the journal)\n"
+            "  --dry-run          scan only, report what --clean would reclaim\n"
+            "  --profile NAME     switch to a stored boost profile after cleaning, as one\n"
+            "                     transaction: any failure rolls every step back\n"
+            "  --serial           run profile steps one by one on this thread instead of\n"
+            "                     in parallel on the boost scheduler\n"
+            "  --save-profile NAME  store the current tweak state as profile NAME\n"
+            "  --spawn            apply tweaks and the DNS flush through the command-line\n"
+            "                     helpers (powercfg, sc, systemctl…) instead of in-process\n"
+            "  --root DIR         clean DIR instead of the OS defaults (repeatable)\n"
+            "  --no-journal       full scan, don't read or write the journal\n"
+            "  --min-age SEC      keep files modified within the last SEC seconds\n"
+            "  --threads N        cleaner worker count (default: all cores)\n"
+            "  --backend NAME     native (default) or mock — mock touches nothing\n"
+            "  --mock-fail KEY    mock: make tweak KEY fail (repeatable)\n"
+            "  --mock-delay KEY=MS  mock: tweak KEY takes MS ms, like a slow helper\n"
+            "  --mock-crash-after N  mock: exit mid-profile after N tweak calls; the\n"
+            "                     next run rolls the interrupted switch back\n"
+            "  --analyze FILE     decode FILE (wav/flac, mp3 on Windows) through the\n"
+            "                     spectrum analyser and report the averaged bands\n"
+            "  --play FILE|DIR    run FILE (or every track under DIR, gaplessly) through\n"
+            "                     the playback engine and report callback timing,\n"
+            "                     underruns and track switches\n"
+            "  --sink SPEC        --play output: null-fast (default), null (real time),\n"
+            "                     wav:PATH, default (the system device)\n", f);
+        for (const BenchMode* m : kBenches) std::fputs(m->usage, f);
+        std::fputs(
+            "  --bench-score      run the boost benchmark suite (timer jitter, wake\n"
+            "                     latency, memory, single core, small files), save it\n"
+            "                     to the history and flag regressions against the last\n"
+            "                     run; with --profile, measure before and after it\n"
+            "  --latency SEC      sample timer-wake and thread-wake latency for SEC\n"
+            "                     seconds (after any --profile) and report p50 / p99 /\n"
+            "                     p99.9 and the sampler's own CPU cost\n"
+            "  --latency-hz N     sampling rate (default 100)\n"
+            "  --latency-csv FILE write the latency histograms to FILE\n"
+            "  --telemetry SEC    sample CPU / memory / disk / network counters for SEC\n"
+            "                     seconds; reports the averages, the cost per sample\n"
+            "                     and heap allocations in steady state (should be 0)\n"
+            "  --telemetry-hz N   sampling rate, 1-20 (default 10)\n"
+            "  --reclaim SEC      watch memory for SEC seconds; below the threshold, trim\n"
+            "                     idle background processes and report bytes per action\n"
+            "  --reclaim-below PCT  act below PCT% of RAM available (default 10)\n"
+            "  --reclaim-idle SEC   only processes idle that long (default 30)\n"
+            "  --reclaim-protect PID  never touch PID's process tree (the game)\n"
+            "  --reclaim-force    reclaim on the last poll even with memory to spare\n"
+            "  --reclaim-synthetic  trim an idle child holding a mapped file next to a\n"
+            "                     protected \"game\" child and check both (fake\n"
+            "                     processes and memory groups with --backend mock)\n"
+            "  --govern PID       pin PID's process tree to the fast cores, move other\n"
+            "                     heavy processes off them, restore all on exit\n"
+            "  --govern-for SEC   stop governing after SEC seconds (and restore)\n"
+            "  --govern-synthetic SEC  govern a spinning child \"game\" next to a\n"
+            "                     spinning \"hog\" for SEC seconds, then check the pinning\n"
+            "                     and the restore (fake processes with --backend mock)\n"
+            "  --trace FILE       record profiler zones for the whole run (cleaner phases,\n"
+            "                     tweak steps, helpers, playback) and write them to FILE\n"
+            "                     as a Chrome trace; also reports the cost of one zone\n"
+            "  --list             list stored profiles, tweaks and their state\n"
+            "  --pretty           indent the JSON report\n", f);
+    }
+
+    static bool ParseArgs(int argc, char** argv, Args& a) {
+        a.bench.assign(kBenchCount, 0);
+        for (int i = 1; i < argc; i++) {
+            const char* s = argv[i];
+            auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+            size_t b = 0;
+            while (b < kBenchCount && std::strcmp(s, kBenches[b]->flag)) b++;
+            if (b < kBenchCount) {
+                a.bench[b] = kBenches[b]->defaultN;
+                if (i + 1 < argc && argv[i + 1][0] != '-') a.bench[b] = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+                if (a.bench[b] < kBenches[b]->minN) return false;
+                continue;
+            }
+            if      (!std::strcmp(s, "--clean"))      a.clean   = true;
+            else if (!std::strcmp(s, "--dry-run"))    a.dryRun  = a.clean = true;
+            else if (!std::strcmp(s, "--no-journal")) a.journal = false;
+            else if (!std::strcmp(s, "--pretty"))     a.pretty  = true;
+            else if (!std::strcmp(s, "--list"))       a.list    = true;
+            else if (!std::strcmp(s, "--profile")) {
+                const char* v = next(); if (!v) return false;
+                a.profile = v;
+            } else if (!std::strcmp(s, "--save-profile")) {
+                const char* v = next(); if (!v || !*v) return false;
+                a.saveProfile = v;
+            } else if (!std::strcmp(s, "--mock-fail")) {
+                const char* v = next(); if (!v) return false;
+                a.mockFail.push_back(v);
+            } else if (!std::strcmp(s, "--mock-delay")) {
+                const char* v = next(); if (!v || !std::strchr(v, '=')) return false;
+                a.mockDelay.push_back(v);
+            } else if (!std::strcmp(s, "--serial")) {
+                a.serial = true;
+            } else if (!std::strcmp(s, "--spawn")) {
+                a.spawn = true;
+            } else if (!std::strcmp(s, "--mock-crash-after")) {
+                const char* v = next(); if (!v) return false;
+                a.mockCrash = (unsigned)std::strtoul(v, nullptr, 10);
+            } else if (!std::strcmp(s, "--root")) {
+                const char* v = next(); if (!v) return false;
+                a.roots.push_back(fs::u8path(v));
+            } else if (!std::strcmp(s, "--threads")) {
+                const char* v = next(); if (!v) return false;
+                a.threads = (unsigned)std::strtoul(v, nullptr, 10);
+            } else if (!std::strcmp(s, "--min-age")) {
+                const char* v = next(); if (!v) return false;
+                a.minAge = (int64_t)std::strtoul(v, nullptr, 10);
+            } else if (!std::strcmp(s, "--backend")) {
+                const char* v = next(); if (!v) return false;
+                a.backend = v;
+            } else if (!std::strcmp(s, "--analyze")) {
+                const char* v = next(); if (!v) return false;
+                a.analyze = fs::u8path(v);
+            } else if (!std::strcmp(s, "--play")) {
+                const char* v = next(); if (!v) return false;
+                a.play = fs::u8path(v);
+            } else if (!std::strcmp(s, "--sink")) {
+                const char* v = next(); if (!v) return false;
+                a.sink = v;
+            } else if (!std::strcmp(s, "--bench-score")) {
+                a.benchScore = true;
+            } else if (!std::strcmp(s, "--latency")) {
+                const char* v = next(); if (!v) return false;
+                a.latencySec = std::strtod(v, nullptr);
+                if (!(a.latencySec > 0.0)) return false;
+            } else if (!std::strcmp(s, "--telemetry")) {
+                const char* v = next(); if (!v) return false;
+                a.telemetrySec = std::strtod(v, nullptr);
+                if (!(a.telemetrySec > 0.0)) return false;
+            } else if (!std::strcmp(s, "--telemetry-hz")) {
+                const char* v = next(); if (!v) return false;
+                a.telemetryHz = (unsigned)std::strtoul(v, nullptr, 10);
+                if (!a.telemetryHz) return false;
+            } else if (!std::strcmp(s, "--latency-hz")) {
+                const char* v = next(); if (!v) return false;
+                a.latencyHz = (unsigned)std::strtoul(v, nullptr, 10);
+                if (!a.latencyHz) return false;
+            } else if (!std::strcmp(s, "--govern")) {
+                const char* v = next(); if (!v) return false;
+                a.governPid = (uint32_t)std::strtoul(v, nullptr, 10);
+                if (!a.governPid) return false;
+            } else if (!std::strcmp(s, "--govern-for")) {
+                const char* v = next(); if (!v) return false;
+                a.governFor = std::strtod(v, nullptr);
+            } else if (!std::strcmp(s, "--govern-synthetic")) {
+                const char* v = next(); if (!v) return false;
+                a.governSynthetic = std::strtod(v, nullptr);
+                if (!(a.governSynthetic > 0.0)) return false;
+            } else if (!std::strcmp(s, "--reclaim")) {
+                const char* v = next(); if (!v) return false;
+                a.reclaimSec = std::strtod(v, nullptr);
+                if (!(a.reclaimSec > 0.0)) return false;
+            } else if (!std::strcmp(s, "--reclaim-below")) {
+                const char* v = next(); if (!v) return false;
+                a.reclaim.lowPct    = std::strtod(v, nullptr);
+                a.reclaim.targetPct = std::min(100.0, a.reclaim.lowPct + 10.0);
+            } else if (!std::strcmp(s, "--reclaim-idle")) {
+                const char* v = next(); if (!v) return false;
+                a.reclaim.minIdleSec = std::strtod(v, nullptr);
+            } else if (!std::strcmp(s, "--reclaim-protect")) {
+                const char* v = next(); if (!v) return false;
+                a.reclaimProtect = (uint32_t)std::strtoul(v, nullptr, 10);
+            } else if (!std::strcmp(s, "--reclaim-force")) {
+                a.reclaimForce = true;
+            } else if (!std::strcmp(s, "--reclaim-synthetic")) {
+                a.reclaimSynthetic = true;
+            } else if (!std::strcmp(s, "--hog")) {              // internal: the synthetic workload
+                const char* v = next(); const char* w = next(); if (!v || !w) return false;
+                a.hogMb  = (unsigned)std::strtoul(v, nullptr, 10);
+                a.hogSec = std::strtod(w, nullptr);
+                if (!a.hogMb || !(a.hogSec > 0.0)) return false;
+            } else if (!std::strcmp(s, "--spin")) {             // internal: the synthetic workload
+                const char* v = next(); if (!v) return false;
+                a.spinSec = std::strtod(v, nullptr);
+                if (i + 1 < argc && argv[i + 1][0] != '-') a.spinThreads = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+                if (!(a.spinSec > 0.0) || !a.spinThreads) return false;
+            } else if (!std::strcmp(s, "--trace")) {
+                const char* v = next(); if (!v) return false;
+                a.trace = fs::u8path(v);
+            } else if (!std::strcmp(s, "--latency-csv")) {
+                const char* v = next(); if (!v) return false;
+                a.latencyCsv = fs::u8path(v);
+            } else return false;
+        }
+        return a.clean || a.list || !a.profile.empty() || !a.saveProfile.empty() ||
+               !a.analyze.empty() || !a.play.empty() ||
+               std::any_of(a.bench.begin(), a.bench.end(), [](unsigned n) { return n != 0; }) || a.benchScore ||
+               a.latencySec > 0.0 || a.telemetrySec > 0.0 || a.reclaimSec > 0.0 || a.reclaimSynthetic ||
+               a.hogMb || a.governPid || a.governSynthetic > 0.0 || a.spinSec > 0.0;
+    }
+
+    static void ListProfiles(const Sys::Backend& be, const Tweaks::ProfileStore& store, IO::JsonWriter& js) {
+        js.Field("store", store.File().u8string()).Field("active", store.Active());
+        js.Key("profiles").BeginArray();
+        for (auto& p : store.Profiles()) {
+            js.BeginObject().Field("name", p.name).Field("desc", p.desc);
+            js.Key("steps").BeginArray();
+            for (auto& st : p.steps)
+                js.BeginObject().Field("tweak", Tweaks::Describe(st.first).key).Field("on", st.second).EndObject();
+            js.EndArray().EndObject();
+        }
+        js.EndArray();
+        const Tweaks::TweakState cur = store.Current(be);
+        js.Key("tweaks").BeginArray();
+        for (size_t i = 0; i < (size_t)Tweaks::Id::Count; i++) {
+            const Tweaks::Info& t = Tweaks::Describe((Tweaks::Id)i);
+            js.BeginObject().Field("key", t.key).Field("label", t.label)
+              .Field("supported", be.Supported(t.id));
+            if (cur.Has(t.id)) js.Field("on", cur.On(t.id));
+            js.EndObject();
+        }
+        js.EndArray();
+    }
+
+    // Scan (+ commit) the roots; returns false if anything failed outright
+    static bool RunClean(const Args& a, Sys::Backend& be, IO::JsonWriter& js) {
+        std::vector<fs::path> roots = a.roots.empty() ? be.CleanRoots() : a.roots;
+        if (roots.empty()) {
+            js.BeginObject().Field("step", "scan").Field("status", "failed")
+              .Field("error", "no default clean roots on this OS; pass --root").EndObject();
+            return false;
+        }
+
+        Cleaner::Options opt;
+        opt.threads       = a.threads;
+        opt.minAgeSeconds = a.minAge >= 0 ? (uint32_t)a.minAge : be.CleanMinAge();
+
+        Cleaner::Journal journal;
+        const bool useJournal = a.journal && !a.dryRun;
+        const fs::path jpath  = be.JournalPath();
+        if (useJournal) journal.Load(jpath);
+
+        auto t0 = Clock::now();
+        Cleaner::Index idx = Cleaner::Scan(roots, opt, useJournal ? &journal : nullptr);
+        js.BeginObject().Field("step", "scan").Field("status", "ok").Field("ms", Ms(t0))
+          .Field("files", idx.FileCount()).Field("dirs", idx.DirCount())
+          .Field("reclaimable_bytes", idx.ReclaimableBytes())
+          .Field("index_bytes", (uint64_t)idx.MemoryBytes());
+        js.Key("roots").BeginArray();
+        for (auto& r : idx.Roots())
+            js.BeginObject().Field("path", r.path.u8string()).Field("files", r.files)
+              .Field("bytes", r.bytes).Field("locked_files", r.lockedFiles)
+              .Field("unchanged_dirs", r.cleanDirs).EndObject();
+        js.EndArray().EndObject();
+        if (a.dryRun) return true;
+
+        t0 = Clock::now();
+        std::vector<Cleaner::Result> res = Cleaner::Commit(idx, opt, useJournal ? &journal : nullptr);
+        Cleaner::Result sum;
+        for (auto& r : res) {
+            sum.filesRemoved += r.filesRemoved; sum.dirsRemoved += r.dirsRemoved;
+            sum.errors       += r.errors;       sum.bytesFreed  += r.bytesFreed;
+        }
+        // Locked / in-use entries are expected in temp folders — not a failure
+        js.BeginObject().Field("step", "commit").Field("status", "ok").Field("ms", Ms(t0))
+          .Field("files", sum.filesRemoved).Field("dirs", sum.dirsRemoved)
+          .Field("skipped", sum.errors).Field("bytes_freed", sum.bytesFreed).EndObject();
+
+        bool ok = true;
+        if (useJournal) {
+            t0 = Clock::now();
+            const bool saved = journal.Save(jpath);
+            ok = saved && ok;
+            js.BeginObject().Field("step", "journal").Field("status", saved ? "ok" : "failed")
+              .Field("ms", Ms(t0)).Field("path", jpath.u8string()).EndObject();
+        }
+
+        // DNS cache only belongs to the default (system) clean
+        if (a.roots.empty()) {
+            t0 = Clock::now();
+            Sys::SetCallError(Tweaks::Error::None);
+            const bool flushed = be.FlushDns();
+            ok = flushed && ok;
+            js.BeginObject().Field("step", "dns").Field("status", flushed ? "ok" : "failed")
+              .Field("ms", Ms(t0));
+            if (!flushed) js.Field("error", Tweaks::ErrorName(Sys::CallError()));
+            js.EndObject();
+        }
+        return ok;
+    }
+
+    static void TweakStep(const char* step, const Tweaks::StepResult& r, IO::JsonWriter& js) {
+        js.BeginObject().Field("step", step).Field("tweak", Tweaks::Describe(r.id).key)
+          .Field("on", r.on).Field("status", Tweaks::StatusName(r.status));
+        if (r.status != Tweaks::Status::Skipped) js.Field("ms", r.ms);
+        if (r.slow) js.Field("slow", true);
+        if (r.error != Tweaks::Error::None && r.status != Tweaks::Status::Skipped)
+            js.Field("error", Tweaks::ErrorName(r.error));
+        js.EndObject();
+    }
+
+    // Rollback steps of a failed or interrupted switch, then its verdict
+    static void TxSummary(const char* step, const std::string& name,
+                          const Tweaks::ProfileStore::TxResult& tx, double ms, IO::JsonWriter& js,
+                          const std::function<void()>& extra = {}) {
+        for (auto& r : tx.undo) TweakStep("rollback", r, js);
+        js.BeginObject().Field("step", step);
+        if (!name.empty()) js.Field("profile", name);
+        js.Field("status", tx.ok && !tx.rolledBack ? "ok" : tx.rolledBack ? "rolled_back" : "failed")
+          .Field("ms", ms);
+        if (!tx.error.empty()) js.Field("error", tx.error);
+        if (extra) extra();
+        js.EndObject();
+    }
+
+    // Steps are reported as they finish; "serial_ms" is what running them
+    // back to back would have cost
+    static bool RunProfile(Sys::Backend& be, Tweaks::ProfileStore& store, const std::string& name,
+                           bool serial, IO::JsonWriter& js) {
+        const auto t0 = Clock::now();
+        auto onStep = [&](const Tweaks::StepResult& r) { TweakStep("tweak", r, js); };
+        Tweaks::ProfileStore::TxResult tx;
+        unsigned workers = 1, peak = 1;
+        if (serial) {
+            tx = store.Switch(be, name, onStep);
+        } else {
+            Tweaks::Switcher sw(store, be);
+            Tweaks::Switcher::Outcome o = sw.Run(*store.Find(name), onStep);
+            tx      = std::move(o.tx);
+            workers = sw.Pool().Workers();
+            peak    = o.peak;
+        }
+        double serialMs = 0.0;
+        for (auto& r : tx.steps) serialMs += r.ms;
+        TxSummary("profile", name, tx, Ms(t0), js, [&] {
+            js.Field("mode", serial ? "serial" : "parallel").Field("serial_ms", serialMs)
+              .Field("workers", (uint64_t)workers).Field("peak_parallel", (uint64_t)peak);
+        });
+        return tx.ok;
+    }
+
+    static bool SaveProfile(const Sys::Backend& be, Tweaks::ProfileStore& store, const std::string& name,
+                            IO::JsonWriter& js) {
+        const Tweaks::Profile p = store.Capture(be, name);
+        const bool ok = store.Put(p) && store.Save();
+        js.BeginObject().Field("step", "save_profile").Field("profile", name)
+          .Field("status", ok ? "ok" : "failed").Field("tweaks", (uint64_t)p.steps.size()).EndObject();
+        return ok;
+    }
+
+    int Run(int argc, char** argv) {
+        const auto start = Clock::now();
+        Args a;
+        if (!ParseArgs(argc, argv, a)) { Usage(stderr); return 2; }
+        if (a.spinSec > 0.0) return Spin(a.spinSec, a.spinThreads);
+        if (a.hogMb)         return Hog(a.hogMb, a.hogSec);
+        if (!a.trace.empty()) {
+            Prof::SetThreadName("main");
+            Prof::Start();
+        }
+
+        Sys::Backend* be = Sys::Find(a.backend);
+        if (!be) {
+            std::fprintf(stderr, "unknown backend '%s'\n", a.backend.c_str());
+            return 2;
+        }
+        if (a.spawn) be->SetActionPath(Sys::ActionPath::Spawn);
+        if (!a.mockFail.empty() || !a.mockDelay.empty() || a.mockCrash) {
+            auto* mock = dynamic_cast<Sys::MockBackend*>(be);
+            if (!mock) { std::fputs("--mock-* options need --backend mock\n", stderr); return 2; }
+            for (auto& key : a.mockFail) {
+                Tweaks::Id id;
+                if (!Tweaks::FindKey(key, id)) {
+                    std::fprintf(stderr, "unknown tweak '%s' (see --list)\n", key.c_str());
+                    return 2;
+                }
+                mock->FailOn(id);
+            }
+            for (auto& kv : a.mockDelay) {
+                const size_t eq = kv.find('=');
+                Tweaks::Id id;
+                if (!Tweaks::FindKey(kv.substr(0, eq), id)) {
+                    std::fprintf(stderr, "unknown tweak '%s' (see --list)\n", kv.substr(0, eq).c_str());
+                    return 2;
+                }
+                mock->DelayOn(id, (unsigned)std::strtoul(kv.c_str() + eq + 1, nullptr, 10));
+            }
+        }
+
+        // Opening the store also rolls back a switch a crash interrupted
+        const bool useStore = a.list || !a.profile.empty() || !a.saveProfile.empty();
+        Tweaks::ProfileStore store(Tweaks::DefaultStorePath(*be));
+        Tweaks::ProfileStore::TxResult recovered;
+        const auto r0 = Clock::now();
+        if (useStore) store.Open(*be, &recovered);
+        const double recoverMs = Ms(r0);
+        if (!a.profile.empty() && !store.Find(a.profile)) {
+            std::fprintf(stderr, "unknown profile '%s' (see --list)\n", a.profile.c_str());
+            return 2;
+        }
+        // Armed only now, so the crash lands inside the switch itself
+        if (a.mockCrash) static_cast<Sys::MockBackend*>(be)->CrashAfter(a.mockCrash);
+
+        IO::JsonWriter js(stdout, a.pretty);
+        js.BeginObject().Field("tool", "x-opt").Field("version", XOPT_VERSION)
+          .Field("backend", be->Name());
+        if (a.list) ListProfiles(*be, store, js);
+
+        bool ok = true;
+        js.Key("steps").BeginArray();
+        if (recovered.rolledBack) {
+            TxSummary("recover", "", recovered, recoverMs, js);
+            ok = recovered.ok && ok;
+        }
+        if (a.clean)  ok = RunClean(a, *be, js) && ok;
+        Bench::History hist(Bench::DefaultHistoryPath(*be));
+        if (a.benchScore) hist.Load();
+        Bench::Result before, after;
+        if (a.benchScore && !a.profile.empty())
+            ok = RunBenchScore(hist, "before:" + a.profile, js, &before) && ok;
+        if (!a.profile.empty())     ok = RunProfile(*be, store, a.profile, a.serial, js) && ok;
+        if (a.benchScore) {
+            ok = RunBenchScore(hist, a.profile.empty() ? "manual" : "after:" + a.profile, js, &after) && ok;
+            if (!a.profile.empty()) BenchDelta(a.profile, before, after, js);
+        }
+        if (a.latencySec > 0.0)     ok = RunLatency(a, js) && ok;
+        if (a.telemetrySec > 0.0)   ok = RunTelemetry(a, js) && ok;
+        if (a.reclaimSec > 0.0)     ok = RunReclaim(*be, a, js) && ok;
+        if (a.reclaimSynthetic)     ok = RunReclaimSynthetic(*be, argv[0], js) && ok;
+        if (a.governPid)            ok = RunGovern(*be, a, js) && ok;
+        if (a.governSynthetic > 0.0) ok = RunGovernSynthetic(*be, a.governSynthetic, argv[0], js) && ok;
+        if (!a.saveProfile.empty()) ok = SaveProfile(*be, store, a.saveProfile, js) && ok;
+        if (!a.analyze.empty()) ok = RunAnalyze(a.analyze, js) && ok;
+        if (!a.play.empty())    ok = RunPlay(a, js) && ok;
+        for (size_t b = 0; b < kBenchCount; b++)
+            if (a.bench[b])     ok = kBenches[b]->run(*be, a, a.bench[b], js) && ok;
+        if (!a.trace.empty())   ok = RunTrace(a.trace, js) && ok;
+        js.EndArray();
+
+        js.Field("ok", ok).Field("total_ms", Ms(start)).EndObject();
+        js.Finish();
+        return ok ? 0 : 1;
+    }
+
+}  // namespace Headless
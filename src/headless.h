@@ -0,0 +1,19 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  HEADLESS RUNNER  —  scripted clean + boost profile, JSON timings on stdout
+// ──────────────────────────────────────────────────────────────────────────────
+//  No ImGui, fonts or graphics device: links only the engine modules, so it
+//  starts instantly and runs on machines without a desktop session.
+#pragma once
+
+#include <cstdint>
+
+namespace Headless {
+
+    // Exit codes: 0 all steps ok / skipped, 1 a step failed, 2 bad arguments
+    int Run(int argc, char** argv);
+
+    // Heap allocations so far.  Defined by the executable (cli_main.cpp
+    // counts operator new), so steps can check that a loop makes none.
+    uint64_t Allocations();
+
+}  // namespace Headless
@@ -0,0 +1,110 @@
+#include "headless_steps.h"
+#include "tweaks.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Headless {
+
+    // Per tweak: N × (flip, flip back) on each action path, timed per Set().
+    // Explorer is left out — a benchmark shouldn't kill the shell 2N times —
+    // and so is anything whose state can't be read back to restore.
+    static bool RunBenchActions(Sys::Backend& be, const Args&, unsigned n, IO::JsonWriter& js) {
+        using Sys::ActionPath;
+        const auto t0 = Clock::now();
+        const ActionPath was = be.GetActionPath();
+        struct PathStats { double ms = 0.0, worst = 0.0; unsigned calls = 0, failed = 0; Tweaks::Error error{}; };
+        auto flipFlop = [&](Tweaks::Id id, bool cur, ActionPath path) {
+            PathStats ps;
+            be.SetActionPath(path);
+            for (unsigned i = 0; i < 2 * n; i++) {
+                const Tweaks::StepResult r = Tweaks::RunStep(be, id, i % 2 == 0 ? !cur : cur,
+                                                             Tweaks::Describe(id).timeoutMs);
+                ps.calls++;
+                ps.ms   += r.ms;
+                ps.worst = std::max(ps.worst, r.ms);
+                if (r.status != Tweaks::Status::Ok) {
+                    if (!ps.failed++) ps.error = r.error;
+                    if (i % 2 == 0) break;          // nothing changed, nothing to flip back
+                }
+            }
+            return ps;
+        };
+        auto emit = [&](const PathStats& ps) {
+            js.BeginObject().Field("calls", (uint64_t)ps.calls)
+              .Field("mean_ms", ps.calls ? ps.ms / ps.calls : 0.0).Field("max_ms", ps.worst)
+              .Field("failed", (uint64_t)ps.failed);
+            if (ps.failed) js.Field("error", Tweaks::ErrorName(ps.error));
+            js.EndObject();
+        };
+
+        bool ok = true;
+        double inMs = 0.0, spawnMs = 0.0;
+        unsigned inCalls = 0, spawnCalls = 0;
+        for (unsigned i = 0; i < (unsigned)Tweaks::Id::Count; i++) {
+            const Tweaks::Id id = (Tweaks::Id)i;
+            bool cur = false;
+            const char* skip = !be.Supported(id)           ? "unsupported"
+                             : id == Tweaks::Id::KillExplorer ? "disruptive"
+                             : !be.Get(id, cur)            ? "state_unreadable"
+                                                           : nullptr;
+            js.BeginObject().Field("step", "bench_action").Field("tweak", Tweaks::Describe(id).key);
+            if (skip) { js.Field("status", "skipped").Field("reason", skip).EndObject(); continue; }
+            // Without a helper both paths run the same code: in-process only
+            const bool      both = be.Spawns(id);
+            const PathStats in   = flipFlop(id, cur, ActionPath::InProcess);
+            const PathStats sp   = both ? flipFlop(id, cur, ActionPath::Spawn) : PathStats{};
+            const bool      fine = !in.failed && !sp.failed;
+            ok = fine && ok;
+            js.Field("status", fine ? "ok" : "failed");
+            js.Key("in_process"); emit(in);
+            if (both) {
+                inMs += in.ms;  inCalls += in.calls;
+                spawnMs += sp.ms;  spawnCalls += sp.calls;
+                js.Key("spawn"); emit(sp);
+                js.Field("speedup_x", in.ms > 0.0 && in.calls == sp.calls ? sp.ms / in.ms : 0.0);
+            }
+            js.EndObject();
+        }
+
+        PathStats dns[2];
+        for (ActionPath path : { ActionPath::InProcess, ActionPath::Spawn }) {
+            PathStats& ps = dns[(int)path];
+            be.SetActionPath(path);
+            for (unsigned i = 0; i < n; i++) {
+                const auto c0 = Clock::now();
+                Sys::SetCallError(Tweaks::Error::None);
+                const bool flushed = be.FlushDns();
+                const double ms = Ms(c0);
+                ps.calls++;
+                ps.ms   += ms;
+                ps.worst = std::max(ps.worst, ms);
+                if (!flushed && !ps.failed++) ps.error = Sys::CallError();
+            }
+        }
+        be.SetActionPath(was);
+        js.BeginObject().Field("step", "bench_action").Field("tweak", "dns-flush")
+          .Field("status", dns[0].failed || dns[1].failed ? "failed" : "ok");
+        js.Key("in_process"); emit(dns[0]);
+        js.Key("spawn");      emit(dns[1]);
+        js.Field("speedup_x", dns[0].ms > 0.0 ? dns[1].ms / dns[0].ms : 0.0).EndObject();
+
+        js.BeginObject().Field("step", "bench_actions").Field("status", ok ? "ok" : "failed")
+          .Field("ms", Ms(t0)).Field("round_trips", (uint64_t)n)
+          .Field("in_process_mean_ms", inCalls ? inMs / inCalls : 0.0)
+          .Field("spawn_mean_ms", spawnCalls ? spawnMs / spawnCalls : 0.0)
+          .Field("speedup_x", inMs > 0.0 && inCalls ? (spawnMs / spawnCalls) / (inMs / inCalls) : 0.0)
+          .EndObject();
+        return ok;
+    }
+
+    const BenchMode kBenchActions = {
+        "--bench-actions", 20, 1,
+        "  --bench-actions [N]  time N on/off round trips of every supported tweak\n"
+        "                     (default 20) in-process and through the helpers; each\n"
+        "                     tweak is left as it was.  Touches the host unless\n"
+        "                     --backend mock\n",
+        RunBenchActions,
+    };
+
+}  // namespace Headless
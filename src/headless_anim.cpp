@@ -0,0 +1,131 @@
+#include "headless_steps.h"
+#include "anim.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Headless {
+
+    // N widgets per frame, ids hashed like ImGuiIDs.  "moving": every spring
+    // retargeted each 30 frames so all integrate; "settled": same targets,
+    // the common idle case; "map": the old immediate-mode std::map<id, State>
+    // store doing the same moving workload, for reference.  The fixed-step
+    // checks replay one scripted second at several frame rates and on every
+    // ISA the CPU has, and require bit-identical springs.
+    static bool RunBenchAnim(Sys::Backend&, const Args&, unsigned n, IO::JsonWriter& js) {
+        using Isa = Anim::Animator::Isa;
+        const auto t0 = Clock::now();
+        constexpr unsigned kFrames = 300;
+        constexpr double   kDt     = 1.0 / 60.0;
+        std::vector<uint32_t> ids(n);
+        uint32_t x = 2166136261u;
+        for (uint32_t& id : ids) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; id = x; }
+        float sink = 0.0f;                  // keeps the optimiser honest
+        auto perCall = [&](Clock::time_point since, unsigned frames) {
+            return std::chrono::duration<double, std::nano>(Clock::now() - since).count() / ((double)frames * n);
+        };
+
+        Anim::Animator anim(64);
+        auto t = Clock::now();
+        for (unsigned i = 0; i < n; i++) sink += anim.Animate(ids[i], 0.0f);
+        anim.EndFrame(kDt);
+        const double insertNs = perCall(t, 1);
+
+        auto moving = [&](Anim::Animator& an) {
+            const auto s0 = Clock::now();
+            for (unsigned f = 0; f < kFrames; f++) {
+                const float target = (f / 30) & 1 ? 0.0f : 1.0f;
+                for (unsigned i = 0; i < n; i++) sink += an.Animate(ids[i], target);
+                an.EndFrame(kDt);
+            }
+            return perCall(s0, kFrames);
+        };
+        const double movingNs = moving(anim);
+        const uint64_t springSteps = anim.GetStats().springSteps;
+
+        for (unsigned f = 0; f < 240; f++) {            // let every spring come to rest
+            for (unsigned i = 0; i < n; i++) sink += anim.Animate(ids[i], 1.0f);
+            anim.EndFrame(kDt);
+        }
+        const size_t activeAfterRest = anim.Active();
+        t = Clock::now();
+        for (unsigned f = 0; f < kFrames; f++) {
+            for (unsigned i = 0; i < n; i++) sink += anim.Animate(ids[i], 1.0f);
+            anim.EndFrame(kDt);
+        }
+        const double settledNs = perCall(t, kFrames);
+
+        // Half the widgets disappear: the sweep should reclaim them
+        for (unsigned f = 0; f < Anim::Animator::kMaxIdleFrames + 2 * Anim::Animator::kSweepEvery; f++) {
+            for (unsigned i = 0; i < n / 2; i++) sink += anim.Animate(ids[i], 1.0f);
+            anim.EndFrame(kDt);
+        }
+
+        Anim::Animator scalar(n);
+        scalar.ForceIsa(Isa::Scalar);
+        for (unsigned i = 0; i < n; i++) scalar.Animate(ids[i], 0.0f);
+        const double scalarNs = moving(scalar);
+
+        std::map<uint32_t, Anim::State> map;
+        t = Clock::now();
+        for (unsigned f = 0; f < kFrames; f++) {
+            const float target = (f / 30) & 1 ? 0.0f : 1.0f;
+            for (unsigned i = 0; i < n; i++) sink += Anim::Step(map[ids[i]], target, (float)kDt, 14.0f);
+        }
+        const double mapNs = perCall(t, kFrames);
+
+        // One scripted second: springs with mixed speeds kicked at t=0 and
+        // retargeted at t=0.5, sampled at the end
+        auto script = [&](double hz, Isa isa) {
+            Anim::Animator an(n);
+            an.ForceIsa(isa);
+            for (unsigned i = 0; i < n; i++) an.Animate(ids[i], 0.0f, 6.0f + (float)(i % 17));
+            an.EndFrame(0.0);
+            const unsigned frames = (unsigned)std::lround(hz);
+            for (unsigned f = 0; f < frames; f++) {
+                const float target = f * 2 < frames ? 1.0f : -0.5f;
+                for (unsigned i = 0; i < n; i++) an.Animate(ids[i], target * (float)(1 + i % 3), 6.0f + (float)(i % 17));
+                an.EndFrame(1.0 / hz);
+            }
+            std::vector<float> out(n);
+            for (unsigned i = 0; i < n; i++) out[i] = an.Animate(ids[i], -0.5f * (float)(1 + i % 3), 6.0f + (float)(i % 17));
+            return out;
+        };
+        const Isa best = anim.ActiveIsa();
+        const std::vector<float> ref = script(60.0, Isa::Scalar);
+        bool isaSame = script(60.0, Isa::Sse2) == ref && script(60.0, best) == ref;
+        bool rateSame = script(144.0, best) == ref && script(240.0, best) == ref;
+
+        const Anim::Animator::Stats st = anim.GetStats();
+        js.BeginObject().Field("step", "bench_anim").Field("status", "ok").Field("ms", Ms(t0))
+          .Field("widgets", (uint64_t)n).Field("frames", (uint64_t)kFrames)
+          .Field("isa", Dsp::Fft::IsaName(best))
+          .Field("insert_ns", insertNs)
+          .Field("moving_ns", movingNs)
+          .Field("moving_scalar_ns", scalarNs)
+          .Field("settled_ns", settledNs)
+          .Field("active_after_rest", (uint64_t)activeAfterRest)
+          .Field("map_moving_ns", mapNs)
+          .Field("speedup_x", movingNs > 0.0 ? mapNs / movingNs : 0.0)
+          .Field("spring_steps", springSteps)
+          .Field("probes_per_call", st.calls ? (double)st.probes / st.calls : 0.0)
+          .Field("live_after_churn", (uint64_t)anim.Size())
+          .Field("evicted", st.evicted)
+          .Field("index_slots", (uint64_t)anim.Capacity())
+          .Field("isa_identical", isaSame)
+          .Field("framerate_independent", rateSame)
+          .Field("checksum", (double)sink).EndObject();
+        return isaSame && rateSame;
+    }
+
+    const BenchMode kBenchAnim = {
+        "--bench-anim", 10000, 1,
+        "  --bench-anim [N]   animation cost for N widgets (default 10000) plus\n"
+        "                     fixed-step determinism checks across ISAs and rates\n",
+        RunBenchAnim,
+    };
+
+}  // namespace Headless
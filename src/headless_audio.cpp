@@ -0,0 +1,130 @@
+#include "headless_steps.h"
+#include "audio_decoder.h"
+#include "audio_engine.h"
+#include "playlist.h"
+#include "spectrum.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Headless {
+
+    // Offline pass over a whole file at full speed — same analyser the player uses
+    bool RunAnalyze(const fs::path& file, IO::JsonWriter& js) {
+        auto t0 = Clock::now();
+        std::string err;
+        std::unique_ptr<Audio::Decoder> dec = Audio::OpenDecoder(file, &err);
+        if (!dec) {
+            js.BeginObject().Field("step", "analyze").Field("status", "failed")
+              .Field("path", file.u8string()).Field("error", err).EndObject();
+            return false;
+        }
+
+        const Audio::Format fmt = dec->Fmt();
+        Dsp::SpectrumAnalyzer an;
+        an.Reset(fmt.sampleRate);
+        std::vector<float> pcm(4096 * (size_t)fmt.channels);
+        std::vector<double> sum(an.Bands(), 0.0);
+        Dsp::Spectrum snap;
+        uint64_t frames = 0, snaps = 0;
+        double   readNs = 0.0;
+        for (size_t got; (got = dec->Read(pcm.data(), 4096)) > 0; ) {
+            an.Push(pcm.data(), got, fmt.channels);
+            frames += got;
+            const auto r0 = Clock::now();
+            const bool fresh = an.Read(snap);
+            readNs += std::chrono::duration<double, std::nano>(Clock::now() - r0).count();
+            if (!fresh) continue;
+            snaps++;
+            for (unsigned b = 0; b < snap.bands; b++) sum[b] += snap.level[b];
+        }
+        const double ms = Ms(t0);
+
+        unsigned loudest = 0;
+        for (unsigned b = 1; b < sum.size(); b++) if (sum[b] > sum[loudest]) loudest = b;
+        const double seconds = fmt.sampleRate ? (double)frames / fmt.sampleRate : 0.0;
+
+        js.BeginObject().Field("step", "analyze").Field("status", "ok").Field("ms", ms)
+          .Field("path", file.u8string()).Field("codec", dec->Codec())
+          .Field("sample_rate", (uint64_t)fmt.sampleRate).Field("channels", (uint64_t)fmt.channels)
+          .Field("frames", frames).Field("seconds", seconds)
+          .Field("realtime_x", ms > 0.0 ? seconds * 1000.0 / ms : 0.0)
+          .Field("fft_isa", Dsp::Fft::IsaName(an.ActiveIsa()))
+          .Field("hop_us", an.HopMicros())
+          .Field("snapshot_read_ns", snaps ? readNs / snaps : 0.0)
+          .Field("loudest_hz", snaps ? (double)an.BandHz(loudest) : 0.0);
+        js.Key("bands").BeginArray();
+        for (unsigned b = 0; b < sum.size(); b++)
+            js.BeginObject().Field("hz", (double)an.BandHz(b))
+              .Field("level", snaps ? sum[b] / snaps : 0.0).EndObject();
+        js.EndArray().EndObject();
+        return true;
+    }
+
+    // Whole file through decoder thread → ring → sink, like the Phonk player
+    bool RunPlay(const Args& a, IO::JsonWriter& js) {
+        auto t0 = Clock::now();
+        std::string err;
+        auto fail = [&](const std::string& why) {
+            js.BeginObject().Field("step", "play").Field("status", "failed")
+              .Field("path", a.play.u8string()).Field("error", why).EndObject();
+            return false;
+        };
+        std::unique_ptr<Audio::Sink> sink = Audio::MakeSink(a.sink, &err);
+        if (!sink) return fail(err);
+
+        Audio::Engine eng(std::move(sink));
+        // A folder goes through the playlist exactly like the UI drives it:
+        // Update() polled on a "frame" timer, successors prefetched and queued
+        std::unique_ptr<Audio::Playlist> pl;
+        std::error_code ec;
+        if (fs::is_directory(a.play, ec)) {
+            pl = std::make_unique<Audio::Playlist>();
+            pl->LoadFolder(a.play);
+            do {
+                pl->Update(eng);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            } while (pl->Loading() || eng.Playing());
+            if (!pl->Size()) return fail("no playable tracks in folder");
+        } else {
+            if (!eng.Open(a.play, &err)) return fail(err);
+            eng.Play();
+            while (!eng.Finished()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        const double   pos = eng.Position();
+        const auto     st  = eng.GetStats();
+        const char*    sinkName = eng.SinkName();
+        eng.Close();
+        const double ms = Ms(t0);
+
+        js.BeginObject().Field("step", "play").Field("status", "ok").Field("ms", ms)
+          .Field("path", a.play.u8string()).Field("sink", sinkName)
+          .Field("sample_rate", (uint64_t)eng.Fmt().sampleRate)
+          .Field("channels", (uint64_t)eng.Fmt().channels)
+          .Field("frames", st.framesRendered).Field("position_s", pos)
+          .Field("realtime_x", ms > 0.0 ? pos * 1000.0 / ms : 0.0)
+          .Field("callbacks", st.callbacks)
+          .Field("callback_us_avg", st.callbackNsAvg / 1000.0)
+          .Field("callback_us_max", (double)st.callbackNsMax / 1000.0)
+          .Field("underrun_frames", st.underrunFrames)
+          .Field("ring_samples", (uint64_t)st.ringSamples);
+        if (pl) {
+            // Engine stats above cover the run since the last hard (re)open
+            const auto ps = pl->GetStats();
+            js.Key("playlist").BeginObject()
+              .Field("tracks", (uint64_t)pl->Size())
+              .Field("reached", (uint64_t)(pl->Current() + 1))
+              .Field("gapless_switches", ps.gapless)
+              .Field("reopened", ps.reopened)
+              .Field("scan_ms", ps.scanMs)
+              .Field("prefetch_ms", ps.prefetchMs).EndObject();
+        }
+        js.EndObject();
+        return true;
+    }
+
+}  // namespace Headless
@@ -0,0 +1,137 @@
+#include "headless_steps.h"
+#include "font_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Headless {
+
+    // The GUI's warm start without the GUI: a synthetic atlas the size of
+    // the baked Segoe UI one (Latin-1 at 15 px, 3x2 oversampled) is saved
+    // once, then loaded n times the way WinMain does — map, stat the font
+    // for the key, copy the pixels out.  The checks cover every reason the
+    // GUI must rebake instead: changed settings, a touched font file, a
+    // truncated cache and one from another format version.
+    static bool RunBenchFontCache(Sys::Backend&, const Args&, unsigned n, IO::JsonWriter& js) {
+        js.BeginObject().Field("step", "bench_font_cache");
+        std::error_code ec;
+        const fs::path dir = fs::temp_directory_path(ec) / ("xopt-fonts-" + std::to_string(
+                                 std::chrono::steady_clock::now().time_since_epoch().count()));
+        fs::create_directories(dir, ec);
+        const fs::path font  = dir / "font.ttf";
+        const fs::path cache = dir / "fonts.xof";
+        {
+            std::vector<uint8_t> ttf(300000, 0x5A);             // segoeui.ttf is ~1 MB, the size doesn't matter
+            IO::WriteFileAtomic(font, ttf.data(), ttf.size());
+        }
+        struct Settings { float size; int32_t overH, overV, rev; } set{ 15.0f, 3, 2, 1 };
+
+        constexpr uint32_t kW = 512, kH = 256, kFirst = 0x20, kLast = 0xFF;
+        std::vector<uint8_t> px((size_t)kW * kH);
+        for (size_t i = 0; i < px.size(); i++) px[i] = (uint8_t)((i * 2654435761u) >> 24);
+        std::vector<FontCache::Glyph> glyphs;
+        for (uint32_t c = kFirst; c <= kLast; c++) {
+            FontCache::Glyph g;
+            const float col = (float)((c - kFirst) % 16), row = (float)((c - kFirst) / 16);
+            g.codepoint = c;
+            g.flags     = c == ' ' ? 0 : FontCache::Glyph::kVisible;
+            g.advanceX  = 7.0f + (float)(c % 5);
+            g.x0 = 0.5f; g.y0 = 3.0f; g.x1 = 7.5f; g.y1 = 14.0f;
+            g.u0 = col * 32 / kW; g.v0 = row * 18 / kH; g.u1 = (col * 32 + 24) / kW; g.v1 = (row * 18 + 14) / kH;
+            glyphs.push_back(g);
+        }
+        std::vector<FontCache::LineUv> lines(64);
+        for (size_t i = 0; i < lines.size(); i++)
+            lines[i] = { 0.9f, (float)i / kH, 0.95f, (float)i / kH };
+        FontCache::Font f{ 15.0f, 13.9f, -3.5f, 0, (uint32_t)glyphs.size() };
+
+        FontCache::Atlas a;
+        a.key    = FontCache::Key(font, &set, sizeof(set));
+        a.width  = kW;  a.height = kH;
+        a.whiteU = 0.99f;  a.whiteV = 0.99f;
+        a.fonts  = &f;             a.fontCount  = 1;
+        a.glyphs = glyphs.data();  a.glyphCount = (uint32_t)glyphs.size();
+        a.lines  = lines.data();   a.lineCount  = (uint32_t)lines.size();
+        a.pixels = px.data();
+        a.source = font.u8string();
+
+        std::string err;
+        const auto s0 = Clock::now();
+        const bool saved = FontCache::Save(cache, a, &err);
+        const double saveMs = Ms(s0);
+
+        // Warm loads, timed as the GUI pays them
+        std::vector<uint8_t> tex((size_t)kW * kH);
+        double total = 0.0, best = 1e300, worst = 0.0;
+        bool   hits = saved;
+        size_t bytes = 0;
+        for (unsigned i = 0; i < n && hits; i++) {
+            const auto t0 = Clock::now();
+            FontCache::Cache c;
+            hits = c.Open(cache, &err) && FontCache::Key(fs::u8path(c.Get().source), &set, sizeof(set)) == c.Get().key;
+            if (hits) std::memcpy(tex.data(), c.Get().pixels, tex.size());
+            const double ms = Ms(t0);
+            total += ms; best = std::min(best, ms); worst = std::max(worst, ms);
+            bytes = c.Bytes();
+        }
+
+        FontCache::Cache c;
+        const bool opened   = c.Open(cache);
+        const FontCache::Atlas& b = c.Get();
+        const bool roundTrip = opened && b.width == kW && b.height == kH && b.fontCount == 1 &&
+                               b.glyphCount == glyphs.size() && b.lineCount == lines.size() &&
+                               b.source == a.source && b.fonts[0].ascent == f.ascent &&
+                               !std::memcmp(b.glyphs, glyphs.data(), glyphs.size() * sizeof(FontCache::Glyph)) &&
+                               !std::memcmp(b.lines, lines.data(), lines.size() * sizeof(FontCache::LineUv)) &&
+                               !std::memcmp(b.pixels, px.data(), px.size()) && !std::memcmp(tex.data(), px.data(), px.size());
+        c.Close();
+
+        Settings bigger = set;
+        bigger.size = 16.0f;
+        const bool settingsMiss = FontCache::Key(font, &bigger, sizeof(bigger)) != a.key;
+        fs::last_write_time(font, fs::last_write_time(font, ec) + std::chrono::seconds(2), ec);
+        const bool touchedMiss = FontCache::Key(font, &set, sizeof(set)) != a.key;
+        const bool missingFont = FontCache::Key(dir / "nope.ttf", &set, sizeof(set)) == 0;
+
+        bool truncated = false, version = false;
+        {
+            IO::MappedFile m;
+            std::vector<uint8_t> bad;
+            if (m.Open(cache)) bad.assign(m.Data(), m.Data() + m.Size());
+            m.Close();
+            if (bad.size() > sizeof(FontCache::CacheHeader)) {
+                IO::WriteFileAtomic(cache, bad.data(), bad.size() - 100);
+                truncated = !c.Open(cache);
+                bad[4]++;                                       // CacheHeader::version
+                IO::WriteFileAtomic(cache, bad.data(), bad.size());
+                version = !c.Open(cache);
+            }
+        }
+        fs::remove_all(dir, ec);
+
+        js.Field("loads", (uint64_t)n).Field("cache_bytes", (uint64_t)bytes)
+          .Field("glyphs", (uint64_t)glyphs.size()).Field("save_ms", saveMs)
+          .Field("warm_ms", hits ? total / n : 0.0).Field("warm_min_ms", hits ? best : 0.0)
+          .Field("warm_max_ms", worst);
+        if (!saved || !hits) js.Field("error", err);
+        js.Key("checks").BeginObject().Field("round_trip", roundTrip).Field("settings_change", settingsMiss)
+          .Field("font_touched", touchedMiss).Field("font_missing", missingFont)
+          .Field("truncated", truncated).Field("other_version", version).EndObject();
+        const bool ok = saved && hits && roundTrip && settingsMiss && touchedMiss && missingFont && truncated && version;
+        js.Field("status", ok ? "ok" : "failed").EndObject();
+        return ok;
+    }
+
+    const BenchMode kBenchFontCache = {
+        "--bench-font-cache", 200, 1,
+        "  --bench-font-cache [N]  save a GUI-sized font atlas to the cache, then\n"
+        "                     time N warm loads (map, key check, pixel copy) and\n"
+        "                     check that stale or damaged caches are rejected\n",
+        RunBenchFontCache,
+    };
+
+}  // namespace Headless
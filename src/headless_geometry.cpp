@@ -0,0 +1,182 @@
+#include "headless_steps.h"
+#include "geometry_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Headless {
+
+    // A rounded rect with a one-pixel fringe, tessellated the way ImGui
+    // does it: corner arcs through cosf/sinf (or the trig table), an inner
+    // fan and an outer ring of quads
+    static void TessellateRoundRect(float x, float y, float w, float h, float r, uint32_t col, bool lut,
+                                    std::vector<Geo::Vertex>& vtx, std::vector<uint32_t>& idx) {
+        constexpr unsigned kArc = 8;
+        const float cx[4] = { x + w - r, x + r, x + r, x + w - r };
+        const float cy[4] = { y + h - r, y + h - r, y + r, y + r };
+        const uint32_t base = (uint32_t)vtx.size();
+        const unsigned n    = 4 * (kArc + 1);
+        for (unsigned k = 0; k < 4; k++) {
+            for (unsigned i = 0; i <= kArc; i++) {
+                const float a = (float)(k * kArc + i) * (1.5707963f / kArc);
+                float c, s;
+                if (lut) Geo::CosSin(a, c, s);
+                else { c = std::cos(a); s = std::sin(a); }
+                vtx.push_back({ cx[k] + c * (r - 0.5f), cy[k] + s * (r - 0.5f), 0.5f, 0.5f, col });
+                vtx.push_back({ cx[k] + c * (r + 0.5f), cy[k] + s * (r + 0.5f), 0.5f, 0.5f, col & 0x00FFFFFFu });
+            }
+        }
+        for (unsigned i = 2; i < n; i++) idx.insert(idx.end(), { base, base + 2 * (i - 1), base + 2 * i });
+        for (unsigned i = 0; i < n; i++) {
+            const uint32_t a = base + 2 * i, b = base + 2 * ((i + 1) % n);
+            idx.insert(idx.end(), { a, b, b + 1, a, b + 1, a + 1 });
+        }
+    }
+
+    // Geo::Retained's draw list over two vectors, as DrawListRef is over an
+    // ImDrawList
+    struct VecList {
+        struct Pos { size_t vtx, idx; };
+        std::vector<Geo::Vertex>& vtx;
+        std::vector<uint32_t>&    idx;
+
+        Pos  Mark() const { return { vtx.size(), idx.size() }; }
+        void Drawn(const Pos& m, size_t& nv, size_t& ni) const { nv = vtx.size() - m.vtx; ni = idx.size() - m.idx; }
+        bool Take(const Pos& m, float ox, float oy, Geo::Mesh& out) const {
+            for (size_t i = m.vtx; i < vtx.size(); i++)
+                out.vtx.push_back({ vtx[i].x - ox, vtx[i].y - oy, vtx[i].u, vtx[i].v, vtx[i].col });
+            for (size_t i = m.idx; i < idx.size(); i++) out.idx.push_back(idx[i] - (uint32_t)m.vtx);
+            return true;
+        }
+        void Replay(const Geo::Mesh& m, float ox, float oy) {
+            const uint32_t base = (uint32_t)vtx.size();
+            for (uint32_t i : m.idx) idx.push_back(base + i);
+            for (const Geo::Vertex& v : m.vtx) vtx.push_back({ ox + v.x, oy + v.y, v.u, v.v, v.col });
+        }
+    };
+
+    // 64 toggle-like widgets (two rounded rects each), one in eight
+    // animating at a time, through Geo::Retained — the replay / record path
+    // Widget::Retained runs — then the same frames with the cache off.  The
+    // widgets themselves need ImGui; xopt-uibench measures those.
+    static bool RunBenchGeometry(Sys::Backend&, const Args&, unsigned frames, IO::JsonWriter& js) {
+        js.BeginObject().Field("step", "bench_geometry");
+
+        // Trig table against libm
+        double lutErr = 0.0;
+        for (int i = -40000; i <= 40000; i++) {
+            const float a = (float)i * 3.1415927f / 10000.0f;
+            float c, s;
+            Geo::CosSin(a, c, s);
+            lutErr = std::max({ lutErr, std::fabs((double)c - std::cos((double)a)), std::fabs((double)s - std::sin((double)a)) });
+        }
+        constexpr unsigned kArcs = 20000, kSegs = 128;
+        std::vector<Geo::Point> pts(kSegs + 1);
+        float sink = 0.0f;
+        auto t0 = Clock::now();
+        for (unsigned k = 0; k < kArcs; k++) {
+            Geo::Arc(44.0f, 44.0f, 44.0f, -1.5707963f, -1.5707963f + 6.2831853f * (float)(k % 100) / 100.0f, kSegs, pts.data());
+            sink += pts[kSegs].x;
+        }
+        const double lutNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (kArcs * (kSegs + 1.0));
+        t0 = Clock::now();
+        for (unsigned k = 0; k < kArcs; k++) {
+            const float a0 = -1.5707963f, step = 6.2831853f * (float)(k % 100) / 100.0f / kSegs;
+            for (unsigned i = 0; i <= kSegs; i++)
+                pts[i] = { 44.0f + std::cos(a0 + step * (float)i) * 44.0f, 44.0f + std::sin(a0 + step * (float)i) * 44.0f };
+            sink += pts[kSegs].x;
+        }
+        const double libmNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (kArcs * (kSegs + 1.0));
+
+        // Simulated frames
+        constexpr unsigned kWidgets = 64;
+        std::vector<Geo::Vertex> vtx, mv;
+        std::vector<uint32_t>    idx, mi;
+        vtx.reserve(1 << 16); idx.reserve(1 << 17);
+        VecList list{ vtx, idx };
+        auto run = [&](Geo::Cache& cache, Geo::FrameStats& steady, uint64_t& allocs) {
+            const auto f0 = Clock::now();
+            uint64_t a0 = 0;
+            for (unsigned f = 0; f < frames; f++) {
+                if (f == frames / 2) a0 = Allocations();
+                vtx.clear(); idx.clear();
+                for (unsigned w = 0; w < kWidgets; w++) {
+                    const bool  moving = (w / 8) == (f / 30) % 8;
+                    const float t      = moving ? (float)(f % 30) / 30.0f : ((w + f / 240) & 1 ? 1.0f : 0.0f);
+                    const float ox = 20.0f, oy = 80.0f + 40.0f * (float)w - (float)(f % 7);   // scrolling
+                    Geo::Key key;
+                    key.Mix('T').Mix(t, 1.0f / 1024).Mix(w % 4);
+                    Geo::Retained(cache, list, key.h, ox, oy, [&] {
+                        const uint32_t col = 0xFF000000u | (w % 4) * 0x3F3F3Fu;
+                        TessellateRoundRect(ox, oy, 50.0f, 28.0f, 14.0f, col, false, vtx, idx);
+                        TessellateRoundRect(ox + 3.0f + t * 22.0f, oy + 3.0f, 22.0f, 22.0f, 11.0f, 0xFFFFFFFFu, false, vtx, idx);
+                    });
+                }
+                cache.EndFrame();
+                if (f == frames - 1) steady = cache.Last();
+            }
+            allocs = Allocations() - a0;
+            return std::chrono::duration<double, std::micro>(Clock::now() - f0).count() / frames;
+        };
+        Geo::Cache on, off;
+        off.SetEnabled(false);
+        Geo::FrameStats sOn, sOff;
+        uint64_t allocOn = 0, allocOff = 0;
+        const double usOn  = run(on, sOn, allocOn);
+        const double usOff = run(off, sOff, allocOff);
+
+        // Through Retained: drawn live at one origin on two frames (stored on
+        // the second), replayed at another on the third — which must be the
+        // live geometry there, moved
+        Geo::Cache c;
+        auto frame = [&](float ox, float oy) {
+            vtx.clear(); idx.clear();
+            Geo::Retained(c, list, 1, ox, oy, [&] {
+                TessellateRoundRect(ox, oy, 50.0f, 28.0f, 14.0f, 0xFF336699u, true, vtx, idx);
+            });
+            c.EndFrame();
+            return c.Last();
+        };
+        const Geo::FrameStats f1 = frame(10.0f, 10.0f), f2 = frame(10.0f, 10.0f), f3 = frame(100.25f, 37.5f);
+        const bool firstMiss  = f1.misses == 1 && f1.stored == 0;
+        const bool secondMiss = f2.misses == 1 && f2.stored == 1;
+        mv.clear(); mi.clear();
+        TessellateRoundRect(100.25f, 37.5f, 50.0f, 28.0f, 14.0f, 0xFF336699u, true, mv, mi);
+        bool same = f3.hits == 1 && vtx.size() == mv.size() && idx == mi;
+        for (size_t i = 0; same && i < vtx.size(); i++)
+            same = std::fabs(vtx[i].x - mv[i].x) < 1e-3f && std::fabs(vtx[i].y - mv[i].y) < 1e-3f && vtx[i].col == mv[i].col;
+        for (uint32_t f = 0; f <= Geo::Cache::kMaxAge + 1; f++) c.EndFrame();
+        const bool aged = c.Entries() == 0;
+        for (uint64_t k = 0; k < Geo::Cache::kMaxEntries + 10; k++) c.Store(100 + k, Geo::Mesh{});
+        const bool bounded = c.Entries() == Geo::Cache::kMaxEntries;
+
+        js.Field("frames", (uint64_t)frames).Field("widgets", (uint64_t)kWidgets)
+          .Field("lut_max_error_ppm", lutErr * 1e6).Field("arc_lut_ns_per_point", lutNs).Field("arc_libm_ns_per_point", libmNs)
+          .Field("frame_us_cached", usOn).Field("frame_us_live", usOff)
+          .Field("steady_allocations", allocOn);
+        js.Key("last_frame").BeginObject()
+          .Field("hits", (uint64_t)sOn.hits).Field("misses", (uint64_t)sOn.misses)
+          .Field("vtx_replayed", sOn.vtxReplayed).Field("idx_replayed", sOn.idxReplayed)
+          .Field("vtx_tessellated", sOn.vtxTessellated).Field("idx_tessellated", sOn.idxTessellated)
+          .Field("vtx_tessellated_uncached", sOff.vtxTessellated).EndObject();
+        js.Field("cache_entries", (uint64_t)on.Entries()).Field("cache_bytes", (uint64_t)on.Bytes());
+        js.Key("checks").BeginObject().Field("lut_accuracy", lutErr < 1e-5).Field("admit_on_second_miss", firstMiss && secondMiss)
+          .Field("replay_matches_live", same).Field("evict_unused", aged).Field("bounded", bounded).EndObject();
+        const bool ok = lutErr < 1e-5 && firstMiss && secondMiss && same && aged && bounded && sink != 0.0f;
+        js.Field("status", ok ? "ok" : "failed").EndObject();
+        return ok;
+    }
+
+    const BenchMode kBenchGeometry = {
+        "--bench-geometry", 2000, 1,
+        "  --bench-geometry [N]  N simulated UI frames (default 2000) of 64 custom\n"
+        "                     widgets with and without the retained geometry cache,\n"
+        "                     trig-table vs libm arcs, and the cache's admission,\n"
+        "                     eviction and replay checks\n",
+        RunBenchGeometry,
+    };
+
+}  // namespace Headless
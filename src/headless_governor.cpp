@@ -0,0 +1,171 @@
+#include "headless_steps.h"
+#include "affinity_governor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Headless {
+
+    static void EmitGovernor(const Affinity::Governor& gov, IO::JsonWriter& js) {
+        const Affinity::Plan&  p  = gov.GetPlan();
+        const Affinity::Stats& st = gov.GetStats();
+        char game[24], bg[24];
+        std::snprintf(game, sizeof(game), "0x%llx", (unsigned long long)p.game);
+        std::snprintf(bg,   sizeof(bg),   "0x%llx", (unsigned long long)p.background);
+        js.Field("partitioned", p.partitioned).Field("game_mask", game).Field("background_mask", bg)
+          .Field("game_cores", (uint64_t)p.gameCores).Field("background_cores", (uint64_t)p.backgroundCores)
+          .Field("polls", st.polls).Field("restored_processes", (uint64_t)st.restored)
+          .Field("skipped", (uint64_t)st.skipped).Field("refused", (uint64_t)st.failed);
+        if (st.failed) js.Field("error", Tweaks::ErrorName(st.lastError));
+    }
+
+    // Until the process exits or --govern-for runs out; restores either way
+    bool RunGovern(Sys::Backend& be, const Args& a, IO::JsonWriter& js) {
+        const auto t0 = Clock::now();
+        Affinity::Governor gov(be);
+        std::string err;
+        js.BeginObject().Field("step", "govern").Field("pid", (uint64_t)a.governPid);
+        if (!gov.Attach(a.governPid, &err)) {
+            js.Field("status", "failed").Field("error", err).EndObject();
+            return false;
+        }
+        unsigned peakGame = 0, peakMoved = 0;
+        bool exited = false;
+        while (a.governFor <= 0.0 || Ms(t0) < a.governFor * 1000.0) {
+            peakGame  = std::max(peakGame,  gov.GetStats().gameProcs);
+            peakMoved = std::max(peakMoved, gov.GetStats().moved);
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (!gov.Poll()) { exited = true; break; }
+        }
+        gov.Restore();
+        js.Field("status", "ok").Field("ms", Ms(t0)).Field("exited", exited)
+          .Field("game_processes", (uint64_t)peakGame).Field("moved", (uint64_t)peakMoved);
+        EmitGovernor(gov, js);
+        js.EndObject();
+        return true;
+    }
+
+    // Keeps `threads` cores busy for `sec` seconds: the synthetic workload
+    int Spin(double sec, unsigned threads) {
+        const auto until = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(sec));
+        std::vector<std::thread> pool;
+        for (unsigned i = 0; i < threads; i++)
+            pool.emplace_back([until] {
+                volatile uint64_t x = 1;
+                while (Clock::now() < until)
+                    for (int k = 0; k < 100000; k++) x = x * 6364136223846793005ull + 1;
+            });
+        for (auto& t : pool) t.join();
+        return 0;
+    }
+
+    // A "game" (two spinning threads) and a "hog" (one) as child processes
+    // — fake ones on the mock, which also gets an idle process, a busy
+    // audio server and a kernel thread — governed for SEC seconds.  Then the game stops, and the hog
+    // must be back exactly as it was.
+    bool RunGovernSynthetic(Sys::Backend& be, double sec, const char* self, IO::JsonWriter& js) {
+        const auto t0 = Clock::now();
+        auto* mock = dynamic_cast<Sys::MockBackend*>(&be);
+        uint32_t game = 0, hog = 0;
+        if (mock) {
+            mock->Spawn(100, 1, "game");
+            mock->Spawn(101, 100, "game-worker");
+            mock->Spawn(200, 1, "hog");
+            mock->Spawn(201, 1, "idle");
+            mock->Spawn(202, 1, "pipewire");
+            mock->Spawn(2, 0, "kthreadd", true);
+            game = 100;
+            hog  = 200;
+        } else {
+            const std::string secs = std::to_string(sec + 10.0);
+            const char* g[] = { self, "--spin", secs.c_str(), "2", nullptr };
+            const char* h[] = { self, "--spin", secs.c_str(), "1", nullptr };
+            game = Sys::StartProcess(g);
+            hog  = Sys::StartProcess(h);
+        }
+        js.BeginObject().Field("step", "govern_synthetic");
+        auto cleanup = [&] {
+            if (mock) { for (uint32_t pid : { 100u, 101u, 200u, 201u, 202u, 2u }) mock->Exit(pid); }
+            else      { Sys::StopProcess(game); Sys::StopProcess(hog); }
+        };
+        if (!game || !hog) {
+            cleanup();
+            js.Field("status", "failed").Field("error", "cannot start the synthetic workload").EndObject();
+            return false;
+        }
+
+        Sys::CpuMask hogMask0 = 0;
+        int          hogNice0 = 0;
+        be.GetAffinity(hog, hogMask0);
+        be.GetPriority(hog, hogNice0);
+
+        Affinity::Options opt;
+        opt.heavyPct = 5.0;             // the hog shares the machine with a raised game
+        Affinity::Governor gov(be, opt);
+        std::string err;
+        if (!gov.Attach(game, &err)) {
+            cleanup();
+            js.Field("status", "failed").Field("error", err).EndObject();
+            return false;
+        }
+        const auto until = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(sec));
+        while (Clock::now() < until) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            if (mock) {                                    // CPU time for those 250 ms
+                mock->Charge(100, 400000000);
+                mock->Charge(101, 100000000);
+                mock->Charge(200, 200000000);
+                mock->Charge(201, 1000000);
+                mock->Charge(202, 200000000);
+            }
+            gov.Poll();
+        }
+
+        const Affinity::Plan& plan = gov.GetPlan();
+        Sys::CpuMask gameMask = 0, hogMask = 0;
+        int gameNice = 0, hogNice = 0;
+        be.GetAffinity(game, gameMask);
+        be.GetAffinity(hog, hogMask);
+        be.GetPriority(game, gameNice);
+        be.GetPriority(hog, hogNice);
+        const bool gamePinned = !plan.partitioned || gameMask == plan.game;
+        const bool hogMoved   = gov.IsMoved(hog) && (!plan.partitioned || hogMask == plan.background);
+        const bool childIn    = !mock || gov.IsGame(101);
+        const bool idleLeft   = !mock || !gov.IsMoved(201);
+        const bool audioLeft  = !mock || !gov.IsMoved(202);
+        const unsigned gameProcs = gov.GetStats().gameProcs;
+
+        // Game over: the next poll restores everything it changed
+        if (mock) mock->Exit(100);
+        else      Sys::StopProcess(game);
+        const bool released = !gov.Poll();
+        Sys::CpuMask hogMask1 = 0;
+        int          hogNice1 = 0;
+        be.GetAffinity(hog, hogMask1);
+        be.GetPriority(hog, hogNice1);
+        const bool restored = released && hogMask1 == hogMask0 && hogNice1 == hogNice0;
+        cleanup();
+
+        const bool ok = gamePinned && hogMoved && childIn && idleLeft && audioLeft && restored;
+        char gm[24], hm[24];
+        std::snprintf(gm, sizeof(gm), "0x%llx", (unsigned long long)gameMask);
+        std::snprintf(hm, sizeof(hm), "0x%llx", (unsigned long long)hogMask);
+        js.Field("status", ok ? "ok" : "failed").Field("ms", Ms(t0))
+          .Field("game_processes", (uint64_t)gameProcs)
+          .Field("game_affinity", gm).Field("game_nice", (int64_t)gameNice)
+          .Field("hog_affinity", hm).Field("hog_nice", (int64_t)hogNice)
+          .Field("game_pinned", gamePinned).Field("hog_moved", hogMoved)
+          .Field("children_followed", childIn).Field("idle_left_alone", idleLeft)
+          .Field("critical_left_alone", audioLeft)
+          .Field("restored", restored);
+        EmitGovernor(gov, js);
+        js.EndObject();
+        return ok;
+    }
+
+}  // namespace Headless
@@ -0,0 +1,43 @@
+#include "headless_steps.h"
+#include "latency_monitor.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace Headless {
+
+    // Runs the sampler for a fixed window on an otherwise idle process, so
+    // what it reports is the system's wakeup latency, not ours
+    bool RunLatency(const Args& a, IO::JsonWriter& js) {
+        Latency::Monitor mon;
+        js.BeginObject().Field("step", "latency");
+        if (!mon.Start(a.latencyHz)) {
+            js.Field("status", "failed").Field("error", "cannot create the sampler's timer").EndObject();
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(a.latencySec));
+        mon.Stop();
+
+        std::string err;
+        const bool csv = a.latencyCsv.empty() || mon.ExportCsv(a.latencyCsv, &err);
+        js.Field("status", csv ? "ok" : "failed").Field("seconds", a.latencySec)
+          .Field("rate_hz", (uint64_t)mon.RateHz()).Field("ticks", mon.Ticks())
+          .Field("missed", mon.Missed()).Field("cpu_pct", mon.CpuPercent());
+        if (!csv) js.Field("error", err);
+        if (!a.latencyCsv.empty() && csv) js.Field("csv", a.latencyCsv.u8string());
+        Latency::Histogram::Snapshot snap;
+        for (unsigned i = 0; i < (unsigned)Latency::Probe::Count; i++) {
+            mon.Get((Latency::Probe)i).Read(snap);
+            const Latency::Summary sm = Latency::Summarize(snap);
+            js.Key(Latency::ProbeName((Latency::Probe)i)).BeginObject()
+              .Field("samples", sm.count)
+              .Field("p50_us", sm.p50 / 1e3).Field("p99_us", sm.p99 / 1e3)
+              .Field("p999_us", sm.p999 / 1e3).Field("max_us", sm.max / 1e3).EndObject();
+        }
+        js.EndObject();
+        return csv;
+    }
+
+}  // namespace Headless
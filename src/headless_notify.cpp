@@ -0,0 +1,146 @@
+#include "headless_steps.h"
+#include "event_bus.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Headless {
+
+    // Notification bus under a flood: `threads` producers post n messages
+    // each — every other one a repeat of the same line, the rest distinct,
+    // and one in 16 a repeated warning — while this thread drains like a UI
+    // frame loop.  Info may be dropped once the queue is near full; no
+    // warning may be.  Then a scripted
+    // sequence on a fresh bus checks coalescing, folding, the waiting line
+    // and the toast rate limit exactly.
+    static bool RunBenchNotify(Sys::Backend&, const Args& a, unsigned n, IO::JsonWriter& js) {
+        const unsigned threads = a.threads ? a.threads : 4;
+        using Events::Source;
+        using Events::Level;
+        js.BeginObject().Field("step", "bench_notify");
+        auto bus = std::make_unique<Events::Bus>();
+        std::atomic<bool>     go{ false };
+        std::atomic<unsigned> done{ 0 };
+        std::vector<double>   postNs(threads, 0.0);
+        std::vector<std::thread> producers;
+        for (unsigned t = 0; t < threads; t++)
+            producers.emplace_back([&, t] {
+                char text[64];
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                const auto t0 = Clock::now();
+                for (unsigned i = 0; i < n; i++) {
+                    if (i % 16 == 15) {
+                        const int len = std::snprintf(text, sizeof(text), "worker %u: disk nearly full", t);
+                        bus->Post(Source::Clean, Level::Warning, text, (size_t)len);
+                        continue;
+                    }
+                    const int len = (i & 1) ? std::snprintf(text, sizeof(text), "worker %u: item %u done", t, i)
+                                            : std::snprintf(text, sizeof(text), "worker %u: still busy", t);
+                    bus->Post(Source::Clean, Level::Info, text, (size_t)len);
+                }
+                postNs[t] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / n;
+                done.fetch_add(1, std::memory_order_release);
+            });
+
+        // Consumer: one Update() per "frame", timed like the UI's
+        const uint64_t allocs0 = Allocations();
+        go.store(true, std::memory_order_release);
+        auto     last = Clock::now();
+        double   updateMax = 0.0;
+        uint64_t frames = 0;
+        for (bool more = true; more;) {
+            more = done.load(std::memory_order_acquire) < threads;
+            const auto now = Clock::now();
+            bus->Update(std::chrono::duration<float>(now - last).count());
+            last = now;
+            updateMax = std::max(updateMax, std::chrono::duration<double, std::micro>(Clock::now() - now).count());
+            frames++;
+            std::this_thread::yield();
+        }
+        const uint64_t allocs = Allocations() - allocs0;
+        for (auto& th : producers) th.join();
+
+        std::vector<const Events::Entry*> hits;
+        hits.reserve(Events::Bus::kHistory);
+        const auto s0 = Clock::now();
+        bus->Search("WORKER", hits);
+        const double searchUs = std::chrono::duration<double, std::micro>(Clock::now() - s0).count();
+
+        const Events::Stats& st = bus->GetStats();
+        const uint64_t posts = (uint64_t)n * threads;
+        double post = 0.0;
+        for (double v : postNs) post += v / threads;
+        const bool delivered = st.received + st.lost == posts && st.received == bus->Last() + st.coalesced
+                            && st.lostUrgent == 0;
+        js.Field("producers", (uint64_t)threads).Field("posts", posts)
+          .Field("received", st.received).Field("queued", st.queued).Field("lost", st.lost)
+          .Field("lost_warnings", st.lostUrgent).Field("coalesced", st.coalesced)
+          .Field("folded", st.folded).Field("dropped", st.dropped).Field("shown", st.shown)
+          .Field("entries", bus->Last()).Field("post_ns", post).Field("frames", frames)
+          .Field("update_max_us", updateMax).Field("steady_allocations", allocs)
+          .Field("search_hits", (uint64_t)hits.size()).Field("search_us", searchUs);
+
+        // Scripted: default options (2 s window, 4 visible, 0.25 s apart, 3 s each)
+        Events::Bus b;
+        for (int i = 0; i < 5; i++) b.Post(Source::Boost, Level::Success, std::string("Saved profile"));
+        b.Update(0.0f);
+        const Events::Entry* saved = b.Get(1);
+        const bool coalesce = b.Last() == 1 && saved && saved->count == 5 && saved->label == "Saved profile (x5)";
+
+        char text[32];
+        for (int i = 0; i < 20; i++) {
+            const int len = std::snprintf(text, sizeof(text), "file %d", i);
+            b.Post(Source::Clean, Level::Info, text, (size_t)len);
+        }
+        b.Update(0.0f);                                 // too soon after the first toast: waits
+        unsigned up = 0;
+        b.ForEachShown([&](const Events::Entry&, float) { up++; });
+        b.Update(0.3f);
+        std::string top;
+        b.ForEachShown([&](const Events::Entry& e, float) { if (top.empty()) top = e.label; });
+        const bool fold = up == 1 && b.GetStats().folded == 19 && top == "file 19  +19 more";
+
+        // Eight more sources behind two shown toasts: six fit in the line
+        const Source others[] = { Source::App, Source::Launch, Source::Audio, Source::Bench,
+                                  Source::Latency, Source::Governor, Source::Reclaim, Source::Stats };
+        for (Source s : others) b.Post(s, Level::Info, std::string("from ") + Events::SourceName(s));
+        unsigned maxUp = 0, maxPerFrame = 0;
+        for (int f = 0; f < 60; f++) {
+            const uint64_t before = b.GetStats().shown;
+            b.Update(0.1f);
+            unsigned k = 0;
+            b.ForEachShown([&](const Events::Entry&, float) { k++; });
+            maxUp       = std::max(maxUp, k);
+            maxPerFrame = std::max(maxPerFrame, (unsigned)(b.GetStats().shown - before));
+        }
+        const Events::Stats& bs = b.GetStats();
+        const bool line  = bs.dropped == 2 && bs.shown == 8;
+        const bool limit = maxUp <= b.GetOptions().maxVisible && maxPerFrame <= 1;
+        std::vector<const Events::Entry*> found;
+        const bool search = b.Search("SAVED", found) == 1 && b.Search("clean", found) == 20 &&
+                            b.Search("", found, 5) == 5;
+        js.Key("checks").BeginObject().Field("delivered", delivered).Field("coalesce", coalesce).Field("fold", fold)
+          .Field("waiting_line", line).Field("rate_limit", limit).Field("search", search).EndObject();
+
+        const bool ok = delivered && coalesce && fold && line && limit && search;
+        js.Field("status", ok ? "ok" : "failed").EndObject();
+        return ok;
+    }
+
+    const BenchMode kBenchNotify = {
+        "--bench-notify", 100000, 1,
+        "  --bench-notify [N]  flood the notification bus from --threads producers\n"
+        "                     (default 4) posting N messages each (default 100000),\n"
+        "                     then check coalescing, folding, the toast rate limit\n"
+        "                     and history search on a scripted sequence\n",
+        RunBenchNotify,
+    };
+
+}  // namespace Headless
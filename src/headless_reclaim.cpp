@@ -0,0 +1,172 @@
+#include "headless_steps.h"
+#include "mapped_file.h"
+#include "memory_reclaimer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Headless {
+
+    static void EmitReclaim(const Reclaim::Report& r, IO::JsonWriter& js) {
+        js.Field("triggered", r.triggered).Field("total", r.total)
+          .Field("available_before", r.availableBefore).Field("available_after", r.availableAfter)
+          .Field("reclaimed", r.reclaimed);
+        js.Key("actions").BeginArray();
+        for (const Reclaim::Action& x : r.actions) {
+            js.BeginObject().Field("pid", (uint64_t)x.pid).Field("name", x.name);
+            if (!x.group.empty()) js.Field("group", x.group).Field("members", (uint64_t)x.members);
+            js.Field("resident", x.resident).Field("idle_s", x.idleSec).Field("reclaimed", x.reclaimed)
+              .Field("status", x.ok ? "ok" : "failed");
+            if (!x.ok) js.Field("error", Tweaks::ErrorName(x.error));
+            js.EndObject();
+        }
+        js.EndArray();
+    }
+
+    // A poll a second; passes that did something are reported
+    bool RunReclaim(Sys::Backend& be, const Args& a, IO::JsonWriter& js) {
+        const auto t0 = Clock::now();
+        Reclaim::Reclaimer rec(be, a.reclaim);
+        rec.Protect(a.reclaimProtect);
+        Reclaim::Report r;
+        js.BeginObject().Field("step", "reclaim");
+        uint64_t total = 0, polls = 0;
+        bool ok = true;
+        js.Key("passes").BeginArray();
+        for (;;) {
+            const bool last = Ms(t0) + 1000.0 > a.reclaimSec * 1000.0;
+            if (!rec.Poll(r, last && a.reclaimForce)) { ok = false; break; }
+            polls++;
+            if (r.triggered) {
+                total += r.reclaimed;
+                js.BeginObject().Field("ms", Ms(t0));
+                EmitReclaim(r, js);
+                js.EndObject();
+            }
+            if (last) break;
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+        js.EndArray();
+        js.Field("status", ok ? "ok" : "failed").Field("polls", polls).Field("reclaimed", total);
+        if (!ok) js.Field("error", "process table or memory status unavailable");
+        js.EndObject();
+        return ok;
+    }
+
+    // Holds `mb` of a mapped file resident and sleeps: page cache a trim can
+    // drop even without swap
+    int Hog(unsigned mb, double sec) {
+        const fs::path file = fs::temp_directory_path() / ("xopt-hog-" + std::to_string(Sys::CurrentPid()));
+        {
+            std::vector<uint8_t> fill((size_t)mb << 20, 0xA5);
+            if (!IO::WriteFileAtomic(file, fill.data(), fill.size())) return 1;
+        }
+        IO::MappedFile m;
+        const bool opened = m.Open(file);
+        std::error_code ec;
+        fs::remove(file, ec);
+        if (!opened) return 1;
+        volatile uint8_t sum = 0;
+        for (size_t i = 0; i < m.Size(); i += 4096) sum += m.Data()[i];
+        std::this_thread::sleep_for(std::chrono::duration<double>(sec));
+        return 0;
+    }
+
+    // An idle "hog" and a protected "game" — children holding mapped files,
+    // or fake processes and a fake memory group on the mock.  One forced
+    // pass must reclaim from the hog (and the group), measure it, and leave
+    // the game, busy and small processes alone.
+    bool RunReclaimSynthetic(Sys::Backend& be, const char* self, IO::JsonWriter& js) {
+        const auto t0 = Clock::now();
+        auto* mock = dynamic_cast<Sys::MockBackend*>(&be);
+        const unsigned mb = 128;
+        uint32_t game = 0, hog = 0;
+        js.BeginObject().Field("step", "reclaim_synthetic");
+        if (mock) {
+            const uint64_t M = 1ull << 20;
+            struct { uint32_t pid, ppid; const char* name; uint64_t mb; const char* group; } fake[] = {
+                { 100, 1, "game",        1500, nullptr },
+                { 101, 100, "game-helper", 200, nullptr },
+                { 200, 1, "hog",          800, nullptr },
+                { 201, 1, "browser",      600, "/user.slice/app-browser.scope" },
+                { 202, 201, "browser-tab", 300, "/user.slice/app-browser.scope" },
+                { 203, 1, "busy",         500, nullptr },
+                { 204, 1, "small",          8, nullptr },
+            };
+            for (auto& f : fake) {
+                mock->Spawn(f.pid, f.ppid, f.name);
+                mock->SetResident(f.pid, f.mb * M, f.group ? f.group : "");
+            }
+            mock->Spawn(2, 0, "kthreadd", true);
+            game = 100;
+            hog  = 200;
+        } else {
+            const std::string m = std::to_string(mb);
+            const char* g[] = { self, "--hog", m.c_str(), "30", nullptr };
+            const char* h[] = { self, "--hog", m.c_str(), "30", nullptr };
+            game = Sys::StartProcess(g);
+            hog  = Sys::StartProcess(h);
+        }
+        auto cleanup = [&] {
+            if (mock) { for (uint32_t pid : { 100u, 101u, 200u, 201u, 202u, 203u, 204u, 2u }) mock->Exit(pid); }
+            else      { Sys::StopProcess(game); Sys::StopProcess(hog); }
+        };
+        auto resident = [&](uint32_t pid) -> uint64_t {
+            std::vector<Sys::ProcessInfo> procs;
+            be.Processes(procs);
+            for (const Sys::ProcessInfo& p : procs)
+                if (p.pid == pid) return p.resident;
+            return 0;
+        };
+        // The children are up once their files are mapped and touched
+        for (int i = 0; !mock && i < 200 && (resident(game) < ((uint64_t)mb << 20) ||
+                                             resident(hog)  < ((uint64_t)mb << 20)); i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        Reclaim::Options opt;
+        opt.minIdleSec  = 0.5;
+        opt.minResident = 16ull << 20;
+        opt.onlyTree    = mock ? 0 : Sys::CurrentPid();     // never anything but our own children
+        Reclaim::Reclaimer rec(be, opt);
+        rec.Protect(game);
+        Reclaim::Report r, all;                             // all: every pass's actions
+        bool polled = true;
+        const int passes = 6;
+        for (int i = 0; i < passes && polled; i++) {
+            if (i) std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            if (mock) mock->Charge(203, 50000000);          // "busy" never goes idle
+            polled = rec.Poll(r, i == passes - 1 && !mock); // the mock is short of memory anyway
+            if (!r.triggered) continue;
+            if (!all.triggered) all.availableBefore = r.availableBefore;
+            all.triggered      = true;
+            all.total          = r.total;
+            all.availableAfter = r.availableAfter;
+            all.reclaimed     += r.reclaimed;
+            all.actions.insert(all.actions.end(), r.actions.begin(), r.actions.end());
+        }
+
+        const uint64_t gameAfter = resident(game), hogAfter = resident(hog);
+        uint64_t hogReclaimed = 0, groupReclaimed = 0, sum = 0;
+        bool touchedKept = false;
+        for (const Reclaim::Action& x : all.actions) {
+            if (x.pid == hog) hogReclaimed += x.reclaimed;
+            if (!x.group.empty()) groupReclaimed += x.reclaimed;
+            sum += x.reclaimed;
+            touchedKept |= x.pid == game || (mock && (x.pid == 101 || x.pid == 203 || x.pid == 204 || x.pid == 2));
+        }
+        const bool ok = polled && all.triggered && hogReclaimed > 0 && !touchedKept && sum == all.reclaimed &&
+                        (!mock || groupReclaimed > 0);
+        js.Field("status", ok ? "ok" : "failed").Field("ms", Ms(t0))
+          .Field("hog_reclaimed", hogReclaimed).Field("hog_resident_after", hogAfter)
+          .Field("game_resident_after", gameAfter).Field("protected_untouched", !touchedKept);
+        if (mock) js.Field("group_reclaimed", groupReclaimed);
+        EmitReclaim(all, js);
+        js.EndObject();
+        cleanup();
+        return ok;
+    }
+
+}  // namespace Headless
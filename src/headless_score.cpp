@@ -0,0 +1,56 @@
+#include "headless_steps.h"
+#include "bench_suite.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Headless {
+
+    // One suite run, saved to the history; regressions are against the last
+    // run under the same label, so "after:gaming" is compared with the last
+    // "after:gaming", not with a run taken unboosted
+    bool RunBenchScore(Bench::History& hist, const std::string& label,
+                       IO::JsonWriter& js, Bench::Result* out) {
+        const auto t0 = Clock::now();
+        const fs::path scratch = hist.File().parent_path() / "bench-scratch";
+        const Bench::Result r = Bench::Run(scratch, label);
+        const double ms = Ms(t0);
+        const Bench::Result* prev = hist.Last(label);
+        const std::vector<Bench::Metric> worse = prev ? Bench::Regressions(*prev, r) : std::vector<Bench::Metric>{};
+        const bool saved = hist.Append(r);
+
+        js.BeginObject().Field("step", "bench_score").Field("label", label)
+          .Field("status", saved ? "ok" : "failed").Field("ms", ms)
+          .Field("score", (double)r.score);
+        if (!saved) js.Field("error", "cannot write " + hist.File().u8string());
+        js.Key("metrics").BeginObject();
+        for (unsigned i = 0; i < (unsigned)Bench::Metric::Count; i++) {
+            const Bench::Metric m = (Bench::Metric)i;
+            js.Key(Bench::Describe(m).key).BeginObject().Field("value", r.value[i])
+              .Field("score", (double)Bench::SubScore(m, r.value[i]));
+            if (prev) js.Field("change_pct", Bench::Improvement(m, prev->value[i], r.value[i]));
+            js.EndObject();
+        }
+        js.EndObject();
+        if (prev) js.Field("previous_score", (double)prev->score);
+        js.Key("regressions").BeginArray();
+        for (Bench::Metric m : worse) js.Str(Bench::Describe(m).key);
+        js.EndArray().Field("history_runs", (uint64_t)hist.Runs().size()).EndObject();
+        if (out) *out = r;
+        return saved;
+    }
+
+    void BenchDelta(const std::string& profile, const Bench::Result& before,
+                    const Bench::Result& after, IO::JsonWriter& js) {
+        js.BeginObject().Field("step", "bench_delta").Field("profile", profile)
+          .Field("score_before", (double)before.score).Field("score_after", (double)after.score)
+          .Field("score_delta", (double)(after.score - before.score));
+        js.Key("improvement_pct").BeginObject();
+        for (unsigned i = 0; i < (unsigned)Bench::Metric::Count; i++)
+            js.Field(Bench::Describe((Bench::Metric)i).key,
+                     Bench::Improvement((Bench::Metric)i, before.value[i], after.value[i]));
+        js.EndObject().EndObject();
+    }
+
+}  // namespace Headless
@@ -0,0 +1,118 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  HEADLESS STEPS  —  the runner's steps, one headless_<module>.cpp each
+// ──────────────────────────────────────────────────────────────────────────────
+//  headless.cpp parses the arguments and runs the steps in order.  A step
+//  writes one object into the report's "steps" array: what it measured, its
+//  checks{} and a status.  It returns false when a check failed.  The
+//  --bench-NAME [N] modes register a BenchMode in headless.cpp's table, so
+//  the dispatcher parses, documents and runs them without naming each one.
+#pragma once
+
+#include "headless.h"
+
+#include "backend.h"
+#include "bench_suite.h"
+#include "json_writer.h"
+#include "latency_monitor.h"
+#include "memory_reclaimer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Headless {
+
+    namespace fs = std::filesystem;
+    using Clock  = std::chrono::steady_clock;
+
+    struct Args {
+        bool                  clean     = false;
+        bool                  dryRun    = false;
+        bool                  journal   = true;
+        bool                  pretty    = false;
+        bool                  list      = false;
+        std::string           profile;
+        std::string           saveProfile;
+        std::vector<std::string> mockFail;     // tweak keys
+        std::vector<std::string> mockDelay;    // KEY=MS
+        bool                  serial    = false;
+        unsigned              mockCrash = 0;    // Set() calls until the simulated crash
+        std::string           backend   = "native";
+        std::vector<fs::path> roots;
+        fs::path              analyze;
+        fs::path              play;
+        std::string           sink      = "null-fast";
+        unsigned              threads   = 0;
+        std::vector<unsigned> bench;            // N per registered BenchMode; 0 = off
+        bool                  benchScore = false;
+        double                latencySec = 0.0; // sampling window; 0 = off
+        unsigned              latencyHz  = Latency::Monitor::kDefaultHz;
+        double                telemetrySec = 0.0;   // 0 = off
+        unsigned              telemetryHz  = 10;
+        fs::path              latencyCsv;
+        fs::path              trace;            // Chrome trace of the run's zones
+        uint32_t              governPid  = 0;
+        double                governFor  = 0.0; // seconds; 0 = until the process exits
+        double                governSynthetic = 0.0;
+        double                spinSec    = 0.0; // --spin: be a synthetic CPU-bound workload
+        double                reclaimSec = 0.0; // watch window; 0 = off
+        Reclaim::Options      reclaim;
+        uint32_t              reclaimProtect = 0;
+        bool                  reclaimForce = false;
+        bool                  reclaimSynthetic = false;
+        unsigned              hogMb      = 0;   // --hog: be a synthetic idle memory holder
+        double                hogSec     = 0.0;
+        unsigned              spinThreads = 1;
+        bool                  spawn     = false;
+        int64_t               minAge    = -1;   // -1: backend default
+    };
+
+    inline double Ms(Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    }
+
+    // ── --bench-NAME [N] ──────────────────────────────────────────────────────
+    struct BenchMode {
+        const char* flag;                       // "--bench-geometry"
+        unsigned    defaultN;                   // when N is left out
+        unsigned    minN;                       // below it is a usage error
+        const char* usage;                      // its lines of the usage text
+        bool      (*run)(Sys::Backend& be, const Args& a, unsigned n, IO::JsonWriter& js);
+    };
+
+    extern const BenchMode kBenchAnim;          // headless_anim.cpp
+    extern const BenchMode kBenchActions;       // headless_actions.cpp
+    extern const BenchMode kBenchNotify;        // headless_notify.cpp
+    extern const BenchMode kBenchFontCache;     // headless_font_cache.cpp
+    extern const BenchMode kBenchGeometry;      // headless_geometry.cpp
+    extern const BenchMode kBenchUiRegress;     // headless_ui_regress.cpp
+
+    // ── Steps with options of their own ───────────────────────────────────────
+    // headless_audio.cpp
+    bool RunAnalyze(const fs::path& file, IO::JsonWriter& js);
+    bool RunPlay(const Args& a, IO::JsonWriter& js);
+
+    // headless_score.cpp
+    bool RunBenchScore(Bench::History& hist, const std::string& label,
+                       IO::JsonWriter& js, Bench::Result* out = nullptr);
+    void BenchDelta(const std::string& profile, const Bench::Result& before,
+                    const Bench::Result& after, IO::JsonWriter& js);
+
+    // headless_latency.cpp, headless_telemetry.cpp, headless_trace.cpp
+    bool RunLatency(const Args& a, IO::JsonWriter& js);
+    bool RunTelemetry(const Args& a, IO::JsonWriter& js);
+    bool RunTrace(const fs::path& file, IO::JsonWriter& js);
+
+    // headless_reclaim.cpp; `self` is argv[0], for the synthetic children
+    bool RunReclaim(Sys::Backend& be, const Args& a, IO::JsonWriter& js);
+    bool RunReclaimSynthetic(Sys::Backend& be, const char* self, IO::JsonWriter& js);
+    int  Hog(unsigned mb, double sec);
+
+    // headless_governor.cpp
+    bool RunGovern(Sys::Backend& be, const Args& a, IO::JsonWriter& js);
+    bool RunGovernSynthetic(Sys::Backend& be, double sec, const char* self, IO::JsonWriter& js);
+    int  Spin(double sec, unsigned threads);
+
+}  // namespace Headless
@@ -0,0 +1,50 @@
+#include "headless_steps.h"
+#include "telemetry.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace Headless {
+
+    bool RunTelemetry(const Args& a, IO::JsonWriter& js) {
+        static Telemetry::Sampler sampler;      // ~70 KB of rings
+        js.BeginObject().Field("step", "telemetry");
+        if (!sampler.Start(a.telemetryHz)) {
+            js.Field("status", "failed").Field("error", "system counters unavailable").EndObject();
+            return false;
+        }
+        // Allocations from the second sample on: Open() and the first read
+        // are allowed to allocate, the loop is not
+        while (sampler.Ticks() < 1) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        const uint64_t allocs0 = Allocations();
+        const uint64_t ticks0  = sampler.Ticks();
+        std::this_thread::sleep_for(std::chrono::duration<double>(a.telemetrySec));
+        const uint64_t allocs = Allocations() - allocs0;
+        const uint64_t ticks  = sampler.Ticks() - ticks0;
+        sampler.Stop();
+
+        float v[Telemetry::kHistory];
+        auto mean = [&](const Telemetry::Ring& r) {
+            const size_t n = r.Read(v, (size_t)ticks);
+            double sum = 0.0;
+            for (size_t i = 0; i < n; i++) sum += v[i];
+            return n ? sum / (double)n : 0.0;
+        };
+        const bool ok = ticks > 0;
+        js.Field("status", ok ? "ok" : "failed").Field("seconds", a.telemetrySec)
+          .Field("rate_hz", (uint64_t)sampler.RateHz()).Field("samples", ticks)
+          .Field("cost_us", sampler.CostNs() / 1e3).Field("steady_allocations", allocs)
+          .Field("cpus", (uint64_t)sampler.Cpus()).Field("mem_total", sampler.MemTotal());
+        js.Key("mean").BeginObject();
+        for (unsigned s = 0; s < (unsigned)Telemetry::Series::Count; s++)
+            js.Field(Telemetry::SeriesName((Telemetry::Series)s), mean(sampler.Get((Telemetry::Series)s)));
+        js.EndObject();
+        js.Key("cores").BeginArray();
+        for (unsigned i = 0; i < sampler.Cpus(); i++) js.Num(mean(sampler.Core(i)));
+        js.EndArray();
+        js.EndObject();
+        return ok;
+    }
+
+}  // namespace Headless
@@ -0,0 +1,52 @@
+#include "headless_steps.h"
+#include "profiler.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Headless {
+
+    // Ends the run's capture and writes it out, then times one zone with
+    // capture off (the price of leaving zones compiled in) and on, on a
+    // fresh thread so the timing loop stays out of the trace
+    bool RunTrace(const fs::path& file, IO::JsonWriter& js) {
+        XOPT_ZONE("Headless::RunTrace");
+        Prof::Stop();
+        std::vector<Prof::Event> ev;
+        Prof::Collect(ev);
+        std::string err;
+        const bool ok = Prof::ExportChromeTrace(ev, file, &err);
+        std::vector<Prof::ZoneStat> zones;
+        Prof::Summarize(ev, zones);
+
+        constexpr unsigned kZones = 100000;
+        auto timeZones = [] {
+            const uint64_t t0 = Prof::Now();
+            for (unsigned i = 0; i < kZones; i++) { XOPT_ZONE("Headless::Overhead"); }
+            return (double)(Prof::Now() - t0) / kZones;
+        };
+        double idleNs = 0.0, onNs = 0.0;
+        std::thread([&] { idleNs = timeZones(); }).join();
+        Prof::Start();
+        std::thread([&] { onNs = timeZones(); }).join();
+        Prof::Stop();
+
+        uint32_t threads = 0;
+        for (size_t i = 0; i < ev.size(); i++) threads += !i || ev[i - 1].thread != ev[i].thread;
+        js.BeginObject().Field("step", "trace").Field("status", ok ? "ok" : "failed")
+          .Field("file", file.u8string()).Field("compiled", Prof::Compiled())
+          .Field("zones", (uint64_t)ev.size()).Field("threads", (uint64_t)threads)
+          .Field("zone_ns", onNs).Field("zone_idle_ns", idleNs);
+        if (!ok) js.Field("error", err);
+        js.Key("top").BeginArray();
+        for (size_t i = 0; i < zones.size() && i < 12; i++)
+            js.BeginObject().Field("zone", zones[i].name).Field("count", zones[i].count)
+              .Field("total_ms", zones[i].totalNs / 1e6).Field("self_ms", zones[i].selfNs / 1e6)
+              .Field("max_ms", zones[i].maxNs / 1e6).EndObject();
+        js.EndArray().EndObject();
+        return ok;
+    }
+
+}  // namespace Headless
@@ -0,0 +1,135 @@
+#include "headless_steps.h"
+#include "ui_bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Headless {
+
+    // Two synthetic panels through the Recorder, as RenderUI's PanelScope
+    // drives it: "Light" (two frames in three) and "Heavy" burn CPU, allocate
+    // and emit geometry in fixed amounts, heavier[run] times more for Heavy.
+    // The runs take turns frame by frame, so a machine that slows down
+    // halfway slows every run alike.
+    static std::vector<std::vector<UiBench::Summary>> RecordUiPanels(unsigned frames, const std::vector<unsigned>& heavier,
+                                                                     float& sink) {
+        std::vector<UiBench::Recorder> recs(heavier.size(), UiBench::Recorder(Allocations));
+        for (unsigned f = 0; f < frames; f++) {
+            for (size_t r = 0; r < recs.size(); r++) {
+                const bool     heavy = f % 3 == 2;
+                const unsigned k     = heavy ? heavier[r] : 1;
+                UiBench::SetActive(&recs[r]);
+                recs[r].BeginFrame();
+                {
+                    UiBench::PanelScope scope(heavy ? "Heavy" : "Light");
+                    for (unsigned i = 0; i < 20000 * k; i++) sink += std::sin((float)i * 1e-3f);
+                    std::vector<std::string> labels;
+                    for (unsigned i = 0; i < 8 * k; i++) labels.push_back(std::string(32, (char)('a' + i % 26)));
+                    sink += (float)labels.size();
+                }
+                recs[r].EndFrame(40 * k, 3000 * k, 4500 * k);
+            }
+        }
+        UiBench::SetActive(nullptr);
+        std::vector<std::vector<UiBench::Summary>> out;
+        for (const UiBench::Recorder& r : recs) out.push_back(r.Summarize());
+        return out;
+    }
+
+    static bool RunBenchUiRegress(Sys::Backend&, const Args&, unsigned frames, IO::JsonWriter& js) {
+        js.BeginObject().Field("step", "bench_ui_regress");
+        float sink = 0.0f;
+
+        // Script parsing and the default tour
+        std::vector<UiBench::Input> script;
+        std::string err;
+        const bool parsed = UiBench::ParseScript("# hover then click\n12 move 300 200\n\n10 tab 2\n14 down 0\n15 up 0\n16 wheel -1\n",
+                                                 script, &err) &&
+                            script.size() == 5 && script[0].kind == UiBench::Input::Kind::Tab && script[0].frame == 10;
+        const bool rejects = !UiBench::ParseScript("3 jump 1\n", script, &err) && !UiBench::ParseScript("move 1 2\n", script, &err);
+        const std::vector<UiBench::Input> tour = UiBench::DefaultScript(5, 240, 1050.0f, 680.0f);
+        unsigned tabs = 0;
+        bool inBounds = true;
+        for (const UiBench::Input& e : tour) {
+            tabs += e.kind == UiBench::Input::Kind::Tab;
+            inBounds = inBounds && e.frame < 5 * 240 && e.x >= 0.0f && e.x <= 1050.0f && e.y <= 680.0f;
+        }
+        const bool tour5 = tabs == 5 && inBounds;
+
+        // A scope with no recorder records nothing
+        { UiBench::PanelScope idle("Idle"); }
+        const bool idleFree = UiBench::Active() == nullptr;
+
+        // A baseline, an unchanged rerun, and Heavy at twice the cost
+        const auto t0 = Clock::now();
+        const auto runs = RecordUiPanels(frames, { 2, 2, 4 }, sink);
+        const double recordMs = Ms(t0);
+        const std::vector<UiBench::Summary>& base  = runs[0];
+        const std::vector<UiBench::Summary>& same  = runs[1];
+        const std::vector<UiBench::Summary>& worse = runs[2];
+
+        std::error_code ec;
+        const fs::path file = fs::temp_directory_path(ec) / ("xopt-ui-" + std::to_string(Sys::CurrentPid()) + ".xou");
+        std::vector<UiBench::Summary> loaded;
+        bool roundTrip = UiBench::SaveBaseline(file, base, &err) && UiBench::LoadBaseline(file, loaded, &err) &&
+                         loaded.size() == base.size();
+        for (size_t i = 0; roundTrip && i < base.size(); i++)
+            roundTrip = loaded[i].name == base[i].name && loaded[i].frames == base[i].frames &&
+                        loaded[i].cpuP50Us == base[i].cpuP50Us && loaded[i].allocations == base[i].allocations &&
+                        loaded[i].vertices == base[i].vertices;
+        fs::remove(file, ec);
+        std::vector<UiBench::Summary> none;
+        const bool missingRejected = !UiBench::LoadBaseline(file, none, &err);
+
+        const std::vector<UiBench::Regression> steady  = UiBench::Compare(loaded, same);
+        const std::vector<UiBench::Regression> regress = UiBench::Compare(loaded, worse);
+        const std::vector<UiBench::Regression> dropped = UiBench::Compare(loaded, { same.front() });
+        auto flagged = [&](const char* panel, const char* metric) {
+            return std::any_of(regress.begin(), regress.end(), [&](const UiBench::Regression& r) {
+                return r.panel == panel && !std::strcmp(r.metric, metric);
+            });
+        };
+        const bool caught = flagged("Heavy", "cpu_p50_us") && flagged("Heavy", "allocations") &&
+                            flagged("Heavy", "draw_calls") && flagged("Heavy", "vertices");
+        const bool lightClean = std::none_of(regress.begin(), regress.end(),
+                                             [](const UiBench::Regression& r) { return r.panel == "Light"; });
+        const bool missing = std::count_if(dropped.begin(), dropped.end(), [](const UiBench::Regression& r) {
+                                 return !std::strcmp(r.metric, "missing");
+                             }) == (ptrdiff_t)loaded.size() - 1;
+
+        js.Field("frames", (uint64_t)frames).Field("record_ms", recordMs);
+        js.Key("panels").BeginArray();
+        for (const UiBench::Summary& p : base)
+            js.BeginObject().Field("name", p.name).Field("frames", (uint64_t)p.frames)
+              .Field("cpu_p50_us", p.cpuP50Us).Field("cpu_p95_us", p.cpuP95Us)
+              .Field("draw_calls", p.drawCalls).Field("vertices", p.vertices).Field("allocations", p.allocations).EndObject();
+        js.EndArray();
+        js.Key("regressions").BeginArray();
+        for (const UiBench::Regression& r : regress)
+            js.BeginObject().Field("panel", r.panel).Field("metric", r.metric)
+              .Field("before", r.before).Field("after", r.after).Field("worse_pct", r.pct).EndObject();
+        js.EndArray();
+        js.Key("checks").BeginObject().Field("script_parse", parsed).Field("script_rejects", rejects)
+          .Field("default_tour", tour5).Field("idle_scope", idleFree).Field("baseline_round_trip", roundTrip)
+          .Field("missing_baseline", missingRejected).Field("unchanged_passes", steady.empty())
+          .Field("regression_caught", caught).Field("other_panel_clean", lightClean).Field("missing_panel", missing).EndObject();
+        const bool ok = parsed && rejects && tour5 && idleFree && roundTrip && missingRejected && steady.empty() &&
+                        caught && lightClean && missing && sink != 0.0f;
+        js.Field("status", ok ? "ok" : "failed").EndObject();
+        return ok;
+    }
+
+    const BenchMode kBenchUiRegress = {
+        "--bench-ui-regress", 600, 10,
+        "  --bench-ui-regress [N]  the UI bench's gate on synthetic panels: record N\n"
+        "                     frames per run (default 600), round-trip a baseline,\n"
+        "                     and check that a slower, allocating panel is reported\n"
+        "                     while an unchanged rerun is not (real panels: xopt-uibench)\n",
+        RunBenchUiRegress,
+    };
+
+}  // namespace Headless
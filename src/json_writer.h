@@ -0,0 +1,105 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  JSON WRITER  —  minimal streaming writer for machine-readable reports
+// ──────────────────────────────────────────────────────────────────────────────
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace IO {
+
+    class JsonWriter {
+    public:
+        explicit JsonWriter(FILE* out, bool pretty = false) : m_out(out), m_pretty(pretty) {}
+
+        JsonWriter& BeginObject()  { Value(); Put('{'); m_first.push_back(true); return *this; }
+        JsonWriter& EndObject()    { Close('}'); return *this; }
+        JsonWriter& BeginArray()   { Value(); Put('['); m_first.push_back(true); return *this; }
+        JsonWriter& EndArray()     { Close(']'); return *this; }
+
+        JsonWriter& Key(const char* k) {
+            Separator();
+            String(k);
+            Put(':');
+            m_afterKey = true;
+            return *this;
+        }
+
+        JsonWriter& Str(const char* s)        { Value(); String(s); return *this; }
+        JsonWriter& Str(const std::string& s) { return Str(s.c_str()); }
+        JsonWriter& Bool(bool b)              { Value(); std::fputs(b ? "true" : "false", m_out); return *this; }
+        JsonWriter& Null()                    { Value(); std::fputs("null", m_out); return *this; }
+        JsonWriter& Uint(uint64_t v)          { Value(); std::fprintf(m_out, "%llu", (unsigned long long)v); return *this; }
+        JsonWriter& Int(int64_t v)            { Value(); std::fprintf(m_out, "%lld", (long long)v); return *this; }
+        JsonWriter& Num(double v, int prec = 3) {
+            Value();
+            if (v != v || v > 1e300 || v < -1e300) std::fputs("null", m_out);   // NaN / inf aren't JSON
+            else std::fprintf(m_out, "%.*f", prec, v);
+            return *this;
+        }
+
+        // Key + value shorthands
+        JsonWriter& Field(const char* k, bool v)               { return Key(k).Bool(v); }
+        JsonWriter& Field(const char* k, double v)             { return Key(k).Num(v); }
+        JsonWriter& Field(const char* k, uint64_t v)           { return Key(k).Uint(v); }
+        JsonWriter& Field(const char* k, int64_t v)            { return Key(k).Int(v); }
+        JsonWriter& Field(const char* k, const char* v)        { return Key(k).Str(v); }
+        JsonWriter& Field(const char* k, const std::string& v) { return Key(k).Str(v); }
+
+        void Finish() { Put('\n'); std::fflush(m_out); }
+
+    private:
+        void Put(char c) { std::fputc(c, m_out); }
+
+        void Indent() {
+            if (!m_pretty) return;
+            Put('\n');
+            for (size_t i = 0; i < m_first.size(); i++) std::fputs("  ", m_out);
+        }
+
+        void Separator() {
+            if (m_first.empty()) return;
+            if (!m_first.back()) Put(',');
+            m_first.back() = false;
+            Indent();
+        }
+
+        void Value() {
+            if (m_afterKey) { m_afterKey = false; return; }
+            Separator();
+        }
+
+        void Close(char c) {
+            const bool empty = m_first.back();
+            m_first.pop_back();
+            if (!empty) Indent();
+            Put(c);
+        }
+
+        void String(const char* s) {
+            Put('"');
+            for (; *s; ++s) {
+                const unsigned char c = (unsigned char)*s;
+                switch (c) {
+                    case '"':  std::fputs("\\\"", m_out); break;
+                    case '\\': std::fputs("\\\\", m_out); break;
+                    case '\n': std::fputs("\\n",  m_out); break;
+                    case '\r': std::fputs("\\r",  m_out); break;
+                    case '\t': std::fputs("\\t",  m_out); break;
+                    default:
+                        if (c < 0x20) std::fprintf(m_out, "\\u%04x", c);
+                        else          Put((char)c);
+                }
+            }
+            Put('"');
+        }
+
+        FILE*             m_out;
+        bool              m_pretty;
+        bool              m_afterKey = false;
+        std::vector<bool> m_first;      // per open container: no element written yet
+    };
+
+}  // namespace IO
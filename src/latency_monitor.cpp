@@ -0,0 +1,301 @@
+#include "latency_monitor.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#  ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#    define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#  endif
+#else
+#  include <cerrno>
+#  include <ctime>
+#  include <pthread.h>
+#  include <sys/eventfd.h>
+#  include <sys/timerfd.h>
+#  include <unistd.h>
+#endif
+
+namespace Latency {
+
+    // ── Histogram ─────────────────────────────────────────────────────────────
+
+    static unsigned Log2(uint64_t v) {
+        unsigned n = 0;
+        while (v >>= 1) n++;
+        return n;
+    }
+
+    size_t Histogram::Bucket(uint64_t ns) {
+        if (ns < kLinear) return (size_t)ns;
+        const unsigned shift = Log2(ns) - 6;           // ns >> shift lands in [64, 128)
+        if (shift > kShifts) return kBuckets - 1;
+        return kLinear + (size_t)(shift - 1) * kSubs + (size_t)((ns >> shift) - kSubs);
+    }
+
+    uint64_t Histogram::Value(size_t b) {
+        if (b < kLinear) return b;
+        const unsigned shift = (unsigned)((b - kLinear) / kSubs) + 1;
+        const uint64_t top   = kSubs + (b - kLinear) % kSubs;
+        return (top << shift) + (1ull << (shift - 1));
+    }
+
+    void Histogram::Record(uint64_t ns) {
+        m_count[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t m = m_max.load(std::memory_order_relaxed);
+        while (ns > m && !m_max.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+    }
+
+    void Histogram::Reset() {
+        for (auto& c : m_count) c.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    void Histogram::Read(Snapshot& out) const {
+        out.total = 0;
+        for (size_t i = 0; i < kBuckets; i++) {
+            out.count[i] = m_count[i].load(std::memory_order_relaxed);
+            out.total   += out.count[i];
+        }
+        out.max = m_max.load(std::memory_order_relaxed);
+    }
+
+    void Histogram::Since(const Snapshot& now, const Snapshot& then, Snapshot& out) {
+        out.total = out.max = 0;
+        for (size_t i = 0; i < kBuckets; i++) {
+            out.count[i] = now.count[i] >= then.count[i] ? now.count[i] - then.count[i] : now.count[i];
+            out.total   += out.count[i];
+            if (out.count[i]) out.max = Value(i);
+        }
+    }
+
+    uint64_t Histogram::Percentile(const Snapshot& s, double p) {
+        if (!s.total) return 0;
+        const uint64_t want = std::max<uint64_t>(1, (uint64_t)std::ceil(std::clamp(p, 0.0, 1.0) * (double)s.total));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; i++)
+            if ((seen += s.count[i]) >= want) return Value(i);
+        return Value(kBuckets - 1);
+    }
+
+    const char* ProbeName(Probe p) {
+        return p == Probe::TimerWake ? "timer_wake" : "thread_wake";
+    }
+
+    Summary Summarize(const Histogram::Snapshot& s) {
+        Summary r;
+        // A bucket midpoint can sit above the largest value actually seen
+        r.count = s.total;
+        r.max   = s.max;
+        r.p50   = std::min(Histogram::Percentile(s, 0.50),  r.max);
+        r.p99   = std::min(Histogram::Percentile(s, 0.99),  r.max);
+        r.p999  = std::min(Histogram::Percentile(s, 0.999), r.max);
+        return r;
+    }
+
+    // ── Platform: clock, tick, doorbell ───────────────────────────────────────
+
+#ifdef _WIN32
+    uint64_t NowNs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64_t ThreadCpuNs(std::thread& t) {
+        FILETIME c, e, k, u;
+        if (!t.joinable() || !GetThreadTimes((HANDLE)t.native_handle(), &c, &e, &k, &u)) return 0;
+        auto ns = [](const FILETIME& f) { return (((uint64_t)f.dwHighDateTime << 32) | f.dwLowDateTime) * 100; };
+        return ns(k) + ns(u);
+    }
+
+    static bool OpenHandles(void*& timer, void*& bell, uint64_t, uint64_t) {
+        timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer) timer = CreateWaitableTimerW(nullptr, FALSE, nullptr);     // before Windows 10 1803
+        bell = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        return timer && bell;
+    }
+
+    static void CloseHandles(void*& timer, void*& bell) {
+        if (timer) CloseHandle(timer);
+        if (bell)  CloseHandle(bell);
+        timer = bell = nullptr;
+    }
+
+    // No absolute periodic timer with sub-ms period: re-arm relative to the
+    // deadline every tick
+    bool Monitor::WaitTick(uint64_t& deadline, uint64_t& expirations) {
+        const uint64_t now = NowNs();
+        if (deadline > now) {
+            LARGE_INTEGER due;
+            due.QuadPart = -(LONGLONG)((deadline - now) / 100);
+            if (!SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) return false;
+            if (WaitForSingleObject(m_timer, INFINITE) != WAIT_OBJECT_0) return false;
+        }
+        const uint64_t after = NowNs();
+        expirations = 1 + (after > deadline ? (after - deadline) / m_periodNs : 0);
+        deadline   += (expirations - 1) * m_periodNs;
+        return true;
+    }
+
+    void Monitor::Ring()     { SetEvent(m_bell); }
+    bool Monitor::WaitRing() { return WaitForSingleObject(m_bell, INFINITE) == WAIT_OBJECT_0; }
+#else
+    uint64_t NowNs() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    }
+
+    static timespec ToTimespec(uint64_t ns) {
+        timespec ts;
+        ts.tv_sec  = (time_t)(ns / 1000000000ull);
+        ts.tv_nsec = (long)(ns % 1000000000ull);
+        return ts;
+    }
+
+    static uint64_t ThreadCpuNs(std::thread& t) {
+        clockid_t id;
+        timespec  ts;
+        if (!t.joinable() || pthread_getcpuclockid(t.native_handle(), &id) != 0 || clock_gettime(id, &ts) != 0)
+            return 0;
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    }
+
+    // An absolute periodic timerfd: the kernel keeps the rate, expirations
+    // past the first say how many ticks were missed.  Without timerfd the
+    // sampler falls back to clock_nanosleep(TIMER_ABSTIME).
+    static bool OpenHandles(int& timer, int& bell, uint64_t firstNs, uint64_t periodNs) {
+        timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (timer >= 0) {
+            itimerspec its;
+            its.it_value    = ToTimespec(firstNs);
+            its.it_interval = ToTimespec(periodNs);
+            if (timerfd_settime(timer, TFD_TIMER_ABSTIME, &its, nullptr) != 0) { close(timer); timer = -1; }
+        }
+        bell = eventfd(0, EFD_CLOEXEC);
+        return bell >= 0;
+    }
+
+    static void CloseHandles(int& timer, int& bell) {
+        if (timer >= 0) close(timer);
+        if (bell >= 0)  close(bell);
+        timer = bell = -1;
+    }
+
+    bool Monitor::WaitTick(uint64_t& deadline, uint64_t& expirations) {
+        if (m_timer >= 0) {
+            uint64_t n = 0;
+            ssize_t  got;
+            while ((got = read(m_timer, &n, sizeof(n))) < 0 && errno == EINTR) {}
+            if (got != (ssize_t)sizeof(n) || !n) return false;
+            expirations = n;
+        } else {
+            const timespec ts = ToTimespec(deadline);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+            const uint64_t now = NowNs();
+            expirations = 1 + (now > deadline ? (now - deadline) / m_periodNs : 0);
+        }
+        deadline += (expirations - 1) * m_periodNs;     // the latest tick is what woke us
+        return true;
+    }
+
+    void Monitor::Ring() {
+        const uint64_t one = 1;
+        while (write(m_bell, &one, sizeof(one)) < 0 && errno == EINTR) {}
+    }
+
+    bool Monitor::WaitRing() {
+        uint64_t n;
+        ssize_t  got;
+        while ((got = read(m_bell, &n, sizeof(n))) < 0 && errno == EINTR) {}
+        return got == (ssize_t)sizeof(n);
+    }
+#endif
+
+    // ── Monitor ───────────────────────────────────────────────────────────────
+
+    bool Monitor::Start(unsigned rateHz) {
+        if (Running()) return false;
+        m_rateHz   = std::clamp(rateHz, 1u, 10000u);
+        m_periodNs = 1000000000ull / m_rateHz;
+        for (auto& h : m_hist) h.Reset();
+        m_ticks  = 0;
+        m_missed = 0;
+        m_stop   = false;
+        m_startNs = NowNs();
+        if (!OpenHandles(m_timer, m_bell, m_startNs + m_periodNs, m_periodNs)) {
+            CloseHandles(m_timer, m_bell);
+            return false;
+        }
+        m_responder = std::thread([this] { ResponderLoop(); });
+        m_sampler   = std::thread([this] { SamplerLoop(); });
+        return true;
+    }
+
+    void Monitor::Stop() {
+        if (!Running()) return;
+        m_cpuAtStop = CpuPercent();
+        m_stop = true;
+        m_sampler.join();           // wakes on its next tick
+        Ring();                     // the responder is parked on the bell
+        m_responder.join();
+        CloseHandles(m_timer, m_bell);
+    }
+
+    void Monitor::SamplerLoop() {
+        uint64_t deadline = m_startNs + m_periodNs, expirations = 0;
+        while (!m_stop.load(std::memory_order_relaxed) && WaitTick(deadline, expirations)) {
+            const uint64_t now = NowNs();
+            m_hist[(size_t)Probe::TimerWake].Record(now > deadline ? now - deadline : 0);
+            if (expirations > 1) m_missed.fetch_add(expirations - 1, std::memory_order_relaxed);
+            m_ticks.fetch_add(1, std::memory_order_relaxed);
+            m_rangAt.store(NowNs(), std::memory_order_release);
+            Ring();
+            deadline += m_periodNs;
+        }
+    }
+
+    void Monitor::ResponderLoop() {
+        while (WaitRing() && !m_stop.load(std::memory_order_relaxed)) {
+            const uint64_t now = NowNs(), at = m_rangAt.load(std::memory_order_acquire);
+            m_hist[(size_t)Probe::ThreadWake].Record(now > at ? now - at : 0);
+        }
+    }
+
+    double Monitor::CpuPercent() const {
+        if (!Running()) return m_cpuAtStop;
+        const uint64_t wall = NowNs() - m_startNs;
+        auto& self = const_cast<Monitor&>(*this);
+        const uint64_t cpu = ThreadCpuNs(self.m_sampler) + ThreadCpuNs(self.m_responder);
+        return wall ? 100.0 * (double)cpu / (double)wall : 0.0;
+    }
+
+    bool Monitor::ExportCsv(const std::filesystem::path& p, std::string* error) const {
+        std::string out = "probe,latency_ns,count,percentile\n";
+        Histogram::Snapshot s;
+        char line[96];
+        for (unsigned i = 0; i < (unsigned)Probe::Count; i++) {
+            m_hist[i].Read(s);
+            uint64_t seen = 0;
+            for (size_t b = 0; b < Histogram::kBuckets; b++) {
+                if (!s.count[b]) continue;
+                seen += s.count[b];
+                std::snprintf(line, sizeof(line), "%s,%llu,%llu,%.6f\n", ProbeName((Probe)i),
+                              (unsigned long long)Histogram::Value(b), (unsigned long long)s.count[b],
+                              (double)seen / (double)s.total);
+                out += line;
+            }
+        }
+        if (IO::WriteFileAtomic(p, out.data(), out.size())) return true;
+        if (error) *error = "cannot write " + p.u8string();
+        return false;
+    }
+
+}  // namespace Latency
@@ -0,0 +1,116 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  LATENCY MONITOR  —  is the timer tweak actually doing anything?
+// ──────────────────────────────────────────────────────────────────────────────
+//  A sampler thread wakes on a fixed-rate absolute timer (timerfd, or
+//  clock_nanosleep without it, on Linux; a high-resolution waitable timer on
+//  Windows) and records how late it woke: timer-wake latency.  On each tick
+//  it also rings a responder thread blocked on an eventfd / event and the
+//  responder records how long it took to run: thread-wake latency.  Both go
+//  into log-linear HDR histograms the UI reads without a lock.
+//
+//  At the default 100 Hz that is 200 wakeups a second, a few µs each on
+//  bare metal: around 0.1 % of one core (VMs charge more per wakeup — a
+//  plain nanosleep loop costs the same there).  CpuPercent() reports the
+//  real figure from the two threads' CPU clocks.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace Latency {
+
+    // Values in ns.  0–127 exact, then 64 buckets per power of two (≤ 1.6 %
+    // error) up to ~2^40 ns.  Record() is a relaxed fetch_add, so any thread
+    // may write; readers copy the counters into a Snapshot.
+    class Histogram {
+    public:
+        static constexpr unsigned kLinear  = 128;
+        static constexpr unsigned kSubs    = 64;
+        static constexpr unsigned kShifts  = 34;
+        static constexpr size_t   kBuckets = kLinear + (size_t)kShifts * kSubs;
+
+        struct Snapshot {
+            uint64_t count[kBuckets] = {};
+            uint64_t total = 0;
+            uint64_t max   = 0;         // ns; after Since(), the top non-empty bucket
+        };
+
+        void Record(uint64_t ns);
+        void Reset();
+        void Read(Snapshot& out) const;
+
+        static size_t   Bucket(uint64_t ns);
+        static uint64_t Value(size_t bucket);                   // bucket midpoint, ns
+        // Counts recorded between two snapshots of the same histogram
+        static void     Since(const Snapshot& now, const Snapshot& then, Snapshot& out);
+        static uint64_t Percentile(const Snapshot& s, double p); // p in [0, 1]; 0 if empty
+
+    private:
+        std::atomic<uint64_t> m_count[kBuckets] = {};
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "histogram counters must be lock-free");
+
+    enum class Probe : uint8_t { TimerWake, ThreadWake, Count };
+    const char* ProbeName(Probe p);     // "timer_wake", "thread_wake"
+
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t p50 = 0, p99 = 0, p999 = 0, max = 0;      // ns
+    };
+    Summary Summarize(const Histogram::Snapshot& s);
+
+    class Monitor {
+    public:
+        static constexpr unsigned kDefaultHz = 100;
+
+        Monitor() = default;
+        ~Monitor() { Stop(); }
+        Monitor(const Monitor&)            = delete;
+        Monitor& operator=(const Monitor&) = delete;
+
+        bool Start(unsigned rateHz = kDefaultHz);   // false: already running / no timer
+        void Stop();
+        bool Running() const { return m_sampler.joinable(); }
+
+        unsigned         RateHz() const                { return m_rateHz; }
+        const Histogram& Get(Probe p) const            { return m_hist[(size_t)p]; }
+        uint64_t         Ticks() const                 { return m_ticks.load(std::memory_order_relaxed); }
+        uint64_t         Missed() const                { return m_missed.load(std::memory_order_relaxed); }
+        // CPU time of the sampler + responder threads over wall time since Start()
+        double           CpuPercent() const;
+
+        // One row per non-empty bucket: probe,latency_ns,count,percentile
+        bool ExportCsv(const std::filesystem::path& p, std::string* error = nullptr) const;
+
+    private:
+        void SamplerLoop();
+        void ResponderLoop();
+        bool WaitTick(uint64_t& deadline, uint64_t& expirations);
+        void Ring();
+        bool WaitRing();
+
+        Histogram             m_hist[(size_t)Probe::Count];
+        std::thread           m_sampler, m_responder;
+        std::atomic<bool>     m_stop{ false };
+        std::atomic<uint64_t> m_rangAt{ 0 };    // ns, when the responder was rung
+        std::atomic<uint64_t> m_ticks{ 0 }, m_missed{ 0 };
+        unsigned              m_rateHz   = kDefaultHz;
+        uint64_t              m_periodNs = 0;
+        uint64_t              m_startNs  = 0;
+        double                m_cpuAtStop = 0.0;
+#ifdef _WIN32
+        void*                 m_timer = nullptr;    // HANDLE, waitable timer
+        void*                 m_bell  = nullptr;    // HANDLE, auto-reset event
+#else
+        int                   m_timer = -1;         // timerfd; -1: clock_nanosleep
+        int                   m_bell  = -1;         // eventfd
+#endif
+    };
+
+    uint64_t NowNs();                   // the monotonic clock the monitor stamps with
+
+}  // namespace Latency
@@ -46,17 +46,50 @@
 #include <algorithm>
 #include <chrono>
 #include <map>
+#include <memory>
 #include <cmath>
+#include <cstring>
+#include <fstream>
 
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
 
+#include "cleaner.h"
+#include "clean_index.h"
+#include "affinity_governor.h"
+#include "backend.h"
+#include "bench_suite.h"
+#include "event_bus.h"
+#include "font_cache.h"
+#include "geometry_cache.h"
+#include "anim.h"
+#include "frame_pacer.h"
+#include "latency_monitor.h"
+#include "memory_reclaimer.h"
+#include "audio_engine.h"
+#include "playlist.h"
+#include "profiler.h"
+#include "boost_scheduler.h"
+#include "profile_store.h"
+#include "spectrum.h"
+#include "telemetry.h"
+#include "ui_bench.h"
+
 // IM_PI: defined in imgui_internal.h but we avoid that dependency
 #ifndef IM_PI
 #define IM_PI 3.14159265358979323846f
 #endif
 
+// 1 builds the UI without its window and device, for xopt-uibench: the
+// DirectX helpers and WinMain give way to the UiHost entry points
+#ifndef XOPT_UI_HEADLESS
+#define XOPT_UI_HEADLESS 0
+#endif
+#if XOPT_UI_HEADLESS
+#include "ui_host.h"
+#endif
+
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dwmapi.lib")
 #pragma comment(lib, "powrprof.lib")
@@ -109,29 +142,29 @@ namespace DS {
 // ──────────────────────────────────────────────────────────────────────────────
 //  ANIMATION HELPERS
 // ──────────────────────────────────────────────────────────────────────────────
-// Per-ID smooth float animation (spring-like)
-struct AnimState { float value = 0.0f; float velocity = 0.0f; };
-static std::map<ImGuiID, AnimState> g_anim;
+// Per-ID smooth float animation (spring-like) — widgets register targets with
+// Anim::Animator and read last frame's value; one batched pass integrates them
+static Anim::Animator   g_anim;
+// Idle-aware frame scheduling — anything still moving keeps the next frame
+static Anim::FramePacer g_pacer;
+// Tessellated widget geometry, replayed while the widget's state holds, and
+// the last frame's draw totals for the report
+static Geo::Cache g_geo;
+struct FrameGeometry { int vtx = 0, idx = 0, lists = 0; };
+static FrameGeometry g_frameGeo;
 
 static float SmoothAnimate(ImGuiID id, float target, float speed = 14.0f) {
-    float dt = ImGui::GetIO().DeltaTime;
-    auto& s = g_anim[id];
-    float diff = target - s.value;
-    s.velocity += diff * speed * dt;
-    s.velocity *= powf(0.001f, dt);  // damping
-    s.value += s.velocity * dt * 60.0f;
-    if (fabsf(diff) < 0.001f && fabsf(s.velocity) < 0.001f) s.value = target;
-    return s.value;
+    return g_anim.Animate(id, target, speed);
 }
 
-static float EaseInOut(float t) { return t * t * (3.0f - 2.0f * t); }
+static float EaseInOut(float t) { return Anim::EaseInOut(t); }
 
 // ──────────────────────────────────────────────────────────────────────────────
 //  GLOBAL APPLICATION STATE
 // ──────────────────────────────────────────────────────────────────────────────
 struct AppState {
     // Navigation
-    int  activeTab      = 0;           // 0=Boost 1=Clean 2=Launch 3=Phonk
+    int  activeTab      = 0;           // 0=Boost 1=Clean 2=Launch 3=Phonk 4=Stats
 
     // Boost toggles
     bool explorerKilled = false;
@@ -153,8 +186,12 @@ struct AppState {
     bool cleanWinTempDone   = false;
     bool cleanPrefetchDone  = false;
     bool cleanDNSDone       = false;
-    std::string cleanLog;
+    std::string cleanLog;                      // UI thread only — fed from cleanProgress
     std::atomic<bool> cleanRunning{ false };
+    Progress::Channel cleanProgress;           // cleaner workers → UI, lock-free
+    Progress::Tracker cleanTracker;
+    Cleaner::Index    cleanIndex;              // dry-run result; cleaner thread owns it while running
+    std::atomic<bool> cleanScanned{ false };
 
     // Launch
     char gamePath[512]  = {};
@@ -170,270 +207,633 @@ struct AppState {
     float phonkProgress = 0.0f;
     bool  phonkLoop     = false;
 
-    // Status notifications
-    struct Notif { std::string msg; ImVec4 col; float timer; };
-    std::vector<Notif> notifs;
-    std::mutex notifMtx;
-
-    void PushNotif(const std::string& msg, ImVec4 col = DS::ACCENT_GREEN) {
-        std::lock_guard<std::mutex> lk(notifMtx);
-        notifs.push_back({ msg, col, 3.0f });
+    // Status notifications — posted lock-free from any thread; the UI thread
+    // drains the bus into toasts and the searchable history
+    Events::Bus notify;
+
+    void PushNotif(Events::Source src, const std::string& msg, ImVec4 col = DS::ACCENT_GREEN) {
+        auto is = [&](ImVec4 c) { return col.x == c.x && col.y == c.y && col.z == c.z; };
+        const Events::Level level = is(DS::ACCENT_RED)    ? Events::Level::Error
+                                  : is(DS::ACCENT_ORANGE) ? Events::Level::Warning
+                                  : is(DS::ACCENT_GREEN)  ? Events::Level::Success
+                                                          : Events::Level::Info;
+        notify.Post(src, level, msg, DS::Col(col));
+        g_pacer.Wake();             // may come from a worker while the loop sleeps
     }
 } g_app;
 
+#if !XOPT_UI_HEADLESS
 // DirectX state
 static ID3D11Device*           g_pd3dDevice           = nullptr;
 static ID3D11DeviceContext*    g_pd3dDeviceContext     = nullptr;
 static IDXGISwapChain*         g_pSwapChain            = nullptr;
 static ID3D11RenderTargetView* g_mainRenderTargetView  = nullptr;
+#endif
+
+// Timer / thread wake latency sampler behind the Boost panel's latency card
+static Latency::Monitor g_latency;
+
+// CPU / memory / disk / network history for the Stats panel; runs from start
+// so the sparklines are full when the tab is opened
+static Telemetry::Sampler g_telemetry;
+
+// How long this start took, for the profiler card and --bench-startup
+struct StartupTimes {
+    double      firstFrameMs = 0.0;     // process creation → first Present
+    double      fontMs       = 0.0;     // atlas ready, baked or mapped
+    const char* fontCache    = "off";   // "hit", "miss" (baked and saved), "off"
+};
+static StartupTimes g_startup;
 
 // ──────────────────────────────────────────────────────────────────────────────
 //  OPTIMISATION FUNCTIONS  (actual Windows API work)
 // ──────────────────────────────────────────────────────────────────────────────
 namespace Opt {
 
-    static void RunCmd(const std::wstring& cmd, bool hidden = true) {
-        STARTUPINFOW si{};
-        PROCESS_INFORMATION pi{};
-        si.cb = sizeof(si);
-        if (hidden) { si.dwFlags |= STARTF_USESHOWWINDOW; si.wShowWindow = SW_HIDE; }
-        std::wstring mutable_cmd = cmd;
-        CreateProcessW(nullptr, mutable_cmd.data(), nullptr, nullptr, FALSE,
-                       CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi);
-        WaitForSingleObject(pi.hProcess, 5000);
-        CloseHandle(pi.hProcess); CloseHandle(pi.hThread);
+    using Tweaks::Id;
+
+    // Every toggle and profile switch is a transaction in the profile store:
+    // a failure leaves nothing half-applied, a restart shows what's applied
+    static Tweaks::ProfileStore& Store() {
+        static Tweaks::ProfileStore store(Tweaks::DefaultStorePath(Sys::Native()));
+        return store;
+    }
+
+    // Transactions run on the boost scheduler's pool; the UI thread only
+    // queues them and collects outcomes in Update(), so a slow helper
+    // (netsh, sc) never stalls a frame
+    static Tweaks::Switcher& Switcher() {
+        static Tweaks::Switcher sw(Store(), Sys::Native());
+        static const bool hooked = (sw.SetWakeHook([](void*) { g_pacer.Wake(); }, nullptr), true);
+        (void)hooked;
+        return sw;
+    }
+
+    // What to say when a queued transaction finishes
+    struct PendingTx { std::string okMsg; ImVec4 okCol; std::string failMsg; };
+    static std::map<uint64_t, PendingTx> s_pendingTx;
+    static bool s_resync = false;      // re-read the toggles once the queue drains
+
+    static void SyncToggles() {
+        const Tweaks::TweakState st = Store().Current(Sys::Native());
+        auto on = [&st](Id id) { return st.Has(id) && st.On(id); };
+        g_app.highPerfPower  = on(Id::HighPerfPower);
+        g_app.hpetOn         = on(Id::TimerRes);
+        g_app.cpuBoost       = on(Id::CpuPriority);
+        g_app.networkOpt     = on(Id::Network);
+        g_app.explorerKilled = on(Id::KillExplorer);
+        g_app.superfetchOff  = on(Id::SuperfetchOff);
+        g_app.animsDisabled  = on(Id::AnimationsOff);
+        g_app.gameModeOn     = on(Id::GameMode);
+        g_app.gameBarOff     = on(Id::GameBarOff);
+    }
+
+    // Load the store, undo a switch a crash interrupted, restore the toggles
+    static void LoadProfiles() {
+        Tweaks::ProfileStore::TxResult rec;
+        Store().Open(Sys::Native(), &rec);
+        if (rec.rolledBack)
+            g_app.PushNotif(Events::Source::Boost,
+                            rec.ok ? "Interrupted profile switch rolled back"
+                                   : "Interrupted profile switch: " + rec.error,
+                            rec.ok ? DS::ACCENT_ORANGE : DS::ACCENT_RED);
+        SyncToggles();
+    }
+
+    static uint64_t QueueSwitch(const std::string& name) {
+        const uint64_t t = Switcher().Switch(name);
+        if (!t) return 0;
+        s_pendingTx[t] = { "Profile \"" + name + "\" applied", DS::ACCENT_GREEN,
+                           "Profile \"" + name + "\" rolled back — " };
+        s_resync = true;
+        return t;
+    }
+
+    // The score ring shows the last bench-suite run, not a tally of toggles.
+    // With s_bracket on, a profile switch is bracketed by runs ("before:NAME",
+    // "after:NAME") so the card shows what the switch bought.  A run takes
+    // about a second on its own thread and lands in the history next to the
+    // profile store; the switch waits for the "before" run, so bracketing is
+    // opt-in and a plain switch starts at once.
+    struct Measurement {
+        std::thread       worker;
+        std::atomic<bool> done{ false };
+        Bench::Result     out;
+        std::string       label;
+        std::string       profile;          // bracketing a switch to this profile
+        uint64_t          ticket = 0;       // that switch, once queued
+        bool              hasScore = false, hasDelta = false;
+        Bench::Result     score, before;
+    };
+    static Measurement s_measure;
+    static bool        s_bracket = false;
+
+    static Bench::History& BenchHistory() {
+        static Bench::History hist(Bench::DefaultHistoryPath(Sys::Native()));
+        return hist;
+    }
+
+    static bool Measuring() { return s_measure.worker.joinable(); }
+    static void WaitMeasure() { if (Measuring()) s_measure.worker.join(); }   // at exit
+
+    static void StartMeasure(std::string label) {
+        if (Measuring()) return;
+        s_measure.label = std::move(label);
+        s_measure.done  = false;
+        s_measure.worker = std::thread([] {
+            Prof::SetThreadName("measure");
+            s_measure.out = Bench::Run(BenchHistory().File().parent_path() / "bench-scratch", s_measure.label);
+            s_measure.done = true;
+            g_pacer.Wake();
+        });
+    }
+
+    // Last saved run, so the ring has a real number from the first frame
+    static void LoadScore() {
+        BenchHistory().Load();
+        if (const Bench::Result* r = BenchHistory().Last()) {
+            s_measure.score    = *r;
+            s_measure.hasScore = true;
+        }
+    }
+
+    static void SwitchProfile(const std::string& name) {
+        if (!s_bracket || Measuring()) { QueueSwitch(name); return; }  // no bracket while one runs
+        s_measure.profile  = name;
+        s_measure.hasDelta = false;
+        StartMeasure("before:" + name);
+    }
+
+    // A finished run: keep it, compare it with the last one under the same
+    // label, and move a bracketed switch on to its next phase
+    static void CollectMeasure() {
+        XOPT_ZONE("Opt::CollectMeasure");
+        if (!Measuring() || !s_measure.done) return;
+        s_measure.worker.join();
+        const Bench::Result r = s_measure.out;
+        const Bench::Result* prev = BenchHistory().Last(r.label);
+        const std::vector<Bench::Metric> worse = prev ? Bench::Regressions(*prev, r) : std::vector<Bench::Metric>{};
+        if (!BenchHistory().Append(r))
+            g_app.PushNotif(Events::Source::Bench, "Couldn't save the benchmark history", DS::ACCENT_RED);
+        for (Bench::Metric m : worse)
+            g_app.PushNotif(Events::Source::Bench,
+                            std::string(Bench::Describe(m).label) + " regressed since the last run",
+                            DS::ACCENT_ORANGE);
+        s_measure.score    = r;
+        s_measure.hasScore = true;
+
+        if (r.label.rfind("before:", 0) == 0) {
+            s_measure.before = r;
+            s_measure.ticket = QueueSwitch(s_measure.profile);
+        } else if (r.label.rfind("after:", 0) == 0) {
+            s_measure.hasDelta = true;
+            const int d = (int)std::lround(r.score - s_measure.before.score);
+            g_app.PushNotif(Events::Source::Bench,
+                            "Profile \"" + s_measure.profile + "\": score " + (d >= 0 ? "+" : "")
+                            + std::to_string(d) + " measured",
+                            d >= 0 ? DS::ACCENT_GREEN : DS::ACCENT_ORANGE);
+        }
+    }
+
+    static void SaveProfile(const std::string& name) {
+        if (Store().Put(Store().Capture(Sys::Native(), name)) && Store().Save())
+            g_app.PushNotif(Events::Source::Boost, "Saved profile \"" + name + "\"");
+        else
+            g_app.PushNotif(Events::Source::Boost, "Couldn't save profile \"" + name + "\"", DS::ACCENT_RED);
+    }
+
+    // A single toggle is a one-step transaction.  The toggle has already
+    // flipped; if the transaction fails the UI snaps back in Update()
+    static void ApplyTweak(Id id, bool on, std::string okMsg, ImVec4 okCol = DS::ACCENT_GREEN) {
+        const uint64_t t = Switcher().Apply(Tweaks::Profile{ "", "", { { id, on } } });
+        s_pendingTx[t] = { std::move(okMsg), okCol,
+                           std::string(Tweaks::Describe(id).label) + " failed — nothing changed: " };
+    }
+
+    // Once per frame: commit / roll back finished transactions, report them
+    static void Update() {
+        std::vector<Tweaks::Switcher::Outcome> done;
+        Switcher().Update(done);
+        for (const auto& o : done) {
+            if (s_measure.ticket && o.ticket == s_measure.ticket) {
+                s_measure.ticket = 0;
+                if (o.tx.ok) StartMeasure("after:" + s_measure.profile);
+            }
+            auto it = s_pendingTx.find(o.ticket);
+            if (it == s_pendingTx.end()) continue;
+            if (o.tx.ok) {
+                g_app.PushNotif(Events::Source::Boost, it->second.okMsg, it->second.okCol);
+                for (const Tweaks::StepResult& s : o.tx.steps)
+                    if (s.slow)
+                        g_app.PushNotif(Events::Source::Boost, std::string(Tweaks::Describe(s.id).label) +
+                                        " applied, but took " + std::to_string((int)s.ms) + " ms", DS::ACCENT_ORANGE);
+            } else {
+                g_app.PushNotif(Events::Source::Boost, it->second.failMsg + o.tx.error, DS::ACCENT_RED);
+                s_resync = true;
+            }
+            s_pendingTx.erase(it);
+        }
+        // Other toggles may still be in flight; read the state back once
+        // nothing is, so an unrelated optimistic flip isn't undone
+        if (s_resync && !Switcher().Busy()) { SyncToggles(); s_resync = false; }
+        CollectMeasure();
     }
 
     static void KillExplorer() {
-        RunCmd(L"cmd /c taskkill /f /im explorer.exe");
         g_app.explorerKilled = true;
-        g_app.PushNotif("Explorer killed — taskbar hidden", DS::ACCENT_ORANGE);
+        ApplyTweak(Id::KillExplorer, true, "Explorer killed — taskbar hidden", DS::ACCENT_ORANGE);
     }
     static void RestartExplorer() {
-        ShellExecuteW(nullptr, L"open", L"explorer.exe", nullptr, nullptr, SW_SHOW);
         g_app.explorerKilled = false;
-        g_app.PushNotif("Explorer restarted", DS::ACCENT_GREEN);
-    }
-    static void ToggleExplorer() {
-        g_app.explorerKilled ? RestartExplorer() : KillExplorer();
+        ApplyTweak(Id::KillExplorer, false, "Explorer restarted");
     }
 
     static void SetHighPerformancePower(bool on) {
-        // High Performance GUID: 8c5e7fda-e8bf-4a96-9a85-a6e23a8c635c
-        if (on) RunCmd(L"cmd /c powercfg /setactive 8c5e7fda-e8bf-4a96-9a85-a6e23a8c635c");
-        else    RunCmd(L"cmd /c powercfg /setactive 381b4222-f694-41f0-9685-ff5bb260df2e");
-        g_app.PushNotif(on ? "High Performance power plan activated"
-                           : "Balanced power plan restored");
+        ApplyTweak(Id::HighPerfPower, on, on ? "High Performance power plan activated"
+                                             : "Balanced power plan restored");
     }
 
     static void SetWindowsAnimations(bool on) {
-        ANIMATIONINFO ai{ sizeof(ANIMATIONINFO), on ? 1 : 0 };
-        SystemParametersInfoW(SPI_SETANIMATION, sizeof(ANIMATIONINFO), &ai, SPIF_UPDATEINIFILE);
-        SystemParametersInfoW(SPI_SETLISTBOXSMOOTHSCROLLING, 0, (PVOID)(UINT_PTR)on, SPIF_SENDCHANGE);
-        SystemParametersInfoW(SPI_SETMENUANIMATION,   0, (PVOID)(UINT_PTR)on, SPIF_SENDCHANGE);
-        SystemParametersInfoW(SPI_SETSELECTIONFADE,   0, (PVOID)(UINT_PTR)on, SPIF_SENDCHANGE);
-        SystemParametersInfoW(SPI_SETTOOLTIPANIMATION,0, (PVOID)(UINT_PTR)on, SPIF_SENDCHANGE);
-        g_app.PushNotif(on ? "Windows animations re-enabled"
-                           : "Windows animations disabled — less CPU waste");
+        ApplyTweak(Id::AnimationsOff, !on, on ? "Windows animations re-enabled"
+                                              : "Windows animations disabled — less CPU waste");
     }
 
     static void SetGameMode(bool on) {
-        HKEY hk;
-        if (RegOpenKeyExW(HKEY_CURRENT_USER,
-            L"SOFTWARE\\Microsoft\\GameBar", 0, KEY_SET_VALUE, &hk) == ERROR_SUCCESS) {
-            DWORD v = on ? 1 : 0;
-            RegSetValueExW(hk, L"AutoGameModeEnabled", 0, REG_DWORD, (BYTE*)&v, sizeof(v));
-            RegCloseKey(hk);
-        }
-        g_app.PushNotif(on ? "Windows Game Mode enabled" : "Windows Game Mode disabled");
+        ApplyTweak(Id::GameMode, on, on ? "Windows Game Mode enabled" : "Windows Game Mode disabled");
     }
 
     static void SetGameBar(bool on) {
-        HKEY hk;
-        if (RegOpenKeyExW(HKEY_CURRENT_USER,
-            L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\GameDVR",
-            0, KEY_SET_VALUE, &hk) == ERROR_SUCCESS) {
-            DWORD v = on ? 1 : 0;
-            RegSetValueExW(hk, L"AppCaptureEnabled", 0, REG_DWORD, (BYTE*)&v, sizeof(v));
-            RegCloseKey(hk);
-        }
         g_app.gameBarOff = !on;
-        g_app.PushNotif(on ? "Game Bar enabled" : "Game Bar / DVR disabled — reclaims RAM");
+        ApplyTweak(Id::GameBarOff, !on, on ? "Game Bar enabled" : "Game Bar / DVR disabled — reclaims RAM");
     }
 
     static void SetHPET(bool on) {
-        if (on) {
-            timeBeginPeriod(1);
-            RunCmd(L"cmd /c bcdedit /set useplatformtick yes");
-        } else {
-            timeEndPeriod(1);
-            RunCmd(L"cmd /c bcdedit /deletevalue useplatformtick");
-        }
-        g_app.PushNotif(on ? "Timer resolution set to 1ms — input lag ↓" : "Timer resolution restored");
+        ApplyTweak(Id::TimerRes, on, on ? "Timer resolution set to 1ms — input lag ↓" : "Timer resolution restored");
+    }
+
+    static void SetCpuPriority(bool on) {
+        ApplyTweak(Id::CpuPriority, on, on ? "CPU priority separation maximised" : "CPU priority restored");
     }
 
     static void SetSuperfetch(bool disable) {
-        if (disable) RunCmd(L"cmd /c sc stop SysMain & sc config SysMain start=disabled");
-        else         RunCmd(L"cmd /c sc config SysMain start=auto & sc start SysMain");
-        g_app.PushNotif(disable ? "SuperFetch/SysMain stopped — RAM freed"
-                                : "SuperFetch/SysMain re-enabled");
+        ApplyTweak(Id::SuperfetchOff, disable, disable ? "SuperFetch/SysMain stopped — RAM freed"
+                                                       : "SuperFetch/SysMain re-enabled");
     }
 
     static void SetNetworkOpt(bool on) {
-        if (on) {
-            // Disable Nagle algorithm, set TCP ACK frequency
-            RunCmd(L"cmd /c netsh int tcp set global autotuninglevel=disabled");
-            RunCmd(L"cmd /c netsh int tcp set global chimney=disabled");
-            HKEY hk;
-            if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-                L"SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters\\Interfaces",
-                0, KEY_ENUMERATE_SUB_KEYS, &hk) == ERROR_SUCCESS) {
-                // Iterate subkeys and set TcpAckFrequency
-                WCHAR name[256]; DWORD i = 0, len = 256;
-                while (RegEnumKeyExW(hk, i++, name, &len, 0,0,0,0) == ERROR_SUCCESS) {
-                    HKEY hSub;
-                    std::wstring path = std::wstring(L"SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters\\Interfaces\\") + name;
-                    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, path.c_str(), 0, KEY_SET_VALUE, &hSub) == ERROR_SUCCESS) {
-                        DWORD v1 = 1, v2 = 1;
-                        RegSetValueExW(hSub, L"TcpAckFrequency",  0, REG_DWORD, (BYTE*)&v1, 4);
-                        RegSetValueExW(hSub, L"TCPNoDelay",        0, REG_DWORD, (BYTE*)&v2, 4);
-                        RegCloseKey(hSub);
+        ApplyTweak(Id::Network, on, on ? "Network optimised — Nagle off, ACK=1" : "Network settings restored");
+    }
+
+    static std::string HumanBytes(uint64_t b) {
+        const char* units[] = { "B", "KB", "MB", "GB", "TB" };
+        double v = (double)b; int u = 0;
+        while (v >= 1024.0 && u < 4) { v /= 1024.0; ++u; }
+        char buf[32];
+        snprintf(buf, sizeof(buf), u ? "%.1f %s" : "%.0f %s", v, units[u]);
+        return buf;
+    }
+
+    // The launched game is governed until it exits: its process tree pinned
+    // to the fast cores at HIGH priority, background hogs moved off them, all
+    // of it undone when the game closes.  The watcher polls once a second on
+    // its own thread; the panel reads the counters.
+    struct Governing {
+        std::thread           worker;
+        std::atomic<bool>     stop{ false };
+        std::atomic<unsigned> gameProcs{ 0 }, moved{ 0 };
+        std::atomic<uint32_t> pid{ 0 };     // the game's root while governed
+        Affinity::Plan        plan;         // written before the worker starts
+    };
+    static Governing s_govern;
+
+    static bool Governed() { return s_govern.worker.joinable() && s_govern.gameProcs > 0; }
+
+    static void StopGovernor() {            // restores, via the worker
+        if (!s_govern.worker.joinable()) return;
+        s_govern.stop = true;
+        s_govern.worker.join();
+    }
+
+    // False if the governor couldn't attach; the game runs ungoverned
+    static bool StartGovernor(uint32_t pid) {
+        StopGovernor();
+        s_govern.plan = Affinity::Plan{};
+        Affinity::Options opt;
+        opt.gameNice = -10;                 // HIGH_PRIORITY_CLASS, as launches always had
+        auto gov = std::make_shared<Affinity::Governor>(Sys::Native(), opt);
+        std::string err;
+        if (!gov->Attach(pid, &err)) {
+            g_app.PushNotif(Events::Source::Governor, "Core governor off: " + err, DS::ACCENT_ORANGE);
+            return false;
+        }
+        s_govern.plan      = gov->GetPlan();
+        s_govern.stop      = false;
+        s_govern.gameProcs = gov->GetStats().gameProcs;
+        s_govern.moved     = gov->GetStats().moved;
+        s_govern.pid       = pid;
+        s_govern.worker = std::thread([gov] {
+            Prof::SetThreadName("governor");
+            for (unsigned tick = 1; !s_govern.stop; tick++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (tick % 10) continue;
+                if (!gov->Poll()) break;
+                s_govern.gameProcs = gov->GetStats().gameProcs;
+                s_govern.moved     = gov->GetStats().moved;
+            }
+            gov->Restore();
+            const unsigned n = gov->GetStats().restored;
+            s_govern.gameProcs = s_govern.moved = 0;
+            s_govern.pid       = 0;
+            if (!s_govern.stop)
+                g_app.PushNotif(Events::Source::Governor, "Game exited — " + std::to_string(n) + " processes restored");
+        });
+        return true;
+    }
+
+    // The reclaimer polls every 2 s from start, so it knows what has been
+    // idle by the time memory runs short.  With auto off it only acts on
+    // Trim now.  The governed game's tree is always off limits.
+    struct Reclaiming {
+        std::thread           worker;
+        std::atomic<bool>     stop{ false }, autoOn{ false }, force{ false };
+        std::mutex            mx;           // guards the two below
+        Reclaim::Report       last;
+        uint64_t              total = 0;
+    };
+    static Reclaiming s_reclaim;
+
+    static void StartReclaimer() {
+        s_reclaim.worker = std::thread([] {
+            Prof::SetThreadName("reclaimer");
+            Reclaim::Reclaimer rec(Sys::Native());
+            const Reclaim::Options defaults = rec.GetOptions();
+            Reclaim::Report r;
+            for (unsigned tick = 0; !s_reclaim.stop; tick++) {
+                const bool force = s_reclaim.force.exchange(false);
+                if (force || tick % 20 == 0) {
+                    Reclaim::Options o = defaults;
+                    if (!s_reclaim.autoOn) o.lowPct = 0.0;
+                    rec.SetOptions(o);
+                    rec.Protect(s_govern.pid);
+                    if (rec.Poll(r, force) && r.triggered) {
+                        {
+                            std::lock_guard<std::mutex> lk(s_reclaim.mx);
+                            s_reclaim.last   = r;
+                            s_reclaim.total += r.reclaimed;
+                        }
+                        if (!r.actions.empty())
+                            g_app.PushNotif(Events::Source::Reclaim,
+                                            "Reclaimed " + HumanBytes(r.reclaimed) + " from "
+                                            + std::to_string(r.actions.size()) + " background processes");
+                        else if (force)
+                            g_app.PushNotif(Events::Source::Reclaim, "Nothing idle to trim", DS::ACCENT_ORANGE);
+                        g_pacer.Wake();
                     }
-                    len = 256;
                 }
-                RegCloseKey(hk);
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
-        }
-        g_app.PushNotif(on ? "Network optimised — Nagle off, ACK=1" : "Network settings restored");
+        });
+    }
+
+    static void StopReclaimer() {
+        if (!s_reclaim.worker.joinable()) return;
+        s_reclaim.stop = true;
+        s_reclaim.worker.join();
     }
 
     static void LaunchGameWithPriority(const std::string& path) {
-        if (path.empty()) { g_app.PushNotif("No game path set!", DS::ACCENT_RED); return; }
+        XOPT_ZONE("Opt::LaunchGame");
+        if (path.empty()) { g_app.PushNotif(Events::Source::Launch, "No game path set!", DS::ACCENT_RED); return; }
         std::wstring wpath(path.begin(), path.end());
         STARTUPINFOW si{}; PROCESS_INFORMATION pi{};
         si.cb = sizeof(si);
         if (CreateProcessW(wpath.c_str(), nullptr, nullptr, nullptr, FALSE,
                            HIGH_PRIORITY_CLASS, nullptr, nullptr, &si, &pi)) {
-            SetPriorityClass(pi.hProcess, HIGH_PRIORITY_CLASS);
+            const bool high = SetPriorityClass(pi.hProcess, HIGH_PRIORITY_CLASS) ||
+                              GetPriorityClass(pi.hProcess) == HIGH_PRIORITY_CLASS;
             SetThreadPriority(pi.hThread, THREAD_PRIORITY_HIGHEST);
             CloseHandle(pi.hProcess); CloseHandle(pi.hThread);
-            g_app.launchStatus = "Launched with HIGH priority!";
-            g_app.PushNotif("Game launched with HIGH priority class", DS::ACCENT_GREEN);
+            const bool governed = StartGovernor(pi.dwProcessId);   // pins it to the fast cores
+            if (governed && s_govern.plan.partitioned) {
+                g_app.launchStatus = "Launched — " + std::to_string(s_govern.plan.gameCores) + " cores reserved, HIGH priority";
+                g_app.PushNotif(Events::Source::Launch,
+                                "Game pinned to " + std::to_string(s_govern.plan.gameCores) + " cores, background on "
+                                + std::to_string(s_govern.plan.backgroundCores), DS::ACCENT_GREEN);
+            } else if (high) {
+                g_app.launchStatus = "Launched with HIGH priority!";
+                g_app.PushNotif(Events::Source::Launch, "Game launched with HIGH priority class", DS::ACCENT_GREEN);
+            } else {
+                g_app.launchStatus = "Launched at normal priority";
+                g_app.PushNotif(Events::Source::Launch, "Game launched, but HIGH priority was refused", DS::ACCENT_ORANGE);
+            }
         } else {
             g_app.launchStatus = "Launch failed — check path";
-            g_app.PushNotif("Launch failed! Check the path.", DS::ACCENT_RED);
+            g_app.PushNotif(Events::Source::Launch, "Launch failed! Check the path.", DS::ACCENT_RED);
         }
     }
 
-    static size_t DeleteTempFolder(const fs::path& dir) {
-        size_t count = 0;
-        std::error_code ec;
-        for (auto& entry : fs::directory_iterator(dir, ec)) {
-            fs::remove_all(entry.path(), ec);
-            if (!ec) ++count;
+
+    // A clean root as the log names it: the backend's path, no trailing slash
+    static std::string RootLabel(const fs::path& p) {
+        std::string s = p.u8string();
+        while (s.size() > 3 && (s.back() == '\\' || s.back() == '/')) s.pop_back();
+        return s;
+    }
+
+    // Dry run: index every candidate, report what a clean would reclaim
+    static void ScanTempFiles(std::function<void(std::string)> log) {
+        XOPT_ZONE("Opt::ScanTempFiles");
+        g_app.cleanRunning = true;
+        g_app.cleanScanned = false;
+        Cleaner::Options opt;
+        opt.progress      = &g_app.cleanProgress;
+        opt.minAgeSeconds = Sys::Native().CleanMinAge();
+        g_app.cleanIndex   = Cleaner::Scan(Sys::Native().CleanRoots(), opt);
+
+        const auto& roots = g_app.cleanIndex.Roots();
+        for (size_t i = 0; i < roots.size(); i++) {
+            char line[160];
+            snprintf(line, sizeof(line), "  %s: %llu files, %s reclaimable (%llu locked)",
+                     RootLabel(roots[i].path).c_str(), (unsigned long long)roots[i].files,
+                     HumanBytes(roots[i].bytes).c_str(), (unsigned long long)roots[i].lockedFiles);
+            log(line);
         }
-        return count;
+        char tail[160];
+        snprintf(tail, sizeof(tail), "\n  Scan: %s reclaimable  |  %.2fs  |  index %s",
+                 HumanBytes(g_app.cleanIndex.ReclaimableBytes()).c_str(),
+                 g_app.cleanIndex.ScanSeconds(),
+                 HumanBytes(g_app.cleanIndex.MemoryBytes()).c_str());
+        log(tail);
+        g_app.cleanScanned = true;
+        g_app.cleanRunning = false;
     }
 
+    // Commits the dry-run index if there is one, otherwise scans first —
+    // either way each tree is walked exactly once.  Without a dry run the
+    // scan is incremental: folders unchanged since the last clean are skipped.
     static void CleanTempFiles(std::function<void(std::string)> log) {
+        XOPT_ZONE("Opt::CleanTempFiles");
         g_app.cleanRunning = true;
-        size_t total = 0;
-
-        // %TEMP%
-        wchar_t tmp[MAX_PATH];
-        if (GetTempPathW(MAX_PATH, tmp)) {
-            size_t n = DeleteTempFolder(fs::path(tmp));
-            total += n; g_app.cleanTempDone = true;
-            log("  %TEMP%: removed " + std::to_string(n) + " items");
+        Cleaner::Options opt;
+        opt.progress      = &g_app.cleanProgress;
+        opt.minAgeSeconds = Sys::Native().CleanMinAge();
+        Cleaner::Journal journal;
+        if (!g_app.cleanScanned) {
+            journal.Load(Sys::Native().JournalPath());
+            g_app.cleanIndex = Cleaner::Scan(Sys::Native().CleanRoots(), opt, &journal);
+        }
+        g_app.cleanScanned = false;
+        uint64_t unchanged = 0;
+        std::vector<std::string> labels;    // Commit clears the index
+        for (auto& r : g_app.cleanIndex.Roots()) {
+            unchanged += r.cleanDirs;
+            labels.push_back(RootLabel(r.path));
+        }
+        auto res = Cleaner::Commit(g_app.cleanIndex, opt, &journal);
+        journal.Save(Sys::Native().JournalPath());
+
+        bool* done[] = { &g_app.cleanTempDone, &g_app.cleanWinTempDone, &g_app.cleanPrefetchDone };
+        uint64_t total = 0, bytes = 0;
+        for (size_t i = 0; i < res.size() && i < labels.size(); i++) {
+            total += res[i].Items();
+            bytes += res[i].bytesFreed;
+            if (i < std::size(done)) *done[i] = true;
+            char line[160];
+            snprintf(line, sizeof(line), "  %s: removed %llu files, %llu folders, %s (%llu locked)",
+                     labels[i].c_str(), (unsigned long long)res[i].filesRemoved,
+                     (unsigned long long)res[i].dirsRemoved,
+                     HumanBytes(res[i].bytesFreed).c_str(), (unsigned long long)res[i].errors);
+            log(line);
         }
-        // C:\Windows\Temp
-        size_t n2 = DeleteTempFolder(L"C:\\Windows\\Temp");
-        total += n2; g_app.cleanWinTempDone = true;
-        log("  C:\\Windows\\Temp: removed " + std::to_string(n2) + " items");
 
-        // Prefetch
-        size_t n3 = DeleteTempFolder(L"C:\\Windows\\Prefetch");
-        total += n3; g_app.cleanPrefetchDone = true;
-        log("  Prefetch: removed " + std::to_string(n3) + " items");
+        if (unchanged) log("  " + std::to_string(unchanged) + " unchanged folders skipped");
 
         // DNS
-        RunCmd(L"cmd /c ipconfig /flushdns");
+        Sys::Native().FlushDns();
         g_app.cleanDNSDone = true;
         log("  DNS cache flushed");
 
-        log("\n  Total: " + std::to_string(total) + " items cleared");
-        g_app.PushNotif("Clean complete — " + std::to_string(total) + " items removed");
+        log("\n  Total: " + std::to_string(total) + " items cleared, " + HumanBytes(bytes) + " freed");
+        g_app.PushNotif(Events::Source::Clean, "Clean complete — " + HumanBytes(bytes) + " freed");
         g_app.cleanRunning = false;
     }
 
-    static int  ComputeBoostScore() {
-        int s = 0;
-        if (g_app.explorerKilled) s += 10;
-        if (g_app.highPerfPower)  s += 20;
-        if (g_app.animsDisabled)  s += 8;
-        if (g_app.gameModeOn)     s += 12;
-        if (g_app.superfetchOff)  s += 15;
-        if (g_app.hpetOn)         s += 18;
-        if (g_app.gameBarOff)     s += 10;
-        if (g_app.networkOpt)     s += 7;
-        return s;
-    }
-
 }  // namespace Opt
 
 // ──────────────────────────────────────────────────────────────────────────────
-//  PHONK PLAYER  (Windows MCI)
+//  PHONK PLAYER  (native engine: decoder thread → PCM ring → WASAPI)
 // ──────────────────────────────────────────────────────────────────────────────
 namespace Phonk {
 
-    static bool  s_open = false;
+    // The engine's output thread feeds the analyser; the visualiser reads
+    // lock-free snapshots.  Position / volume are atomics — no per-frame
+    // round-trips to the audio device.  The playlist's worker opens and
+    // pre-decodes the next track so same-format albums play without a gap.
+    static Dsp::SpectrumAnalyzer            s_spectrum;
+    static std::unique_ptr<Audio::Engine>   s_engine;
+    static std::unique_ptr<Audio::Playlist> s_playlist;
+
+    static Audio::Engine& Engine() {
+        if (!s_engine) {
+            s_engine = std::make_unique<Audio::Engine>(Audio::MakeSink("default"));
+            s_engine->SetTap(&s_spectrum);
+        }
+        return *s_engine;
+    }
+
+    static Audio::Playlist& List() {
+        if (!s_playlist) s_playlist = std::make_unique<Audio::Playlist>();
+        return *s_playlist;
+    }
+
+    // Tag title once the worker has read it, the file name until then
+    static void  RefreshTitle() {
+        const int cur = List().Current();
+        if (cur < 0) return;
+        if (const Audio::TrackInfo* ti = List().Info((size_t)cur))
+            g_app.phonkTitle = ti->artist.empty() ? ti->title : ti->artist + " — " + ti->title;
+        else
+            g_app.phonkTitle = List().Path((size_t)cur).stem().string();
+    }
 
-    static void  Open(const std::string& path) {
-        std::string cmd = "open \"" + path + "\" type mpegvideo alias phonk";
-        mciSendStringA(cmd.c_str(), nullptr, 0, nullptr);
-        s_open = true;
-        // Extract filename as title
-        fs::path p(path);
-        g_app.phonkTitle = p.stem().string();
+    // Single file: a one-track playlist, opened but not started
+    static bool  Open(const std::string& path) {
+        std::string err;
+        List().SetTracks({ fs::path(path) });
+        if (!List().Open(Engine(), 0, &err)) {
+            g_app.PushNotif(Events::Source::Audio, "Can't play track: " + err, DS::ACCENT_RED);
+            return false;
+        }
+        Engine().SetVolume(g_app.phonkVolume / 100.0f);
         g_app.phonkLoaded = true;
+        RefreshTitle();
+        return true;
+    }
+
+    static void  OpenFolder(const std::string& dir) {
+        Engine().SetVolume(g_app.phonkVolume / 100.0f);
+        Engine().SetLoop(g_app.phonkLoop);
+        List().LoadFolder(fs::path(dir));
+        g_app.phonkTitle = "Scanning folder...";
     }
 
     static void  Play() {
-        if (!s_open) return;
-        std::string cmd = g_app.phonkLoop
-            ? "play phonk repeat"
-            : "play phonk";
-        mciSendStringA(cmd.c_str(), nullptr, 0, nullptr);
+        if (!Engine().IsOpen()) return;
+        Engine().SetLoop(g_app.phonkLoop);
+        Engine().Play();
         g_app.phonkPlaying = true;
     }
 
     static void  Pause() {
-        mciSendStringA("pause phonk", nullptr, 0, nullptr);
+        Engine().Pause();
         g_app.phonkPlaying = false;
     }
 
     static void  Stop() {
-        mciSendStringA("stop phonk",  nullptr, 0, nullptr);
-        mciSendStringA("close phonk", nullptr, 0, nullptr);
+        if (s_engine) s_engine->Close();
         g_app.phonkPlaying = false;
-        s_open = false;
     }
 
-    static void  SetVolume(float vol) {
-        // MCI volume 0-1000
-        int v = (int)(vol / 100.0f * 1000.0f);
-        std::string cmd = "setaudio phonk volume to " + std::to_string(v);
-        mciSendStringA(cmd.c_str(), nullptr, 0, nullptr);
+    static void  Jump(size_t i) {
+        std::string err;
+        if (!List().Play(Engine(), i, &err)) {
+            g_app.PushNotif(Events::Source::Audio, "Can't play track: " + err, DS::ACCENT_RED);
+            return;
+        }
+        g_app.phonkLoaded  = true;
+        g_app.phonkPlaying = true;
+        RefreshTitle();
+    }
+
+    static void  Next() {
+        if (List().Current() + 1 < (int)List().Size()) Jump((size_t)List().Current() + 1);
+        else g_app.PushNotif(Events::Source::Audio, "End of playlist", DS::TEXT_SECONDARY);
     }
 
-    static float GetProgress() {
-        char pos[64] = {}, len[64] = {};
-        mciSendStringA("status phonk position", pos, sizeof(pos), nullptr);
-        mciSendStringA("status phonk length",   len, sizeof(len), nullptr);
-        long p = atol(pos), l = atol(len);
-        return (l > 0) ? (float)p / (float)l : 0.0f;
+    static void  Prev() {
+        std::string err;
+        if (!List().Prev(Engine(), &err) && !err.empty())
+            g_app.PushNotif(Events::Source::Audio, "Can't play track: " + err, DS::ACCENT_RED);
+        g_app.phonkPlaying = Engine().Playing();
+        RefreshTitle();
     }
 
+    static void  SetVolume(float vol) { Engine().SetVolume(vol / 100.0f); }
+    static void  SetLoop(bool on)     { Engine().SetLoop(on); }
+    static void  Seek(float frac)     { Engine().Seek(frac * Engine().Duration()); }
+
+    // Every frame, whichever tab is open: follows gapless switches, queues
+    // the prefetched successor and pauses at the end of the list
+    static void  Update() {
+        if (!s_engine || !s_playlist) return;
+        const int before = s_playlist->Current();
+        s_playlist->Update(*s_engine);
+        if (s_playlist->Current() != before) { g_app.phonkLoaded = true; RefreshTitle(); }
+        g_app.phonkPlaying = s_engine->Playing();
+    }
+
+    static float GetProgress() { return Engine().Progress(); }
+
 }  // namespace Phonk
 
 // ──────────────────────────────────────────────────────────────────────────────
@@ -441,9 +841,48 @@ namespace Phonk {
 // ──────────────────────────────────────────────────────────────────────────────
 namespace Widget {
 
+    // ── Retained geometry ─────────────────────────────────────────────────────
+    // Geo::Retained over an ImDrawList
+    struct DrawListRef {
+        struct Pos { int vtx, idx, cmds; unsigned base; };
+        ImDrawList* dl;
+
+        Pos  Mark() const { return { dl->VtxBuffer.Size, dl->IdxBuffer.Size, dl->CmdBuffer.Size, dl->_VtxCurrentIdx }; }
+        void Drawn(const Pos& m, size_t& vtx, size_t& idx) const {
+            vtx = (size_t)(dl->VtxBuffer.Size - m.vtx);
+            idx = (size_t)(dl->IdxBuffer.Size - m.idx);
+        }
+        bool Take(const Pos& m, float ox, float oy, Geo::Mesh& out) const {
+            const int nv = dl->VtxBuffer.Size - m.vtx, ni = dl->IdxBuffer.Size - m.idx;
+            // Geometry that spilled into a new draw command can't replay as one block
+            if (dl->CmdBuffer.Size != m.cmds || dl->_VtxCurrentIdx != m.base + (unsigned)nv) return false;
+            out.vtx.resize((size_t)nv);
+            out.idx.resize((size_t)ni);
+            for (int i = 0; i < nv; i++) {
+                const ImDrawVert& v = dl->VtxBuffer[m.vtx + i];
+                out.vtx[(size_t)i] = { v.pos.x - ox, v.pos.y - oy, v.uv.x, v.uv.y, v.col };
+            }
+            for (int i = 0; i < ni; i++) out.idx[(size_t)i] = (uint32_t)dl->IdxBuffer[m.idx + i] - m.base;
+            return true;
+        }
+        void Replay(const Geo::Mesh& m, float ox, float oy) {
+            dl->PrimReserve((int)m.idx.size(), (int)m.vtx.size());
+            const unsigned base = dl->_VtxCurrentIdx;
+            for (uint32_t i : m.idx) dl->PrimWriteIdx((ImDrawIdx)(base + i));
+            for (const Geo::Vertex& v : m.vtx) dl->PrimWriteVtx({ox + v.x, oy + v.y}, {v.u, v.v}, v.col);
+        }
+    };
+
+    template <class Fn>
+    static void Retained(ImDrawList* dl, uint64_t key, ImVec2 origin, Fn&& draw) {
+        DrawListRef list{ dl };
+        Geo::Retained(g_geo, list, key, origin.x, origin.y, std::forward<Fn>(draw));
+    }
+
     // ── iOS Toggle Switch ──────────────────────────────────────────────────────
     // Returns true if value changed
     static bool Toggle(const char* id, bool* v, ImVec4 accentColor = DS::ACCENT_BLUE) {
+        XOPT_ZONE("Widget::Toggle");
         ImGuiID wid = ImGui::GetID(id);
         float t = SmoothAnimate(wid, *v ? 1.0f : 0.0f, 16.0f);
 
@@ -464,25 +903,29 @@ namespace Widget {
         float  alpha   = hovered ? 0.9f : 1.0f;
         ImU32  trackUi = DS::ColA(trackC, alpha);
 
-        dl->AddRectFilled(pos, ImVec2(pos.x+W, pos.y+H), trackUi, R);
+        Geo::Key key;
+        key.Mix('T').Mix(t, 1.0f / 1024).Mix(DS::Col(accentColor)).Mix(hovered);
+        Retained(dl, key.h, pos, [&] {
+            dl->AddRectFilled(pos, ImVec2(pos.x+W, pos.y+H), trackUi, R);
 
-        // Glow under the track when on
-        if (t > 0.01f) {
-            ImU32 glow = DS::ColA(accentColor, 0.25f * t);
-            dl->AddRectFilled(ImVec2(pos.x-3, pos.y-3),
-                              ImVec2(pos.x+W+3, pos.y+H+3), glow, R+3);
-        }
+            // Glow under the track when on
+            if (t > 0.01f) {
+                ImU32 glow = DS::ColA(accentColor, 0.25f * t);
+                dl->AddRectFilled(ImVec2(pos.x-3, pos.y-3),
+                                  ImVec2(pos.x+W+3, pos.y+H+3), glow, R+3);
+            }
 
-        // Thumb (white circle)
-        float thumbX  = pos.x + PAD + t * (W - H);
-        float thumbCX = thumbX + (H - PAD*2) * 0.5f;
-        float thumbCY = pos.y  + H * 0.5f;
-        float thumbR  = (H - PAD*2) * 0.5f;
-        dl->AddCircleFilled(ImVec2(thumbCX, thumbCY), thumbR,
-                            IM_COL32(255,255,255,255), 32);
-        // Subtle shadow on thumb
-        dl->AddCircle(ImVec2(thumbCX, thumbCY), thumbR+1.0f,
-                      IM_COL32(0,0,0,40), 32, 1.0f);
+            // Thumb (white circle)
+            float thumbX  = pos.x + PAD + t * (W - H);
+            float thumbCX = thumbX + (H - PAD*2) * 0.5f;
+            float thumbCY = pos.y  + H * 0.5f;
+            float thumbR  = (H - PAD*2) * 0.5f;
+            dl->AddCircleFilled(ImVec2(thumbCX, thumbCY), thumbR,
+                                IM_COL32(255,255,255,255), 32);
+            // Subtle shadow on thumb
+            dl->AddCircle(ImVec2(thumbCX, thumbCY), thumbR+1.0f,
+                          IM_COL32(0,0,0,40), 32, 1.0f);
+        });
 
         if (clicked) { *v = !*v; return true; }
         return false;
@@ -491,6 +934,7 @@ namespace Widget {
     // ── Premium Slider (horizontal) ────────────────────────────────────────────
     static bool Slider(const char* id, float* v, float mn, float mx,
                        ImVec4 color = DS::ACCENT_BLUE) {
+        XOPT_ZONE("Widget::Slider");
         ImGuiID wid = ImGui::GetID(id);
         const float W = ImGui::GetContentRegionAvail().x;
         const float H = 6.0f;
@@ -515,33 +959,37 @@ namespace Widget {
         float trackY = pos.y + totalH * 0.5f;
 
         ImDrawList* dl = ImGui::GetWindowDrawList();
-
-        // Track background
-        dl->AddRectFilled(
-            ImVec2(pos.x + THUMB_R, trackY - H*0.5f),
-            ImVec2(pos.x + W - THUMB_R, trackY + H*0.5f),
-            DS::Col(DS::BG_CARD_HIGH), H);
-
-        // Filled portion (gradient feel via two rects)
-        if (tSm > 0.001f) {
-            ImVec2 fillP1 = ImVec2(pos.x + THUMB_R, trackY - H*0.5f);
-            ImVec2 fillP2 = ImVec2(thumbX, trackY + H*0.5f);
-            // gradient: slightly brighter start
-            dl->AddRectFilled(fillP1, fillP2, DS::Col(color), H);
-        }
-
-        // Glow behind thumb
         float glowR = (active || hovered) ? THUMB_R + 8.0f : THUMB_R + 4.0f;
-        dl->AddCircleFilled({thumbX, trackY}, glowR,
-                            DS::ColA(color, (active||hovered) ? 0.35f : 0.20f), 32);
+        float tr = THUMB_R + SmoothAnimate(ImGui::GetID((std::string(id)+"_r").c_str()),
+                                           active ? 2.0f : (hovered ? 1.0f : 0.0f), 20.0f);
+
+        Geo::Key key;
+        key.Mix('S').Mix(W, 0.25f).Mix(thumbX - pos.x, 0.125f).Mix(tr, 1.0f / 64)
+           .Mix(DS::Col(color)).Mix(active || hovered);
+        Retained(dl, key.h, pos, [&] {
+            // Track background
+            dl->AddRectFilled(
+                ImVec2(pos.x + THUMB_R, trackY - H*0.5f),
+                ImVec2(pos.x + W - THUMB_R, trackY + H*0.5f),
+                DS::Col(DS::BG_CARD_HIGH), H);
+
+            // Filled portion (gradient feel via two rects)
+            if (tSm > 0.001f) {
+                ImVec2 fillP1 = ImVec2(pos.x + THUMB_R, trackY - H*0.5f);
+                ImVec2 fillP2 = ImVec2(thumbX, trackY + H*0.5f);
+                // gradient: slightly brighter start
+                dl->AddRectFilled(fillP1, fillP2, DS::Col(color), H);
+            }
+
+            // Glow behind thumb
+            dl->AddCircleFilled({thumbX, trackY}, glowR,
+                                DS::ColA(color, (active||hovered) ? 0.35f : 0.20f), 32);
 
-        // Thumb
-        float tr = (active ? THUMB_R + 2.0f : (hovered ? THUMB_R + 1.0f : THUMB_R));
-        tr = THUMB_R + SmoothAnimate(ImGui::GetID((std::string(id)+"_r").c_str()),
-                                     active ? 2.0f : (hovered ? 1.0f : 0.0f), 20.0f);
-        dl->AddCircleFilled({thumbX, trackY}, tr, IM_COL32(255,255,255,255), 32);
-        // thumb border
-        dl->AddCircle({thumbX, trackY}, tr, DS::ColA(color, 0.6f), 32, 1.5f);
+            // Thumb
+            dl->AddCircleFilled({thumbX, trackY}, tr, IM_COL32(255,255,255,255), 32);
+            // thumb border
+            dl->AddCircle({thumbX, trackY}, tr, DS::ColA(color, 0.6f), 32, 1.5f);
+        });
 
         return active;
     }
@@ -592,6 +1040,7 @@ namespace Widget {
     // ── Boost row with toggle ──────────────────────────────────────────────────
     static bool BoostRow(const char* label, const char* desc,
                          bool* val, ImVec4 accent = DS::ACCENT_BLUE) {
+        XOPT_ZONE("Widget::BoostRow");
         float sy = ImGui::GetCursorPosY();
         ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_PRIMARY);
         ImGui::Text("%s", label);
@@ -618,6 +1067,7 @@ namespace Widget {
 
     // ── Tab bar (iOS-style pill selector) ─────────────────────────────────────
     static void TabBar(const char** tabs, int count, int* active) {
+        XOPT_ZONE("Widget::TabBar");
         ImDrawList* dl  = ImGui::GetWindowDrawList();
         float       W   = ImGui::GetContentRegionAvail().x;
         float       H   = 38.0f;
@@ -658,25 +1108,30 @@ namespace Widget {
 
     // ── Score ring ────────────────────────────────────────────────────────────
     static void ScoreRing(float score, ImVec4 color) {
+        XOPT_ZONE("Widget::ScoreRing");
         ImDrawList* dl = ImGui::GetWindowDrawList();
         ImVec2 c  = ImGui::GetCursorScreenPos();
         float  R  = 44.0f;
         c.x += R; c.y += R;
 
-        dl->AddCircle(c, R, DS::Col(DS::BG_CARD_HIGH), 128, 6.0f);
-        float ang  = (float)(score / 100.0f) * IM_PI * 2.0f;
         float t    = SmoothAnimate(ImGui::GetID("_scoreang"), score/100.0f, 8.0f);
         float endA = -IM_PI/2.0f + t * IM_PI * 2.0f;
-        // Arc
-        int   segs = (int)(t * 128) + 1;
-        for (int i = 0; i < segs-1; i++) {
-            float a0 = -IM_PI/2.0f + (float)i/(float)(segs-1) * t * IM_PI*2.0f;
-            float a1 = -IM_PI/2.0f + (float)(i+1)/(float)(segs-1) * t * IM_PI*2.0f;
-            dl->AddLine(
-                {c.x + cosf(a0)*R, c.y + sinf(a0)*R},
-                {c.x + cosf(a1)*R, c.y + sinf(a1)*R},
-                DS::Col(color), 6.0f);
-        }
+
+        // Track and arc, each one polyline through the trig table
+        Geo::Key key;
+        key.Mix('R').Mix(t, 1.0f / 1024).Mix(DS::Col(color));
+        Retained(dl, key.h, c, [&] {
+            static Geo::Point pts[129];
+            Geo::Arc(c.x, c.y, R, 0.0f, IM_PI * 2.0f, 128, pts);
+            for (int i = 0; i < 128; i++) dl->PathLineTo({pts[i].x, pts[i].y});
+            dl->PathStroke(DS::Col(DS::BG_CARD_HIGH), ImDrawFlags_Closed, 6.0f);
+            int segs = (int)(t * 128) + 1;
+            if (segs > 1) {
+                Geo::Arc(c.x, c.y, R, -IM_PI/2.0f, endA, (unsigned)(segs - 1), pts);
+                for (int i = 0; i < segs; i++) dl->PathLineTo({pts[i].x, pts[i].y});
+                dl->PathStroke(DS::Col(color), 0, 6.0f);
+            }
+        });
         // Center text
         char buf[16]; snprintf(buf, 16, "%d", (int)score);
         ImVec2 ts  = ImGui::CalcTextSize(buf);
@@ -689,31 +1144,73 @@ namespace Widget {
         ImGui::Dummy({R*2+4, R*2+8});
     }
 
+    // ── Sparkline ─────────────────────────────────────────────────────────────
+    // One telemetry ring as a polyline over a faint fill, newest sample on
+    // the right.  `top` fixes the scale (percentages); 0 scales to the peak
+    // in view, which is returned for the caption.
+    static float Sparkline(const char* id, const Telemetry::Ring& r, float top, ImVec4 color,
+                           ImVec2 size, const Telemetry::Ring* second = nullptr, ImVec4 color2 = DS::ACCENT_ORANGE) {
+        XOPT_ZONE("Widget::Sparkline");
+        static float v[Telemetry::kHistory], w[Telemetry::kHistory];
+        const size_t n = r.Read(v, Telemetry::kHistory);
+        const size_t m = second ? second->Read(w, Telemetry::kHistory) : 0;
+        float peak = 0.0f;
+        for (size_t i = 0; i < n; i++) peak = std::max(peak, v[i]);
+        for (size_t i = 0; i < m; i++) peak = std::max(peak, w[i]);
+        const float scale = top > 0.0f ? top : std::max(peak, 1.0f);
+
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+        const ImVec2 p0 = ImGui::GetCursorScreenPos();
+        const ImVec2 p1 = { p0.x + size.x, p0.y + size.y };
+        ImGui::InvisibleButton(id, size);
+        dl->AddRectFilled(p0, p1, DS::Col(DS::BG_CARD), 6.0f);
+
+        const float dx = size.x / (float)(Telemetry::kHistory - 1);
+        auto trace = [&](const float* s, size_t k, ImVec4 c, bool fill) {
+            if (k < 2) return;
+            const float x0 = p1.x - dx * (float)(k - 1);
+            auto y = [&](float val) { return p1.y - 2.0f - std::clamp(val / scale, 0.0f, 1.0f) * (size.y - 4.0f); };
+            if (fill) {
+                for (size_t i = 1; i < k; i++) {
+                    const float xa = x0 + dx * (float)(i - 1), xb = x0 + dx * (float)i;
+                    dl->AddQuadFilled({xa, y(s[i - 1])}, {xb, y(s[i])}, {xb, p1.y}, {xa, p1.y}, DS::ColA(c, 0.12f));
+                }
+            }
+            for (size_t i = 0; i < k; i++) dl->PathLineTo({x0 + dx * (float)i, y(s[i])});
+            dl->PathStroke(DS::Col(c), 0, 1.5f);
+        };
+        trace(v, n, color, true);
+        if (second) trace(w, m, color2, false);
+        return peak;
+    }
+
     // ── Notification toasts ───────────────────────────────────────────────────
+    // The bus decides what is up (coalesced, folded, rate-limited); a label
+    // is measured the first frame it is drawn and after its count changes
     static void RenderNotifs() {
-        float dt = ImGui::GetIO().DeltaTime;
-        std::lock_guard<std::mutex> lk(g_app.notifMtx);
-        float y = ImGui::GetIO().DisplaySize.y - 20.0f;
-        for (auto it = g_app.notifs.rbegin(); it != g_app.notifs.rend(); ++it) {
-            it->timer -= dt;
-            float alpha = std::min(1.0f, it->timer * 2.0f); // fade out last 0.5s
-            if (alpha <= 0) continue;
-            ImVec2 ts = ImGui::CalcTextSize(it->msg.c_str());
-            float W   = ts.x + 28.0f, H = 34.0f;
-            float x   = (ImGui::GetIO().DisplaySize.x - W) * 0.5f;
+        XOPT_ZONE("Widget::RenderNotifs");
+        float dt = std::min(ImGui::GetIO().DeltaTime, 0.1f);
+        if (g_app.notify.Update(dt)) g_pacer.KeepAlive();
+        const ImVec2 disp = ImGui::GetIO().DisplaySize;
+        const float  th   = ImGui::GetFontSize();
+        ImDrawList*  dl   = ImGui::GetForegroundDrawList();
+        float y = disp.y - 20.0f;
+        g_app.notify.ForEachShown([&](Events::Entry& e, float left) {
+            float alpha = std::min(1.0f, left * 2.0f);      // fade out last 0.5s
+            if (e.width < 0.0f) e.width = ImGui::CalcTextSize(e.label.c_str()).x;
+            const ImVec4 col = ImGui::ColorConvertU32ToFloat4(e.color);
+            float W = e.width + 28.0f, H = 34.0f;
+            float x = (disp.x - W) * 0.5f;
             y -= H + 6.0f;
-            ImDrawList* dl = ImGui::GetForegroundDrawList();
             dl->AddRectFilled({x, y}, {x+W, y+H},
                 DS::ColA(DS::BG_CARD, alpha * 0.95f), 10.0f);
             dl->AddRect({x, y}, {x+W, y+H},
-                DS::ColA(it->col, alpha * 0.6f), 10.0f, 0, 1.5f);
+                DS::ColA(col, alpha * 0.6f), 10.0f, 0, 1.5f);
             dl->AddRectFilled({x, y}, {x+4, y+H},
-                DS::ColA(it->col, alpha), 3.0f);
-            dl->AddText({x+12, y+(H-ts.y)*0.5f},
-                DS::ColA(DS::TEXT_PRIMARY, alpha), it->msg.c_str());
-        }
-        g_app.notifs.erase(std::remove_if(g_app.notifs.begin(), g_app.notifs.end(),
-            [](auto& n){ return n.timer <= 0; }), g_app.notifs.end());
+                DS::ColA(col, alpha), 3.0f);
+            dl->AddText({x+12, y+(H-th)*0.5f},
+                DS::ColA(DS::TEXT_PRIMARY, alpha), e.label.c_str());
+        });
     }
 
 }  // namespace Widget
@@ -722,9 +1219,11 @@ namespace Widget {
 //  UI PANELS
 // ──────────────────────────────────────────────────────────────────────────────
 static void RenderBoostPanel() {
+    XOPT_ZONE("RenderBoostPanel");
     // Score header row
     {
-        float sc = (float)Opt::ComputeBoostScore();
+        const bool measured = Opt::s_measure.hasScore;
+        float sc = measured ? Opt::s_measure.score.score : 0.0f;
         g_app.boostScore = (int)sc;
 
         ImGui::PushStyleColor(ImGuiCol_ChildBg, DS::BG_ELEVATED);
@@ -735,8 +1234,9 @@ static void RenderBoostPanel() {
 
         // Score ring on left
         float sy = ImGui::GetCursorPosY();
-        Widget::ScoreRing(sc, sc > 60 ? DS::ACCENT_GREEN
-                                      : (sc > 30 ? DS::ACCENT_ORANGE : DS::ACCENT_RED));
+        Widget::ScoreRing(sc, !measured ? DS::TEXT_SECONDARY
+                            : sc > 60  ? DS::ACCENT_GREEN
+                            : sc > 30  ? DS::ACCENT_ORANGE : DS::ACCENT_RED);
         ImGui::SameLine(110);
         ImGui::SetCursorPosY(sy + 14);
         ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_PRIMARY);
@@ -745,12 +1245,28 @@ static void RenderBoostPanel() {
         ImGui::SetCursorPosY(sy + 38);
         ImGui::SameLine(110);
         ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
-        const char* grade = sc > 80 ? "Excellent — Near-native performance"
-                          : sc > 50 ? "Good — Significant improvements applied"
-                          : sc > 20 ? "Fair — Apply more toggles below"
-                                    : "Baseline — Enable tweaks to boost FPS";
-        ImGui::Text("%s", grade);
+        if (Opt::Measuring()) {
+            ImGui::TextUnformatted(Opt::s_measure.label.rfind("before:", 0) == 0
+                                   ? "Measuring before the switch..." : "Measuring...");
+        } else if (!measured) {
+            ImGui::TextUnformatted("Not measured yet — run the benchmark");
+        } else if (Opt::s_measure.hasDelta) {
+            const float d = sc - Opt::s_measure.before.score;
+            ImGui::Text("%+.0f measured for \"%s\" (%.0f before)", d,
+                        Opt::s_measure.profile.c_str(), Opt::s_measure.before.score);
+        } else {
+            const char* grade = sc > 80 ? "Excellent — Near-native performance"
+                              : sc > 50 ? "Good — Significant improvements applied"
+                              : sc > 20 ? "Fair — Apply more toggles below"
+                                        : "Baseline — Enable tweaks to boost FPS";
+            ImGui::Text("%s", grade);
+        }
         ImGui::PopStyleColor();
+        ImGui::SetCursorPosY(sy + 62);
+        ImGui::SameLine(110);
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 12.0f);
+        if (ImGui::Button("Measure", ImVec2(96, 24))) Opt::StartMeasure("manual");   // no-op while one runs
+        ImGui::PopStyleVar();
 
         ImGui::EndChild();
         ImGui::PopStyleVar(2);
@@ -758,6 +1274,61 @@ static void RenderBoostPanel() {
         ImGui::Spacing();
     }
 
+    // Profile strip: one tap switches every tweak as a single transaction
+    {
+        const std::string& active = Opt::Store().Active();
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("PROFILE");
+        ImGui::PopStyleColor();
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 14.0f);
+        auto pill = [&active](const char* name, const char* label, ImVec4 col) {
+            const bool on = active == name;
+            ImGui::SameLine();
+            ImGui::PushStyleColor(ImGuiCol_Button, on ? col : DS::BG_CARD_HIGH);
+            if (ImGui::Button(label, ImVec2(120, 28)) && !on) Opt::SwitchProfile(name);
+            ImGui::PopStyleColor();
+        };
+        pill("competitive", "Competitive", DS::ACCENT_RED);
+        pill("desktop",     "Desktop",     DS::ACCENT_BLUE);
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(150);
+        if (ImGui::BeginCombo("##profiles", active.empty() ? "Custom" : active.c_str())) {
+            for (const Tweaks::Profile& p : Opt::Store().Profiles())
+                if (ImGui::Selectable(p.name.c_str(), p.name == active) && p.name != active)
+                    Opt::SwitchProfile(p.name);
+            ImGui::EndCombo();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Save as...", ImVec2(0, 28))) ImGui::OpenPopup("##save_profile");
+        ImGui::PopStyleVar();
+        ImGui::SameLine();
+        ImGui::Checkbox("Measure switches", &Opt::s_bracket);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Run the benchmark before and after each switch (delays it by about a second)");
+        if (Opt::Switcher().Busy()) {
+            ImGui::SameLine();
+            ImGui::PushStyleColor(ImGuiCol_Text, DS::ACCENT_ORANGE);
+            ImGui::AlignTextToFramePadding();
+            ImGui::Text("Applying...");
+            ImGui::PopStyleColor();
+        }
+        if (ImGui::BeginPopup("##save_profile")) {
+            static char name[32] = {};
+            ImGui::SetNextItemWidth(180);
+            const bool enter = ImGui::InputTextWithHint("##name", "profile name", name, sizeof(name),
+                                                        ImGuiInputTextFlags_EnterReturnsTrue);
+            if ((enter || ImGui::Button("Save")) && name[0]) {
+                Opt::SaveProfile(name);
+                name[0] = 0;
+                ImGui::CloseCurrentPopup();
+            }
+            ImGui::EndPopup();
+        }
+        ImGui::Spacing();
+    }
+
     // Boost options card
     Widget::BeginCard(0, DS::BG_ELEVATED);
 
@@ -780,17 +1351,8 @@ static void RenderBoostPanel() {
         [](bool on){ Opt::SetHPET(on); });
 
     row("CPU Priority Boost",       "Foreground process gets more CPU time",
-        &g_app.cpuBoost,       DS::ACCENT_ORANGE, [](bool on){
-            HKEY hk;
-            if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-                L"SYSTEM\\CurrentControlSet\\Control\\PriorityControl",
-                0, KEY_SET_VALUE, &hk) == ERROR_SUCCESS) {
-                DWORD v = on ? 2 : 1;
-                RegSetValueExW(hk, L"Win32PrioritySeparation",0,REG_DWORD,(BYTE*)&v,4);
-                RegCloseKey(hk);
-            }
-            g_app.PushNotif(on ? "CPU priority separation maximised" : "CPU priority restored");
-        });
+        &g_app.cpuBoost,       DS::ACCENT_ORANGE,
+        [](bool on){ Opt::SetCpuPriority(on); });
 
     row("Network Low-Latency",      "Disables Nagle, sets TCP ACK = 1",
         &g_app.networkOpt,     DS::ACCENT_BLUE,
@@ -804,7 +1366,7 @@ static void RenderBoostPanel() {
 
     row("Kill Windows Explorer",    "Frees RAM + CPU  |  taskbar disappears",
         &g_app.explorerKilled, DS::ACCENT_RED,
-        [](bool){ Opt::ToggleExplorer(); });
+        [](bool on){ on ? Opt::KillExplorer() : Opt::RestartExplorer(); });
 
     row("Disable SuperFetch",       "Stops background prefetching — frees RAM",
         &g_app.superfetchOff,  DS::ACCENT_ORANGE,
@@ -823,10 +1385,111 @@ static void RenderBoostPanel() {
         [](bool on){ Opt::SetGameBar(!on); });
 
     Widget::EndCard();
+
+    // Latency card: what the timer / priority tweaks actually do to wakeups.
+    // Percentiles are over the last second, from snapshots of the sampler's
+    // histograms, so the UI never blocks it.
+    ImGui::Spacing();
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::Text("SCHEDULING LATENCY");
+    ImGui::PopStyleColor();
+    ImGui::SameLine(ImGui::GetContentRegionAvail().x - 170);
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 12.0f);
+    if (ImGui::Button(g_latency.Running() ? "Stop" : "Start", ImVec2(70, 0))) {
+        if (g_latency.Running()) g_latency.Stop();
+        else if (!g_latency.Start()) g_app.PushNotif(Events::Source::Latency, "Latency sampler couldn't start", DS::ACCENT_RED);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export CSV", ImVec2(90, 0))) {
+        OPENFILENAMEA ofn{};
+        char fname[512] = "latency.csv";
+        ofn.lStructSize = sizeof(ofn);
+        ofn.lpstrFile   = fname;
+        ofn.nMaxFile    = sizeof(fname);
+        ofn.lpstrFilter = "CSV\0*.csv\0All\0*.*\0";
+        ofn.lpstrDefExt = "csv";
+        ofn.Flags       = OFN_OVERWRITEPROMPT;
+        std::string err;
+        if (GetSaveFileNameA(&ofn)) {
+            if (g_latency.ExportCsv(fs::u8path(fname), &err))
+                g_app.PushNotif(Events::Source::Latency, "Latency histogram exported");
+            else
+                g_app.PushNotif(Events::Source::Latency, err, DS::ACCENT_RED);
+        }
+    }
+    ImGui::PopStyleVar();
+    {
+        using Latency::Histogram;
+        static Histogram::Snapshot cur[2], last[2], window[2];
+        static double next = 0.0;
+        const double t = ImGui::GetTime();
+        if (g_latency.Running() && t >= next) {
+            for (int i = 0; i < 2; i++) {
+                last[i] = cur[i];
+                g_latency.Get((Latency::Probe)i).Read(cur[i]);
+                Histogram::Since(cur[i], last[i], window[i]);
+            }
+            next = t + 1.0;
+        }
+        if (g_latency.Running()) g_pacer.WakeIn(next - t);
+        const char* names[2] = { "Timer wake", "Thread wake" };
+        for (int i = 0; i < 2; i++) {
+            const Latency::Summary sm = Latency::Summarize(window[i]);
+            ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_PRIMARY);
+            ImGui::Text("%-12s", names[i]);
+            ImGui::PopStyleColor();
+            ImGui::SameLine(120);
+            ImGui::PushStyleColor(ImGuiCol_Text, sm.p99 > 2000000 ? DS::ACCENT_RED
+                                               : sm.p99 > 500000  ? DS::ACCENT_ORANGE : DS::TEXT_SECONDARY);
+            ImGui::Text("p50 %7.1f us   p99 %7.1f us   p99.9 %7.1f us", sm.p50 / 1e3, sm.p99 / 1e3, sm.p999 / 1e3);
+            ImGui::PopStyleColor();
+        }
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+        ImGui::Text("%u Hz  |  %llu missed ticks  |  sampler %.2f%% of a core", g_latency.RateHz(),
+                    (unsigned long long)g_latency.Missed(), g_latency.CpuPercent());
+        ImGui::PopStyleColor();
+    }
+    Widget::EndCard();
+
+    // Reclaimer card: the last pass, action by action, in measured bytes
+    ImGui::Spacing();
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::Text("MEMORY RECLAIMER");
+    ImGui::PopStyleColor();
+    ImGui::SameLine(ImGui::GetContentRegionAvail().x - 90);
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 12.0f);
+    if (ImGui::Button("Trim now", ImVec2(90, 0))) Opt::s_reclaim.force = true;
+    ImGui::PopStyleVar();
+    {
+        static bool autoOn = false;
+        if (Widget::BoostRow("Auto-reclaim", "Trim idle background apps when free RAM drops below 10%",
+                             &autoOn, DS::ACCENT_GREEN))
+            Opt::s_reclaim.autoOn = autoOn;
+        std::lock_guard<std::mutex> lk(Opt::s_reclaim.mx);
+        const Reclaim::Report& r = Opt::s_reclaim.last;
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+        if (r.total)
+            ImGui::Text("Last pass: %s from %zu processes  |  %s in total since start",
+                        Opt::HumanBytes(r.reclaimed).c_str(), r.actions.size(),
+                        Opt::HumanBytes(Opt::s_reclaim.total).c_str());
+        else
+            ImGui::Text("No pass yet");
+        ImGui::PopStyleColor();
+        for (const Reclaim::Action& a : r.actions) {
+            ImGui::PushStyleColor(ImGuiCol_Text, a.ok ? DS::TEXT_PRIMARY : DS::ACCENT_RED);
+            ImGui::Text("%-24.24s %10s  of %10s%s", a.name.c_str(), Opt::HumanBytes(a.reclaimed).c_str(),
+                        Opt::HumanBytes(a.resident).c_str(), a.group.empty() ? "" : "  (group)");
+            ImGui::PopStyleColor();
+        }
+    }
+    Widget::EndCard();
 }
 
 // ──────────────────────────────────────────────────────────────────────────────
 static void RenderCleanPanel() {
+    XOPT_ZONE("RenderCleanPanel");
     Widget::BeginCard(0, DS::BG_ELEVATED);
 
     ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
@@ -834,8 +1497,9 @@ static void RenderCleanPanel() {
     ImGui::PopStyleColor();
     ImGui::Dummy({0,6});
 
-    // Status dots
-    auto dot = [](const char* lbl, bool done) {
+    // Status dots (+ reclaimable size once a dry-run scan has finished)
+    const bool scanned = g_app.cleanScanned && !g_app.cleanRunning;
+    auto dot = [scanned](const char* lbl, bool done, int root = -1) {
         ImVec4 c = done ? DS::ACCENT_GREEN : DS::BG_CARD_HIGH;
         ImGui::GetWindowDrawList()->AddCircleFilled(
             {ImGui::GetCursorScreenPos().x + 6,
@@ -843,17 +1507,43 @@ static void RenderCleanPanel() {
         ImGui::Dummy({14,18}); ImGui::SameLine(0,6);
         ImGui::PushStyleColor(ImGuiCol_Text, done ? DS::TEXT_PRIMARY : DS::TEXT_SECONDARY);
         ImGui::Text("%s", lbl); ImGui::PopStyleColor();
+        if (scanned && root >= 0 && root < (int)g_app.cleanIndex.Roots().size()) {
+            std::string sz = Opt::HumanBytes(g_app.cleanIndex.Roots()[root].bytes);
+            ImGui::SameLine(ImGui::GetContentRegionAvail().x + ImGui::GetCursorPosX()
+                            - ImGui::CalcTextSize(sz.c_str()).x);
+            ImGui::PushStyleColor(ImGuiCol_Text, DS::ACCENT_BLUE);
+            ImGui::Text("%s", sz.c_str()); ImGui::PopStyleColor();
+        }
     };
 
-    dot("%%TEMP%% folder",          g_app.cleanTempDone);
-    dot("C:\\Windows\\Temp",        g_app.cleanWinTempDone);
-    dot("Prefetch cache",           g_app.cleanPrefetchDone);
+    dot("%%TEMP%% folder",          g_app.cleanTempDone,     0);
+    dot("C:\\Windows\\Temp",        g_app.cleanWinTempDone,  1);
+    dot("Prefetch cache",           g_app.cleanPrefetchDone, 2);
     dot("DNS cache",                g_app.cleanDNSDone);
 
     ImGui::Dummy({0,10});
 
+    // Drain worker progress + log lines (the cleaner thread never touches cleanLog)
+    auto& tr = g_app.cleanTracker;
+    g_app.cleanProgress.Drain([&](const Progress::Event& e){ tr.Apply(e); });
+    g_app.cleanProgress.DrainLog([](const char* line){ g_app.cleanLog += line; g_app.cleanLog += '\n'; });
+    tr.Tick(ImGui::GetTime());
+    if (g_app.cleanRunning) g_pacer.WakeIn(1.0 / 20.0);     // counters, not animation: 20 Hz is plenty
+
     if (!g_app.cleanRunning) {
-        // Big clean button
+        auto startJob = [](void (*job)(std::function<void(std::string)>)) {
+            g_app.cleanLog.clear();
+            g_app.cleanTempDone = g_app.cleanWinTempDone =
+            g_app.cleanPrefetchDone = g_app.cleanDNSDone = false;
+            g_app.cleanRunning = true;
+            std::thread([job](){
+                Prof::SetThreadName("cleaner");
+                job([](std::string line){
+                    g_app.cleanProgress.Log("%s", line.c_str());
+                });
+            }).detach();
+        };
+
         ImGui::PushStyleColor(ImGuiCol_Button,        DS::BG_CARD_HIGH);
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, DS::ACCENT_BLUE);
         ImGui::PushStyleColor(ImGuiCol_ButtonActive,  DS::Lerp(DS::ACCENT_BLUE, DS::BG_BASE, 0.3f));
@@ -861,23 +1551,36 @@ static void RenderCleanPanel() {
         ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 14.0f);
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding,  ImVec2(0, 12));
         float bw = ImGui::GetContentRegionAvail().x;
-        if (ImGui::Button("  Clean Now  ", ImVec2(bw, 0))) {
-            g_app.cleanLog.clear();
-            g_app.cleanTempDone = g_app.cleanWinTempDone =
-            g_app.cleanPrefetchDone = g_app.cleanDNSDone = false;
-            std::thread([](){
-                Opt::CleanTempFiles([](std::string line){
-                    g_app.cleanLog += line + "\n";
-                });
-            }).detach();
-        }
+        // Dry-run scan
+        if (ImGui::Button("  Scan  ", ImVec2(bw * 0.3f, 0)))
+            startJob(Opt::ScanTempFiles);
+        ImGui::SameLine(0, 8);
+        // Big clean button — commits the scanned index when there is one
+        std::string cleanLbl = scanned
+            ? "  Clean Now  —  " + Opt::HumanBytes(g_app.cleanIndex.ReclaimableBytes()) + "  ###clean"
+            : std::string("  Clean Now  ###clean");
+        if (ImGui::Button(cleanLbl.c_str(), ImVec2(ImGui::GetContentRegionAvail().x, 0)))
+            startJob(Opt::CleanTempFiles);
         ImGui::PopStyleVar(2);
         ImGui::PopStyleColor(4);
     } else {
-        float t = (float)ImGui::GetTime();
+        const char* what = tr.phase == Progress::Phase::Scan ? "Scanning" : "Cleaning";
+        const float pct  = tr.Percent();
         ImGui::PushStyleColor(ImGuiCol_Text, DS::ACCENT_BLUE);
-        ImGui::Text("  Cleaning...  (%.0f%%)", fmod(t*40, 100));
+        if (pct >= 0.0f)
+            ImGui::Text("  %s...  (%.0f%%)", what, pct * 100.0f);
+        else
+            ImGui::Text("  %s...  %llu files", what, (unsigned long long)tr.files);
         ImGui::PopStyleColor();
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+        ImGui::Text("  %.0f files/s  |  %s/s  |  %llu skipped", tr.filesPerSec,
+                    Opt::HumanBytes((uint64_t)tr.bytesPerSec).c_str(), (unsigned long long)tr.errors);
+        ImGui::PopStyleColor();
+        if (pct >= 0.0f) {
+            ImGui::PushStyleColor(ImGuiCol_PlotHistogram, DS::ACCENT_BLUE);
+            ImGui::ProgressBar(pct, ImVec2(-1, 4), "");
+            ImGui::PopStyleColor();
+        }
     }
 
     if (!g_app.cleanLog.empty()) {
@@ -896,6 +1599,7 @@ static void RenderCleanPanel() {
 
 // ──────────────────────────────────────────────────────────────────────────────
 static void RenderLaunchPanel() {
+    XOPT_ZONE("RenderLaunchPanel");
     Widget::BeginCard(0, DS::BG_ELEVATED);
 
     ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
@@ -932,7 +1636,7 @@ static void RenderLaunchPanel() {
             strncpy_s(g_app.gamePath, fname, sizeof(g_app.gamePath)-1);
             g_app.launchReady  = true;
             g_app.launchStatus = "Ready to launch!";
-            g_app.PushNotif("Game selected: " + std::string(fname), DS::ACCENT_GREEN);
+            g_app.PushNotif(Events::Source::Launch, "Game selected: " + std::string(fname), DS::ACCENT_GREEN);
         }
     }
     ImGui::PopStyleVar(2); ImGui::PopStyleColor(3);
@@ -940,6 +1644,9 @@ static void RenderLaunchPanel() {
     ImGui::Dummy({0,16});
     ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
     ImGui::Text("%s", g_app.launchStatus.c_str());
+    if (Opt::Governed())
+        ImGui::Text("Governing %u game processes  |  %u background moved", Opt::s_govern.gameProcs.load(),
+                    Opt::s_govern.moved.load());
     ImGui::PopStyleColor();
     ImGui::Dummy({0,8});
 
@@ -988,6 +1695,7 @@ static void RenderLaunchPanel() {
 
 // ──────────────────────────────────────────────────────────────────────────────
 static void RenderPhonkPanel() {
+    XOPT_ZONE("RenderPhonkPanel");
     Widget::BeginCard(0, DS::BG_ELEVATED);
 
     ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
@@ -1003,7 +1711,7 @@ static void RenderPhonkPanel() {
     ImGui::PushStyleColor(ImGuiCol_Text,             DS::TEXT_PRIMARY);
     ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 12.0f);
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding,  ImVec2(12, 10));
-    ImGui::SetNextItemWidth(bw - 100.0f);
+    ImGui::SetNextItemWidth(bw - 190.0f);
     ImGui::InputText("##ppath", g_app.phonkPath, sizeof(g_app.phonkPath));
     ImGui::PopStyleVar(2); ImGui::PopStyleColor(3);
     ImGui::SameLine(0, 10);
@@ -1022,16 +1730,34 @@ static void RenderPhonkPanel() {
         if (GetOpenFileNameA(&ofn)) {
             Phonk::Stop();
             strncpy_s(g_app.phonkPath, fn, sizeof(g_app.phonkPath)-1);
-            Phonk::Open(fn);
-            g_app.PushNotif("Track loaded: " + std::string(fn), DS::ACCENT_PURPLE);
+            if (Phonk::Open(fn))
+                g_app.PushNotif(Events::Source::Audio, "Track loaded: " + std::string(fn), DS::ACCENT_PURPLE);
         }
     }
+    ImGui::SameLine(0, 10);
+    if (ImGui::Button("Folder##pk")) {
+        // Enumeration, tag reads and decoding all happen on the playlist worker
+        const bool com = SUCCEEDED(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED));
+        BROWSEINFOA bi{}; char dir[MAX_PATH] = {};
+        bi.lpszTitle = "Play every track in this folder";
+        bi.ulFlags   = BIF_RETURNONLYFSDIRS | BIF_NEWDIALOGSTYLE;
+        if (LPITEMIDLIST pidl = SHBrowseForFolderA(&bi)) {
+            if (SHGetPathFromIDListA(pidl, dir)) {
+                Phonk::Stop();
+                strncpy_s(g_app.phonkPath, dir, sizeof(g_app.phonkPath)-1);
+                Phonk::OpenFolder(dir);
+            }
+            CoTaskMemFree(pidl);
+        }
+        if (com) CoUninitialize();
+    }
     ImGui::PopStyleVar(2); ImGui::PopStyleColor(3);
 
     ImGui::Dummy({0,14});
 
     // Track title (scrolling marquee if long)
     {
+        Phonk::RefreshTitle();
         ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_PRIMARY);
         std::string t = g_app.phonkTitle.empty() ? "No Track" : g_app.phonkTitle;
         if (t.length() > 40) t = t.substr(0, 37) + "...";
@@ -1048,7 +1774,10 @@ static void RenderPhonkPanel() {
         g_app.phonkProgress = Phonk::GetProgress();
     }
     float prog = g_app.phonkProgress;
-    Widget::Slider("##phonkprog", &prog, 0.0f, 1.0f, DS::ACCENT_PURPLE);
+    if (Widget::Slider("##phonkprog", &prog, 0.0f, 1.0f, DS::ACCENT_PURPLE) && g_app.phonkLoaded) {
+        Phonk::Seek(prog);
+        g_app.phonkProgress = prog;
+    }
     ImGui::Dummy({0,8});
 
     // Controls row: loop | ◁◁ | ▶/⏸ | ▷▷
@@ -1067,23 +1796,21 @@ static void RenderPhonkPanel() {
     };
 
     ImVec4 loopC = g_app.phonkLoop ? DS::ACCENT_PURPLE : DS::TEXT_SECONDARY;
-    if (ctrlBtn("Loop", loopC))  g_app.phonkLoop = !g_app.phonkLoop;
+    if (ctrlBtn("Loop", loopC))  Phonk::SetLoop(g_app.phonkLoop = !g_app.phonkLoop);
     ImGui::SameLine(0,6);
-    if (ctrlBtn("◁◁", DS::TEXT_SECONDARY)) {
-        Phonk::Stop();
-        if (g_app.phonkLoaded) { Phonk::Open(g_app.phonkPath); Phonk::Play(); }
-    }
+    if (ctrlBtn("◁◁", DS::TEXT_SECONDARY)) Phonk::Prev();
     ImGui::SameLine(0,6);
     const char* playLbl = g_app.phonkPlaying ? "  ⏸  " : "  ▶  ";
     if (ctrlBtn(playLbl, DS::ACCENT_PURPLE, btnW + 16)) {
-        if (!g_app.phonkLoaded && strlen(g_app.phonkPath)>0) Phonk::Open(g_app.phonkPath);
+        if (!Phonk::Engine().IsOpen() && strlen(g_app.phonkPath)>0) {
+            std::error_code ec;
+            if (fs::is_directory(fs::u8path(g_app.phonkPath), ec)) Phonk::OpenFolder(g_app.phonkPath);
+            else Phonk::Open(g_app.phonkPath);
+        }
         g_app.phonkPlaying ? Phonk::Pause() : Phonk::Play();
     }
     ImGui::SameLine(0,6);
-    if (ctrlBtn("▷▷", DS::TEXT_SECONDARY)) {
-        Phonk::Stop();
-        g_app.PushNotif("Next track (no queue — load next manually)", DS::TEXT_SECONDARY);
-    }
+    if (ctrlBtn("▷▷", DS::TEXT_SECONDARY)) Phonk::Next();
 
     ImGui::Dummy({0,16});
 
@@ -1099,35 +1826,374 @@ static void RenderPhonkPanel() {
 
     ImGui::Dummy({0,8});
 
-    // Visualiser: animated bars (fake but beautiful)
+    // Visualiser: live FFT bands from the analyser, with peak-hold markers
     {
-        float t   = (float)ImGui::GetTime();
+        static Dsp::Spectrum snap;
+        if (!Phonk::s_spectrum.Read(snap) && !g_app.phonkPlaying)
+            for (unsigned i = 0; i < snap.bands; i++) { snap.level[i] *= 0.9f; snap.peak[i] *= 0.9f; }
+        // Live while playing, then only until the bars have decayed
+        bool moving = g_app.phonkPlaying;
+        for (unsigned i = 0; i < snap.bands && !moving; i++) moving = snap.peak[i] > 0.01f;
+        if (moving) g_pacer.KeepAlive();
         ImDrawList* dl = ImGui::GetWindowDrawList();
         ImVec2 vp  = ImGui::GetCursorScreenPos();
         float vh   = 36.0f, vw = bw;
-        int   bars = 48;
+        int   bars = (int)Phonk::s_spectrum.Bands();
         float bw2  = vw / (bars * 2.0f);
         for (int i = 0; i < bars; i++) {
-            float phase  = (float)i / bars * IM_PI * 2.0f;
-            float amp    = g_app.phonkPlaying
-                ? fabsf(sinf(t * 3.8f + phase) * sinf(t * 2.1f + phase*1.3f))
-                : fabsf(sinf(phase) * 0.15f);
-            float h      = amp * vh * (g_app.phonkVolume / 100.0f);
+            float amp    = snap.level[i];
+            float h      = std::max(2.0f, amp * vh);
             float x      = vp.x + i * (bw2*2.0f) + bw2 * 0.5f;
             float alpha  = 0.5f + amp * 0.5f;
             ImU32 col    = DS::ColA(DS::ACCENT_PURPLE, alpha);
             dl->AddRectFilled({x, vp.y + vh - h}, {x + bw2, vp.y + vh}, col, 2.0f);
+            if (snap.peak[i] > amp + 0.02f) {
+                float py = vp.y + vh - snap.peak[i] * vh;
+                dl->AddRectFilled({x, py - 1.5f}, {x + bw2, py}, DS::ColA(DS::TEXT_PRIMARY, 0.7f));
+            }
         }
         ImGui::Dummy({vw, vh + 4});
     }
 
+    // Queue: only the visible rows are laid out, and only their tags are
+    // requested — a folder of thousands of tracks costs the same per frame
+    const size_t count = Phonk::List().Size();
+    if (Phonk::List().Loading() || count > 1) {
+        ImGui::Dummy({0,8});
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+        if (Phonk::List().Loading()) { ImGui::Text("Scanning folder..."); g_pacer.WakeIn(0.1); }
+        else                         ImGui::Text("Queue  ·  %zu tracks", count);
+        ImGui::PopStyleColor();
+        ImGui::PushStyleColor(ImGuiCol_ChildBg, DS::BG_CARD);
+        ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 12.0f);
+        ImGui::BeginChild("##pkqueue", {bw, 220.0f}, false);
+        ImGuiListClipper clip;
+        clip.Begin((int)count);
+        while (clip.Step()) {
+            for (int i = clip.DisplayStart; i < clip.DisplayEnd; i++) {
+                const Audio::TrackInfo* ti = Phonk::List().Info((size_t)i);
+                if (!ti) g_pacer.WakeIn(0.05);                  // tags still being read
+                std::string row = ti ? (ti->artist.empty() ? ti->title : ti->artist + " — " + ti->title)
+                                     : Phonk::List().Path((size_t)i).stem().string();
+                if (ti && ti->seconds > 0)
+                    row += "  " + std::to_string((int)ti->seconds / 60) + ":" +
+                           (((int)ti->seconds % 60) < 10 ? "0" : "") + std::to_string((int)ti->seconds % 60);
+                const bool cur = i == Phonk::List().Current();
+                ImGui::PushStyleColor(ImGuiCol_Text, cur ? DS::ACCENT_PURPLE : DS::TEXT_PRIMARY);
+                ImGui::PushID(i);
+                if (ImGui::Selectable(row.c_str(), cur)) Phonk::Jump((size_t)i);
+                ImGui::PopID();
+                ImGui::PopStyleColor();
+            }
+        }
+        ImGui::EndChild();
+        ImGui::PopStyleVar(); ImGui::PopStyleColor();
+    }
+
     Widget::EndCard();
 }
 
+// ──────────────────────────────────────────────────────────────────────────────
+//  PROFILER VIEW
+// ──────────────────────────────────────────────────────────────────────────────
+// The last 100 ms of zones as a flame timeline, one lane per thread with
+// nested zones stacked under their parent, then the top zones by time.  The
+// snapshot refreshes four times a second so it can be read while it runs.
+static void RenderProfiler(float bw) {
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("PROFILER");
+    ImGui::PopStyleColor();
+    if (g_startup.firstFrameMs > 0.0) {
+        ImGui::SameLine();
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+        ImGui::Text("first frame %.0f ms  ·  fonts %.1f ms (cache %s)",
+                    g_startup.firstFrameMs, g_startup.fontMs, g_startup.fontCache);
+        ImGui::PopStyleColor();
+    }
+    if (!Prof::Compiled()) {
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+        ImGui::Text("Zones compiled out (XOPT_PROFILER=OFF)");
+        ImGui::PopStyleColor();
+        Widget::EndCard();
+        return;
+    }
+    ImGui::SameLine(ImGui::GetContentRegionAvail().x - 170);
+    bool capture = Prof::Capturing();
+    if (Widget::Toggle("##prof_capture", &capture, DS::ACCENT_PINK)) {
+        if (capture) Prof::Start(); else Prof::Stop();
+    }
+    ImGui::SameLine();
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 12.0f);
+    if (ImGui::Button("Export trace", ImVec2(100, 0))) {
+        OPENFILENAMEA ofn{};
+        char fname[512] = "xopt-trace.json";
+        ofn.lStructSize = sizeof(ofn);
+        ofn.lpstrFile   = fname;
+        ofn.nMaxFile    = sizeof(fname);
+        ofn.lpstrFilter = "Chrome trace\0*.json\0All\0*.*\0";
+        ofn.lpstrDefExt = "json";
+        ofn.Flags       = OFN_OVERWRITEPROMPT;
+        std::vector<Prof::Event> all;
+        std::string err;
+        Prof::Collect(all);
+        if (GetSaveFileNameA(&ofn)) {
+            if (Prof::ExportChromeTrace(all, fs::u8path(fname), &err))
+                g_app.PushNotif(Events::Source::Stats, "Trace exported — " + std::to_string(all.size()) + " zones");
+            else
+                g_app.PushNotif(Events::Source::Stats, err, DS::ACCENT_RED);
+        }
+    }
+    ImGui::PopStyleVar();
+
+    struct Lane { uint32_t thread; std::string name; size_t first, last; uint32_t depth; };
+    static std::vector<Prof::Event>    ev;
+    static std::vector<Prof::ZoneStat> zones;
+    static std::vector<Lane>           lanes;
+    static uint64_t                    t1 = 0;
+    static double                      snapAt = -1.0;
+    constexpr uint64_t kWindowNs = 100000000;
+    if (capture && ImGui::GetTime() - snapAt >= 0.25) {
+        snapAt = ImGui::GetTime();
+        t1     = Prof::Now();
+        Prof::Collect(ev, t1 - kWindowNs);
+        Prof::Summarize(ev, zones);
+        lanes.clear();
+        for (size_t i = 0; i < ev.size(); i++) {
+            if (lanes.empty() || lanes.back().thread != ev[i].thread)
+                lanes.push_back({ ev[i].thread, Prof::ThreadName(ev[i].thread), i, i, 0 });
+            lanes.back().last  = i;
+            lanes.back().depth = std::max(lanes.back().depth, ev[i].depth);
+        }
+    }
+    if (capture) g_pacer.WakeIn(0.25);
+    if (ev.empty()) {
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+        ImGui::TextUnformatted(capture ? "Waiting for zones..." : "Off — turn capture on to record zones");
+        ImGui::PopStyleColor();
+        Widget::EndCard();
+        return;
+    }
+
+    // Timeline
+    const ImVec4 kCol[] = { DS::ACCENT_BLUE, DS::ACCENT_PURPLE, DS::ACCENT_GREEN, DS::ACCENT_ORANGE, DS::ACCENT_PINK };
+    const float  labelW = 96.0f, rowH = 16.0f;
+    const float  W      = bw - 40.0f - labelW;
+    const uint64_t t0   = t1 - kWindowNs;
+    ImDrawList*  dl     = ImGui::GetWindowDrawList();
+    for (const Lane& lane : lanes) {
+        const ImVec2 o = ImGui::GetCursorScreenPos();
+        const float  H = rowH * (float)(lane.depth + 1);
+        dl->AddText({ o.x, o.y + 1 }, DS::Col(DS::TEXT_TERTIARY), lane.name.c_str());
+        dl->AddRectFilled({ o.x + labelW, o.y }, { o.x + labelW + W, o.y + H }, DS::Col(DS::BG_CARD), 4.0f);
+        for (size_t i = lane.first; i <= lane.last; i++) {
+            const Prof::Event& e = ev[i];
+            const float x0 = o.x + labelW + W * (float)((double)(std::max(e.begin, t0) - t0) / kWindowNs);
+            const float x1 = std::max(x0 + 1.0f, o.x + labelW + W * (float)((double)(std::min(e.end, t1) - t0) / kWindowNs));
+            const float y0 = o.y + rowH * (float)e.depth;
+            const ImVec2 a{ x0, y0 + 1 }, b{ x1, y0 + rowH - 1 };
+            size_t h = 0;
+            for (const char* c = e.name; *c; c++) h = h * 31 + (unsigned char)*c;
+            dl->AddRectFilled(a, b, DS::Col(kCol[h % 5], 0.75f), 2.0f);
+            if (x1 - x0 > 40.0f) {
+                dl->PushClipRect(a, b, true);
+                dl->AddText({ x0 + 3, y0 + 1 }, DS::Col(DS::TEXT_PRIMARY), e.name);
+                dl->PopClipRect();
+            }
+            if (ImGui::IsMouseHoveringRect(a, b))
+                ImGui::SetTooltip("%s\n%.3f ms on %s", e.name, (double)(e.end - e.begin) / 1e6, lane.name.c_str());
+        }
+        ImGui::Dummy({ labelW + W, H + 4.0f });
+    }
+
+    // Top zones over the window
+    ImGui::Spacing();
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+    ImGui::Text("zone");
+    ImGui::SameLine(220); ImGui::Text("calls");
+    ImGui::SameLine(290); ImGui::Text("total ms");
+    ImGui::SameLine(370); ImGui::Text("self ms");
+    ImGui::SameLine(450); ImGui::Text("max ms");
+    ImGui::PopStyleColor();
+    for (size_t i = 0; i < zones.size() && i < 10; i++) {
+        const Prof::ZoneStat& z = zones[i];
+        ImGui::TextUnformatted(z.name);
+        ImGui::SameLine(220); ImGui::Text("%llu", (unsigned long long)z.count);
+        ImGui::SameLine(290); ImGui::Text("%.3f", z.totalNs / 1e6);
+        ImGui::SameLine(370); ImGui::Text("%.3f", z.selfNs / 1e6);
+        ImGui::SameLine(450); ImGui::Text("%.3f", z.maxNs / 1e6);
+    }
+    Widget::EndCard();
+}
+
+// ──────────────────────────────────────────────────────────────────────────────
+static std::string PerSecond(float bytes) {
+    return Opt::HumanBytes((uint64_t)bytes) + "/s";
+}
+
+static void RenderStatsPanel() {
+    XOPT_ZONE("RenderStatsPanel");
+    const ImVec4 kCol[] = { DS::ACCENT_BLUE, DS::ACCENT_PURPLE, DS::ACCENT_GREEN, DS::ACCENT_PINK };
+    const float bw = ImGui::GetContentRegionAvail().x;
+
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::Text("SAMPLE RATE");
+    ImGui::PopStyleColor();
+    static const char* rates[]   = { "1 Hz", "2 Hz", "5 Hz", "10 Hz" };
+    static const unsigned hz[]   = { 1, 2, 5, 10 };
+    static int rate = 1;
+    const int was = rate;
+    ImGui::PushID("rate");
+    Widget::TabBar(rates, 4, &rate);
+    ImGui::PopID();
+    if (rate != was) {
+        g_telemetry.Stop();
+        g_telemetry.Start(hz[rate]);
+    }
+    if (!g_telemetry.Running() && ImGui::Button("Start sampling") && !g_telemetry.Start(hz[rate]))
+        g_app.PushNotif(Events::Source::Stats, "System counters unavailable", DS::ACCENT_RED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+    ImGui::Text("%u samples  |  %.0f us per sample  |  last %zu shown", (unsigned)g_telemetry.Ticks(),
+                g_telemetry.CostNs() / 1e3, Telemetry::kHistory);
+    ImGui::PopStyleColor();
+    Widget::EndCard();
+    ImGui::Spacing();
+
+    using Telemetry::Series;
+    const float H = 56.0f;
+
+    // CPU: the total, then one small line per core
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::Text("CPU  %.0f%%", g_telemetry.Get(Series::Cpu).Last());
+    ImGui::PopStyleColor();
+    Widget::Sparkline("##cpu", g_telemetry.Get(Series::Cpu), 100.0f, DS::ACCENT_BLUE, { bw - 40.0f, H });
+    const unsigned cpus = g_telemetry.Cpus();
+    if (cpus > 1) {
+        const unsigned perRow = std::max(1u, std::min(cpus, (unsigned)((bw - 40.0f) / 120.0f)));
+        const float    cw     = (bw - 40.0f - 8.0f * (perRow - 1)) / (float)perRow;
+        for (unsigned i = 0; i < cpus; i++) {
+            if (i % perRow) ImGui::SameLine(0, 8);
+            ImGui::BeginGroup();
+            char id[16];
+            snprintf(id, sizeof(id), "##core%u", i);
+            ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+            ImGui::Text("%u  %.0f%%", i, g_telemetry.Core(i).Last());
+            ImGui::PopStyleColor();
+            Widget::Sparkline(id, g_telemetry.Core(i), 100.0f, kCol[i % 4], { cw, 28.0f });
+            ImGui::EndGroup();
+        }
+    }
+    Widget::EndCard();
+    ImGui::Spacing();
+
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    const float mem = g_telemetry.Get(Series::Memory).Last();
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::Text("MEMORY  %.0f%%  (%s of %s)", mem,
+                Opt::HumanBytes((uint64_t)(g_telemetry.MemTotal() * (double)mem / 100.0)).c_str(),
+                Opt::HumanBytes(g_telemetry.MemTotal()).c_str());
+    ImGui::PopStyleColor();
+    Widget::Sparkline("##mem", g_telemetry.Get(Series::Memory), 100.0f, DS::ACCENT_PURPLE, { bw - 40.0f, H });
+    Widget::EndCard();
+    ImGui::Spacing();
+
+    // Disk and network: in (green) and out (orange) on one shared scale
+    struct { const char* title; const char* in; const char* out; Series a, b; } rows[] = {
+        { "DISK",    "read", "write", Series::DiskRead, Series::DiskWrite },
+        { "NETWORK", "down", "up",    Series::NetRx,    Series::NetTx     },
+    };
+    for (auto& r : rows) {
+        Widget::BeginCard(0, DS::BG_ELEVATED);
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+        ImGui::Text("%s  %s %s  |  %s %s", r.title, r.in, PerSecond(g_telemetry.Get(r.a).Last()).c_str(),
+                    r.out, PerSecond(g_telemetry.Get(r.b).Last()).c_str());
+        ImGui::PopStyleColor();
+        const float peak = Widget::Sparkline(r.title, g_telemetry.Get(r.a), 0.0f, DS::ACCENT_GREEN, { bw - 40.0f, H },
+                                             &g_telemetry.Get(r.b), DS::ACCENT_ORANGE);
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+        ImGui::Text("peak %s", PerSecond(peak).c_str());
+        ImGui::PopStyleColor();
+        Widget::EndCard();
+        ImGui::Spacing();
+    }
+
+    RenderProfiler(bw);
+    ImGui::Spacing();
+
+    // What the last frame sent to the GPU, and how much of the custom
+    // widgets' share came out of the geometry cache instead of tessellation
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("GEOMETRY");
+    ImGui::PopStyleColor();
+    ImGui::SameLine(ImGui::GetContentRegionAvail().x - 58.0f);
+    bool retained = g_geo.Enabled();
+    if (Widget::Toggle("##geo_retained", &retained)) g_geo.SetEnabled(retained);
+    const Geo::FrameStats& gs = g_geo.Last();
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+    ImGui::Text("Frame: %d vertices  |  %d indices  |  %d draw lists", g_frameGeo.vtx, g_frameGeo.idx, g_frameGeo.lists);
+    ImGui::Text("Widgets: %llu vtx / %llu idx replayed (%u hits)  |  %llu vtx / %llu idx tessellated (%u misses)",
+                (unsigned long long)gs.vtxReplayed, (unsigned long long)gs.idxReplayed, gs.hits,
+                (unsigned long long)gs.vtxTessellated, (unsigned long long)gs.idxTessellated, gs.misses);
+    ImGui::Text("Cache: %zu meshes  |  %.1f KB  |  %u stored, %u evicted last frame",
+                g_geo.Entries(), g_geo.Bytes() / 1024.0, gs.stored, gs.evicted);
+    ImGui::PopStyleColor();
+    Widget::EndCard();
+    ImGui::Spacing();
+
+    // Notification history: everything the toasts showed, folded or dropped
+    Widget::BeginCard(0, DS::BG_ELEVATED);
+    const Events::Stats& ns = g_app.notify.GetStats();
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_SECONDARY);
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("NOTIFICATIONS");
+    ImGui::PopStyleColor();
+    ImGui::SameLine();
+    static char query[64] = {};
+    ImGui::SetNextItemWidth(200);
+    ImGui::InputTextWithHint("##notif_search", "search", query, sizeof(query));
+    ImGui::SameLine();
+    ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+    ImGui::Text("%llu received  |  %llu merged  |  %llu lost", (unsigned long long)ns.received,
+                (unsigned long long)(ns.coalesced + ns.folded), (unsigned long long)ns.lost);
+    ImGui::PopStyleColor();
+    static std::vector<const Events::Entry*> found;
+    g_app.notify.Search(query, found, 50);
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch()).count();
+    for (const Events::Entry* e : found) {
+        const double ago = (double)(nowNs - e->lastNs) / 1e9;
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+        if (ago < 60.0) ImGui::Text("%4.0fs", ago);
+        else            ImGui::Text("%4.0fm", ago / 60.0);
+        ImGui::SameLine(60);
+        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::ColorConvertU32ToFloat4(e->color));
+        ImGui::Text("%s", Events::SourceName(e->source));
+        ImGui::PopStyleColor(2);
+        ImGui::SameLine(140);
+        ImGui::TextUnformatted(e->label.c_str());
+    }
+    if (found.empty()) {
+        ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
+        ImGui::TextUnformatted(query[0] ? "No matches" : "Nothing yet");
+        ImGui::PopStyleColor();
+    }
+    Widget::EndCard();
+    ImGui::Spacing();
+
+    // Redraw when the next sample lands, not every vsync
+    if (g_telemetry.Running()) g_pacer.WakeIn(1.0 / g_telemetry.RateHz());
+}
+
 // ──────────────────────────────────────────────────────────────────────────────
 //  MAIN RENDER FRAME
 // ──────────────────────────────────────────────────────────────────────────────
 static void RenderUI() {
+    XOPT_ZONE("RenderUI");
     ImGuiIO& io = ImGui::GetIO();
     ImVec2   ds = io.DisplaySize;
 
@@ -1159,7 +2225,9 @@ static void RenderUI() {
         ImDrawList* dl = ImGui::GetWindowDrawList();
         ImVec2 lp = ImGui::GetCursorScreenPos();
         lp.x += (SBW - 36.0f)*0.5f; lp.y += 4;
-        dl->AddRectFilled(lp, {lp.x+36, lp.y+36}, DS::Col(DS::ACCENT_BLUE), 10.0f);
+        Widget::Retained(dl, Geo::Key().Mix('L').h, lp, [&] {
+            dl->AddRectFilled(lp, {lp.x+36, lp.y+36}, DS::Col(DS::ACCENT_BLUE), 10.0f);
+        });
         ImVec2 ts = ImGui::CalcTextSize("X");
         dl->AddText({lp.x + (36-ts.x)*0.5f, lp.y + (36-ts.y)*0.5f},
                     IM_COL32(255,255,255,255), "X");
@@ -1168,18 +2236,21 @@ static void RenderUI() {
 
     struct NavItem { const char* icon; const char* lbl; };
     static NavItem navItems[] = {
-        {"◈","Boost"},{"◉","Clean"},{"▷","Launch"},{"♪","Phonk"}
+        {"◈","Boost"},{"◉","Clean"},{"▷","Launch"},{"♪","Phonk"},{"▤","Stats"}
     };
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < 5; i++) {
         bool sel = (g_app.activeTab == i);
         if (sel) {
             ImVec2 p = ImGui::GetCursorScreenPos();
-            ImGui::GetWindowDrawList()->AddRectFilled(
-                {p.x + 6, p.y}, {p.x + SBW - 6, p.y + 56},
-                DS::ColA(DS::ACCENT_BLUE, 0.18f), 12.0f);
-            ImGui::GetWindowDrawList()->AddRectFilled(
-                {p.x + SBW - 4, p.y + 8}, {p.x + SBW, p.y + 48},
-                DS::Col(DS::ACCENT_BLUE), 4.0f);
+            ImDrawList* dl = ImGui::GetWindowDrawList();
+            Widget::Retained(dl, Geo::Key().Mix('N').Mix(SBW).h, p, [&] {
+                dl->AddRectFilled(
+                    {p.x + 6, p.y}, {p.x + SBW - 6, p.y + 56},
+                    DS::ColA(DS::ACCENT_BLUE, 0.18f), 12.0f);
+                dl->AddRectFilled(
+                    {p.x + SBW - 4, p.y + 8}, {p.x + SBW, p.y + 48},
+                    DS::Col(DS::ACCENT_BLUE), 4.0f);
+            });
         }
         ImGui::PushStyleColor(ImGuiCol_Text, sel ? DS::ACCENT_BLUE : DS::TEXT_TERTIARY);
         ImGui::SetCursorPosX((SBW - ImGui::CalcTextSize(navItems[i].icon).x) * 0.5f);
@@ -1215,17 +2286,26 @@ static void RenderUI() {
             {hp.x, hp.y+HH}, {hp.x+contentW, hp.y+HH},
             DS::Col(DS::BG_SEPARATOR), 1.0f);
 
-        static const char* titles[] = {"Boost Engine","Deep Clean","Game Launch","Phonk Player"};
+        static const char* titles[] = {"Boost Engine","Deep Clean","Game Launch","Phonk Player","System Stats"};
         ImGui::SetCursorPos({20, 20});
         ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_PRIMARY);
         ImGui::Text("%s", titles[g_app.activeTab]);
         ImGui::PopStyleColor();
 
-        // FPS counter top right
-        ImGui::SetCursorPos({contentW - 90.0f, 22});
+        // Frame counter top right: drawn vs. refreshes skipped while idle
+        const Anim::FramePacer::Stats ps = g_pacer.GetStats();
+        char fc[64];
+        snprintf(fc, sizeof(fc), "%llu drawn · %llu idle",
+                 (unsigned long long)ps.rendered, (unsigned long long)ps.skipped);
+        ImGui::SetCursorPos({contentW - 20.0f - ImGui::CalcTextSize(fc).x, 22});
         ImGui::PushStyleColor(ImGuiCol_Text, DS::TEXT_TERTIARY);
-        ImGui::Text("%.0f FPS", io.Framerate);
+        ImGui::Text("%s", fc);
         ImGui::PopStyleColor();
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("%.0f FPS while animating\n%llu cross-thread wakeups\n"
+                              "%d vertices, %d indices last frame (%llu replayed)",
+                              io.Framerate, (unsigned long long)ps.wakeups, g_frameGeo.vtx, g_frameGeo.idx,
+                              (unsigned long long)g_geo.Last().vtxReplayed);
 
         ImGui::Dummy({0, HH});
     }
@@ -1237,11 +2317,17 @@ static void RenderUI() {
     ImGui::PopStyleVar();
     ImGui::Dummy({0, 14});
 
-    switch (g_app.activeTab) {
-        case 0: RenderBoostPanel();  break;
-        case 1: RenderCleanPanel();  break;
-        case 2: RenderLaunchPanel(); break;
-        case 3: RenderPhonkPanel();  break;
+    // Each panel is timed while xopt-uibench records; otherwise a null check
+    static const char* const kPanels[] = { "Boost", "Clean", "Launch", "Phonk", "Stats" };
+    {
+        UiBench::PanelScope scope(kPanels[std::clamp(g_app.activeTab, 0, 4)]);
+        switch (g_app.activeTab) {
+            case 0: RenderBoostPanel();  break;
+            case 1: RenderCleanPanel();  break;
+            case 2: RenderLaunchPanel(); break;
+            case 3: RenderPhonkPanel();  break;
+            case 4: RenderStatsPanel();  break;
+        }
     }
 
     ImGui::Dummy({0, 20});
@@ -1253,6 +2339,9 @@ static void RenderUI() {
 
     // Notifications
     Widget::RenderNotifs();
+
+    // Blinking caret in a focused text field (ImGui blinks on a 1.2 s cycle)
+    if (io.WantTextInput) g_pacer.WakeIn(0.4);
 }
 
 // ──────────────────────────────────────────────────────────────────────────────
@@ -1315,6 +2404,161 @@ static void ApplyIOSStyle() {
     c[ImGuiCol_NavHighlight]          = DS::ACCENT_BLUE;
 }
 
+// ──────────────────────────────────────────────────────────────────────────────
+//  FONTS  (baked once, then mapped back from the font cache)
+// ──────────────────────────────────────────────────────────────────────────────
+// The restore fills ImGui's baked atlas by hand.  ImGui 1.92 rasterizes
+// glyphs on demand and has no baked atlas to cache, so it always bakes.
+#if IMGUI_VERSION_NUM >= 18900 && IMGUI_VERSION_NUM < 19200
+#define XOPT_FONT_CACHE 1
+#else
+#define XOPT_FONT_CACHE 0
+#endif
+
+static constexpr float kFontSize = 15.0f;
+
+// Everything the atlas depends on besides the font file; all 4-byte fields
+// so there is no padding in the key
+struct FontSettings { float size; int32_t overH, overV, imgui; };
+static const FontSettings kFontSettings = { kFontSize, 3, 2, IMGUI_VERSION_NUM };
+
+static fs::path FindUiFont() {
+    const wchar_t* fontPaths[] = {
+        L"C:\\Windows\\Fonts\\segoeui.ttf",
+        L"C:\\Windows\\Fonts\\calibri.ttf",
+        L"C:\\Windows\\Fonts\\tahoma.ttf",
+    };
+    std::error_code ec;
+    for (auto& fp : fontPaths)
+        if (fs::exists(fp, ec)) return fp;
+    return {};
+}
+
+#if XOPT_FONT_CACHE
+// Rebuilds the atlas exactly as Build() left it when the cache was saved
+static bool RestoreFontAtlas(ImFontAtlas* atlas, const FontCache::Atlas& c) {
+    if (c.fontCount != 1 || c.lineCount > (uint32_t)IM_ARRAYSIZE(atlas->TexUvLines)) return false;
+    const FontCache::Font& f = c.fonts[0];
+    atlas->Clear();
+    atlas->TexWidth   = (int)c.width;
+    atlas->TexHeight  = (int)c.height;
+    atlas->TexUvScale = ImVec2(1.0f / c.width, 1.0f / c.height);
+    atlas->TexUvWhitePixel = ImVec2(c.whiteU, c.whiteV);
+    for (uint32_t i = 0; i < c.lineCount; i++)
+        atlas->TexUvLines[i] = ImVec4(c.lines[i].u0, c.lines[i].v0, c.lines[i].u1, c.lines[i].v1);
+    if (!c.lineCount) atlas->Flags |= ImFontAtlasFlags_NoBakedLines;
+
+    ImFontConfig cfg{};
+    cfg.SizePixels  = f.size;
+    cfg.OversampleH = kFontSettings.overH;
+    cfg.OversampleV = kFontSettings.overV;
+    cfg.FontDataOwnedByAtlas = false;           // no TTF data: nothing to rasterize from
+    atlas->ConfigData.push_back(cfg);
+    ImFont* font = IM_NEW(ImFont);
+    atlas->Fonts.push_back(font);
+    ImFontConfig& src = atlas->ConfigData.back();
+    src.DstFont           = font;
+    font->ContainerAtlas  = atlas;
+    font->ConfigData      = &src;
+    font->ConfigDataCount = 1;
+    font->FontSize        = f.size;
+    font->Ascent          = f.ascent;
+    font->Descent         = f.descent;
+    font->Glyphs.reserve((int)f.glyphCount);
+    for (uint32_t i = 0; i < f.glyphCount; i++) {
+        const FontCache::Glyph& g = c.glyphs[f.firstGlyph + i];
+        // No config: AddGlyph stores the baked metrics as they are
+        font->AddGlyph(nullptr, (ImWchar)g.codepoint, g.x0, g.y0, g.x1, g.y1, g.u0, g.v0, g.u1, g.v1, g.advanceX);
+        font->Glyphs.back().Visible = (g.flags & FontCache::Glyph::kVisible) != 0;
+        font->Glyphs.back().Colored = (g.flags & FontCache::Glyph::kColored) != 0;
+    }
+    font->BuildLookupTable();
+
+    // ImGui frees the pixels itself, so they are copied out of the mapping
+    const size_t n = (size_t)c.width * c.height;
+    atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(n);
+    std::memcpy(atlas->TexPixelsAlpha8, c.pixels, n);
+    atlas->TexReady = true;
+    return true;
+}
+
+static bool SaveFontAtlas(ImFontAtlas* atlas, const fs::path& cache, const fs::path& source, uint64_t key) {
+    unsigned char* px = nullptr;
+    int w = 0, h = 0;
+    atlas->GetTexDataAsAlpha8(&px, &w, &h);     // builds
+    if (!px || atlas->Fonts.Size != 1) return false;
+    const ImFont* font = atlas->Fonts[0];
+    std::vector<FontCache::Glyph> glyphs((size_t)font->Glyphs.Size);
+    for (int i = 0; i < font->Glyphs.Size; i++) {
+        const ImFontGlyph& s = font->Glyphs[i];
+        FontCache::Glyph&  g = glyphs[(size_t)i];
+        g.codepoint = s.Codepoint;
+        g.flags     = (s.Visible ? FontCache::Glyph::kVisible : 0u) | (s.Colored ? FontCache::Glyph::kColored : 0u);
+        g.advanceX  = s.AdvanceX;
+        g.x0 = s.X0; g.y0 = s.Y0; g.x1 = s.X1; g.y1 = s.Y1;
+        g.u0 = s.U0; g.v0 = s.V0; g.u1 = s.U1; g.v1 = s.V1;
+    }
+    std::vector<FontCache::LineUv> lines;
+    if (!(atlas->Flags & ImFontAtlasFlags_NoBakedLines))
+        for (const ImVec4& l : atlas->TexUvLines) lines.push_back({ l.x, l.y, l.z, l.w });
+    const FontCache::Font f{ font->FontSize, font->Ascent, font->Descent, 0, (uint32_t)glyphs.size() };
+
+    FontCache::Atlas a;
+    a.key    = key;
+    a.width  = (uint32_t)w;  a.height = (uint32_t)h;
+    a.whiteU = atlas->TexUvWhitePixel.x;  a.whiteV = atlas->TexUvWhitePixel.y;
+    a.fonts  = &f;             a.fontCount  = 1;
+    a.glyphs = glyphs.data();  a.glyphCount = (uint32_t)glyphs.size();
+    a.lines  = lines.data();   a.lineCount  = (uint32_t)lines.size();
+    a.pixels = px;
+    a.source = source.u8string();
+    return FontCache::Save(cache, a);
+}
+#endif
+
+// Maps the cached atlas when it was baked from the same font file with the
+// same settings; otherwise probes the system fonts, bakes and saves it.
+// The cache records its font, so a warm start stats only that one file.
+static void LoadFonts(ImGuiIO& io, bool useCache) {
+    XOPT_ZONE("LoadFonts");
+    const auto t0 = std::chrono::steady_clock::now();
+    auto done = [&](const char* cache) {
+        g_startup.fontCache = cache;
+        g_startup.fontMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+#if XOPT_FONT_CACHE
+    const fs::path cachePath = FontCache::DefaultPath(Sys::Native());
+    if (useCache) {
+        FontCache::Cache c;
+        if (c.Open(cachePath)) {
+            const fs::path src = fs::u8path(c.Get().source);
+            if (FontCache::Key(src, &kFontSettings, sizeof(kFontSettings)) == c.Get().key &&
+                RestoreFontAtlas(io.Fonts, c.Get()))
+                return done("hit");
+            io.Fonts->Clear();
+        }
+    }
+#endif
+    const fs::path font = FindUiFont();
+    if (font.empty()) {
+        io.Fonts->AddFontDefault();
+        return done("off");
+    }
+    ImFontConfig fc{}; fc.OversampleH = kFontSettings.overH; fc.OversampleV = kFontSettings.overV;
+    io.Fonts->AddFontFromFileTTF(font.u8string().c_str(), kFontSize, &fc);
+#if XOPT_FONT_CACHE
+    if (useCache) {
+        const uint64_t key = FontCache::Key(font, &kFontSettings, sizeof(kFontSettings));
+        return done(key && SaveFontAtlas(io.Fonts, cachePath, font, key) ? "miss" : "off");
+    }
+#else
+    (void)useCache;
+#endif
+    io.Fonts->Build();                          // bake here so the timing compares like for like
+    done("off");
+}
+
+#if !XOPT_UI_HEADLESS
 // ──────────────────────────────────────────────────────────────────────────────
 //  DIRECTX 11 HELPERS
 // ──────────────────────────────────────────────────────────────────────────────
@@ -1387,10 +2631,52 @@ static LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     return DefWindowProcW(hWnd, msg, wParam, lParam);
 }
 
+// ──────────────────────────────────────────────────────────────────────────────
+//  STARTUP BENCHMARK
+// ──────────────────────────────────────────────────────────────────────────────
+// --bench-startup FILE appends this start's timings to FILE (one JSON object
+// per line) and exits after the first frame; --no-font-cache bakes the atlas
+// even when a cached one would do, for the cold number
+struct LaunchArgs {
+    bool     noFontCache = false;
+    fs::path benchStartup;
+};
+
+static LaunchArgs ParseLaunchArgs() {
+    LaunchArgs a;
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    for (int i = 1; argv && i < argc; i++) {
+        if (!wcscmp(argv[i], L"--no-font-cache")) a.noFontCache = true;
+        else if (!wcscmp(argv[i], L"--bench-startup") && i + 1 < argc) a.benchStartup = argv[++i];
+    }
+    LocalFree(argv);
+    return a;
+}
+
+// Since the process was created, so loader and CRT start-up count too
+static double MsSinceProcessStart() {
+    FILETIME created{}, exited{}, kernel{}, user{}, now{};
+    GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user);
+    GetSystemTimePreciseAsFileTime(&now);
+    auto ticks = [](FILETIME f) { return (int64_t)(((uint64_t)f.dwHighDateTime << 32) | f.dwLowDateTime); };
+    return (double)(ticks(now) - ticks(created)) / 1e4;            // 100 ns ticks
+}
+
+static void WriteStartupBench(const fs::path& file) {
+    char line[192];
+    snprintf(line, sizeof(line),
+                  "{\"first_frame_ms\":%.3f,\"font_ms\":%.3f,\"font_cache\":\"%s\",\"imgui\":%d}\n",
+                  g_startup.firstFrameMs, g_startup.fontMs, g_startup.fontCache, IMGUI_VERSION_NUM);
+    std::ofstream(file, std::ios::app) << line;
+}
+
 // ──────────────────────────────────────────────────────────────────────────────
 //  ENTRY POINT
 // ──────────────────────────────────────────────────────────────────────────────
 int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int) {
+    Prof::SetThreadName("ui");
+    const LaunchArgs args = ParseLaunchArgs();
     // Request admin privileges reminder (soft, non-blocking)
     // Real UAC elevation should be handled by manifest or ShellExecute runas
 
@@ -1438,59 +2724,100 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int) {
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
-    // Load Segoe UI from system for clean iOS-like font
-    float fontSize = 15.0f;
-    ImFontConfig fc{}; fc.OversampleH = 3; fc.OversampleV = 2;
-    bool loaded = false;
-    const wchar_t* fontPaths[] = {
-        L"C:\\Windows\\Fonts\\segoeui.ttf",
-        L"C:\\Windows\\Fonts\\calibri.ttf",
-        L"C:\\Windows\\Fonts\\tahoma.ttf",
-    };
-    for (auto& fp : fontPaths) {
-        char narrow[MAX_PATH];
-        WideCharToMultiByte(CP_ACP, 0, fp, -1, narrow, MAX_PATH, nullptr, nullptr);
-        if (fs::exists(narrow)) {
-            io.Fonts->AddFontFromFileTTF(narrow, fontSize, &fc);
-            loaded = true; break;
-        }
-    }
-    if (!loaded) io.Fonts->AddFontDefault();
+    // Segoe UI from the system for the clean iOS-like look, mapped from the
+    // font cache after the first start
+    LoadFonts(io, !args.noFontCache);
 
     ApplyIOSStyle();
     ImGui_ImplWin32_Init(hwnd);
     ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
 
     // Welcome notification
-    g_app.PushNotif("X-OPT Engine ready — apply boosts from the sidebar", DS::ACCENT_BLUE);
-
-    // Main loop
-    bool running = true;
+    g_app.PushNotif(Events::Source::App, "X-OPT Engine ready — apply boosts from the sidebar", DS::ACCENT_BLUE);
+    Opt::LoadProfiles();
+    Opt::LoadScore();
+    g_telemetry.Start();
+    Opt::StartReclaimer();
+
+    // Main loop — event driven: block on the message queue unless the pacer
+    // has a frame due.  Minimised / occluded windows render nothing at all.
+    {
+        DEVMODEW dm{}; dm.dmSize = sizeof(dm);
+        if (EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &dm) && dm.dmDisplayFrequency > 1)
+            g_pacer.SetRefresh(dm.dmDisplayFrequency);
+    }
+    g_pacer.SetWakeHook([](void* h) { PostMessageW((HWND)h, WM_NULL, 0, 0); }, hwnd);
+    const auto t0 = std::chrono::steady_clock::now();
+    auto now = [t0] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count(); };
+    bool running  = true;
+    bool occluded = false;
     while (running) {
+        const bool hidden = IsIconic(hwnd) || occluded;
+        // Music keeps the playlist serviced (track advance) without drawing
+        const DWORD tick = g_app.phonkPlaying ? 50 : INFINITE;
+        DWORD wait = tick;
+        if (occluded) wait = std::min<DWORD>(wait, 100);            // re-test Present below
+        else if (!hidden) {
+            const double s = g_pacer.WaitSeconds(now());
+            if (s >= 0.0) wait = std::min<DWORD>(wait, (DWORD)std::ceil(s * 1000.0));
+        }
+        if (wait) MsgWaitForMultipleObjectsEx(0, nullptr, wait, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
         MSG msg;
         while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
             TranslateMessage(&msg);
             DispatchMessageW(&msg);
             if (msg.message == WM_QUIT) running = false;
+            g_pacer.RequestFrames(Anim::FramePacer::kInputFrames);   // hover / layout settle
         }
         if (!running) break;
 
+        Phonk::Update();
+        Opt::Update();
+        if (occluded) {
+            occluded = g_pSwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED;
+            if (occluded) continue;
+            g_pacer.RequestFrames(1);
+        }
+        if (IsIconic(hwnd) || !g_pacer.ShouldRender(now())) continue;
+
+        g_pacer.BeginFrame(now());
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
 
         RenderUI();
+        // The first frame after an idle stretch carries the whole gap as its
+        // delta; clamp it so springs resume instead of jumping ahead
+        g_anim.EndFrame(std::min(io.DeltaTime, 1.0f / 30.0f));
+        if (g_anim.Active()) g_pacer.KeepAlive();
 
         ImGui::Render();
+        if (const ImDrawData* dd = ImGui::GetDrawData())
+            g_frameGeo = { dd->TotalVtxCount, dd->TotalIdxCount, dd->CmdListsCount };
+        g_geo.EndFrame();
 
         constexpr float cc[4] = {0.0f, 0.0f, 0.0f, 1.0f};
         g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
         g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, cc);
         ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
-        g_pSwapChain->Present(1, 0); // VSync on
+        occluded = g_pSwapChain->Present(1, 0) == DXGI_STATUS_OCCLUDED;   // VSync on
+        g_pacer.EndFrame(now());
+        if (g_startup.firstFrameMs == 0.0) {
+            g_startup.firstFrameMs = MsSinceProcessStart();
+            if (!args.benchStartup.empty()) {
+                WriteStartupBench(args.benchStartup);
+                running = false;
+            }
+        }
     }
 
     Phonk::Stop();
+    Opt::WaitMeasure();
+    Opt::StopGovernor();
+    Opt::StopReclaimer();
+    g_latency.Stop();
+    g_telemetry.Stop();
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
@@ -1499,3 +2826,46 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int) {
     UnregisterClassW(wc.lpszClassName, hInst);
     return 0;
 }
+
+#else  // XOPT_UI_HEADLESS
+// ──────────────────────────────────────────────────────────────────────────────
+//  HEADLESS HOST  (xopt-uibench: no window, no device, no message loop)
+// ──────────────────────────────────────────────────────────────────────────────
+namespace UiHost {
+
+    void Init(bool fontCache) {
+        Prof::SetThreadName("ui");
+        ImGuiIO& io = ImGui::GetIO();
+        LoadFonts(io, fontCache);
+        ApplyIOSStyle();
+        // The same state a start shows; the samplers and the governor stay
+        // off, so a run never touches the machine it measures
+        g_app.PushNotif(Events::Source::App, "X-OPT Engine ready — apply boosts from the sidebar", DS::ACCENT_BLUE);
+        Opt::LoadProfiles();
+        Opt::LoadScore();
+    }
+
+    ImDrawData* Frame() {
+        ImGuiIO& io = ImGui::GetIO();
+        ImGui::NewFrame();
+        RenderUI();
+        g_anim.EndFrame(std::min(io.DeltaTime, 1.0f / 30.0f));
+        ImGui::Render();
+        ImDrawData* dd = ImGui::GetDrawData();
+        if (dd) g_frameGeo = { dd->TotalVtxCount, dd->TotalIdxCount, dd->CmdListsCount };
+        g_geo.EndFrame();
+        return dd;
+    }
+
+    int  Tabs()          { return 5; }
+    void SetTab(int tab) { g_app.activeTab = std::clamp(tab, 0, Tabs() - 1); }
+
+    void Shutdown() {
+        Phonk::Stop();
+        Opt::WaitMeasure();
+        Opt::StopGovernor();
+        Opt::StopReclaimer();
+    }
+
+}  // namespace UiHost
+#endif  // XOPT_UI_HEADLESS
@@ -0,0 +1,109 @@
+#include "mapped_file.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IO {
+
+    namespace fs = std::filesystem;
+
+    MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+        if (this != &o) {
+            Close();
+            std::swap(m_data, o.m_data);
+            std::swap(m_size, o.m_size);
+#ifdef _WIN32
+            std::swap(m_file, o.m_file);
+            std::swap(m_mapping, o.m_mapping);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::Open(const fs::path& p) {
+        Close();
+        HANDLE f = CreateFileW(p.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (f == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz{};
+        if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) { CloseHandle(f); return false; }
+        HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m) { CloseHandle(f); return false; }
+        void* v = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+        if (!v) { CloseHandle(m); CloseHandle(f); return false; }
+        m_file = f; m_mapping = m;
+        m_data = (const uint8_t*)v;
+        m_size = (size_t)sz.QuadPart;
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if (m_data)    UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle((HANDLE)m_mapping);
+        if (m_file)    CloseHandle((HANDLE)m_file);
+        m_data = nullptr; m_size = 0; m_mapping = nullptr; m_file = nullptr;
+    }
+#else
+    bool MappedFile::Open(const fs::path& p) {
+        Close();
+        int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+        void* v = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   // the mapping keeps the file alive
+        if (v == MAP_FAILED) return false;
+        m_data = (const uint8_t*)v;
+        m_size = (size_t)st.st_size;
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if (m_data) ::munmap((void*)m_data, m_size);
+        m_data = nullptr; m_size = 0;
+    }
+#endif
+
+    bool WriteFileAtomic(const fs::path& p, const void* data, size_t size) {
+        std::error_code ec;
+        if (p.has_parent_path()) fs::create_directories(p.parent_path(), ec);
+        fs::path tmp = p;
+        tmp += ".tmp";
+#ifdef _WIN32
+        FILE* f = _wfopen(tmp.c_str(), L"wb");
+#else
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+#endif
+        if (!f) return false;
+        bool ok = std::fwrite(data, 1, size, f) == size;
+        ok = (std::fflush(f) == 0) && ok;
+        // On disk before the rename, or a crash can leave an empty file behind
+#ifdef _WIN32
+        ok = (_commit(_fileno(f)) == 0) && ok;
+#else
+        ok = (::fsync(fileno(f)) == 0) && ok;
+#endif
+        std::fclose(f);
+        if (!ok) { fs::remove(tmp, ec); return false; }
+        fs::rename(tmp, p, ec);
+        if (ec) { fs::remove(tmp, ec); return false; }
+        return true;
+    }
+
+}  // namespace IO
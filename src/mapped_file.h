@@ -0,0 +1,42 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  MAPPED FILE  —  read-only memory map + crash-safe whole-file writes
+// ──────────────────────────────────────────────────────────────────────────────
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+
+namespace IO {
+
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& o) noexcept { *this = std::move(o); }
+        MappedFile& operator=(MappedFile&& o) noexcept;
+
+        bool Open(const std::filesystem::path& p);   // false if missing / empty
+        void Close();
+
+        const uint8_t* Data() const { return m_data; }
+        size_t         Size() const { return m_size; }
+        bool           IsOpen() const { return m_data != nullptr; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t         m_size = 0;
+#ifdef _WIN32
+        void*          m_file    = nullptr;   // HANDLE
+        void*          m_mapping = nullptr;   // HANDLE
+#endif
+    };
+
+    // Write to "<p>.tmp", sync, then rename over `p`, so readers never see a
+    // torn file — not even after a power cut
+    bool WriteFileAtomic(const std::filesystem::path& p, const void* data, size_t size);
+
+}  // namespace IO
@@ -0,0 +1,101 @@
+#include "memory_reclaimer.h"
+#include "profiler.h"
+
+#include <algorithm>
+
+namespace Reclaim {
+
+    bool Reclaimer::Poll(Report& out, bool force) {
+        XOPT_ZONE("Reclaim::Poll");
+        out = Report{};
+        const Clock::time_point now = Clock::now();
+        if (!m_be.Processes(m_procs) || !m_be.Memory(out.total, out.availableBefore)) return false;
+        out.availableAfter = out.availableBefore;
+
+        // Idle tracking: a process first seen counts as busy now, so nothing
+        // is reclaimed before it has been watched for minIdleSec
+        std::map<uint32_t, Seen> seen;
+        for (const Sys::ProcessInfo& p : m_procs) {
+            auto it = m_seen.find(p.pid);
+            Seen s = it != m_seen.end() ? it->second : Seen{ p.cpuNs, now };
+            if (p.cpuNs != s.cpuNs) s = Seen{ p.cpuNs, now };
+            seen[p.pid] = s;
+        }
+        m_seen.swap(seen);
+
+        const uint64_t low    = (uint64_t)((double)out.total * m_opt.lowPct / 100.0);
+        const uint64_t target = (uint64_t)((double)out.total * m_opt.targetPct / 100.0);
+        out.triggered = force || out.availableBefore < low;
+        if (!out.triggered) return true;
+        uint64_t need = target > out.availableBefore ? target - out.availableBefore : 0;
+        if (force && !need) need = UINT64_MAX;             // forced with room to spare: take what ranks
+
+        // Off limits: the game's tree, X-OPT, kernel threads — and any memory
+        // group one of them lives in
+        std::vector<uint32_t> keep = m_protect ? Sys::ProcessTree(m_procs, m_protect) : std::vector<uint32_t>{};
+        keep.push_back(Sys::CurrentPid());
+        std::vector<std::string> keepGroups;
+        for (uint32_t pid : keep) {
+            std::string g;
+            if (m_be.MemoryGroup(pid, g)) keepGroups.push_back(g);
+        }
+
+        const std::vector<uint32_t> scope = m_opt.onlyTree ? Sys::ProcessTree(m_procs, m_opt.onlyTree)
+                                                           : std::vector<uint32_t>{};
+        struct Candidate { Action a; double score; uint64_t top; };
+        std::vector<Candidate> cand;
+        std::map<std::string, size_t> byGroup;
+        for (const Sys::ProcessInfo& p : m_procs) {
+            if (p.system || std::find(keep.begin(), keep.end(), p.pid) != keep.end()) continue;
+            if (!scope.empty() && std::find(scope.begin(), scope.end(), p.pid) == scope.end()) continue;
+            const double idle = std::chrono::duration<double>(now - m_seen[p.pid].busy).count();
+            if (idle < m_opt.minIdleSec) continue;
+            std::string g;
+            const bool grouped = m_be.MemoryGroup(p.pid, g) &&
+                                 std::find(keepGroups.begin(), keepGroups.end(), g) == keepGroups.end();
+            if (grouped) {
+                auto it = byGroup.find(g);
+                if (it != byGroup.end()) {                 // one action per group
+                    Candidate& c = cand[it->second];
+                    Action&    a = c.a;
+                    if (p.resident > c.top) { a.pid = p.pid; a.name = p.name; c.top = p.resident; }
+                    a.members++;
+                    a.resident += p.resident;
+                    a.idleSec   = std::min(a.idleSec, idle);
+                    continue;
+                }
+                byGroup[g] = cand.size();
+            }
+            Action a;
+            a.pid      = p.pid;
+            a.name     = p.name;
+            a.group    = grouped ? g : std::string();
+            a.resident = p.resident;
+            a.idleSec  = idle;
+            cand.push_back({ std::move(a), 0.0, p.resident });
+        }
+        for (Candidate& c : cand) {
+            const double weight = m_opt.minIdleSec > 0.0 ? std::min(4.0, c.a.idleSec / m_opt.minIdleSec) : 4.0;
+            c.score = (double)c.a.resident * std::max(1.0, weight);
+        }
+        cand.erase(std::remove_if(cand.begin(), cand.end(),
+                                  [this](const Candidate& c) { return c.a.resident < m_opt.minResident; }),
+                   cand.end());
+        std::sort(cand.begin(), cand.end(), [](const Candidate& x, const Candidate& y) { return x.score > y.score; });
+
+        for (Candidate& c : cand) {
+            if (out.reclaimed >= need || out.actions.size() >= m_opt.maxActions) break;
+            Action& a = c.a;
+            Sys::SetCallError(Tweaks::Error::None);
+            a.ok = a.group.empty() ? m_be.TrimProcess(a.pid, a.reclaimed)
+                                   : m_be.ReclaimGroup(a.group, std::min(need - out.reclaimed, a.resident), a.reclaimed);
+            if (!a.ok) a.error = Sys::CallError();
+            out.reclaimed += a.reclaimed;
+            out.actions.push_back(std::move(a));
+        }
+        uint64_t total = 0;
+        if (!out.actions.empty()) m_be.Memory(total, out.availableAfter);
+        return true;
+    }
+
+}  // namespace Reclaim
@@ -0,0 +1,86 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  MEMORY RECLAIMER  —  give the game RAM back from whatever sits idle on it
+// ──────────────────────────────────────────────────────────────────────────────
+//  Poll() (every couple of seconds) tracks each process's CPU time, so it
+//  knows how long each has been idle, and checks available memory.  Below
+//  `lowPct` of RAM it reclaims until `targetPct` is available again, taking
+//  background processes by rank: resident size, weighted up by idle time
+//  (up to 4x at four times `minIdleSec`).  Processes busy more recently than
+//  `minIdleSec`, or smaller than `minResident`, are left alone.
+//
+//  A process in its own memory group (cgroup v2 on Linux) is reclaimed
+//  through the group, which also takes its page cache; otherwise its
+//  working set is trimmed (MADV_PAGEOUT / EmptyWorkingSet).  A group that
+//  also holds a protected process — the game's tree, or X-OPT itself — is
+//  never reclaimed as a group.  Every action reports the bytes it measured
+//  coming back.  Not thread-safe: one thread owns a Reclaimer.
+#pragma once
+
+#include "backend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Reclaim {
+
+    struct Options {
+        double   lowPct      = 10.0;            // act below this much RAM available
+        double   targetPct   = 20.0;            // … and stop once this much is
+        double   minIdleSec  = 30.0;
+        uint64_t minResident = 32ull << 20;
+        unsigned maxActions  = 16;              // per pass
+        uint32_t onlyTree    = 0;               // nonzero: only this process's descendants
+    };
+
+    struct Action {
+        uint32_t      pid       = 0;            // the group's largest member, for groups
+        std::string   name;
+        std::string   group;                    // empty: trimmed on its own
+        unsigned      members   = 1;
+        uint64_t      resident  = 0;            // bytes before, all members
+        double        idleSec   = 0.0;
+        uint64_t      reclaimed = 0;            // measured
+        bool          ok        = false;
+        Tweaks::Error error     = Tweaks::Error::None;
+    };
+
+    struct Report {
+        bool                triggered = false;  // below lowPct (or forced)
+        uint64_t            total = 0, availableBefore = 0, availableAfter = 0;
+        uint64_t            reclaimed = 0;      // sum over actions
+        std::vector<Action> actions;
+    };
+
+    class Reclaimer {
+    public:
+        explicit Reclaimer(Sys::Backend& be, Options o = {}) : m_be(be), m_opt(o) {}
+
+        // The game's root: it and everything it starts are never touched
+        void Protect(uint32_t rootPid) { m_protect = rootPid; }
+        void SetOptions(const Options& o) { m_opt = o; }
+
+        // Updates idle times; reclaims if memory is low (or `force`).
+        // False if the process table or memory status was unreadable.
+        bool Poll(Report& out, bool force = false);
+
+        const Options& GetOptions() const { return m_opt; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Seen {
+            uint64_t          cpuNs = 0;
+            Clock::time_point busy{};       // last time its CPU time moved
+        };
+
+        Sys::Backend&                 m_be;
+        Options                       m_opt;
+        uint32_t                      m_protect = 0;
+        std::map<uint32_t, Seen>      m_seen;
+        std::vector<Sys::ProcessInfo> m_procs;
+    };
+
+}  // namespace Reclaim
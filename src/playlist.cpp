@@ -0,0 +1,266 @@
+#include "playlist.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+namespace Audio {
+
+    using Clock = std::chrono::steady_clock;
+
+    static double MsSince(Clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    }
+
+    Playlist::Playlist() {
+        m_thread = std::thread([this] { Worker(); });
+    }
+
+    Playlist::~Playlist() {
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_quit = true;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    void Playlist::LoadFolder(const fs::path& dir, bool autoplay) {
+        m_loading  = true;
+        m_autoplay = autoplay;
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_scanReq = dir;
+            ++m_scanGen;
+        }
+        m_cv.notify_all();
+    }
+
+    void Playlist::SetTracks(std::vector<fs::path> tracks) {
+        m_tracks    = std::move(tracks);
+        m_gen++;
+        m_current   = m_queued = m_spareIndex = -1;
+        m_spare.reset();
+        m_dropQueued = true;
+        m_lru.clear();
+        m_lruIndex.clear();
+        m_metaPending.clear();
+        std::lock_guard<std::mutex> lk(m_mx);
+        m_metaReq.clear();
+        m_metaGen        = m_gen;
+        m_prefetchWanted = false;
+    }
+
+    const TrackInfo* Playlist::Info(size_t i) {
+        if (i >= m_tracks.size()) return nullptr;
+        auto it = m_lruIndex.find(i);
+        if (it != m_lruIndex.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            m_stats.metaHits++;
+            return &it->second->second;
+        }
+        if (m_metaPending.insert(i).second) {
+            m_stats.metaMisses++;
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_metaReq.emplace_back(i, m_tracks[i]);
+            // Rows scrolled past long ago aren't worth reading any more
+            while (m_metaReq.size() > kMetaQueue) {
+                m_metaPending.erase(m_metaReq.front().first);
+                m_metaReq.pop_front();
+            }
+            m_cv.notify_all();
+        }
+        return nullptr;
+    }
+
+    void Playlist::RequestPrefetch(int index) {
+        if (m_spareIndex != index) { m_spare.reset(); m_spareIndex = -1; }
+        if (index < 0 || (size_t)index >= m_tracks.size()) return;
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_prefetchWanted = true;
+            m_prefetchIndex  = index;
+            m_prefetchGen    = m_gen;
+            m_prefetchPath   = m_tracks[(size_t)index];
+        }
+        m_cv.notify_all();
+    }
+
+    bool Playlist::Play(Engine& eng, size_t i, std::string* error) {
+        if (!Open(eng, i, error)) return false;
+        eng.Play();
+        return true;
+    }
+
+    bool Playlist::Open(Engine& eng, size_t i, std::string* error) {
+        if (i >= m_tracks.size()) return false;
+        // Reuse whatever was already opened for this index: the engine's
+        // queued successor or the format-mismatch spare
+        std::unique_ptr<Decoder> dec;
+        if (m_queued == (int)i) dec = eng.TakeNext();
+        if (!dec && m_spareIndex == (int)i) dec = std::move(m_spare);
+        m_spare.reset();
+        m_spareIndex = m_queued = -1;
+        if (!dec) dec = OpenDecoder(m_tracks[i], error);
+        if (!dec || !eng.Open(std::move(dec), error)) return false;
+        m_current   = (int)i;
+        m_seenTrack = 0;
+        m_dropQueued = false;
+        m_stats.reopened++;
+        RequestPrefetch((int)i + 1);
+        return true;
+    }
+
+    bool Playlist::Next(Engine& eng, std::string* error) {
+        return m_current + 1 < (int)m_tracks.size() && Play(eng, (size_t)(m_current + 1), error);
+    }
+
+    bool Playlist::Prev(Engine& eng, std::string* error) {
+        // A few seconds in, "previous" means "from the top" like every player
+        if (m_current <= 0 || eng.Position() > 3.0) {
+            if (!eng.IsOpen()) return false;
+            eng.Seek(0.0);
+            return true;
+        }
+        return Play(eng, (size_t)(m_current - 1), error);
+    }
+
+    void Playlist::Update(Engine& eng) {
+        bool                    scanned = false;
+        std::vector<fs::path>   list;
+        Prefetched              pf;
+        std::vector<MetaResult> meta;
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            if (m_scanDone) {
+                scanned    = true;
+                m_scanDone = false;
+                list.swap(m_scanResult);
+                m_stats.scanMs = m_scanMs;
+            }
+            if (m_prefetchDone.index >= 0) pf = std::move(m_prefetchDone);
+            m_prefetchDone = Prefetched{};
+            meta.swap(m_metaDone);
+        }
+
+        if (scanned) {
+            m_loading = false;
+            SetTracks(std::move(list));
+            if (m_autoplay && !m_tracks.empty()) Play(eng, 0);
+        }
+        if (m_dropQueued) { eng.TakeNext(); m_dropQueued = false; }
+
+        for (MetaResult& r : meta) {
+            if (r.gen != m_gen) continue;
+            m_metaPending.erase(r.index);
+            if (m_lruIndex.count(r.index)) continue;
+            m_lru.emplace_front(r.index, std::move(r.info));
+            m_lruIndex[r.index] = m_lru.begin();
+            if (m_lru.size() > kMetaCache) {
+                m_lruIndex.erase(m_lru.back().first);
+                m_lru.pop_back();
+            }
+        }
+
+        // Hand the pre-decoded successor over while the current track plays
+        if (pf.dec && pf.gen == m_gen && pf.index == m_current + 1 && eng.IsOpen()) {
+            m_stats.prefetchMs = pf.ms;
+            if (eng.QueueNext(pf.dec)) {
+                m_queued = pf.index;
+            } else {
+                m_spare      = std::move(pf.dec);
+                m_spareIndex = pf.index;
+            }
+        }
+
+        // The decoder thread switched tracks without a gap
+        const uint32_t track = eng.Track();
+        if (eng.IsOpen() && track != m_seenTrack) {
+            m_seenTrack = track;
+            m_current   = m_queued;
+            m_queued    = -1;
+            m_stats.gapless++;
+            RequestPrefetch(m_current >= 0 ? m_current + 1 : -1);
+        }
+
+        // Ran out without a queued successor: format change, unreadable file
+        // or the end of the list.  Skip a few bad files rather than stalling.
+        if (eng.Playing() && eng.Finished() && m_current >= 0) {
+            bool started = false;
+            for (int i = m_current + 1, tries = 0; i < (int)m_tracks.size() && tries < 8 && !started; i++, tries++)
+                started = Play(eng, (size_t)i);
+            if (!started && eng.IsOpen()) eng.Pause();
+        }
+    }
+
+    void Playlist::Worker() {
+        std::unique_lock<std::mutex> lk(m_mx);
+        for (;;) {
+            m_cv.wait(lk, [this] {
+                return m_quit || !m_scanReq.empty() || m_prefetchWanted || !m_metaReq.empty();
+            });
+            if (m_quit) return;
+
+            // Next-track prefetch first: it's the only job with a deadline
+            if (m_prefetchWanted) {
+                Prefetched job;
+                job.index = m_prefetchIndex;
+                job.gen   = m_prefetchGen;
+                const fs::path path = m_prefetchPath;
+                m_prefetchWanted = false;
+                lk.unlock();
+                const auto t0 = Clock::now();
+                if (auto dec = OpenDecoder(path)) {
+                    const size_t frames = (size_t)(dec->Fmt().sampleRate * kPrefetchSecs);
+                    job.dec = Prefetch(std::move(dec), frames);
+                }
+                job.ms = MsSince(t0);
+                lk.lock();
+                if (job.gen == m_prefetchGen && !m_prefetchWanted) m_prefetchDone = std::move(job);
+                continue;
+            }
+
+            if (!m_scanReq.empty()) {
+                const fs::path dir = std::move(m_scanReq);
+                const uint64_t gen = m_scanGen;
+                m_scanReq.clear();
+                lk.unlock();
+                const auto t0 = Clock::now();
+                // Paths only; tags are read lazily for the rows on screen
+                std::vector<std::pair<std::string, fs::path>> found;
+                std::error_code ec;
+                for (fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+                     !ec && it != end; it.increment(ec)) {
+                    std::error_code fe;
+                    if (!it->is_regular_file(fe) || !IsAudioFile(it->path())) continue;
+                    std::string key = it->path().generic_u8string();
+                    for (char& c : key) c = (char)std::tolower((unsigned char)c);
+                    found.emplace_back(std::move(key), it->path());
+                }
+                std::sort(found.begin(), found.end(),
+                          [](const auto& a, const auto& b) { return a.first < b.first; });
+                std::vector<fs::path> out;
+                out.reserve(found.size());
+                for (auto& f : found) out.push_back(std::move(f.second));
+                const double ms = MsSince(t0);
+                lk.lock();
+                if (gen == m_scanGen) {
+                    m_scanResult = std::move(out);
+                    m_scanMs     = ms;
+                    m_scanDone   = true;
+                }
+                continue;
+            }
+
+            // Most recently requested rows first — that's what's on screen
+            const auto req = std::move(m_metaReq.back());
+            const uint64_t gen = m_metaGen;
+            m_metaReq.pop_back();
+            lk.unlock();
+            TrackInfo info = ReadTrackInfo(req.second);
+            lk.lock();
+            m_metaDone.push_back({ gen, req.first, std::move(info) });
+        }
+    }
+
+}  // namespace Audio
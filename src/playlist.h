@@ -0,0 +1,132 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  PLAYLIST  —  folder queue, gapless prefetch, lazy metadata
+// ──────────────────────────────────────────────────────────────────────────────
+//  One worker thread does every slow thing: walking folders, opening and
+//  pre-decoding the next track, reading tags.  The UI thread only swaps in
+//  finished results from Update(), so the list, the LRU metadata cache and
+//  the engine calls all stay on one thread without locks on the hot path.
+//  The next track is handed to the engine ahead of time; same-format tracks
+//  switch inside the decoder thread with no gap, others fall back to a quick
+//  re-open using the already-prefetched decoder.
+#pragma once
+
+#include "audio_engine.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Audio {
+
+    struct TrackInfo {
+        std::string title;                  // tag, else the file stem
+        std::string artist;
+        const char* codec   = "";
+        double      seconds = 0.0;          // 0 = unknown (MP3 without decoding)
+        uint32_t    sampleRate = 0;
+    };
+
+    // Tags + length without decoding audio (WAV LIST/INFO, FLAC Vorbis
+    // comments, MP3 ID3v2).  Touches only the header pages of the file.
+    TrackInfo ReadTrackInfo(const fs::path& p);
+
+    bool IsAudioFile(const fs::path& p);
+
+    class Playlist {
+    public:
+        struct Stats {
+            uint64_t gapless    = 0;        // switches done inside the decoder thread
+            uint64_t reopened   = 0;        // format change / manual skip
+            double   scanMs     = 0.0;
+            double   prefetchMs = 0.0;      // last open + pre-decode
+            uint64_t metaHits   = 0, metaMisses = 0;
+        };
+
+        static constexpr size_t kMetaCache    = 512;
+        static constexpr size_t kMetaQueue    = 128;
+        static constexpr double kPrefetchSecs = 2.0;
+
+        Playlist();
+        ~Playlist();
+        Playlist(const Playlist&)            = delete;
+        Playlist& operator=(const Playlist&) = delete;
+
+        // All UI thread ───────────────────────────────────────────────────────
+        // Async, recursive; replaces the list and optionally starts track 0
+        void LoadFolder(const fs::path& dir, bool autoplay = true);
+        void SetTracks(std::vector<fs::path> tracks);
+        bool Loading() const { return m_loading; }
+
+        size_t          Size() const    { return m_tracks.size(); }
+        const fs::path& Path(size_t i) const { return m_tracks[i]; }
+        int             Current() const { return m_current; }
+
+        // Cached tags, or nullptr while the worker reads them — never blocks
+        const TrackInfo* Info(size_t i);
+
+        bool Open(Engine& eng, size_t i, std::string* error = nullptr);    // paused
+        bool Play(Engine& eng, size_t i, std::string* error = nullptr);
+        bool Next(Engine& eng, std::string* error = nullptr);
+        bool Prev(Engine& eng, std::string* error = nullptr);
+
+        // Once per frame: adopt worker results, follow gapless switches,
+        // queue the prefetched successor, advance when a track runs out
+        void  Update(Engine& eng);
+        Stats GetStats() const { return m_stats; }
+
+    private:
+        struct Prefetched {
+            uint64_t                 gen   = 0;
+            int                      index = -1;
+            std::unique_ptr<Decoder> dec;
+            double                   ms    = 0.0;
+        };
+        struct MetaResult { uint64_t gen; size_t index; TrackInfo info; };
+
+        void Worker();
+        void RequestPrefetch(int index);
+
+        // UI-thread state
+        std::vector<fs::path> m_tracks;
+        int                   m_current = -1;
+        int                   m_queued  = -1;       // handed to Engine::QueueNext
+        uint32_t              m_seenTrack = 0;
+        uint64_t              m_gen = 0;            // bumps when the list is replaced
+        bool                  m_loading = false, m_autoplay = false;
+        bool                  m_dropQueued = false;     // list replaced: un-queue the old successor
+        std::unique_ptr<Decoder> m_spare;           // prefetched but format differs
+        int                   m_spareIndex = -1;
+        Stats                 m_stats;
+        std::list<std::pair<size_t, TrackInfo>> m_lru;   // front = most recent
+        std::unordered_map<size_t, std::list<std::pair<size_t, TrackInfo>>::iterator> m_lruIndex;
+        std::unordered_set<size_t> m_metaPending;
+
+        // Shared with the worker (m_mx)
+        std::mutex              m_mx;
+        std::condition_variable m_cv;
+        bool                    m_quit = false;
+        fs::path                m_scanReq;
+        uint64_t                m_scanGen = 0;
+        bool                    m_scanDone = false;
+        std::vector<fs::path>   m_scanResult;
+        double                  m_scanMs = 0.0;
+        bool                    m_prefetchWanted = false;
+        int                     m_prefetchIndex  = -1;
+        uint64_t                m_prefetchGen    = 0;
+        fs::path                m_prefetchPath;
+        Prefetched              m_prefetchDone;
+        std::deque<std::pair<size_t, fs::path>> m_metaReq;   // newest at the back
+        uint64_t                m_metaGen = 0;
+        std::vector<MetaResult> m_metaDone;
+
+        std::thread             m_thread;
+    };
+
+}  // namespace Audio
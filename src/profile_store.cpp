@@ -0,0 +1,281 @@
+#include "profile_store.h"
+#include "backend.h"
+#include "mapped_file.h"
+
+#include <cstring>
+
+namespace Tweaks {
+
+    static const char    kMagic[4] = { 'X', 'O', 'P', '1' };
+    static const uint8_t kOnBit    = 0x80;
+
+    fs::path DefaultStorePath(const Sys::Backend& be) {
+        return be.JournalPath().parent_path() / "profiles.xop";
+    }
+
+    bool ProfileStore::Load(std::string* error) {
+        auto fail = [&](const char* why) {
+            m_profiles = Tweaks::Profiles();
+            m_state = m_tx = TweakState{};
+            m_active.clear();
+            m_txActive.clear();
+            if (error) *error = why;
+            return false;
+        };
+        IO::MappedFile f;
+        if (!f.Open(m_file)) return fail("no profile store yet");
+
+        const uint8_t* p   = f.Data();
+        const uint8_t* end = p + f.Size();
+        StoreHeader    h;
+        if (f.Size() < sizeof(h)) return fail("profile store truncated");
+        std::memcpy(&h, p, sizeof(h));
+        p += sizeof(h);
+        if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion)
+            return fail("profile store has an unknown format");
+
+        const uint16_t all = (uint16_t)((1u << (unsigned)Id::Count) - 1);
+        std::vector<Profile> profiles;
+        for (unsigned i = 0; i < h.profileCount; i++) {
+            if (end - p < 3) return fail("profile store truncated");
+            const size_t nameLen = p[0], descLen = p[1], steps = p[2];
+            p += 3;
+            if ((size_t)(end - p) < nameLen + descLen + steps) return fail("profile store truncated");
+            Profile pr;
+            pr.name.assign((const char*)p, nameLen);  p += nameLen;
+            pr.desc.assign((const char*)p, descLen);  p += descLen;
+            for (size_t s = 0; s < steps; s++, p++) {
+                const Id id = (Id)(*p & ~kOnBit);
+                if (id >= Id::Count) return fail("profile store names an unknown tweak");
+                pr.steps.emplace_back(id, (*p & kOnBit) != 0);
+            }
+            if (pr.name.empty()) return fail("profile store has an unnamed profile");
+            profiles.push_back(std::move(pr));
+        }
+        if (p != end || (h.known | h.txKnown) & ~all) return fail("profile store is corrupt");
+
+        m_profiles = std::move(profiles);
+        m_state    = { h.known, (uint16_t)(h.on & h.known) };
+        m_tx       = { h.txKnown, (uint16_t)(h.txOn & h.txKnown) };
+        m_active   = h.active   < m_profiles.size() ? m_profiles[h.active].name   : std::string();
+        m_txActive = h.txActive < m_profiles.size() ? m_profiles[h.txActive].name : std::string();
+        return true;
+    }
+
+    bool ProfileStore::Save() const {
+        auto indexOf = [this](const std::string& name) -> uint8_t {
+            for (size_t i = 0; i < m_profiles.size(); i++)
+                if (m_profiles[i].name == name) return (uint8_t)i;
+            return kNoProfile;
+        };
+        StoreHeader h{};
+        std::memcpy(h.magic, kMagic, 4);
+        h.version      = kVersion;
+        h.profileCount = (uint8_t)m_profiles.size();
+        h.active       = m_active.empty()   ? kNoProfile : indexOf(m_active);
+        h.txActive     = m_txActive.empty() ? kNoProfile : indexOf(m_txActive);
+        h.known   = m_state.known;  h.on   = m_state.on;
+        h.txKnown = m_tx.known;     h.txOn = m_tx.on;
+
+        std::vector<uint8_t> buf(sizeof(h));
+        std::memcpy(buf.data(), &h, sizeof(h));
+        for (const Profile& pr : m_profiles) {
+            buf.push_back((uint8_t)pr.name.size());
+            buf.push_back((uint8_t)pr.desc.size());
+            buf.push_back((uint8_t)pr.steps.size());
+            buf.insert(buf.end(), pr.name.begin(), pr.name.end());
+            buf.insert(buf.end(), pr.desc.begin(), pr.desc.end());
+            for (auto& st : pr.steps) buf.push_back((uint8_t)((uint8_t)st.first | (st.second ? kOnBit : 0)));
+        }
+        return IO::WriteFileAtomic(m_file, buf.data(), buf.size());
+    }
+
+    bool ProfileStore::Open(Sys::Backend& be, TxResult* recovered, std::string* error) {
+        const bool loaded = Load(error);
+        if (!loaded) Save();                // seed the built-ins so the file exists
+        if (Pending()) Recover(be, recovered);
+        return loaded;
+    }
+
+    const Profile* ProfileStore::Find(const std::string& name) const {
+        for (const Profile& p : m_profiles)
+            if (p.name == name) return &p;
+        return nullptr;
+    }
+
+    bool ProfileStore::Put(const Profile& p) {
+        if (p.name.empty() || p.name.size() > 255 || p.desc.size() > 255 || p.steps.size() > 255) return false;
+        for (auto& st : p.steps)
+            if (st.first >= Id::Count) return false;
+        for (Profile& q : m_profiles)
+            if (q.name == p.name) { q = p; return true; }
+        if (m_profiles.size() >= kMaxProfiles) return false;
+        m_profiles.push_back(p);
+        return true;
+    }
+
+    bool ProfileStore::Remove(const std::string& name) {
+        for (auto it = m_profiles.begin(); it != m_profiles.end(); ++it) {
+            if (it->name != name) continue;
+            m_profiles.erase(it);
+            if (m_active == name) m_active.clear();
+            return true;
+        }
+        return false;
+    }
+
+    TweakState ProfileStore::Current(const Sys::Backend& be) const {
+        TweakState s = m_state;
+        for (unsigned i = 0; i < (unsigned)Id::Count; i++) {
+            bool on;
+            if (be.Supported((Id)i) && be.Get((Id)i, on)) s.Set((Id)i, on);
+        }
+        return s;
+    }
+
+    Profile ProfileStore::Capture(const Sys::Backend& be, const std::string& name) const {
+        const TweakState cur = Current(be);
+        Profile p{ name, "Saved from the tweak state at the time", {} };
+        for (bool boost : { true, false })
+            for (unsigned i = 0; i < (unsigned)Id::Count; i++)
+                if (cur.Has((Id)i) && cur.On((Id)i) == boost) p.steps.emplace_back((Id)i, boost);
+        return p;
+    }
+
+    bool ProfileStore::Begin(Sys::Backend& be, const Profile& p, TxResult& r) {
+        if (Pending()) Recover(be);         // never stack a transaction on an open one
+
+        // Snapshot: what the OS reports, else what we last committed, else
+        // the untouched default (not boosted)
+        TweakState prior;
+        for (auto& st : p.steps) {
+            if (prior.Has(st.first) || !be.Supported(st.first)) continue;
+            bool on = false;
+            if (!be.Get(st.first, on)) on = m_state.Has(st.first) && m_state.On(st.first);
+            prior.Set(st.first, on);
+        }
+
+        // Intent record: must be on disk before the first side effect
+        m_tx       = prior;
+        m_txActive = m_active;
+        if (prior.known && !Save()) {
+            m_tx = TweakState{};
+            m_txActive.clear();
+            r.error = "cannot write " + m_file.u8string();
+            return false;
+        }
+        return true;
+    }
+
+    bool ProfileStore::Commit(const Profile& p, TxResult& r) {
+        // Name the step that broke it, not the ones cancelled after it
+        const StepResult* bad = nullptr;
+        for (const StepResult& s : r.steps)
+            if (s.status == Status::Failed || s.status == Status::TimedOut) { bad = &s; break; }
+        if (bad) {
+            r.error = std::string("'") + Describe(bad->id).key + "' " + StatusName(bad->status);
+            if (bad->error != Error::None && bad->error != Error::Failed && bad->error != Error::TimedOut)
+                r.error += std::string(" (") + ErrorName(bad->error) + ")";
+            return false;
+        }
+        for (const StepResult& s : r.steps)
+            if (s.status == Status::Cancelled) { r.error = "cancelled"; return false; }
+        if (r.steps.size() < p.steps.size()) { r.error = "not every step ran"; return false; }
+
+        const TweakState  prior = m_tx;
+        const std::string was   = m_txActive;
+        const TweakState  state = m_state;
+        for (const StepResult& s : r.steps)
+            if (s.status == Status::Ok) m_state.Set(s.id, s.on);
+        m_active = Find(p.name) ? p.name : std::string();
+        m_tx     = TweakState{};
+        m_txActive.clear();
+        if (Save()) { r.ok = true; return true; }
+        // Commit not durable: the intent on disk would undo it at the next
+        // start anyway, so the caller undoes it now
+        m_state    = state;
+        m_tx       = prior;
+        m_txActive = was;
+        r.error = "cannot commit to " + m_file.u8string();
+        return false;
+    }
+
+    std::vector<Id> ProfileStore::Touched(const TxResult& r) {
+        std::vector<Id> ids;
+        for (const StepResult& s : r.steps)
+            if (s.status != Status::Skipped && s.status != Status::Cancelled) ids.push_back(s.id);
+        return ids;                     // failed / timed-out Sets may still have half-applied
+    }
+
+    // Newest change first, once per tweak; tweaks the backend reports as
+    // already back at the snapshot (e.g. the step that failed) are left alone
+    std::vector<std::pair<Id, bool>> ProfileStore::RollbackSteps(const Sys::Backend& be,
+                                                                 const std::vector<Id>& touched) {
+        std::vector<std::pair<Id, bool>> steps;
+        uint16_t done = 0;
+        for (auto it = touched.rbegin(); it != touched.rend(); ++it) {
+            const Id id = *it;
+            if (done >> (unsigned)id & 1u || !m_tx.Has(id)) continue;
+            done |= (uint16_t)(1u << (unsigned)id);
+            bool now;
+            if (be.Get(id, now) && now == m_tx.On(id)) { m_state.Set(id, now); continue; }
+            steps.emplace_back(id, m_tx.On(id));
+        }
+        return steps;
+    }
+
+    // r.undo holds the rollback outcomes; closes the transaction
+    void ProfileStore::EndRollback(TxResult& r) {
+        r.rolledBack = true;
+        for (const StepResult& s : r.undo) {
+            if (s.status == Status::Ok) { m_state.Set(s.id, s.on); continue; }
+            if (s.status == Status::Skipped) continue;
+            // State unknown now; don't claim either value
+            m_state.known &= (uint16_t)~(1u << (unsigned)s.id);
+            if (r.error.find("rollback incomplete") == std::string::npos)
+                r.error += r.error.empty() ? "rollback incomplete" : ", rollback incomplete";
+        }
+        m_tx     = TweakState{};
+        m_active = m_txActive;
+        m_txActive.clear();
+        Save();
+    }
+
+    ProfileStore::TxResult ProfileStore::Apply(Sys::Backend& be, const Profile& p,
+                                               const std::function<void(const StepResult&)>& onStep) {
+        TxResult r;
+        if (!Begin(be, p, r)) return r;
+        for (auto& st : p.steps) {
+            r.steps.push_back(RunStep(be, st.first, st.second, Describe(st.first).timeoutMs));
+            if (onStep) onStep(r.steps.back());
+            const Status s = r.steps.back().status;
+            if (s != Status::Ok && s != Status::Skipped) break;
+        }
+        if (Commit(p, r)) return r;
+        for (auto& st : RollbackSteps(be, Touched(r))) r.undo.push_back(RunStep(be, st.first, st.second, Describe(st.first).timeoutMs));
+        EndRollback(r);
+        return r;
+    }
+
+    ProfileStore::TxResult ProfileStore::Switch(Sys::Backend& be, const std::string& name,
+                                                const std::function<void(const StepResult&)>& onStep) {
+        if (const Profile* p = Find(name)) return Apply(be, *p, onStep);
+        TxResult r;
+        r.error = "unknown profile '" + name + "'";
+        return r;
+    }
+
+    bool ProfileStore::Recover(Sys::Backend& be, TxResult* out) {
+        if (!Pending()) return false;
+        TxResult r;
+        std::vector<Id> touched;
+        for (unsigned i = 0; i < (unsigned)Id::Count; i++)
+            if (m_tx.Has((Id)i)) touched.push_back((Id)i);
+        for (auto& st : RollbackSteps(be, touched)) r.undo.push_back(RunStep(be, st.first, st.second, Describe(st.first).timeoutMs));
+        EndRollback(r);
+        r.ok = r.error.empty();
+        if (out) *out = std::move(r);
+        return true;
+    }
+
+}  // namespace Tweaks
@@ -0,0 +1,124 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  PROFILE STORE  —  named boost profiles on disk, applied as transactions
+// ──────────────────────────────────────────────────────────────────────────────
+//  Holds every named profile (the built-ins are seeded on first run), the
+//  tweak state X-OPT last committed and the active profile name, so toggles
+//  survive a restart.
+//
+//  Apply() is all-or-nothing: it snapshots the prior state of every tweak the
+//  profile touches (read back from the backend, else what we last committed),
+//  writes that snapshot to the store as an intent record, then runs the
+//  steps.  A failed step rolls the already-applied ones back in reverse
+//  order; success commits the new state and drops the intent.  If the
+//  process dies in between, the intent is still on disk and Recover() (run
+//  by Open()) restores the snapshot on the next start.
+//
+//  On disk (native endianness, ~30 bytes per profile):
+//      StoreHeader | { u8 nameLen, u8 descLen, u8 stepCount, name, desc,
+//                      u8 step[stepCount] }[profileCount]
+//  A step byte is the Tweaks::Id in the low 7 bits and `on` in the top bit.
+#pragma once
+
+#include "tweaks.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Tweaks {
+
+    namespace fs = std::filesystem;
+
+    // One bit per Id: `known` says which bits of `on` mean anything
+    struct TweakState {
+        uint16_t known = 0;
+        uint16_t on    = 0;
+
+        bool Has(Id id) const { return known >> (unsigned)id & 1u; }
+        bool On(Id id) const  { return on >> (unsigned)id & 1u; }
+        void Set(Id id, bool v) {
+            known |= (uint16_t)(1u << (unsigned)id);
+            on = v ? (uint16_t)(on | 1u << (unsigned)id) : (uint16_t)(on & ~(1u << (unsigned)id));
+        }
+    };
+    static_assert((size_t)Id::Count <= 16, "TweakState holds one bit per tweak");
+
+    struct StoreHeader {            // 16 bytes
+        char     magic[4];          // "XOP1"
+        uint8_t  version;
+        uint8_t  profileCount;
+        uint8_t  active;            // profile index, kNoProfile: none / hand-picked toggles
+        uint8_t  txActive;          // `active` to restore if the open transaction rolls back
+        uint16_t known, on;         // committed TweakState
+        uint16_t txKnown, txOn;     // open transaction's snapshot; txKnown == 0: none
+    };
+
+    class ProfileStore {
+    public:
+        static constexpr uint8_t  kVersion    = 1;
+        static constexpr uint8_t  kNoProfile  = 0xFF;
+        static constexpr size_t   kMaxProfiles = 64;
+
+        struct TxResult {
+            bool                    ok         = false;
+            bool                    rolledBack = false;
+            std::vector<StepResult> steps;      // forward steps, in profile order
+            std::vector<StepResult> undo;       // rollback steps
+            std::string             error;
+        };
+
+        explicit ProfileStore(fs::path file) : m_file(std::move(file)) {}
+
+        // Load (or seed) the store, then roll back a transaction a crash left
+        // open.  `recovered` gets the rollback steps when there was one.
+        bool Open(Sys::Backend& be, TxResult* recovered = nullptr, std::string* error = nullptr);
+        bool Load(std::string* error = nullptr);   // false: missing / corrupt → built-ins seeded
+        bool Save() const;
+
+        // One call per switch: snapshot → apply → commit, or roll back
+        TxResult Apply(Sys::Backend& be, const Profile& p,
+                       const std::function<void(const StepResult&)>& onStep = {});
+        TxResult Switch(Sys::Backend& be, const std::string& name,
+                        const std::function<void(const StepResult&)>& onStep = {});
+        bool     Recover(Sys::Backend& be, TxResult* out = nullptr);
+        bool     Pending() const { return m_tx.known != 0; }
+
+        // The same transaction in phases, for callers that run the steps
+        // elsewhere (Tweaks::Switcher).  Begin(): snapshot + intent.  Commit():
+        // true once r.steps all succeeded and the new state is on disk;
+        // otherwise run RollbackSteps(Touched(r)) into r.undo and EndRollback().
+        bool Begin(Sys::Backend& be, const Profile& p, TxResult& r);
+        bool Commit(const Profile& p, TxResult& r);
+        std::vector<std::pair<Id, bool>> RollbackSteps(const Sys::Backend& be, const std::vector<Id>& touched);
+        void EndRollback(TxResult& r);
+        static std::vector<Id> Touched(const TxResult& r);
+
+        const std::vector<Profile>& Profiles() const { return m_profiles; }
+        const Profile*              Find(const std::string& name) const;
+        bool                        Put(const Profile& p);        // add or replace; false if full / invalid
+        bool                        Remove(const std::string& name);
+        // Current(be) as a profile: boosts first, then reverts
+        Profile                     Capture(const Sys::Backend& be, const std::string& name) const;
+
+        // Committed state, with the backend's view layered on top where it
+        // can report one — what the Boost toggles should show
+        TweakState                  Current(const Sys::Backend& be) const;
+        const TweakState&           Committed() const { return m_state; }
+        const std::string&          Active() const { return m_active; }
+        const fs::path&             File() const { return m_file; }
+
+    private:
+        fs::path             m_file;
+        std::vector<Profile> m_profiles;
+        TweakState           m_state;
+        TweakState           m_tx;
+        std::string          m_active;
+        std::string          m_txActive;
+    };
+
+    // Store next to the backend's other state (the clean journal)
+    fs::path DefaultStorePath(const Sys::Backend& be);
+
+}  // namespace Tweaks
@@ -0,0 +1,229 @@
+#include "profiler.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string_view>
+
+namespace Prof {
+
+    namespace detail {
+
+        std::atomic<bool> g_capturing{ false };
+
+        // Relaxed atomics throughout: plain moves on x86/ARM64, and a reader
+        // racing the writer is well-defined (and caught by the claim check)
+        struct Slot {
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<uint64_t>    begin{ 0 }, end{ 0 };
+            std::atomic<uint32_t>    thread{ 0 }, depth{ 0 };
+        };
+
+        struct Ring {
+            // `claimed` moves before a slot is overwritten and `written` after
+            // it is complete, so a reader knows which of its copies can be torn
+            alignas(64) std::atomic<uint64_t> claimed{ 0 };
+            std::atomic<uint64_t>             written{ 0 };
+            std::atomic<bool>                 owned{ true };
+            uint32_t                          thread = 0;   // the owner's, owner only
+            uint32_t                          depth  = 0;
+            Slot                              slot[kRing];
+        };
+
+        static std::atomic<Ring*>    g_rings[kMaxThreads] = {};
+        static std::atomic<unsigned> g_ringCount{ 0 };
+        static std::atomic<uint32_t> g_lastThread{ 0 };
+        static std::mutex                      g_namesMx;
+        static std::map<uint32_t, std::string> g_names;
+
+        // Gives the ring back when its thread exits
+        struct Owner {
+            Ring*    ring   = nullptr;
+            uint32_t id     = 0;
+            bool     failed = false;
+            ~Owner() { if (ring) ring->owned.store(false, std::memory_order_release); }
+        };
+        static thread_local Owner t_owner;
+
+        static uint32_t ThreadId(Owner& o) {
+            if (!o.id) o.id = g_lastThread.fetch_add(1, std::memory_order_relaxed) + 1;
+            return o.id;
+        }
+
+        static Ring* Acquire() {
+            const unsigned n = std::min(g_ringCount.load(std::memory_order_acquire), kMaxThreads);
+            for (unsigned i = 0; i < n; i++) {
+                Ring* r = g_rings[i].load(std::memory_order_acquire);
+                bool  free = false;
+                if (r && r->owned.compare_exchange_strong(free, true, std::memory_order_acq_rel)) return r;
+            }
+            const unsigned i = g_ringCount.fetch_add(1, std::memory_order_acq_rel);
+            if (i >= kMaxThreads) return nullptr;
+            Ring* r = new Ring;
+            g_rings[i].store(r, std::memory_order_release);
+            return r;
+        }
+
+        Ring* Enter() {
+            Owner& o = t_owner;
+            if (!o.ring) {
+                if (o.failed) return nullptr;
+                o.ring = Acquire();
+                if (!o.ring) { o.failed = true; return nullptr; }
+                o.ring->thread = ThreadId(o);
+                o.ring->depth  = 0;
+            }
+            o.ring->depth++;
+            return o.ring;
+        }
+
+        void Leave(Ring* r, const char* name, uint64_t begin) {
+            const uint64_t end = Now();
+            const uint64_t n   = r->written.load(std::memory_order_relaxed);
+            r->claimed.store(n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            Slot& s = r->slot[n & (kRing - 1)];
+            s.name.store(name, std::memory_order_relaxed);
+            s.begin.store(begin, std::memory_order_relaxed);
+            s.end.store(end, std::memory_order_relaxed);
+            s.thread.store(r->thread, std::memory_order_relaxed);
+            s.depth.store(--r->depth, std::memory_order_relaxed);
+            r->written.store(n + 1, std::memory_order_release);
+        }
+
+    }  // namespace detail
+
+    using namespace detail;
+
+    uint64_t Now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Start()     { g_capturing.store(true, std::memory_order_relaxed); }
+    void Stop()      { g_capturing.store(false, std::memory_order_relaxed); }
+    bool Capturing() { return g_capturing.load(std::memory_order_relaxed); }
+
+    void SetThreadName(const char* name) {
+        const uint32_t id = ThreadId(t_owner);
+        std::lock_guard<std::mutex> lk(g_namesMx);
+        g_names[id] = name;
+    }
+
+    std::string ThreadName(uint32_t thread) {
+        {
+            std::lock_guard<std::mutex> lk(g_namesMx);
+            auto it = g_names.find(thread);
+            if (it != g_names.end()) return it->second;
+        }
+        return "thread " + std::to_string(thread);
+    }
+
+    size_t Collect(std::vector<Event>& out, uint64_t sinceNs) {
+        out.clear();
+        const unsigned n = std::min(g_ringCount.load(std::memory_order_acquire), kMaxThreads);
+        for (unsigned k = 0; k < n; k++) {
+            const Ring* r = g_rings[k].load(std::memory_order_acquire);
+            if (!r) continue;
+            // A ring fills in order of zone end, so walk back from the newest
+            // until the window starts
+            const uint64_t w     = r->written.load(std::memory_order_acquire);
+            const uint64_t first = w > kRing ? w - kRing : 0;
+            const size_t   base  = out.size();
+            uint64_t i = w;
+            while (i > first) {
+                const Slot& s = r->slot[(i - 1) & (kRing - 1)];
+                Event e;
+                e.end = s.end.load(std::memory_order_relaxed);
+                if (e.end < sinceNs) break;
+                e.name   = s.name.load(std::memory_order_relaxed);
+                e.begin  = s.begin.load(std::memory_order_relaxed);
+                e.thread = s.thread.load(std::memory_order_relaxed);
+                e.depth  = s.depth.load(std::memory_order_relaxed);
+                out.push_back(e);
+                --i;
+            }
+            // Anything the writer claimed meanwhile may be torn: drop it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t c  = r->claimed.load(std::memory_order_relaxed);
+            const uint64_t lo = c > kRing ? c - kRing : 0;
+            if (i < lo) out.resize(out.size() - (size_t)std::min<uint64_t>(lo - i, out.size() - base));
+            std::sort(out.begin() + (ptrdiff_t)base, out.end(), [](const Event& a, const Event& b) {
+                return a.thread != b.thread ? a.thread < b.thread
+                     : a.begin  != b.begin  ? a.begin  < b.begin : a.depth < b.depth;
+            });
+        }
+        return out.size();
+    }
+
+    void Summarize(const std::vector<Event>& ev, std::vector<ZoneStat>& out) {
+        // Direct children's time, found with a stack of open zones per thread
+        std::vector<uint64_t> child(ev.size(), 0);
+        std::vector<size_t>   open;
+        for (size_t i = 0; i < ev.size(); i++) {
+            const Event& e = ev[i];
+            if (i && ev[i - 1].thread != e.thread) open.clear();
+            while (!open.empty() && (ev[open.back()].depth >= e.depth || ev[open.back()].end < e.end)) open.pop_back();
+            if (!open.empty() && ev[open.back()].depth + 1 == e.depth) child[open.back()] += e.end - e.begin;
+            open.push_back(i);
+        }
+        std::map<std::string_view, ZoneStat> by;
+        for (size_t i = 0; i < ev.size(); i++) {
+            const Event&   e   = ev[i];
+            const uint64_t dur = e.end - e.begin;
+            ZoneStat&      z   = by[e.name];
+            z.name     = e.name;
+            z.count   += 1;
+            z.totalNs += dur;
+            z.selfNs  += dur - std::min(dur, child[i]);
+            z.maxNs    = std::max(z.maxNs, dur);
+        }
+        out.clear();
+        for (auto& kv : by) out.push_back(kv.second);
+        std::sort(out.begin(), out.end(), [](const ZoneStat& a, const ZoneStat& b) { return a.totalNs > b.totalNs; });
+    }
+
+    static void AppendString(std::string& out, const char* s) {
+        out += '"';
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\') out += '\\';
+            if ((unsigned char)*s >= 0x20) out += *s;
+        }
+        out += '"';
+    }
+
+    bool ExportChromeTrace(const std::vector<Event>& ev, const std::filesystem::path& p, std::string* error) {
+        uint64_t t0 = UINT64_MAX;
+        for (const Event& e : ev) t0 = std::min(t0, e.begin);
+        std::string out;
+        out.reserve(ev.size() * 112 + 256);
+        out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        char buf[128];
+        bool first = true;
+        for (size_t i = 0; i < ev.size(); i++) {
+            if (i && ev[i - 1].thread == ev[i].thread) continue;
+            std::snprintf(buf, sizeof(buf), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                          first ? "" : ",", ev[i].thread);
+            out += buf;
+            AppendString(out, ThreadName(ev[i].thread).c_str());
+            out += "}}";
+            first = false;
+        }
+        for (const Event& e : ev) {
+            out += first ? "\n{\"name\":" : ",\n{\"name\":";
+            AppendString(out, e.name ? e.name : "?");
+            std::snprintf(buf, sizeof(buf), ",\"cat\":\"xopt\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                          e.thread, (double)(e.begin - t0) / 1e3, (double)(e.end - e.begin) / 1e3);
+            out += buf;
+            first = false;
+        }
+        out += "\n]}\n";
+        if (IO::WriteFileAtomic(p, out.data(), out.size())) return true;
+        if (error) *error = "cannot write " + p.u8string();
+        return false;
+    }
+
+}  // namespace Prof
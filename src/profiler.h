@@ -0,0 +1,109 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  PROFILER  —  where the frame time goes, zone by zone, on every thread
+// ──────────────────────────────────────────────────────────────────────────────
+//  XOPT_ZONE("Name") times the rest of the enclosing scope.  When the scope
+//  closes, the zone (steady-clock ns begin and end, nesting depth) goes into
+//  a ring owned by the calling thread.  Only that thread writes the ring, so
+//  recording takes no lock and shares no cache line.  Collect() copies every
+//  ring from any thread while the writers keep going.  A zone the writer
+//  overwrote during the copy is dropped, never returned torn.
+//
+//  Nothing is recorded until Start().  Outside a capture a zone costs one
+//  relaxed load.  A ring belongs to one live thread at a time.  When its
+//  thread exits, the next new thread takes it over, and the zones already in
+//  it stay readable under the old thread's id.
+//
+//  Configuring with -DXOPT_PROFILER=OFF defines XOPT_PROFILE=0: every
+//  XOPT_ZONE compiles to nothing and Compiled() is false.  The rest of the
+//  API stays, so callers need no #if of their own.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef XOPT_PROFILE
+#define XOPT_PROFILE 1
+#endif
+
+namespace Prof {
+
+    static constexpr size_t   kRing       = 1u << 15;     // zones per thread
+    static constexpr unsigned kMaxThreads = 64;
+
+    constexpr bool Compiled() { return XOPT_PROFILE != 0; }
+
+    uint64_t Now();                     // ns, steady clock
+
+    void Start();
+    void Stop();
+    bool Capturing();
+
+    // Names the calling thread in the timeline and the trace
+    void SetThreadName(const char* name);
+
+    struct Event {
+        const char* name  = nullptr;    // the XOPT_ZONE literal
+        uint64_t    begin = 0, end = 0; // ns
+        uint32_t    thread = 0;         // 1, 2, … as threads show up; never reused
+        uint32_t    depth  = 0;         // 0 = outermost on its thread
+    };
+
+    // Zones that ended at or after `sinceNs`, every thread: grouped by
+    // thread, each thread's ordered by begin
+    size_t      Collect(std::vector<Event>& out, uint64_t sinceNs = 0);
+    std::string ThreadName(uint32_t thread);    // "thread N" if never named
+
+    struct ZoneStat {
+        const char* name    = nullptr;
+        uint64_t    count   = 0;
+        uint64_t    totalNs = 0;
+        uint64_t    selfNs  = 0;        // total minus directly nested zones
+        uint64_t    maxNs   = 0;
+    };
+    // Per zone name, by total time, descending
+    void Summarize(const std::vector<Event>& events, std::vector<ZoneStat>& out);
+
+    // Chrome trace event format ("X" complete events, µs), for
+    // chrome://tracing, Perfetto or speedscope
+    bool ExportChromeTrace(const std::vector<Event>& events, const std::filesystem::path& p,
+                           std::string* error = nullptr);
+
+    namespace detail {
+        struct Ring;
+        extern std::atomic<bool> g_capturing;
+        Ring* Enter();                              // null if out of rings
+        void  Leave(Ring* r, const char* name, uint64_t begin);
+    }
+
+    class Zone {
+    public:
+        explicit Zone(const char* name) {
+            if (!detail::g_capturing.load(std::memory_order_relaxed)) return;
+            m_ring = detail::Enter();
+            if (!m_ring) return;
+            m_name  = name;
+            m_begin = Now();
+        }
+        ~Zone() { if (m_ring) detail::Leave(m_ring, m_name, m_begin); }
+        Zone(const Zone&)            = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        detail::Ring* m_ring  = nullptr;
+        const char*   m_name  = nullptr;
+        uint64_t      m_begin = 0;
+    };
+
+}  // namespace Prof
+
+#if XOPT_PROFILE
+#define XOPT_ZONE_JOIN2(a, b) a##b
+#define XOPT_ZONE_JOIN(a, b)  XOPT_ZONE_JOIN2(a, b)
+#define XOPT_ZONE(name)       ::Prof::Zone XOPT_ZONE_JOIN(xoptZone_, __LINE__)(name)
+#else
+#define XOPT_ZONE(name)       ((void)0)
+#endif
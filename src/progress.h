@@ -0,0 +1,234 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  PROGRESS CHANNEL  —  lock-free worker → UI progress events
+// ──────────────────────────────────────────────────────────────────────────────
+//  Every cleaner worker owns one single-producer/single-consumer ring; the UI
+//  thread is the only consumer and drains all rings once per frame.  Workers
+//  never block: deltas coalesce locally until their ring has room.  Phase
+//  End events carry absolute totals, so anything still coalescing when a
+//  phase finishes is reconciled there.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace Progress {
+
+    // ── Lock-free SPSC ring ───────────────────────────────────────────────────
+    template <class T, size_t N>
+    class SpscRing {
+        static_assert((N & (N - 1)) == 0, "SpscRing size must be a power of two");
+    public:
+        bool TryPush(const T& v) {
+            const size_t h = m_head.load(std::memory_order_relaxed);
+            if (h - m_tailCache == N) {
+                m_tailCache = m_tail.load(std::memory_order_acquire);
+                if (h - m_tailCache == N) return false;
+            }
+            m_buf[h & (N - 1)] = v;
+            m_head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPop(T& out) {
+            const T* front = Peek();
+            if (!front) return false;
+            out = *front;
+            Drop();
+            return true;
+        }
+
+        // Consumer: look at the oldest entry without removing it
+        const T* Peek() {
+            const size_t t = m_tail.load(std::memory_order_relaxed);
+            if (t == m_headCache) {
+                m_headCache = m_head.load(std::memory_order_acquire);
+                if (t == m_headCache) return nullptr;
+            }
+            return &m_buf[t & (N - 1)];
+        }
+        void Drop() {                       // after a successful Peek()
+            m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    private:
+        // Producer and consumer each keep a cached copy of the other's index
+        // on their own cache line, so the common case touches no shared line
+        alignas(64) std::atomic<size_t> m_head{ 0 };
+        size_t                          m_tailCache = 0;
+        alignas(64) std::atomic<size_t> m_tail{ 0 };
+        size_t                          m_headCache = 0;
+        alignas(64) T                   m_buf[N];
+    };
+
+    enum class Phase : uint8_t { Scan, Commit };
+
+    struct Event {
+        enum Kind : uint8_t { Begin, Delta, End };
+        Kind     kind   = Delta;
+        Phase    phase  = Phase::Scan;
+        uint16_t root   = 0;
+        uint16_t run    = 0;     // Channel::BeginRun() sequence — drops stale deltas
+        uint32_t files  = 0;
+        uint32_t dirs   = 0;
+        uint32_t errors = 0;
+        uint64_t bytes  = 0;
+        uint64_t total  = 0;     // Begin: work units expected (0 = unknown)
+    };
+
+    struct LogLine { char text[124]; };
+
+    class Channel {
+    public:
+        static constexpr unsigned kProducers = 64;
+        static constexpr size_t   kRingSize  = 256;
+
+        // Producer side ───────────────────────────────────────────────────────
+        uint16_t BeginRun() { return (uint16_t)(m_run.fetch_add(1, std::memory_order_relaxed) + 1); }
+
+        bool Push(unsigned producer, const Event& e) {
+            return producer < kProducers && m_rings[producer].TryPush(e);
+        }
+
+        // Control events (Begin/End) are rare; give a slow consumer a moment
+        // but never hang a worker on a UI that stopped draining
+        void PushControl(unsigned producer, const Event& e) {
+            for (int i = 0; i < 200 && !Push(producer, e); i++) SleepBriefly();
+        }
+
+        // Single log producer: the thread orchestrating the clean
+        void Log(const char* fmt, ...) {
+            LogLine l;
+            va_list ap; va_start(ap, fmt);
+            vsnprintf(l.text, sizeof(l.text), fmt, ap);
+            va_end(ap);
+            for (int i = 0; i < 200 && !m_log.TryPush(l); i++) SleepBriefly();
+        }
+
+        // Consumer side (UI thread only) ──────────────────────────────────────
+        template <class Fn>
+        size_t Drain(Fn&& onEvent) {
+            size_t n = 0;
+            Event  e;
+            for (auto& r : m_rings)
+                while (r.TryPop(e)) { onEvent(e); ++n; }
+            return n;
+        }
+
+        template <class Fn>
+        size_t DrainLog(Fn&& onLine) {
+            size_t  n = 0;
+            LogLine l;
+            while (m_log.TryPop(l)) { onLine(l.text); ++n; }
+            return n;
+        }
+
+    private:
+        static void SleepBriefly() { std::this_thread::sleep_for(std::chrono::microseconds(500)); }
+
+        SpscRing<Event, kRingSize>   m_rings[kProducers];
+        SpscRing<LogLine, kRingSize> m_log;
+        std::atomic<uint16_t>        m_run{ 0 };
+    };
+
+    // ── Per-worker coalescing reporter ────────────────────────────────────────
+    class Reporter {
+    public:
+        Reporter() = default;
+        Reporter(Channel* ch, unsigned producer, Phase phase, uint16_t run, size_t roots)
+            : m_ch(ch), m_producer(producer), m_pending(ch ? roots : 0) {
+            for (size_t r = 0; r < m_pending.size(); r++) {
+                m_pending[r].phase = phase;
+                m_pending[r].run   = run;
+                m_pending[r].root  = (uint16_t)r;
+            }
+        }
+
+        void Add(uint16_t root, uint32_t files, uint32_t dirs, uint32_t errors, uint64_t bytes) {
+            if (!m_ch) return;
+            Event& e = m_pending[root];
+            e.files += files; e.dirs += dirs; e.errors += errors; e.bytes += bytes;
+            if (++m_adds >= kFlushEvery) Flush();
+        }
+
+        void Flush() {
+            m_adds = 0;
+            for (auto& e : m_pending) {
+                if (!(e.files | e.dirs | e.errors) && !e.bytes) continue;
+                if (!m_ch->Push(m_producer, e)) return;    // ring full — keep coalescing
+                e.files = e.dirs = e.errors = 0; e.bytes = 0;
+            }
+        }
+
+    private:
+        static constexpr unsigned kFlushEvery = 16;
+
+        Channel*           m_ch       = nullptr;
+        unsigned           m_producer = 0;
+        unsigned           m_adds     = 0;
+        std::vector<Event> m_pending;
+    };
+
+    // ── Consumer-side aggregate: percent complete + throughput ────────────────
+    struct Tracker {
+        uint16_t run    = 0;
+        Phase    phase  = Phase::Scan;
+        bool     active = false;
+        uint64_t total  = 0;
+        uint64_t files  = 0, dirs = 0, errors = 0, bytes = 0;
+        double   filesPerSec = 0.0, bytesPerSec = 0.0;
+
+        void Apply(const Event& e) {
+            const int16_t age = (int16_t)(e.run - run);
+            if (age < 0) return;                  // stale run
+            if (age > 0) Reset(e);                // newer run — its Begin may still be queued
+            switch (e.kind) {
+                case Event::Begin: total = e.total; break;
+                case Event::Delta:
+                    if (!active) return;          // straggler drained after End
+                    files += e.files; dirs += e.dirs; errors += e.errors; bytes += e.bytes;
+                    break;
+                case Event::End:
+                    files = e.files; dirs = e.dirs; errors = e.errors; bytes = e.bytes;
+                    active = false;
+                    break;
+            }
+        }
+
+        // Call once per frame with the frame clock in seconds
+        void Tick(double now) {
+            const double dt = now - m_lastT;
+            if (dt < 0.25) return;
+            const double a = std::min(1.0, dt / 1.0);      // ~1 s smoothing
+            if (m_lastT > 0.0) {
+                filesPerSec += a * ((double)(files - m_lastFiles) / dt - filesPerSec);
+                bytesPerSec += a * ((double)(bytes - m_lastBytes) / dt - bytesPerSec);
+            }
+            m_lastT = now; m_lastFiles = files; m_lastBytes = bytes;
+        }
+
+        // 0..1, or < 0 when the amount of work is not known up front
+        float Percent() const {
+            if (!total) return -1.0f;
+            return std::min(1.0f, (float)(files + dirs + errors) / (float)total);
+        }
+
+    private:
+        void Reset(const Event& e) {
+            run = e.run; phase = e.phase; active = true; total = 0;
+            files = dirs = errors = bytes = 0;
+            filesPerSec = bytesPerSec = 0.0;
+            m_lastT = 0.0; m_lastFiles = m_lastBytes = 0;
+        }
+
+        double   m_lastT = 0.0;
+        uint64_t m_lastFiles = 0, m_lastBytes = 0;
+    };
+
+}  // namespace Progress
@@ -0,0 +1,115 @@
+#include "spectrum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Dsp {
+
+    SpectrumAnalyzer::SpectrumAnalyzer(const Config& cfg)
+        : m_cfg(cfg), m_fft(cfg.fftSize),
+          m_window(cfg.fftSize), m_ring(cfg.fftSize), m_re(cfg.fftSize), m_im(cfg.fftSize) {
+        m_cfg.bands = std::min(std::max(1u, m_cfg.bands), Spectrum::kMaxBands);
+        const double kTwoPi = 6.283185307179586;
+        double sum = 0.0;
+        for (unsigned i = 0; i < cfg.fftSize; i++) {
+            m_window[i] = (float)(0.5 - 0.5 * std::cos(kTwoPi * i / cfg.fftSize));
+            sum += m_window[i];
+        }
+        m_winGain = (float)(2.0 / sum);     // full-scale sine → magnitude 1 (0 dB)
+        Reset(48000);
+    }
+
+    void SpectrumAnalyzer::Reset(uint32_t sampleRate) {
+        m_rate = sampleRate ? sampleRate : 48000;
+        std::fill(m_ring.begin(), m_ring.end(), 0.0f);
+        m_pos = m_sinceHop = 0;
+        std::fill(std::begin(m_level), std::end(m_level), 0.0f);
+        std::fill(std::begin(m_peak),  std::end(m_peak),  0.0f);
+        std::fill(std::begin(m_hold),  std::end(m_hold),  0.0f);
+
+        // Log-spaced band edges → FFT bin ranges (at least one bin each)
+        const unsigned n     = m_cfg.fftSize, half = n / 2;
+        const double   binHz = (double)m_rate / n;
+        const double   lo    = std::max(binHz, (double)m_cfg.minHz);
+        const double   hi    = std::min((double)m_rate * 0.5, (double)m_cfg.maxHz);
+        m_bandLo.resize(m_cfg.bands);
+        m_bandHi.resize(m_cfg.bands);
+        m_bandHz.resize(m_cfg.bands);
+        for (unsigned b = 0; b < m_cfg.bands; b++) {
+            const double f0 = lo * std::pow(hi / lo, (double)b / m_cfg.bands);
+            const double f1 = lo * std::pow(hi / lo, (double)(b + 1) / m_cfg.bands);
+            uint32_t k0 = (uint32_t)std::min<double>(half - 1, std::floor(f0 / binHz));
+            uint32_t k1 = (uint32_t)std::min<double>(half, std::ceil(f1 / binHz));
+            m_bandLo[b] = std::max(1u, k0);
+            m_bandHi[b] = std::max(m_bandLo[b] + 1, k1);
+            m_bandHz[b] = (float)std::sqrt(f0 * f1);
+        }
+    }
+
+    void SpectrumAnalyzer::Push(const float* in, size_t frames, unsigned channels) {
+        if (!channels) return;
+        const size_t n   = m_ring.size();
+        const size_t hop = n / 2;
+        const float  inv = 1.0f / (float)channels;
+        for (size_t f = 0; f < frames; f++) {
+            float mono = 0.0f;
+            for (unsigned c = 0; c < channels; c++) mono += in[f * channels + c];
+            m_ring[m_pos] = mono * inv;
+            m_pos = (m_pos + 1) & (n - 1);
+            if (++m_sinceHop == hop) { m_sinceHop = 0; Analyse(); }
+        }
+    }
+
+    void SpectrumAnalyzer::Analyse() {
+        const auto   t0   = std::chrono::steady_clock::now();
+        const size_t n    = m_ring.size();
+        const float  hopS = (float)(n / 2) / (float)m_rate;
+
+        // Unroll the ring oldest-first and window it
+        double energy = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            const float s = m_ring[(m_pos + i) & (n - 1)];
+            energy += (double)s * s;
+            m_re[i] = s * m_window[i];
+            m_im[i] = 0.0f;
+        }
+        m_fft.Forward(m_re.data(), m_im.data());
+
+        const float floorDb = m_cfg.floorDb;
+        auto toLevel = [floorDb](float db) { return std::min(1.0f, std::max(0.0f, (db - floorDb) / -floorDb)); };
+
+        Spectrum& out = m_out.Back();
+        const float g2 = m_winGain * m_winGain;
+        for (unsigned b = 0; b < m_cfg.bands; b++) {
+            float pmax = 0.0f;
+            for (uint32_t k = m_bandLo[b]; k < m_bandHi[b]; k++)
+                pmax = std::max(pmax, m_re[k] * m_re[k] + m_im[k] * m_im[k]);
+            const float v = toLevel(10.0f * std::log10(pmax * g2 + 1e-12f));
+
+            float& lv = m_level[b];
+            lv += (v - lv) * (v > lv ? m_cfg.attack : m_cfg.release);
+            if (lv >= m_peak[b]) { m_peak[b] = lv; m_hold[b] = m_cfg.peakHold; }
+            else if (m_hold[b] > 0.0f) m_hold[b] -= hopS;
+            else m_peak[b] = std::max(lv, m_peak[b] - m_cfg.peakFall * hopS);
+
+            out.level[b] = lv;
+            out.peak[b]  = m_peak[b];
+        }
+        out.bands = m_cfg.bands;
+        out.rms   = toLevel(10.0f * std::log10((float)(energy / n) * 2.0f + 1e-12f));
+        out.seq   = ++m_seq;
+        m_out.Publish();
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        m_hopNs.fetch_add((uint64_t)ns, std::memory_order_relaxed);
+        m_hops.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    double SpectrumAnalyzer::HopMicros() const {
+        const uint64_t h = m_hops.load(std::memory_order_relaxed);
+        return h ? (double)m_hopNs.load(std::memory_order_relaxed) / h / 1000.0 : 0.0;
+    }
+
+}  // namespace Dsp
@@ -0,0 +1,103 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  SPECTRUM ANALYSER  —  audio thread FFT → lock-free snapshots for the UI
+// ──────────────────────────────────────────────────────────────────────────────
+//  The audio thread Push()es PCM as it plays; every hop (half an FFT window)
+//  it runs a Hann-windowed FFT, folds the bins into log-spaced bands with
+//  attack/release smoothing and peak-hold, and publishes the result through
+//  a triple buffer.  The UI's Read() is a single atomic exchange plus a
+//  ~0.5 KB copy — no locks, and a slow frame never blocks the audio thread.
+#pragma once
+
+#include "fft.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp {
+
+    // Single writer / single reader; the writer never waits
+    template <class T>
+    class TripleBuffer {
+    public:
+        T&   Back() { return m_buf[m_back]; }
+        void Publish() {
+            m_back = m_mid.exchange((uint8_t)(m_back | kDirty), std::memory_order_acq_rel) & kIndex;
+        }
+
+        // false: nothing new since the last Fetch (out untouched)
+        bool Fetch(T& out) {
+            if (!(m_mid.load(std::memory_order_relaxed) & kDirty)) return false;
+            m_front = m_mid.exchange(m_front, std::memory_order_acq_rel) & kIndex;
+            out = m_buf[m_front];
+            return true;
+        }
+
+    private:
+        static constexpr uint8_t kIndex = 3, kDirty = 4;
+        T                    m_buf[3] = {};
+        uint8_t              m_back   = 0;     // writer only
+        uint8_t              m_front  = 1;     // reader only
+        std::atomic<uint8_t> m_mid{ 2 };
+    };
+
+    struct Spectrum {
+        static constexpr unsigned kMaxBands = 64;
+        uint64_t seq   = 0;                 // hop counter, 0 = no data yet
+        unsigned bands = 0;
+        float    rms   = 0.0f;              // 0..1 (dBFS mapped like the bands)
+        float    level[kMaxBands] = {};     // 0..1 smoothed band level
+        float    peak[kMaxBands]  = {};     // 0..1 peak-hold marker
+    };
+
+    class SpectrumAnalyzer {
+    public:
+        struct Config {
+            unsigned fftSize  = 2048;
+            unsigned bands    = 48;
+            float    minHz    = 30.0f;
+            float    maxHz    = 16000.0f;
+            float    floorDb  = -72.0f;     // maps to level 0
+            float    attack   = 0.6f;       // per-hop smoothing towards louder
+            float    release  = 0.18f;      // … and quieter values
+            float    peakHold = 0.5f;       // seconds before a peak starts falling
+            float    peakFall = 0.8f;       // level units per second
+        };
+
+        SpectrumAnalyzer() : SpectrumAnalyzer(Config{}) {}
+        explicit SpectrumAnalyzer(const Config& cfg);
+
+        // Audio thread ────────────────────────────────────────────────────────
+        void Reset(uint32_t sampleRate);    // also call on seek / track change
+        void Push(const float* interleaved, size_t frames, unsigned channels);
+
+        // UI thread ───────────────────────────────────────────────────────────
+        bool Read(Spectrum& out) { return m_out.Fetch(out); }
+
+        // Either thread: mean cost of one analysis hop (FFT + banding)
+        double HopMicros() const;
+        unsigned Bands() const { return m_cfg.bands; }
+        float    BandHz(unsigned b) const { return m_bandHz[b]; }   // geometric centre
+        Fft::Isa ActiveIsa() const { return m_fft.ActiveIsa(); }
+
+    private:
+        void Analyse();
+
+        Config             m_cfg;
+        Fft                m_fft;
+        uint32_t           m_rate = 48000;
+        std::vector<float> m_window, m_ring, m_re, m_im;
+        std::vector<uint32_t> m_bandLo, m_bandHi;   // bin range per band
+        std::vector<float> m_bandHz;
+        size_t             m_pos = 0, m_sinceHop = 0;
+        float              m_winGain = 1.0f;
+        float              m_level[Spectrum::kMaxBands] = {};
+        float              m_peak[Spectrum::kMaxBands]  = {};
+        float              m_hold[Spectrum::kMaxBands]  = {};
+        uint64_t           m_seq = 0;
+        std::atomic<uint64_t> m_hopNs{ 0 }, m_hops{ 0 };
+        TripleBuffer<Spectrum> m_out;
+    };
+
+}  // namespace Dsp
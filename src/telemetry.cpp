@@ -0,0 +1,389 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <winsock2.h>
+#  include <windows.h>
+#  include <winioctl.h>
+#  include <iphlpapi.h>
+#  include <cwchar>
+#else
+#  include <fcntl.h>
+#  include <filesystem>
+#  include <unistd.h>
+#endif
+
+namespace Telemetry {
+
+    // ── Ring ──────────────────────────────────────────────────────────────────
+
+    void Ring::Push(float v) {
+        const uint64_t n = m_n.load(std::memory_order_relaxed);
+        m_v[n % kHistory].store(v, std::memory_order_relaxed);
+        m_n.store(n + 1, std::memory_order_release);
+    }
+
+    size_t Ring::Read(float* out, size_t max) const {
+        const uint64_t n = m_n.load(std::memory_order_acquire);
+        const size_t   k = (size_t)std::min<uint64_t>({ n, (uint64_t)kHistory, (uint64_t)max });
+        for (size_t i = 0; i < k; i++)
+            out[i] = m_v[(n - k + i) % kHistory].load(std::memory_order_relaxed);
+        return k;
+    }
+
+    float Ring::Last() const {
+        const uint64_t n = m_n.load(std::memory_order_acquire);
+        return n ? m_v[(n - 1) % kHistory].load(std::memory_order_relaxed) : 0.0f;
+    }
+
+    const char* SeriesName(Series s) {
+        switch (s) {
+            case Series::Cpu:       return "cpu";
+            case Series::Memory:    return "memory";
+            case Series::DiskRead:  return "disk_read";
+            case Series::DiskWrite: return "disk_write";
+            case Series::NetRx:     return "net_rx";
+            case Series::NetTx:     return "net_tx";
+            default:                return "?";
+        }
+    }
+
+    // ── Counters → rates ──────────────────────────────────────────────────────
+
+    static float Percent(uint64_t busy1, uint64_t busy0, uint64_t total1, uint64_t total0) {
+        if (total1 <= total0 || busy1 < busy0) return 0.0f;          // no time passed, or a reset
+        return std::min(100.0f, 100.0f * (float)(busy1 - busy0) / (float)(total1 - total0));
+    }
+
+    static float Rate(uint64_t now, uint64_t then, double seconds) {
+        return now >= then && seconds > 0.0 ? (float)((double)(now - then) / seconds) : 0.0f;
+    }
+
+    void Diff(const Counters& now, const Counters& then, double seconds, Sample& out) {
+        out.cpus = std::min(now.cpus, then.cpus);
+        out.cpu  = Percent(now.busy[0], then.busy[0], now.total[0], then.total[0]);
+        for (unsigned i = 0; i < out.cpus; i++)
+            out.core[i] = Percent(now.busy[i + 1], then.busy[i + 1], now.total[i + 1], then.total[i + 1]);
+        out.memory    = now.memTotal ? 100.0f * (float)(now.memTotal - std::min(now.memAvail, now.memTotal))
+                                            / (float)now.memTotal : 0.0f;
+        out.diskRead  = Rate(now.diskRead,  then.diskRead,  seconds);
+        out.diskWrite = Rate(now.diskWrite, then.diskWrite, seconds);
+        out.netRx     = Rate(now.netRx,     then.netRx,     seconds);
+        out.netTx     = Rate(now.netTx,     then.netTx,     seconds);
+    }
+
+    // ── Reader ────────────────────────────────────────────────────────────────
+
+#ifdef _WIN32
+
+    // The documented layout; kernel time includes idle time
+    struct CpuPerf { LARGE_INTEGER idle, kernel, user, reserved1[2]; ULONG reserved2; };
+    using QueryFn = LONG (WINAPI*)(ULONG, PVOID, ULONG, PULONG);
+    static const ULONG kProcessorPerformance = 8;     // SystemProcessorPerformanceInformation
+
+    Reader::Reader() = default;
+    Reader::~Reader() { Close(); }
+
+    bool Reader::Open() {
+        Close();
+        m_query = (void*)GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtQuerySystemInformation");
+        if (!m_query) return false;
+        m_cpuInfo = new CpuPerf[kMaxCpus];
+        m_ifRow   = new MIB_IF_ROW2;
+
+        for (unsigned i = 0; i < 32 && m_disks < kMaxDevices; i++) {
+            wchar_t name[32];
+            std::swprintf(name, 32, L"\\\\.\\PhysicalDrive%u", i);
+            HANDLE h = CreateFileW(name, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+            if (h == INVALID_HANDLE_VALUE) continue;
+            DISK_PERFORMANCE perf;
+            DWORD got = 0;
+            if (DeviceIoControl(h, IOCTL_DISK_PERFORMANCE, nullptr, 0, &perf, sizeof(perf), &got, nullptr))
+                m_disk[m_disks++] = h;
+            else
+                CloseHandle(h);
+        }
+
+        MIB_IF_TABLE2* table = nullptr;
+        if (GetIfTable2(&table) == NO_ERROR) {
+            for (ULONG i = 0; i < table->NumEntries && m_ifaces < kMaxDevices; i++) {
+                const MIB_IF_ROW2& r = table->Table[i];
+                if (r.Type != IF_TYPE_SOFTWARE_LOOPBACK && r.InterfaceAndOperStatusFlags.HardwareInterface)
+                    m_ifIndex[m_ifaces++] = r.InterfaceIndex;
+            }
+            FreeMibTable(table);
+        }
+        m_open = true;
+        return true;
+    }
+
+    void Reader::Close() {
+        for (unsigned i = 0; i < m_disks; i++) CloseHandle((HANDLE)m_disk[i]);
+        delete[] (CpuPerf*)m_cpuInfo;
+        delete (MIB_IF_ROW2*)m_ifRow;
+        m_cpuInfo = m_ifRow = m_query = nullptr;
+        m_disks = m_ifaces = 0;
+        m_open  = false;
+    }
+
+    bool Reader::Read(Counters& c) {
+        if (!m_open) return false;
+        CpuPerf* cpu = (CpuPerf*)m_cpuInfo;
+        ULONG got = 0;
+        if (((QueryFn)m_query)(kProcessorPerformance, cpu, sizeof(CpuPerf) * kMaxCpus, &got) < 0) return false;
+        c.cpus = std::min<unsigned>(kMaxCpus, got / sizeof(CpuPerf));
+        c.busy[0] = c.total[0] = 0;
+        for (unsigned i = 0; i < c.cpus; i++) {
+            const uint64_t total = (uint64_t)cpu[i].kernel.QuadPart + (uint64_t)cpu[i].user.QuadPart;
+            c.total[i + 1] = total;
+            c.busy[i + 1]  = total - std::min(total, (uint64_t)cpu[i].idle.QuadPart);
+            c.busy[0]  += c.busy[i + 1];
+            c.total[0] += total;
+        }
+
+        MEMORYSTATUSEX ms{ sizeof(ms) };
+        if (GlobalMemoryStatusEx(&ms)) { c.memTotal = ms.ullTotalPhys; c.memAvail = ms.ullAvailPhys; }
+
+        c.diskRead = c.diskWrite = 0;
+        for (unsigned i = 0; i < m_disks; i++) {
+            DISK_PERFORMANCE perf;
+            DWORD n = 0;
+            if (!DeviceIoControl((HANDLE)m_disk[i], IOCTL_DISK_PERFORMANCE, nullptr, 0, &perf, sizeof(perf), &n, nullptr))
+                continue;
+            c.diskRead  += (uint64_t)perf.BytesRead.QuadPart;
+            c.diskWrite += (uint64_t)perf.BytesWritten.QuadPart;
+        }
+
+        c.netRx = c.netTx = 0;
+        MIB_IF_ROW2* row = (MIB_IF_ROW2*)m_ifRow;
+        for (unsigned i = 0; i < m_ifaces; i++) {
+            std::memset(row, 0, sizeof(*row));
+            row->InterfaceIndex = m_ifIndex[i];
+            if (GetIfEntry2(row) != NO_ERROR) continue;
+            c.netRx += row->InOctets;
+            c.netTx += row->OutOctets;
+        }
+        return true;
+    }
+
+#else
+
+    static constexpr size_t kBufSize = 64 * 1024;      // the cpu lines lead /proc/stat; the rest may be cut
+
+    static const char* const kProcFiles[] = { "/proc/stat", "/proc/meminfo", "/proc/diskstats", "/proc/net/dev" };
+
+    Reader::Reader() = default;
+    Reader::~Reader() { Close(); }
+
+    bool Reader::Open() {
+        Close();
+        for (int i = 0; i < kFiles; i++) m_fd[i] = ::open(kProcFiles[i], O_RDONLY | O_CLOEXEC);
+        if (m_fd[kStat] < 0) { Close(); return false; }
+        m_buf = new char[kBufSize];
+
+        // Whole physical disks (partitions and loop / dm / md devices would
+        // count the same bytes twice) and physical NICs
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        for (fs::directory_iterator it("/sys/block", ec), end; !ec && it != end && m_disks < kMaxDevices; it.increment(ec)) {
+            const std::string n = it->path().filename().string();
+            if (n.size() < sizeof(m_disk[0]) && fs::exists(it->path() / "device", ec))
+                std::strcpy(m_disk[m_disks++], n.c_str());
+        }
+        for (fs::directory_iterator it("/sys/class/net", ec), end; !ec && it != end && m_ifaces < kMaxDevices; it.increment(ec)) {
+            const std::string n = it->path().filename().string();
+            if (n.size() < sizeof(m_iface[0]) && fs::exists(it->path() / "device", ec))
+                std::strcpy(m_iface[m_ifaces++], n.c_str());
+        }
+        m_allIfaces = m_ifaces == 0;
+        m_open = true;
+        return true;
+    }
+
+    void Reader::Close() {
+        for (int& fd : m_fd) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+        delete[] m_buf;
+        m_buf    = nullptr;
+        m_disks  = m_ifaces = 0;
+        m_open   = false;
+    }
+
+    // The whole file, NUL-terminated, in m_buf; reading at offset 0 makes
+    // procfs regenerate it, so the descriptor never needs reopening
+    size_t Reader::Fill(int file) {
+        if (m_fd[file] < 0) return 0;
+        size_t len = 0;
+        while (len < kBufSize - 1) {
+            const ssize_t n = ::pread(m_fd[file], m_buf + len, kBufSize - 1 - len, (off_t)len);
+            if (n <= 0) break;
+            len += (size_t)n;
+        }
+        m_buf[len] = 0;
+        return len;
+    }
+
+    static const char* NextLine(const char* p) {
+        while (*p && *p != '\n') p++;
+        return *p ? p + 1 : p;
+    }
+
+    static uint64_t Num(const char*& p) {
+        while (*p == ' ' || *p == '\t') p++;
+        uint64_t v = 0;
+        while (*p >= '0' && *p <= '9') v = v * 10 + (uint64_t)(*p++ - '0');
+        return v;
+    }
+
+    // The next whitespace-delimited word, ending at ':' too; false if too long
+    static bool Word(const char*& p, char* out, size_t cap) {
+        while (*p == ' ' || *p == '\t') p++;
+        size_t n = 0;
+        while (*p && *p != ' ' && *p != '\t' && *p != ':' && *p != '\n') {
+            if (n + 1 >= cap) return false;
+            out[n++] = *p++;
+        }
+        out[n] = 0;
+        return n > 0;
+    }
+
+    bool Reader::Read(Counters& c) {
+        if (!m_open || !Fill(kStat)) return false;
+        // "cpu  user nice system idle iowait irq softirq steal …", then cpuN
+        c.cpus = 0;
+        for (const char* line = m_buf; std::strncmp(line, "cpu", 3) == 0; line = NextLine(line)) {
+            const char* p = line + 3;
+            unsigned slot = 0;
+            if (*p >= '0' && *p <= '9') {
+                const uint64_t n = Num(p);
+                if (n >= kMaxCpus) continue;
+                slot   = (unsigned)n + 1;
+                c.cpus = std::max(c.cpus, slot);
+            }
+            uint64_t v[8];
+            for (uint64_t& x : v) x = Num(p);
+            c.busy[slot]  = v[0] + v[1] + v[2] + v[5] + v[6] + v[7];
+            c.total[slot] = c.busy[slot] + v[3] + v[4];
+        }
+        if (!c.total[0]) return false;
+
+        if (Fill(kMem))
+            for (const char* p = m_buf; *p; p = NextLine(p)) {
+                if (!std::strncmp(p, "MemTotal:", 9))          { const char* q = p + 9;  c.memTotal = Num(q) * 1024; }
+                else if (!std::strncmp(p, "MemAvailable:", 13)) { const char* q = p + 13; c.memAvail = Num(q) * 1024; }
+            }
+
+        // "major minor name reads merged sectors ms writes merged sectors …",
+        // in 512-byte sectors whatever the device's own sector size
+        c.diskRead = c.diskWrite = 0;
+        if (Fill(kDisk))
+            for (const char* p = m_buf; *p; p = NextLine(p)) {
+                const char* q = p;
+                char name[32];
+                Num(q); Num(q);
+                if (!Word(q, name, sizeof(name))) continue;
+                bool want = false;
+                for (unsigned i = 0; i < m_disks && !want; i++) want = !std::strcmp(name, m_disk[i]);
+                if (!want) continue;
+                uint64_t f[7];
+                for (uint64_t& x : f) x = Num(q);
+                c.diskRead  += f[2] * 512;
+                c.diskWrite += f[6] * 512;
+            }
+
+        // "  eth0: rx_bytes packets errs drop fifo frame compressed multicast tx_bytes …"
+        c.netRx = c.netTx = 0;
+        if (Fill(kNet))
+            for (const char* p = NextLine(NextLine(m_buf)); *p; p = NextLine(p)) {
+                const char* q = p;
+                char name[32];
+                if (!Word(q, name, sizeof(name)) || *q != ':') continue;
+                q++;
+                bool want = m_allIfaces && std::strcmp(name, "lo") != 0;
+                for (unsigned i = 0; i < m_ifaces && !want; i++) want = !std::strcmp(name, m_iface[i]);
+                if (!want) continue;
+                uint64_t f[9];
+                for (uint64_t& x : f) x = Num(q);
+                c.netRx += f[0];
+                c.netTx += f[8];
+            }
+        return true;
+    }
+
+#endif
+
+    // ── Sampler ───────────────────────────────────────────────────────────────
+
+    bool Sampler::Start(unsigned rateHz) {
+        if (Running() || !m_reader.Open()) return false;
+        m_rateHz = std::clamp(rateHz, 1u, 20u);
+        m_stop   = false;
+        m_ticks  = 0;
+        m_costNs = 0;
+        m_thread = std::thread(&Sampler::Loop, this);
+        return true;
+    }
+
+    void Sampler::Stop() {
+        if (!Running()) return;
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+        m_reader.Close();
+    }
+
+    double Sampler::CostNs() const {
+        const uint64_t n = Ticks();
+        return n ? (double)m_costNs.load(std::memory_order_relaxed) / (double)n : 0.0;
+    }
+
+    // Absolute deadlines, so the rate doesn't drift by the cost of a read
+    void Sampler::Loop() {
+        using Clock = std::chrono::steady_clock;
+        const Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_rateHz));
+        Clock::time_point next = Clock::now(), then{};
+        bool have = false;
+        std::unique_lock<std::mutex> lk(m_mx);
+        while (!m_stop) {
+            lk.unlock();
+            const Clock::time_point t0 = Clock::now();
+            if (m_reader.Read(m_cur)) {
+                if (have) {
+                    Diff(m_cur, m_prev, std::chrono::duration<double>(t0 - then).count(), m_sample);
+                    m_series[(size_t)Series::Cpu].Push(m_sample.cpu);
+                    m_series[(size_t)Series::Memory].Push(m_sample.memory);
+                    m_series[(size_t)Series::DiskRead].Push(m_sample.diskRead);
+                    m_series[(size_t)Series::DiskWrite].Push(m_sample.diskWrite);
+                    m_series[(size_t)Series::NetRx].Push(m_sample.netRx);
+                    m_series[(size_t)Series::NetTx].Push(m_sample.netTx);
+                    for (unsigned i = 0; i < m_sample.cpus; i++) m_core[i].Push(m_sample.core[i]);
+                    m_cpus.store(m_sample.cpus, std::memory_order_relaxed);
+                    m_memTotal.store(m_cur.memTotal, std::memory_order_relaxed);
+                    m_costNs.fetch_add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count(),
+                                       std::memory_order_relaxed);
+                    m_ticks.fetch_add(1, std::memory_order_relaxed);
+                }
+                m_prev = m_cur;
+                then   = t0;
+                have   = true;
+            }
+            lk.lock();
+            next += period;
+            const Clock::time_point now = Clock::now();
+            if (next < now) next = now + period;        // fell behind: don't burst to catch up
+            m_cv.wait_until(lk, next, [this] { return m_stop; });
+        }
+    }
+
+}  // namespace Telemetry
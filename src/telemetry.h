@@ -0,0 +1,147 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  TELEMETRY  —  per-core CPU, memory, disk and network, a few times a second
+// ──────────────────────────────────────────────────────────────────────────────
+//  A sampler thread reads the OS's cumulative counters at a fixed rate, turns
+//  the difference from the previous read into a rate and pushes it into one
+//  fixed-size ring per series.  The UI draws the rings as sparklines, reading
+//  them without a lock.
+//
+//  Steady-state sampling allocates nothing.  The Reader opens its handles
+//  once and rereads them in place: /proc/stat, /proc/meminfo, /proc/diskstats
+//  and /proc/net/dev on Linux, through pread() into one preallocated buffer;
+//  NtQuerySystemInformation, the physical-drive handles and interface rows
+//  on Windows.  The devices counted (whole physical disks, non-loopback
+//  interfaces) are picked once, in Open().
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Telemetry {
+
+    static constexpr unsigned kMaxCpus = 64;
+    static constexpr size_t   kHistory = 240;      // samples per series
+
+    // Single writer, any number of readers.  A reader racing the writer may
+    // see one sample from the next lap; it never sees a torn value.
+    class Ring {
+    public:
+        void     Push(float v);
+        size_t   Read(float* out, size_t max) const;    // newest `max` at most, oldest first
+        float    Last() const;                          // 0 if empty
+        uint64_t Written() const { return m_n.load(std::memory_order_acquire); }
+        void     Clear()         { m_n.store(0, std::memory_order_release); }
+
+    private:
+        std::atomic<float>    m_v[kHistory] = {};
+        std::atomic<uint64_t> m_n{ 0 };
+    };
+    static_assert(std::atomic<float>::is_always_lock_free, "telemetry rings must be lock-free");
+
+    enum class Series : uint8_t { Cpu, Memory, DiskRead, DiskWrite, NetRx, NetTx, Count };
+    const char* SeriesName(Series s);   // "cpu", "memory", "disk_read", …
+    // Cpu and Memory are percentages; the rest bytes per second
+
+    // Cumulative counters as the OS reports them
+    struct Counters {
+        unsigned cpus = 0;                              // per-core slots in use
+        uint64_t busy[kMaxCpus + 1]  = {};              // [0] all cores, then one per core
+        uint64_t total[kMaxCpus + 1] = {};              // same unit as busy (ticks / 100 ns)
+        uint64_t memTotal = 0, memAvail = 0;            // bytes
+        uint64_t diskRead = 0, diskWrite = 0;           // bytes since boot
+        uint64_t netRx = 0, netTx = 0;
+    };
+
+    // One sampling interval, as rates
+    struct Sample {
+        unsigned cpus = 0;
+        float    cpu = 0.0f;                            // % of all cores
+        float    core[kMaxCpus] = {};
+        float    memory = 0.0f;                         // % in use
+        float    diskRead = 0.0f, diskWrite = 0.0f;     // bytes/s
+        float    netRx = 0.0f, netTx = 0.0f;
+    };
+    void Diff(const Counters& now, const Counters& then, double seconds, Sample& out);
+
+    // Platform counter source.  Open() allocates and picks devices; Read()
+    // does neither.
+    class Reader {
+    public:
+        Reader();
+        ~Reader();
+        Reader(const Reader&)            = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        bool Open();
+        void Close();
+        bool Read(Counters& out);       // false if the CPU counters were unreadable
+
+        unsigned Disks() const      { return m_disks; }
+        unsigned Interfaces() const { return m_ifaces; }
+
+    private:
+        static constexpr unsigned kMaxDevices = 16;
+        unsigned m_disks = 0, m_ifaces = 0;
+        bool     m_open  = false;
+#ifdef _WIN32
+        void*    m_disk[kMaxDevices] = {};      // HANDLE, \\.\PhysicalDriveN
+        uint32_t m_ifIndex[kMaxDevices] = {};
+        void*    m_cpuInfo = nullptr;           // SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION[kMaxCpus]
+        void*    m_ifRow   = nullptr;           // MIB_IF_ROW2
+        void*    m_query   = nullptr;           // NtQuerySystemInformation
+#else
+        enum { kStat, kMem, kDisk, kNet, kFiles };
+        int      m_fd[kFiles] = { -1, -1, -1, -1 };
+        char     m_disk[kMaxDevices][32] = {};
+        char     m_iface[kMaxDevices][32] = {};
+        bool     m_allIfaces = false;           // no physical NIC found: every one but lo
+        char*    m_buf = nullptr;               // kBufSize, shared by all four files
+        size_t   Fill(int file);
+#endif
+    };
+
+    class Sampler {
+    public:
+        static constexpr unsigned kDefaultHz = 2;
+
+        Sampler() = default;
+        ~Sampler() { Stop(); }
+        Sampler(const Sampler&)            = delete;
+        Sampler& operator=(const Sampler&) = delete;
+
+        bool Start(unsigned rateHz = kDefaultHz);   // 1–20 Hz; false if already running / no counters
+        void Stop();
+        bool Running() const { return m_thread.joinable(); }
+
+        unsigned    RateHz() const                  { return m_rateHz; }
+        unsigned    Cpus() const                    { return m_cpus.load(std::memory_order_relaxed); }
+        const Ring& Get(Series s) const             { return m_series[(size_t)s]; }
+        const Ring& Core(unsigned i) const          { return m_core[i < kMaxCpus ? i : 0]; }
+        uint64_t    MemTotal() const                { return m_memTotal.load(std::memory_order_relaxed); }
+        uint64_t    Ticks() const                   { return m_ticks.load(std::memory_order_relaxed); }
+        // Mean cost of one Read() + Diff() + push, ns
+        double      CostNs() const;
+
+    private:
+        void Loop();
+
+        Reader                  m_reader;
+        Counters                m_prev, m_cur;
+        Sample                  m_sample;
+        Ring                    m_series[(size_t)Series::Count];
+        Ring                    m_core[kMaxCpus];
+        std::atomic<unsigned>   m_cpus{ 0 };
+        std::atomic<uint64_t>   m_memTotal{ 0 };
+        std::atomic<uint64_t>   m_ticks{ 0 }, m_costNs{ 0 };
+        unsigned                m_rateHz = kDefaultHz;
+        std::thread             m_thread;
+        std::mutex              m_mx;           // only for the stop signal
+        std::condition_variable m_cv;
+        bool                    m_stop = false;
+    };
+
+}  // namespace Telemetry
@@ -0,0 +1,126 @@
+#include "tweaks.h"
+#include "backend.h"
+#include "profiler.h"
+
+#include <chrono>
+
+namespace Tweaks {
+
+    // Budgets cover a spawned helper (powercfg, bcdedit, sc, netsh) or a
+    // settings broadcast that waits on every top-level window
+    static const Info kInfo[] = {
+        { Id::HighPerfPower, "power",          "High Performance Power",     5000 },
+        { Id::TimerRes,      "timer",          "High-Res Timer (1ms)",       5000 },
+        { Id::CpuPriority,   "cpu-priority",   "CPU Priority Boost",         1000 },
+        { Id::Network,       "network",        "Network Low-Latency",       10000 },
+        { Id::KillExplorer,  "kill-explorer",  "Kill Windows Explorer",      5000 },
+        { Id::SuperfetchOff, "superfetch-off", "Disable SuperFetch",        10000 },
+        { Id::AnimationsOff, "animations-off", "Disable Windows Animations", 3000 },
+        { Id::GameMode,      "game-mode",      "Game Mode",                  1000 },
+        { Id::GameBarOff,    "gamebar-off",    "Disable Xbox Game Bar/DVR",  1000 },
+    };
+    static_assert(sizeof(kInfo) / sizeof(kInfo[0]) == (size_t)Id::Count, "kInfo out of sync with Id");
+
+    const Info& Describe(Id id) { return kInfo[(size_t)id]; }
+
+    bool FindKey(const std::string& key, Id& out) {
+        for (auto& i : kInfo)
+            if (key == i.key) { out = i.id; return true; }
+        return false;
+    }
+
+    bool Ordered(Id a, Id b) {
+        static const std::pair<Id, Id> kPairs[] = {
+            // Explorer reads the animation settings when it starts
+            { Id::AnimationsOff, Id::KillExplorer },
+        };
+        for (auto& p : kPairs)
+            if ((p.first == a && p.second == b) || (p.first == b && p.second == a)) return true;
+        return false;
+    }
+
+    const std::vector<Profile>& Profiles() {
+        static const std::vector<Profile> p = {
+            { "gaming", "Power, timer, scheduler and network tweaks for play", {
+                { Id::HighPerfPower, true }, { Id::TimerRes, true }, { Id::CpuPriority, true },
+                { Id::GameMode, true }, { Id::GameBarOff, true }, { Id::Network, true },
+            } },
+            { "max", "Everything in gaming plus shell, SuperFetch and animations", {
+                { Id::HighPerfPower, true }, { Id::TimerRes, true }, { Id::CpuPriority, true },
+                { Id::GameMode, true }, { Id::GameBarOff, true }, { Id::Network, true },
+                { Id::SuperfetchOff, true }, { Id::AnimationsOff, true }, { Id::KillExplorer, true },
+            } },
+            { "competitive", "Latency first: gaming plus SuperFetch and animations off, shell kept", {
+                { Id::HighPerfPower, true }, { Id::TimerRes, true }, { Id::CpuPriority, true },
+                { Id::GameMode, true }, { Id::GameBarOff, true }, { Id::Network, true },
+                { Id::SuperfetchOff, true }, { Id::AnimationsOff, true }, { Id::KillExplorer, false },
+            } },
+            { "desktop", "Everyday use: every tweak back to the Windows defaults", {
+                { Id::KillExplorer, false }, { Id::AnimationsOff, false }, { Id::SuperfetchOff, false },
+                { Id::Network, false }, { Id::GameBarOff, false }, { Id::GameMode, false },
+                { Id::CpuPriority, false }, { Id::TimerRes, false }, { Id::HighPerfPower, false },
+            } },
+        };
+        return p;
+    }
+
+    const Profile* FindProfile(const std::string& name) {
+        for (auto& p : Profiles())
+            if (name == p.name) return &p;
+        return nullptr;
+    }
+
+    StepResult RunStep(Sys::Backend& be, Id id, bool on, uint32_t timeoutMs) {
+        XOPT_ZONE("Tweaks::RunStep");
+        StepResult r{ id, on, Status::Skipped, 0.0, Error::Unsupported };
+        if (!be.Supported(id)) return r;
+        const auto t0 = Sys::Clock::now();
+        if (timeoutMs) Sys::SetCallDeadline(t0 + std::chrono::milliseconds(timeoutMs));
+        Sys::SetCallError(Error::None);
+        const bool ok = be.Set(id, on);
+        r.error = ok ? Error::None : Sys::CallError() != Error::None ? Sys::CallError() : Error::Failed;
+        if (timeoutMs) Sys::SetCallDeadline({});
+        r.ms = std::chrono::duration<double, std::milli>(Sys::Clock::now() - t0).count();
+        r.slow = timeoutMs && r.ms > timeoutMs && r.error == Error::None;
+        r.status = r.error == Error::None     ? Status::Ok
+                 : r.error == Error::TimedOut ? Status::TimedOut
+                                              : Status::Failed;
+        return r;
+    }
+
+    std::vector<StepResult> ApplyProfile(Sys::Backend& be, const Profile& p,
+                                         const std::function<void(const StepResult&)>& onStep) {
+        std::vector<StepResult> out;
+        out.reserve(p.steps.size());
+        for (auto& st : p.steps) {
+            out.push_back(RunStep(be, st.first, st.second));
+            if (onStep) onStep(out.back());
+        }
+        return out;
+    }
+
+    const char* StatusName(Status s) {
+        switch (s) {
+            case Status::Ok:        return "ok";
+            case Status::Failed:    return "failed";
+            case Status::Skipped:   return "skipped";
+            case Status::TimedOut:  return "timed_out";
+            case Status::Cancelled: return "cancelled";
+        }
+        return "?";
+    }
+
+    const char* ErrorName(Error e) {
+        switch (e) {
+            case Error::None:        return "none";
+            case Error::Unsupported: return "unsupported";
+            case Error::Denied:      return "denied";
+            case Error::NotFound:    return "not_found";
+            case Error::TimedOut:    return "timed_out";
+            case Error::Io:          return "io";
+            case Error::Failed:      return "failed";
+        }
+        return "?";
+    }
+
+}  // namespace Tweaks
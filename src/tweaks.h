@@ -0,0 +1,82 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  TWEAKS  —  boost toggles and named boost profiles
+// ──────────────────────────────────────────────────────────────────────────────
+//  Identifies the toggles behind the Boost panel and groups them into
+//  profiles; the OS effect of each one lives in a Sys::Backend.  `on` always
+//  means "boosted" (e.g. Set(AnimationsOff, true) disables animations).
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Sys { class Backend; }
+
+namespace Tweaks {
+
+    enum class Id : uint8_t {
+        HighPerfPower,
+        TimerRes,
+        CpuPriority,
+        Network,
+        KillExplorer,
+        SuperfetchOff,
+        AnimationsOff,
+        GameMode,
+        GameBarOff,
+        Count
+    };
+
+    struct Info {
+        Id          id;
+        const char* key;        // stable name used by profiles / the CLI
+        const char* label;
+        uint32_t    timeoutMs;  // budget for one Set() before the scheduler gives up on it
+    };
+
+    const Info& Describe(Id id);
+    bool        FindKey(const std::string& key, Id& out);
+    // a and b touch shared state (e.g. a shell restart must see the new
+    // animation settings): never run them concurrently — profile order wins
+    bool        Ordered(Id a, Id b);
+
+    // ── Named boost profiles ──────────────────────────────────────────────────
+    struct Profile {
+        std::string                      name;
+        std::string                      desc;
+        std::vector<std::pair<Id, bool>> steps;   // applied in order
+    };
+
+    const std::vector<Profile>& Profiles();
+    const Profile*              FindProfile(const std::string& name);
+
+    // Skipped: unsupported here.  Cancelled: never started because an
+    // earlier step of the same transaction failed.
+    enum class Status : uint8_t { Ok, Failed, Skipped, TimedOut, Cancelled };
+
+    // Why a backend call failed (Sys::CallError()).  Failed: the API or
+    // helper said no without saying why.
+    enum class Error : uint8_t { None, Unsupported, Denied, NotFound, TimedOut, Io, Failed };
+
+    struct StepResult {
+        Id     id;
+        bool   on;
+        Status status;
+        double ms;
+        Error  error = Error::None;
+        bool   slow  = false;       // Ok, but took longer than its timeout
+    };
+
+    // One Set() on `be`, timed; with a timeout it runs under that call
+    // deadline.  TimedOut only when the deadline abandoned the call; a Set
+    // that finished late still succeeded and is Ok with `slow` set
+    StepResult RunStep(Sys::Backend& be, Id id, bool on, uint32_t timeoutMs = 0);
+    // Runs every step on `be`, reporting each as it completes
+    std::vector<StepResult> ApplyProfile(Sys::Backend& be, const Profile& p,
+                                         const std::function<void(const StepResult&)>& onStep = {});
+    const char* StatusName(Status s);
+    const char* ErrorName(Error e);
+
+}  // namespace Tweaks
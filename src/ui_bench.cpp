@@ -0,0 +1,232 @@
+#include "ui_bench.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace UiBench {
+
+    static const char kMagic[4] = { 'X', 'O', 'U', '1' };
+
+    static uint64_t NowNs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // ── Scripted input ────────────────────────────────────────────────────────
+    bool ParseScript(const std::string& text, std::vector<Input>& out, std::string* error) {
+        out.clear();
+        std::istringstream in(text);
+        std::string line;
+        for (unsigned n = 1; std::getline(in, line); n++) {
+            const size_t hash = line.find('#');
+            if (hash != std::string::npos) line.resize(hash);
+            std::istringstream ls(line);
+            std::string verb;
+            Input e;
+            if (!(ls >> e.frame)) {
+                if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                if (error) *error = "line " + std::to_string(n) + ": expected a frame number";
+                return false;
+            }
+            ls >> verb;
+            bool ok = false;
+            if (verb == "move")       { e.kind = Input::Kind::Move;  ok = (bool)(ls >> e.x >> e.y); }
+            else if (verb == "down")  { e.kind = Input::Kind::Down;  ok = (bool)(ls >> e.button) && e.button >= 0 && e.button < 5; }
+            else if (verb == "up")    { e.kind = Input::Kind::Up;    ok = (bool)(ls >> e.button) && e.button >= 0 && e.button < 5; }
+            else if (verb == "wheel") { e.kind = Input::Kind::Wheel; ok = (bool)(ls >> e.y); }
+            else if (verb == "tab")   { e.kind = Input::Kind::Tab;   ok = (bool)(ls >> e.x) && e.x >= 0.0f; }
+            if (!ok) {
+                if (error) *error = "line " + std::to_string(n) + ": expected move X Y, down B, up B, wheel N or tab I";
+                return false;
+            }
+            out.push_back(e);
+        }
+        std::stable_sort(out.begin(), out.end(), [](const Input& a, const Input& b) { return a.frame < b.frame; });
+        return true;
+    }
+
+    std::vector<Input> DefaultScript(unsigned tabs, unsigned framesPerTab, float width, float height) {
+        std::vector<Input> s;
+        const unsigned sweep = framesPerTab / 2, scroll = framesPerTab / 4;
+        for (unsigned t = 0; t < tabs; t++) {
+            const uint32_t f0 = t * framesPerTab;
+            Input tab;
+            tab.frame = f0; tab.kind = Input::Kind::Tab; tab.x = (float)t;
+            s.push_back(tab);
+            for (unsigned i = 0; i < sweep; i++) {                  // hover down the content column
+                Input m;
+                m.frame = f0 + framesPerTab / 8 + i;
+                m.kind  = Input::Kind::Move;
+                m.x     = width * (i & 1 ? 0.85f : 0.5f);           // toggles sit on the right
+                m.y     = 80.0f + (height - 100.0f) * (float)i / (float)std::max(1u, sweep);
+                s.push_back(m);
+            }
+            for (unsigned i = 0; i < scroll; i++) {                 // down, then back up
+                Input w;
+                w.frame = f0 + framesPerTab / 8 + sweep + i;
+                w.kind  = Input::Kind::Wheel;
+                w.y     = i < scroll / 2 ? -1.0f : 1.0f;
+                s.push_back(w);
+            }
+        }
+        return s;
+    }
+
+    // ── Recording ─────────────────────────────────────────────────────────────
+    static Recorder* g_active = nullptr;
+
+    void      SetActive(Recorder* r) { g_active = r; }
+    Recorder* Active()               { return g_active; }
+
+    void Recorder::BeginFrame() {
+        m_drawn.clear();
+        m_frameAllocs = Allocs();
+        m_frameNs     = NowNs();
+    }
+
+    void Recorder::BeginPanel(const char* name) {
+        m_panel       = name;
+        m_panelAllocs = Allocs();
+        m_panelNs     = NowNs();
+    }
+
+    void Recorder::EndPanel() {
+        Sample s;
+        s.cpuUs       = (double)(NowNs() - m_panelNs) / 1e3;
+        s.allocations = Allocs() - m_panelAllocs;
+        m_samples[m_panel].push_back(s);
+        m_drawn.push_back(m_panel);
+    }
+
+    void Recorder::EndFrame(uint32_t drawCalls, uint32_t vertices, uint32_t indices) {
+        Sample f;
+        f.cpuUs       = (double)(NowNs() - m_frameNs) / 1e3;
+        f.allocations = Allocs() - m_frameAllocs;
+        f.drawCalls = drawCalls; f.vertices = vertices; f.indices = indices;
+        m_samples[kFrame].push_back(f);
+        for (const std::string& p : m_drawn) {
+            Sample& s = m_samples[p].back();
+            s.drawCalls = drawCalls; s.vertices = vertices; s.indices = indices;
+        }
+        m_frames++;
+    }
+
+    template <class T, class Get>
+    static double Percentile(const std::vector<T>& v, double q, Get get) {
+        std::vector<double> x;
+        x.reserve(v.size());
+        for (const T& e : v) x.push_back((double)get(e));
+        if (x.empty()) return 0.0;
+        const size_t k = std::min(x.size() - 1, (size_t)(q * (double)(x.size() - 1) + 0.5));
+        std::nth_element(x.begin(), x.begin() + (ptrdiff_t)k, x.end());
+        return x[k];
+    }
+
+    std::vector<Summary> Recorder::Summarize() const {
+        std::vector<Summary> out;
+        for (auto& kv : m_samples) {
+            const std::vector<Sample>& v = kv.second;
+            Summary s;
+            s.name        = kv.first;
+            s.frames      = (uint32_t)v.size();
+            s.cpuP50Us    = Percentile(v, 0.50, [](const Sample& e) { return e.cpuUs; });
+            s.cpuP95Us    = Percentile(v, 0.95, [](const Sample& e) { return e.cpuUs; });
+            s.cpuMaxUs    = Percentile(v, 1.00, [](const Sample& e) { return e.cpuUs; });
+            s.drawCalls   = Percentile(v, 0.50, [](const Sample& e) { return e.drawCalls; });
+            s.vertices    = Percentile(v, 0.50, [](const Sample& e) { return e.vertices; });
+            s.indices     = Percentile(v, 0.50, [](const Sample& e) { return e.indices; });
+            s.allocations = Percentile(v, 0.50, [](const Sample& e) { return e.allocations; });
+            out.push_back(std::move(s));
+        }
+        std::stable_partition(out.begin(), out.end(), [](const Summary& s) { return s.name == kFrame; });
+        return out;
+    }
+
+    // ── Baselines ─────────────────────────────────────────────────────────────
+    std::vector<Regression> Compare(const std::vector<Summary>& base, const std::vector<Summary>& cur,
+                                    const Thresholds& t) {
+        std::vector<Regression> out;
+        for (const Summary& b : base) {
+            auto it = std::find_if(cur.begin(), cur.end(), [&](const Summary& c) { return c.name == b.name; });
+            if (it == cur.end()) {
+                Regression r;
+                r.panel = b.name; r.metric = "missing";
+                out.push_back(r);
+                continue;
+            }
+            auto check = [&](const char* metric, double before, double after, double pct, double floor) {
+                if (after - before <= floor) return;
+                const double worse = before > 0.0 ? (after - before) / before * 100.0 : 100.0;
+                if (worse <= pct) return;
+                Regression r;
+                r.panel = b.name; r.metric = metric;
+                r.before = before; r.after = after; r.pct = worse;
+                out.push_back(r);
+            };
+            check("cpu_p50_us",  b.cpuP50Us,    it->cpuP50Us,    t.cpuPct,   t.cpuFloorUs);
+            check("draw_calls",  b.drawCalls,   it->drawCalls,   t.drawPct,  0.0);
+            check("vertices",    b.vertices,    it->vertices,    t.drawPct,  0.0);
+            check("allocations", b.allocations, it->allocations, t.allocPct, t.allocFloor);
+        }
+        return out;
+    }
+
+    bool SaveBaseline(const fs::path& p, const std::vector<Summary>& s, std::string* error) {
+        BaselineHeader h{};
+        std::memcpy(h.magic, kMagic, 4);
+        h.version = kBaselineVersion;
+        h.count   = (uint16_t)std::min<size_t>(s.size(), 0xFFFF);
+        std::vector<uint8_t> buf(sizeof(h) + (size_t)h.count * sizeof(BaselineRecord));
+        std::memcpy(buf.data(), &h, sizeof(h));
+        uint8_t* d = buf.data() + sizeof(h);
+        for (size_t i = 0; i < h.count; i++, d += sizeof(BaselineRecord)) {
+            BaselineRecord r{};
+            std::memcpy(r.name, s[i].name.data(), std::min(s[i].name.size(), sizeof(r.name) - 1));
+            r.frames      = s[i].frames;
+            r.cpuP50Us    = s[i].cpuP50Us;  r.cpuP95Us = s[i].cpuP95Us;  r.cpuMaxUs = s[i].cpuMaxUs;
+            r.drawCalls   = s[i].drawCalls; r.vertices = s[i].vertices;  r.indices  = s[i].indices;
+            r.allocations = s[i].allocations;
+            std::memcpy(d, &r, sizeof(r));
+        }
+        std::error_code ec;
+        if (p.has_parent_path()) fs::create_directories(p.parent_path(), ec);
+        if (IO::WriteFileAtomic(p, buf.data(), buf.size())) return true;
+        if (error) *error = "cannot write " + p.u8string();
+        return false;
+    }
+
+    bool LoadBaseline(const fs::path& p, std::vector<Summary>& out, std::string* error) {
+        out.clear();
+        auto fail = [&](const char* why) {
+            out.clear();
+            if (error) *error = why;
+            return false;
+        };
+        IO::MappedFile f;
+        if (!f.Open(p)) return fail("no baseline yet");
+        BaselineHeader h;
+        if (f.Size() < sizeof(h)) return fail("baseline truncated");
+        std::memcpy(&h, f.Data(), sizeof(h));
+        if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kBaselineVersion)
+            return fail("baseline has an unknown format");
+        if (f.Size() != sizeof(h) + (size_t)h.count * sizeof(BaselineRecord)) return fail("baseline is corrupt");
+        const uint8_t* d = f.Data() + sizeof(h);
+        for (unsigned i = 0; i < h.count; i++, d += sizeof(BaselineRecord)) {
+            BaselineRecord r;
+            std::memcpy(&r, d, sizeof(r));
+            Summary s;
+            s.name.assign(r.name, strnlen(r.name, sizeof(r.name)));
+            s.frames      = r.frames;
+            s.cpuP50Us    = r.cpuP50Us;  s.cpuP95Us = r.cpuP95Us;  s.cpuMaxUs = r.cpuMaxUs;
+            s.drawCalls   = r.drawCalls; s.vertices = r.vertices;  s.indices  = r.indices;
+            s.allocations = r.allocations;
+            out.push_back(std::move(s));
+        }
+        return true;
+    }
+
+}  // namespace UiBench
@@ -0,0 +1,146 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  UI BENCH  —  per-panel cost of the UI frame, and a gate against regressions
+// ──────────────────────────────────────────────────────────────────────────────
+//  The headless UI driver (xopt-uibench) runs RenderUI with no window and no
+//  device.  It feeds scripted input with a fixed DeltaTime and counts the
+//  draw data each frame instead of rasterizing it.  RenderUI puts the active
+//  panel inside a PanelScope.  While a Recorder is Active(), each scope
+//  records the panel's CPU time and heap allocations.  The frame's draw
+//  calls, vertices and indices are charged to the panel that frame showed,
+//  plus a "frame" entry for the whole of NewFrame → Render.  In the GUI no
+//  recorder is active, and a scope costs one load.
+//
+//  Summaries use medians, so the first frame after a tab switch (window
+//  creation, first-use allocations) doesn't skew a panel.  A baseline is the
+//  summaries saved on one machine.  Compare() lists each panel metric that
+//  got worse by more than its threshold.
+//
+//  On disk (native endianness):
+//      BaselineHeader | BaselineRecord[count]
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace UiBench {
+
+    namespace fs = std::filesystem;
+
+    // ── Scripted input ────────────────────────────────────────────────────────
+    struct Input {
+        enum class Kind : uint8_t { Move, Down, Up, Wheel, Tab };
+        uint32_t frame  = 0;        // applied before this frame
+        Kind     kind   = Kind::Move;
+        float    x = 0, y = 0;      // Move: position; Wheel: y notches; Tab: x = index
+        int      button = 0;
+    };
+
+    // One event per line, "#" starts a comment:
+    //     <frame> move X Y | down B | up B | wheel N | tab I
+    // Sorted by frame on return
+    bool ParseScript(const std::string& text, std::vector<Input>& out, std::string* error = nullptr);
+    // Every tab for `framesPerTab` frames: settle, sweep the pointer down the
+    // content column (hover states), scroll down and back up.  No clicks, so
+    // nothing on the host is changed.
+    std::vector<Input> DefaultScript(unsigned tabs, unsigned framesPerTab, float width, float height);
+
+    // ── Recording ─────────────────────────────────────────────────────────────
+    struct Sample {
+        double   cpuUs       = 0.0;
+        uint32_t drawCalls   = 0, vertices = 0, indices = 0;
+        uint64_t allocations = 0;
+    };
+
+    struct Summary {
+        std::string name;
+        uint32_t    frames      = 0;
+        double      cpuP50Us    = 0.0, cpuP95Us = 0.0, cpuMaxUs = 0.0;
+        double      drawCalls   = 0.0, vertices = 0.0, indices = 0.0;   // medians
+        double      allocations = 0.0;                                  // median per frame
+    };
+
+    class Recorder {
+    public:
+        static constexpr const char* kFrame = "frame";
+
+        // `allocations`: heap allocations so far (the executable counts them)
+        explicit Recorder(uint64_t (*allocations)() = nullptr) : m_allocs(allocations) {}
+
+        void BeginFrame();
+        void BeginPanel(const char* name);      // panels don't nest
+        void EndPanel();
+        void EndFrame(uint32_t drawCalls, uint32_t vertices, uint32_t indices);
+
+        std::vector<Summary> Summarize() const; // "frame" first, then by name
+        uint32_t             Frames() const { return m_frames; }
+
+    private:
+        uint64_t Allocs() const { return m_allocs ? m_allocs() : 0; }
+
+        uint64_t (*m_allocs)();
+        std::map<std::string, std::vector<Sample>> m_samples;
+        std::vector<std::string> m_drawn;       // panels this frame
+        std::string m_panel;
+        uint64_t    m_panelNs = 0, m_panelAllocs = 0;
+        uint64_t    m_frameNs = 0, m_frameAllocs = 0;
+        uint32_t    m_frames  = 0;
+    };
+
+    // The recorder PanelScope reports to; null records nothing
+    void      SetActive(Recorder* r);
+    Recorder* Active();
+
+    class PanelScope {
+    public:
+        explicit PanelScope(const char* name) : m_rec(Active()) { if (m_rec) m_rec->BeginPanel(name); }
+        ~PanelScope() { if (m_rec) m_rec->EndPanel(); }
+        PanelScope(const PanelScope&)            = delete;
+        PanelScope& operator=(const PanelScope&) = delete;
+
+    private:
+        Recorder* m_rec;
+    };
+
+    // ── Baselines ─────────────────────────────────────────────────────────────
+    struct Thresholds {
+        double cpuPct     = 25.0;   // median CPU time
+        double cpuFloorUs = 20.0;   // … ignoring changes smaller than this
+        double drawPct    = 10.0;   // draw calls, vertices
+        double allocPct   = 10.0;
+        double allocFloor = 2.0;    // allocations per frame
+    };
+
+    struct Regression {
+        std::string panel;
+        const char* metric = "";    // "cpu_p50_us", "draw_calls", "vertices", "allocations", "missing"
+        double      before = 0.0, after = 0.0;
+        double      pct    = 0.0;   // worse by, in percent
+    };
+
+    std::vector<Regression> Compare(const std::vector<Summary>& baseline, const std::vector<Summary>& current,
+                                    const Thresholds& t = {});
+
+    struct BaselineHeader {         // 8 bytes
+        char     magic[4];          // "XOU1"
+        uint8_t  version;
+        uint8_t  reserved;
+        uint16_t count;
+    };
+
+    struct BaselineRecord {         // 96 bytes
+        char     name[32];          // NUL-padded
+        uint32_t frames;
+        uint32_t reserved;
+        double   cpuP50Us, cpuP95Us, cpuMaxUs;
+        double   drawCalls, vertices, indices, allocations;
+    };
+
+    static constexpr uint8_t kBaselineVersion = 1;
+
+    bool SaveBaseline(const fs::path& p, const std::vector<Summary>& s, std::string* error = nullptr);
+    bool LoadBaseline(const fs::path& p, std::vector<Summary>& out, std::string* error = nullptr);
+
+}  // namespace UiBench
@@ -0,0 +1,273 @@
+// xopt-uibench — drives the GUI's RenderUI with no window and no device
+// (see ui_bench.h).  Plays the platform backend with scripted input and a
+// fixed DeltaTime, and the renderer backend by consuming the draw data
+// instead of submitting it.  Prints per-panel costs as JSON; with
+// --baseline, exits 1 when a panel regressed past its threshold.
+#include "imgui.h"
+#include "json_writer.h"
+#include "ui_bench.h"
+#include "ui_host.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Counted here, like xopt-cli's, so the operators never inline into the UI
+// code they measure.  ImGui allocates through its own hooks; both count.
+static std::atomic<uint64_t> g_allocs{ 0 };
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept              { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static void* ImAlloc(size_t n, void*) { g_allocs.fetch_add(1, std::memory_order_relaxed); return std::malloc(n); }
+static void  ImFree(void* p, void*)   { std::free(p); }
+
+static uint64_t Allocations() { return g_allocs.load(std::memory_order_relaxed); }
+
+namespace {
+
+    struct Args {
+        unsigned    framesPerTab = 240;
+        unsigned    frames       = 0;       // 0: the script's length
+        float       dt           = 1.0f / 60.0f;
+        float       width        = 1050.0f, height = 680.0f;    // the GUI's window
+        fs::path    script, baseline;
+        bool        updateBaseline = false;
+        bool        fontCache      = true;
+        bool        pretty         = false;
+        UiBench::Thresholds th;
+    };
+
+    void Usage(FILE* f) {
+        std::fputs(
+            "usage: xopt-uibench [options]\n"
+            "  --frames-per-tab N   default script: frames on each tab (240)\n"
+            "  --script FILE        scripted input instead, one event per line:\n"
+            "                         <frame> move X Y | down B | up B | wheel N | tab I\n"
+            "  --frames N           frames to run (default: the script's last event + 60)\n"
+            "  --dt SECONDS         DeltaTime of every frame (1/60)\n"
+            "  --size WxH           display size (1050x680)\n"
+            "  --baseline FILE      compare against FILE; created from this run if missing\n"
+            "  --update-baseline    overwrite FILE with this run instead of comparing\n"
+            "  --threshold PCT      CPU regression threshold per panel (25)\n"
+            "  --no-font-cache      bake the font atlas instead of mapping the cached one\n"
+            "  --pretty             indent the JSON report\n"
+            "exit: 0 ok, 1 a panel regressed, 2 usage or I/O error\n", f);
+    }
+
+    bool ParseArgs(int argc, char** argv, Args& a) {
+        for (int i = 1; i < argc; i++) {
+            const char* s = argv[i];
+            auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+            if      (!std::strcmp(s, "--update-baseline")) a.updateBaseline = true;
+            else if (!std::strcmp(s, "--no-font-cache"))   a.fontCache      = false;
+            else if (!std::strcmp(s, "--pretty"))          a.pretty         = true;
+            else if (!std::strcmp(s, "--frames-per-tab")) {
+                const char* v = next(); if (!v) return false;
+                a.framesPerTab = (unsigned)std::strtoul(v, nullptr, 10);
+                if (a.framesPerTab < 8) return false;
+            } else if (!std::strcmp(s, "--frames")) {
+                const char* v = next(); if (!v) return false;
+                a.frames = (unsigned)std::strtoul(v, nullptr, 10);
+            } else if (!std::strcmp(s, "--dt")) {
+                const char* v = next(); if (!v) return false;
+                a.dt = std::strtof(v, nullptr);
+                if (!(a.dt > 0.0f)) return false;
+            } else if (!std::strcmp(s, "--size")) {
+                const char* v = next(); if (!v) return false;
+                char* x = nullptr;
+                a.width = std::strtof(v, &x);
+                if (!x || (*x != 'x' && *x != 'X')) return false;
+                a.height = std::strtof(x + 1, nullptr);
+                if (a.width < 320.0f || a.height < 240.0f) return false;
+            } else if (!std::strcmp(s, "--script")) {
+                const char* v = next(); if (!v) return false;
+                a.script = fs::u8path(v);
+            } else if (!std::strcmp(s, "--baseline")) {
+                const char* v = next(); if (!v) return false;
+                a.baseline = fs::u8path(v);
+            } else if (!std::strcmp(s, "--threshold")) {
+                const char* v = next(); if (!v) return false;
+                a.th.cpuPct = std::strtod(v, nullptr);
+                if (!(a.th.cpuPct > 0.0)) return false;
+            } else {
+                return false;
+            }
+        }
+        return !a.updateBaseline || !a.baseline.empty();
+    }
+
+    // What the renderer backend would submit, without a device: one draw
+    // call per command, plus the pixels it would cover (overdraw included)
+    struct DrawCost {
+        uint32_t drawCalls = 0, vertices = 0, indices = 0;
+        double   fill      = 0.0;           // covered area / display area
+    };
+
+    DrawCost Consume(const ImDrawData* dd) {
+        DrawCost c;
+        if (!dd) return c;
+        c.vertices = (uint32_t)dd->TotalVtxCount;
+        c.indices  = (uint32_t)dd->TotalIdxCount;
+        double area = 0.0;
+        for (int n = 0; n < dd->CmdListsCount; n++) {
+            const ImDrawList* dl = dd->CmdLists[n];
+            for (const ImDrawCmd& cmd : dl->CmdBuffer) {
+                if (cmd.UserCallback || !cmd.ElemCount) continue;
+                c.drawCalls++;
+                for (unsigned i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                    const ImDrawIdx* ix = dl->IdxBuffer.Data + cmd.IdxOffset + i;
+                    const ImDrawVert* v = dl->VtxBuffer.Data + cmd.VtxOffset;
+                    const ImVec2 a = v[ix[0]].pos, b = v[ix[1]].pos, d = v[ix[2]].pos;
+                    area += std::fabs((b.x - a.x) * (d.y - a.y) - (d.x - a.x) * (b.y - a.y)) * 0.5;
+                }
+            }
+        }
+        const double screen = (double)dd->DisplaySize.x * dd->DisplaySize.y;
+        c.fill = screen > 0.0 ? area / screen : 0.0;
+        return c;
+    }
+
+    void Apply(ImGuiIO& io, const UiBench::Input& e) {
+        using K = UiBench::Input::Kind;
+        switch (e.kind) {
+            case K::Move:  io.AddMousePosEvent(e.x, e.y);              break;
+            case K::Down:  io.AddMouseButtonEvent(e.button, true);     break;
+            case K::Up:    io.AddMouseButtonEvent(e.button, false);    break;
+            case K::Wheel: io.AddMouseWheelEvent(0.0f, e.y);           break;
+            case K::Tab:   UiHost::SetTab((int)e.x);                   break;
+        }
+    }
+
+    void WriteSummary(IO::JsonWriter& w, const UiBench::Summary& s) {
+        w.BeginObject();
+        w.Field("name", s.name);
+        w.Field("frames", (uint64_t)s.frames);
+        w.Field("cpu_p50_us", s.cpuP50Us);
+        w.Field("cpu_p95_us", s.cpuP95Us);
+        w.Field("cpu_max_us", s.cpuMaxUs);
+        w.Field("draw_calls", s.drawCalls);
+        w.Field("vertices", s.vertices);
+        w.Field("indices", s.indices);
+        w.Field("allocations", s.allocations);
+        w.EndObject();
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args a;
+    if (!ParseArgs(argc, argv, a)) { Usage(stderr); return 2; }
+
+    std::vector<UiBench::Input> script;
+    if (!a.script.empty()) {
+        std::ifstream in(a.script, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+        std::string err;
+        if (!in || !UiBench::ParseScript(text.str(), script, &err)) {
+            std::fprintf(stderr, "%s: %s\n", a.script.u8string().c_str(), in ? err.c_str() : "cannot read");
+            return 2;
+        }
+    }
+
+    ImGui::SetAllocatorFunctions(ImAlloc, ImFree);
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename  = nullptr;          // no imgui.ini next to the bench
+    io.LogFilename  = nullptr;
+    io.DisplaySize  = { a.width, a.height };
+    io.DeltaTime    = a.dt;
+    io.BackendPlatformName = "xopt_uibench";
+    io.BackendRendererName = "xopt_uibench";
+    UiHost::Init(a.fontCache);
+
+    // The renderer's only duty before the first frame: take the atlas
+    unsigned char* px = nullptr;
+    int tw = 0, th = 0;
+    io.Fonts->GetTexDataAsRGBA32(&px, &tw, &th);
+    io.Fonts->SetTexID((ImTextureID)(intptr_t)1);
+
+    if (script.empty()) script = UiBench::DefaultScript((unsigned)UiHost::Tabs(), a.framesPerTab, a.width, a.height);
+    const unsigned frames = a.frames ? a.frames : script.empty() ? a.framesPerTab : script.back().frame + 60;
+
+    UiBench::Recorder rec(Allocations);
+    UiBench::SetActive(&rec);
+    double fill = 0.0;
+    size_t next = 0;
+    for (unsigned f = 0; f < frames; f++) {
+        for (; next < script.size() && script[next].frame <= f; next++) Apply(io, script[next]);
+        io.DeltaTime = a.dt;
+        rec.BeginFrame();
+        const DrawCost c = Consume(UiHost::Frame());
+        rec.EndFrame(c.drawCalls, c.vertices, c.indices);
+        fill += c.fill;
+    }
+    UiBench::SetActive(nullptr);
+    UiHost::Shutdown();
+    ImGui::DestroyContext();
+
+    const std::vector<UiBench::Summary> cur = rec.Summarize();
+    std::vector<UiBench::Summary>    base;
+    std::vector<UiBench::Regression> regressions;
+    const char* baseline = "none";
+    std::string err;
+    if (!a.baseline.empty()) {
+        if (!a.updateBaseline && UiBench::LoadBaseline(a.baseline, base, &err)) {
+            regressions = UiBench::Compare(base, cur, a.th);
+            baseline = "compared";
+        } else if (a.updateBaseline || !fs::exists(a.baseline)) {
+            if (!UiBench::SaveBaseline(a.baseline, cur, &err)) {
+                std::fprintf(stderr, "%s\n", err.c_str());
+                return 2;
+            }
+            baseline = a.updateBaseline ? "updated" : "created";
+        } else {
+            std::fprintf(stderr, "%s: %s\n", a.baseline.u8string().c_str(), err.c_str());
+            return 2;
+        }
+    }
+
+    IO::JsonWriter w(stdout, a.pretty);
+    w.BeginObject();
+    w.Field("frames", (uint64_t)rec.Frames());
+    w.Field("dt", (double)a.dt);
+    w.Field("width", (double)a.width);
+    w.Field("height", (double)a.height);
+    w.Field("fill_per_frame", frames ? fill / frames : 0.0);
+    w.Key("panels").BeginArray();
+    for (const UiBench::Summary& s : cur) WriteSummary(w, s);
+    w.EndArray();
+    w.Field("baseline", baseline);
+    w.Field("cpu_threshold_pct", a.th.cpuPct);
+    w.Key("regressions").BeginArray();
+    for (const UiBench::Regression& r : regressions) {
+        w.BeginObject();
+        w.Field("panel", r.panel);
+        w.Field("metric", r.metric);
+        w.Field("before", r.before);
+        w.Field("after", r.after);
+        w.Field("worse_pct", r.pct);
+        w.EndObject();
+    }
+    w.EndArray();
+    w.Field("ok", regressions.empty());
+    w.EndObject();
+    w.Finish();
+    return regressions.empty() ? 0 : 1;
+}
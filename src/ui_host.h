@@ -0,0 +1,24 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  UI HOST  —  main.cpp's UI without its window, for the headless UI bench
+// ──────────────────────────────────────────────────────────────────────────────
+//  main.cpp built with XOPT_UI_HEADLESS=1 drops the DirectX helpers and
+//  WinMain and exports these instead.  The caller owns the ImGui context and
+//  plays the platform and renderer backends: it sets io.DisplaySize,
+//  io.DeltaTime and the input events, and gives the font atlas a texture id.
+#pragma once
+
+struct ImDrawData;
+
+namespace UiHost {
+
+    // Fonts (from the font cache unless `fontCache` is false), style, and the
+    // profiles and score a normal start loads.  Call after ImGui::CreateContext()
+    void        Init(bool fontCache);
+    // NewFrame → RenderUI → Render; the frame's draw data
+    ImDrawData* Frame();
+    int         Tabs();
+    void        SetTab(int tab);
+    // Joins whatever a panel started; before ImGui::DestroyContext()
+    void        Shutdown();
+
+}  // namespace UiHost
@@ -0,0 +1,135 @@
+// ──────────────────────────────────────────────────────────────────────────────
+//  WORK POOL  —  work-stealing task deques shared by the cleaner phases
+// ──────────────────────────────────────────────────────────────────────────────
+//  Each worker owns a deque: it pushes/pops at the back (LIFO, cache-warm) and
+//  idle workers steal from the front of other deques (oldest = shallowest
+//  directories, which tend to fan out into the most work).
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cleaner.h"
+#include "profiler.h"
+
+namespace Cleaner {
+
+    // ── Per-device concurrency gate ───────────────────────────────────────────
+    // Spinning disks and cheap SSDs fall over when dozens of threads hammer the
+    // same volume; cap the number of workers that may touch one device at once.
+    struct DeviceGate {
+        std::mutex              m;
+        std::condition_variable cv;
+        unsigned                active = 0;
+        unsigned                cap    = 1;
+
+        void Acquire() {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait(lk, [&]{ return active < cap; });
+            ++active;
+        }
+        void Release() {
+            { std::lock_guard<std::mutex> lk(m); --active; }
+            cv.notify_one();
+        }
+    };
+
+    // Stable per-volume key (st_dev on POSIX, drive letter / share on Windows)
+    uint64_t DeviceKey(const std::filesystem::path& p);
+
+    // Sockets, FIFOs and device nodes belong to running programs (X11 and
+    // agent sockets live in /tmp) — never treat them as temp files
+    inline bool IsSpecial(std::filesystem::file_type ft) {
+        using T = std::filesystem::file_type;
+        return ft == T::socket || ft == T::fifo || ft == T::block || ft == T::character;
+    }
+
+    // Worker count for a job spread over `devices` volumes
+    unsigned PoolSize(unsigned requested, size_t devices, unsigned perDeviceCap, bool reporting);
+
+    // Phase-end progress event carrying absolute totals
+    Progress::Event EndEvent(Progress::Phase phase, uint16_t run, const std::vector<Result>& res);
+
+    template <class Task>
+    class WorkPool {
+    public:
+        explicit WorkPool(unsigned n) {
+            for (unsigned i = 0; i < n; i++) m_q.emplace_back(std::make_unique<Queue>());
+        }
+
+        unsigned Size() const { return (unsigned)m_q.size(); }
+
+        void Push(unsigned self, Task&& t) {
+            m_outstanding.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lk(m_q[self]->m);
+            m_q[self]->d.push_back(std::move(t));
+        }
+
+        // Runs tasks until every queue is drained and no task is in flight.
+        // `exec(self, task)` may Push() follow-up work before returning.
+        template <class Fn>
+        void Run(unsigned self, Fn&& exec) {
+            unsigned misses = 0;
+            while (m_outstanding.load(std::memory_order_acquire) > 0) {
+                Task t;
+                if (PopLocal(self, t) || Steal(self, t)) {
+                    misses = 0;
+                    exec(self, t);
+                    m_outstanding.fetch_sub(1, std::memory_order_acq_rel);
+                    continue;
+                }
+                if (++misses < 64) std::this_thread::yield();
+                else std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        // Worker 0 is the calling thread
+        template <class Fn>
+        void RunAll(Fn exec) {
+            std::vector<std::thread> workers;
+            for (unsigned w = 1; w < Size(); w++)
+                workers.emplace_back([this, w, &exec]{
+                    Prof::SetThreadName("clean worker");
+                    Run(w, exec);
+                });
+            Run(0, exec);
+            for (auto& th : workers) th.join();
+        }
+
+    private:
+        struct Queue { std::mutex m; std::deque<Task> d; };
+
+        bool PopLocal(unsigned self, Task& out) {
+            std::lock_guard<std::mutex> lk(m_q[self]->m);
+            if (m_q[self]->d.empty()) return false;
+            out = std::move(m_q[self]->d.back());
+            m_q[self]->d.pop_back();
+            return true;
+        }
+
+        bool Steal(unsigned self, Task& out) {
+            const unsigned n = Size();
+            for (unsigned k = 1; k < n; k++) {
+                Queue& q = *m_q[(self + k) % n];
+                std::lock_guard<std::mutex> lk(q.m);
+                if (q.d.empty()) continue;
+                out = std::move(q.d.front());
+                q.d.pop_front();
+                return true;
+            }
+            return false;
+        }
+
+        std::vector<std::unique_ptr<Queue>> m_q;
+        std::atomic<int64_t>                 m_outstanding{ 0 };
+    };
+
+}  // namespace Cleaner